@@ -16,4 +16,13 @@ auto async(F &&f, Args &&...args) -> std::future<typename std::invoke_result<F,
 	return app::App::getInstance()->threadPool().enqueue(core::forward<F>(f), core::forward<Args>(args)...);
 }
 
+/**
+ * @brief Split the range [begin, end) into chunks of @c grain elements and execute them on the app thread pool
+ * @sa core::for_parallel()
+ */
+template<class F>
+void for_parallel(int begin, int end, int grain, F &&func) {
+	core::for_parallel(app::App::getInstance()->threadPool(), begin, end, grain, core::forward<F>(func));
+}
+
 } // namespace app
@@ -103,8 +103,12 @@ constexpr const char *VoxformatQBSaveLeftHanded = "voxformat_qbsavelefthanded";
 constexpr const char *VoxformatQBSaveCompressed = "voxformat_qbsavecompressed";
 constexpr const char *VoxFormatGLTF_KHR_materials_pbrSpecularGlossiness = "voxformat_gltf_khr_materials_pbrspecularglossiness";
 constexpr const char *VoxFormatGLTF_KHR_materials_specular = "voxformat_gltf_khr_materials_specular";
+constexpr const char *VoxFormatGLTF_MSFT_lod = "voxformat_gltf_msft_lod";
+constexpr const char *VoxFormatGLTF_KHR_mesh_quantization = "voxformat_gltf_khr_mesh_quantization";
+constexpr const char *VoxFormatGLTF_EXT_meshopt_compression = "voxformat_gltf_ext_meshopt_compression";
 constexpr const char *VoxformatImageVolumeMaxDepth = "voxformat_imagevolumemaxdepth";
 constexpr const char *VoxformatImageVolumeBothSides = "voxformat_imagevolumebothsides";
 constexpr const char *VoxformatImageImportType = "voxformat_imageimporttype";
+constexpr const char *VoxformatMCRRegion = "voxformat_mcrregion";
 
 }
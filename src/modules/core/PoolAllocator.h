@@ -29,14 +29,30 @@ private:
 	static_assert(sizeof(T) >= sizeof(T*), "T must at least be of the same size as T*");
 	// the pool buffer memory
 	Type* _poolBuf = nullptr;
-	// fast lookup of the next free slot in the pool
+	// fast lookup of the next free slot in the pool - the list only contains the freed slots
 	Type* _nextFreeSlot = nullptr;
 	SizeType _maxPoolSize = (SizeType)0;
 	SizeType _currentAllocatedItems = (SizeType)0;
+	// the slots behind this index were never handed out - they are not touched before they are needed
+	SizeType _usedSlots = (SizeType)0;
 
 	inline bool outOfRange(Type* ptr) const {
 		return ptr < &_poolBuf[0] || ptr > &_poolBuf[_maxPoolSize - 1];
 	}
+
+	Type* nextSlot() {
+		if (_nextFreeSlot != POOLBUFFER_END_MARKER) {
+			core_assert_msg(!outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
+			Type* ptr = _nextFreeSlot;
+			_nextFreeSlot = *(Type**)ptr;
+			core_assert_msg(_nextFreeSlot == POOLBUFFER_END_MARKER || !outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
+			return ptr;
+		}
+		if (_usedSlots < _maxPoolSize) {
+			return &_poolBuf[_usedSlots++];
+		}
+		return nullptr;
+	}
 public:
 	~PoolAllocator() {
 		core_assert_msg(_poolBuf == nullptr, "PoolAllocator wasn't shut down properly");
@@ -47,11 +63,12 @@ public:
 
 	PoolAllocator(PoolAllocator &&other) noexcept
 		: _poolBuf(other._poolBuf), _nextFreeSlot(other._nextFreeSlot), _maxPoolSize(other._maxPoolSize),
-		  _currentAllocatedItems(other._currentAllocatedItems) {
+		  _currentAllocatedItems(other._currentAllocatedItems), _usedSlots(other._usedSlots) {
 		other._poolBuf = nullptr;
 		other._nextFreeSlot = nullptr;
 		other._maxPoolSize = 0u;
 		other._currentAllocatedItems = 0u;
+		other._usedSlots = 0u;
 	}
 
 	PoolAllocator &operator=(PoolAllocator &&other) noexcept {
@@ -65,6 +82,8 @@ public:
 			other._maxPoolSize = 0u;
 			_currentAllocatedItems = other._currentAllocatedItems;
 			other._currentAllocatedItems = 0u;
+			_usedSlots = other._usedSlots;
+			other._usedSlots = 0u;
 		}
 		return *this;
 	}
@@ -83,16 +102,10 @@ public:
 
 		_maxPoolSize = poolSize;
 		_poolBuf = (Type*)core_malloc(sizeof(T) * _maxPoolSize);
-		for (SizeType i = (SizeType)0; i < _maxPoolSize - 1; ++i) {
-			// init the next free slot address (for fast lookup)
-			*(Type**) &_poolBuf[i] = &_poolBuf[i + 1];
-		}
-
-		// put end of list marker to ... the end of the list.
-		*(Type**) &_poolBuf[_maxPoolSize - 1] = POOLBUFFER_END_MARKER;
-
-		_nextFreeSlot = _poolBuf;
+		// the slots are handed out in order - the free list is only built by free()
+		_nextFreeSlot = POOLBUFFER_END_MARKER;
 		_currentAllocatedItems = (SizeType)0;
+		_usedSlots = (SizeType)0;
 
 		return true;
 	}
@@ -104,6 +117,7 @@ public:
 		_nextFreeSlot = nullptr;
 		_maxPoolSize = (SizeType)0;
 		_currentAllocatedItems = (SizeType)0;
+		_usedSlots = (SizeType)0;
 	}
 
 	inline SizeType allocated() const {
@@ -115,14 +129,10 @@ public:
 	}
 
 	T* alloc() {
-		Type* ptr = nullptr;
-		if (_nextFreeSlot != POOLBUFFER_END_MARKER) {
+		Type* ptr = nextSlot();
+		if (ptr != nullptr) {
 			core_assert_msg(_currentAllocatedItems < (this->max)(), "Exceed the max allowed items while the end of slot marker wasn't found");
-			core_assert_msg(!outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
-			ptr = _nextFreeSlot;
-			_nextFreeSlot = *(Type**)ptr;
 			++_currentAllocatedItems;
-			core_assert_msg(_nextFreeSlot == POOLBUFFER_END_MARKER || !outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
 			new ((void*)ptr) Type();
 		}
 
@@ -131,14 +141,10 @@ public:
 
 	template<class ... Args>
 	inline T* alloc(Args&&... args) {
-		Type* ptr = nullptr;
-		if (_nextFreeSlot != POOLBUFFER_END_MARKER) {
+		Type* ptr = nextSlot();
+		if (ptr != nullptr) {
 			core_assert_msg(_currentAllocatedItems < (this->max)(), "Exceed the max allowed items while the end of slot marker wasn't found");
-			core_assert_msg(!outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
-			ptr = _nextFreeSlot;
-			_nextFreeSlot = *(Type**)ptr;
 			++_currentAllocatedItems;
-			core_assert_msg(_nextFreeSlot == POOLBUFFER_END_MARKER || !outOfRange(_nextFreeSlot), "Out of range after %i allocated slots", (int)_currentAllocatedItems);
 			new ((void*)ptr) Type(core::forward<Args>(args) ...);
 		}
 
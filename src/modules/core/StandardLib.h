@@ -16,6 +16,7 @@
 
 extern "C" void SDLCALL SDL_SIMDFree(void *ptr);
 extern "C" void *SDLCALL SDL_SIMDAlloc(const size_t len);
+extern "C" void *SDLCALL SDL_SIMDRealloc(void *mem, const size_t len);
 extern "C" void *SDLCALL SDL_malloc(size_t size);
 extern "C" void *SDLCALL SDL_realloc(void *mem, size_t size);
 extern "C" void SDLCALL SDL_free(void *mem);
@@ -44,6 +45,10 @@ extern "C" char *SDLCALL SDL_strdup(const char *str);
 #define core_aligned_malloc SDL_SIMDAlloc
 #endif
 
+#ifndef core_aligned_realloc
+#define core_aligned_realloc SDL_SIMDRealloc
+#endif
+
 #ifndef core_aligned_free
 #define core_aligned_free SDL_SIMDFree
 #endif
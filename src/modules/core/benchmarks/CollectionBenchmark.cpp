@@ -1,8 +1,12 @@
 #include "app/benchmark/AbstractBenchmark.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/FlatHashMap.h"
 #include "core/collection/Map.h"
 #include "core/Assert.h"
+#include "core/String.h"
 #include <unordered_map>
 #include <map>
+#include <vector>
 
 class MapBenchmark: public app::AbstractBenchmark {
 };
@@ -53,8 +57,120 @@ BENCHMARK_DEFINE_F(MapBenchmark, compareToMapCore) (benchmark::State& state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(MapBenchmark, compareToFlatHashMapCore) (benchmark::State& state) {
+	core::FlatHashMap<int64_t, int64_t, std::hash<int64_t>> map;
+	for (auto _ : state) {
+		const int64_t n = state.range(0);
+		for (int64_t i = 0; i < n; ++i) {
+			map.put(i, i);
+			int64_t value;
+			const bool found = map.get(i, value);
+			if (!found || value != i) {
+				state.SkipWithError("Failed!");
+				break;
+			}
+		}
+	}
+}
+
+// fill the map with a lot of entries and measure the lookups - this is what the SparseVolume is doing
+template<class MAP, class PUT, class GET>
+static void largeMapBenchmark(benchmark::State& state, PUT put, GET get) {
+	const int64_t n = state.range(0);
+	MAP map;
+	for (int64_t i = 0; i < n; ++i) {
+		put(map, i * 7);
+	}
+	for (auto _ : state) {
+		for (int64_t i = 0; i < n; ++i) {
+			if (!get(map, ((i * 31) % n) * 7)) {
+				state.SkipWithError("Failed!");
+				break;
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, largeUnorderedMapStd) (benchmark::State& state) {
+	using MAP = std::unordered_map<int64_t, int64_t>;
+	largeMapBenchmark<MAP>(
+		state, [](MAP &map, int64_t i) { map.insert(std::make_pair(i, i)); },
+		[](const MAP &map, int64_t i) { return map.find(i) != map.end(); });
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, largeMapCore) (benchmark::State& state) {
+	using MAP = core::Map<int64_t, int64_t, 4096, std::hash<int64_t>>;
+	largeMapBenchmark<MAP>(
+		state, [](MAP &map, int64_t i) { map.put(i, i); },
+		[](const MAP &map, int64_t i) { return map.hasKey(i); });
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, largeFlatHashMapCore) (benchmark::State& state) {
+	using MAP = core::FlatHashMap<int64_t, int64_t>;
+	largeMapBenchmark<MAP>(
+		state, [](MAP &map, int64_t i) { map.put(i, i); },
+		[](const MAP &map, int64_t i) { return map.hasKey(i); });
+}
+
+class DynamicArrayBenchmark: public app::AbstractBenchmark {
+};
+
+// same layout as the voxel::VoxelVertex
+struct BenchmarkVertex {
+	float x, y, z;
+	uint32_t info;
+};
+
+// append n elements without reserving the memory - this is what the mesh extraction is doing
+template<class ARRAY, class CREATE>
+static void appendBenchmark(benchmark::State& state, CREATE create) {
+	const int64_t n = state.range(0);
+	for (auto _ : state) {
+		ARRAY array;
+		for (int64_t i = 0; i < n; ++i) {
+			array.push_back(create(i));
+		}
+		benchmark::DoNotOptimize(array.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+static BenchmarkVertex createVertex(int64_t i) {
+	return BenchmarkVertex{(float)i, (float)i, (float)i, (uint32_t)i};
+}
+
+static core::String createString(int64_t i) {
+	return core::String::format("%i", (int)i);
+}
+
+BENCHMARK_DEFINE_F(DynamicArrayBenchmark, appendVertexStd) (benchmark::State& state) {
+	appendBenchmark<std::vector<BenchmarkVertex>>(state, createVertex);
+}
+
+BENCHMARK_DEFINE_F(DynamicArrayBenchmark, appendVertexCore) (benchmark::State& state) {
+	// the increase of the voxel::VertexArray
+	appendBenchmark<core::DynamicArray<BenchmarkVertex, 1024>>(state, createVertex);
+}
+
+BENCHMARK_DEFINE_F(DynamicArrayBenchmark, appendStringStd) (benchmark::State& state) {
+	appendBenchmark<std::vector<core::String>>(state, createString);
+}
+
+BENCHMARK_DEFINE_F(DynamicArrayBenchmark, appendStringCore) (benchmark::State& state) {
+	appendBenchmark<core::DynamicArray<core::String>>(state, createString);
+}
+
+BENCHMARK_REGISTER_F(DynamicArrayBenchmark, appendVertexStd)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK_REGISTER_F(DynamicArrayBenchmark, appendVertexCore)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK_REGISTER_F(DynamicArrayBenchmark, appendStringStd)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK_REGISTER_F(DynamicArrayBenchmark, appendStringCore)->Arg(1 << 16)->Arg(1 << 20);
 BENCHMARK_REGISTER_F(MapBenchmark, compareToMapCore)->RangeMultiplier(2)->Range(8, 512);
 BENCHMARK_REGISTER_F(MapBenchmark, compareToMapStd)->RangeMultiplier(2)->Range(8, 512);
 BENCHMARK_REGISTER_F(MapBenchmark, compareToUnorderedMapStd)->RangeMultiplier(2)->Range(8, 512);
+BENCHMARK_REGISTER_F(MapBenchmark, compareToFlatHashMapCore)->RangeMultiplier(2)->Range(8, 512);
+BENCHMARK_REGISTER_F(MapBenchmark, largeUnorderedMapStd)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK_REGISTER_F(MapBenchmark, largeMapCore)->Arg(1 << 20)->Arg(1 << 22);
+BENCHMARK_REGISTER_F(MapBenchmark, largeFlatHashMapCore)->Arg(1 << 20)->Arg(1 << 22);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,66 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+
+class ThreadPoolBenchmark : public app::AbstractBenchmark {
+};
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, enqueue)(benchmark::State &state) {
+	core::ThreadPool pool((size_t)state.range(0), "BenchmarkPool");
+	pool.init();
+	const int n = 4096;
+	for (auto _ : state) {
+		core::AtomicInt count{0};
+		for (int i = 0; i < n; ++i) {
+			pool.enqueue([&count]() { count.increment(); });
+		}
+		while (count < n) {
+			std::this_thread::yield();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, taskGroup)(benchmark::State &state) {
+	core::ThreadPool pool((size_t)state.range(0), "BenchmarkPool");
+	pool.init();
+	const int n = 4096;
+	for (auto _ : state) {
+		core::AtomicInt count{0};
+		core::TaskGroup group(pool);
+		for (int i = 0; i < n; ++i) {
+			group.run([&count]() { count.increment(); });
+		}
+		group.wait();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, forParallel)(benchmark::State &state) {
+	core::ThreadPool pool((size_t)state.range(0), "BenchmarkPool");
+	pool.init();
+	const int n = 1 << 20;
+	core::DynamicArray<float> values;
+	values.resize(n);
+	for (auto _ : state) {
+		core::for_parallel(pool, 0, n, 4096, [&values](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				float v = (float)i;
+				for (int j = 0; j < 16; ++j) {
+					v = v * 0.5f + 1.0f;
+				}
+				values[i] = v;
+			}
+		});
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, enqueue)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, taskGroup)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, forParallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -11,43 +11,101 @@
 #include <cstdint> // intptr_t - not available in stdint.h
 #include <new>
 #include <initializer_list>
+#include <type_traits>
 
 namespace core {
 
+/**
+ * @brief Types that can be moved to a new address with a plain memcpy - without calling the move ctor and the dtor
+ *
+ * Specialize this for own types that are relocatable but not trivially copyable.
+ */
+template<class TYPE>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<TYPE>::value> {};
+
 /**
  * @brief Dynamically growing continuous storage buffer
  *
- * @note This array does not have an upper size limit. Each time the capacity is reached, it will
- * allocate new slots given by the @c INCREASE template parameter.
+ * @note This array does not have an upper size limit. Each time the capacity is reached, it grows by half of the
+ * current capacity - rounded up to a multiple of the @c INCREASE template parameter. Appending n elements is
+ * amortized O(n). If @c MAXINCREASE is not @c 0 the growth is capped to this amount of elements - which limits the
+ * memory overhead of huge arrays at the cost of more reallocations.
+ *
+ * @note Types that are trivially relocatable (see @c is_trivially_relocatable) are moved with one realloc call
+ * instead of a move ctor and dtor call for each element.
  *
  * @note Use a fixed size array to prevent memory allocations - where possible
  * @sa Array
  * @ingroup Collections
  */
-template<class TYPE, size_t INCREASE = 32u>
+template<class TYPE, size_t INCREASE = 32u, size_t MAXINCREASE = 0u>
 class DynamicArray {
 private:
 	TYPE* _buffer = nullptr;
 	size_t _capacity = 0u;
 	size_t _size = 0u;
+	size_t _allocations = 0u;
+
+	static constexpr bool Relocatable = is_trivially_relocatable<TYPE>::value;
 
 	static inline constexpr size_t align(size_t val) {
 		const size_t len = INCREASE - 1u;
 		return (size_t)((val + len) & ~len);
 	}
 
+	void reallocate(size_t newCapacity) {
+		if constexpr (Relocatable) {
+			_buffer = (TYPE*)core_aligned_realloc((void*)_buffer, newCapacity * sizeof(TYPE));
+		} else {
+			TYPE* newBuffer = (TYPE*)core_aligned_malloc(newCapacity * sizeof(TYPE));
+			for (size_t i = 0u; i < _size; ++i) {
+				new ((void*)&newBuffer[i]) TYPE(core::move(_buffer[i]));
+				_buffer[i].~TYPE();
+			}
+			core_aligned_free(_buffer);
+			_buffer = newBuffer;
+		}
+		_capacity = newCapacity;
+		++_allocations;
+	}
+
+	/**
+	 * @brief Allocate exactly the (aligned) requested capacity - used if the final size is known
+	 */
+	void reserveExact(size_t newSize) {
+		if (_capacity >= newSize) {
+			return;
+		}
+		reallocate(align(newSize));
+	}
+
+	/**
+	 * @brief Geometric growth for appending elements
+	 */
 	void checkBufferSize(size_t newSize) {
 		if (_capacity >= newSize) {
 			return;
 		}
-		_capacity = align(newSize);
-		TYPE* newBuffer = (TYPE*)core_aligned_malloc(_capacity * sizeof(TYPE));
-		for (size_t i = 0u; i < _size; ++i) {
-			new ((void*)&newBuffer[i]) TYPE(core::move(_buffer[i]));
-			_buffer[i].~TYPE();
+		size_t growth = _capacity / 2u;
+		if (MAXINCREASE > 0u && growth > MAXINCREASE) {
+			growth = MAXINCREASE;
+		}
+		reallocate(align(core_max(newSize, _capacity + growth)));
+	}
+
+	/**
+	 * @brief Move the elements [startIdx, _size) by n slots to the end. The capacity must be big enough and the
+	 * source slots are left unconstructed.
+	 */
+	void shiftRight(size_t startIdx, size_t n) {
+		if constexpr (Relocatable) {
+			memmove((void*)&_buffer[startIdx + n], (const void*)&_buffer[startIdx], (_size - startIdx) * sizeof(TYPE));
+		} else {
+			for (size_t s = _size; s-- > startIdx;) {
+				new ((void*)&_buffer[s + n]) TYPE(core::move(_buffer[s]));
+				_buffer[s].~TYPE();
+			}
 		}
-		core_aligned_free(_buffer);
-		_buffer = newBuffer;
 	}
 public:
 	using value_type = TYPE;
@@ -60,7 +118,7 @@ public:
 	}
 
 	explicit DynamicArray(size_t amount) {
-		checkBufferSize(amount);
+		reserveExact(amount);
 		_size = amount;
 		for (size_t i = 0u; i < _size; ++i) {
 			new (&_buffer[i]) TYPE();
@@ -68,7 +126,7 @@ public:
 	}
 
 	DynamicArray(const DynamicArray& other) {
-		checkBufferSize(other._size);
+		reserveExact(other._size);
 		_size = other._size;
 		for (size_t i = 0u; i < _size; ++i) {
 			new (&_buffer[i]) TYPE(other._buffer[i]);
@@ -76,11 +134,12 @@ public:
 	}
 
 	DynamicArray(DynamicArray &&other) noexcept :
-			_capacity(other._capacity), _size(other._size) {
+			_capacity(other._capacity), _size(other._size), _allocations(other._allocations) {
 		_buffer = other._buffer;
 		other._buffer = nullptr;
 		other._size = 0;
 		other._capacity = 0;
+		other._allocations = 0;
 	}
 
 	~DynamicArray() {
@@ -92,7 +151,7 @@ public:
 			return *this;
 		}
 		release();
-		checkBufferSize(other._size);
+		reserveExact(other._size);
 		_size = other._size;
 		for (size_t i = 0u; i < _size; ++i) {
 			new (&_buffer[i]) TYPE(other._buffer[i]);
@@ -104,10 +163,12 @@ public:
 		release();
 		_capacity = other._capacity;
 		_size = other._size;
+		_allocations = other._allocations;
 		_buffer = other._buffer;
 		other._buffer = nullptr;
 		other._size = 0;
 		other._capacity = 0;
+		other._allocations = 0;
 		return *this;
 	}
 
@@ -252,20 +313,8 @@ public:
 		}
 
 		const size_t startIdx = index(pos);
-		size_t s = _size - 1;
-		size_t t = s + n;
-
-		// TODO: this can be optimized by only calling the move ctor once
 		checkBufferSize(_size + n);
-
-		const size_t cnt = _size - startIdx;
-		for (size_t i = 0; i < cnt; ++i, --s, --t) {
-			new ((void*)&_buffer[t]) TYPE(core::move(_buffer[s]));
-			_buffer[s].~TYPE();
-			if (s == 0) {
-				break;
-			}
-		}
+		shiftRight(startIdx, n);
 
 		for (size_t i = 0u; i < n; ++i) {
 			new ((void *)&_buffer[startIdx + i]) TYPE(array[i]);
@@ -291,21 +340,8 @@ public:
 		}
 
 		size_t startIdx = index(pos);
-
-		// TODO: this can be optimized by only calling the move ctor once
 		checkBufferSize(_size + n);
-
-		size_t s = _size - 1;
-		size_t t = s + n;
-
-		const size_t cnt = _size - startIdx;
-		for (size_t i = 0; i < cnt; ++i, --s, --t) {
-			new ((void*)&_buffer[t]) TYPE(core::move(_buffer[s]));
-			_buffer[s].~TYPE();
-			if (s == 0) {
-				break;
-			}
-		}
+		shiftRight(startIdx, n);
 
 		for (ITER i = first; i != last; ++i) {
 			new ((void *)&_buffer[startIdx++]) TYPE(*i);
@@ -347,7 +383,7 @@ public:
 	}
 
 	void reserve(size_t size) {
-		checkBufferSize(size);
+		reserveExact(size);
 	}
 
 	void insert(size_t size, const TYPE& type) {
@@ -413,6 +449,17 @@ public:
 		const size_t srcIdxStart = index + delta;
 		const size_t tgtIdxStart = index;
 		size_t newSize = _size;
+		if constexpr (Relocatable) {
+			for (size_t i = tgtIdxStart; i < srcIdxStart; ++i) {
+				_buffer[i].~TYPE();
+			}
+			if (srcIdxStart < _size) {
+				memmove((void*)&_buffer[tgtIdxStart], (const void*)&_buffer[srcIdxStart],
+						(_size - srcIdxStart) * sizeof(TYPE));
+			}
+			_size -= delta;
+			return;
+		}
 		if (srcIdxStart < _size) {
 			size_t s = srcIdxStart;
 			size_t t = tgtIdxStart;
@@ -436,6 +483,13 @@ public:
 		return _capacity;
 	}
 
+	/**
+	 * @return The amount of buffer (re-)allocations of this instance - mainly for tests
+	 */
+	inline size_t allocations() const {
+		return _allocations;
+	}
+
 	inline iterator begin() const {
 		return iterator(_buffer);
 	}
@@ -0,0 +1,391 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include "core/collection/DynamicMap.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <initializer_list>
+
+namespace core {
+
+/**
+ * @brief Open addressing hash map with robin hood probing.
+ *
+ * The entries are stored in one continuous array and the capacity grows with the load factor - this makes
+ * the map suitable for millions of entries where the fixed bucket count of the @c DynamicMap would lead to
+ * long chains.
+ *
+ * @note Pointers and iterators are invalidated by @c put(), @c emplace() and @c remove()
+ * @sa DynamicMap
+ * @ingroup Collections
+ */
+template<typename KEYTYPE, typename VALUETYPE, typename HASHER = privdynamicmap::DefaultHasher,
+		 typename COMPARE = privdynamicmap::EqualCompare>
+class FlatHashMap {
+public:
+	using value_type = VALUETYPE;
+	using key_type = KEYTYPE;
+
+	struct KeyValue {
+		inline KeyValue(const KEYTYPE &_key, const VALUETYPE &_value) : key(_key), value(_value) {
+		}
+
+		inline KeyValue(const KEYTYPE &_key, VALUETYPE &&_value)
+			: key(_key), value(core::forward<VALUETYPE>(_value)) {
+		}
+
+		KEYTYPE key;
+		VALUETYPE value;
+	};
+
+private:
+	static constexpr size_t MinCapacity = 16u;
+	// the probe distance is stored in one byte - 0 marks an empty slot
+	static constexpr uint8_t MaxProbeDistance = 255u;
+
+	KeyValue *_entries = nullptr;
+	uint8_t *_distances = nullptr;
+	size_t _capacity = 0u;
+	size_t _size = 0u;
+	int _shift = 64;
+	HASHER _hasher;
+
+	/**
+	 * @brief Fibonacci hashing to spread the hash bits over the whole table - this allows us to use
+	 * cheap hashers like the identity or morton codes.
+	 */
+	inline size_t slot(const KEYTYPE &key) const {
+		const uint64_t hashValue = (uint64_t)_hasher(key);
+		return (size_t)((hashValue * UINT64_C(0x9E3779B97F4A7C15)) >> _shift);
+	}
+
+	inline size_t maxLoad() const {
+		// 87.5% load factor
+		return _capacity - (_capacity >> 3u);
+	}
+
+	size_t findIndex(const KEYTYPE &key) const {
+		if (_size == 0u) {
+			return _capacity;
+		}
+		const size_t mask = _capacity - 1u;
+		size_t idx = slot(key);
+		for (uint8_t distance = 1u; _distances[idx] >= distance; ++distance) {
+			if (COMPARE()(_entries[idx].key, key)) {
+				return idx;
+			}
+			idx = (idx + 1u) & mask;
+		}
+		return _capacity;
+	}
+
+	/**
+	 * @note The key must not be part of the map yet
+	 */
+	void insertUnique(KeyValue &&entry) {
+		if (_size + 1u > maxLoad()) {
+			rehash(_capacity == 0u ? MinCapacity : _capacity * 2u);
+		}
+		const size_t mask = _capacity - 1u;
+		size_t idx = slot(entry.key);
+		uint8_t distance = 1u;
+		for (;;) {
+			if (_distances[idx] == 0u) {
+				new ((void *)&_entries[idx]) KeyValue(core::move(entry));
+				_distances[idx] = distance;
+				++_size;
+				return;
+			}
+			if (_distances[idx] < distance) {
+				// robin hood: take the slot from the entry that is closer to its home slot
+				KeyValue tmp(core::move(_entries[idx]));
+				_entries[idx].~KeyValue();
+				new ((void *)&_entries[idx]) KeyValue(core::move(entry));
+				entry.~KeyValue();
+				new ((void *)&entry) KeyValue(core::move(tmp));
+				const uint8_t tmpDistance = _distances[idx];
+				_distances[idx] = distance;
+				distance = tmpDistance;
+			}
+			idx = (idx + 1u) & mask;
+			if (++distance == MaxProbeDistance) {
+				rehash(_capacity * 2u);
+				insertUnique(core::move(entry));
+				return;
+			}
+		}
+	}
+
+	void rehash(size_t newCapacity) {
+		core_assert((newCapacity & (newCapacity - 1u)) == 0u);
+		KeyValue *oldEntries = _entries;
+		uint8_t *oldDistances = _distances;
+		const size_t oldCapacity = _capacity;
+
+		_entries = (KeyValue *)core_malloc(newCapacity * sizeof(KeyValue));
+		_distances = (uint8_t *)core_malloc(newCapacity);
+		core_memset(_distances, 0, newCapacity);
+		_capacity = newCapacity;
+		_size = 0u;
+		_shift = 64;
+		for (size_t c = newCapacity; c > 1u; c >>= 1u) {
+			--_shift;
+		}
+
+		for (size_t i = 0u; i < oldCapacity; ++i) {
+			if (oldDistances[i] == 0u) {
+				continue;
+			}
+			insertUnique(core::move(oldEntries[i]));
+			oldEntries[i].~KeyValue();
+		}
+		core_free(oldEntries);
+		core_free(oldDistances);
+	}
+
+	void copyFrom(const FlatHashMap &other) {
+		if (other._size == 0u) {
+			return;
+		}
+		_entries = (KeyValue *)core_malloc(other._capacity * sizeof(KeyValue));
+		_distances = (uint8_t *)core_malloc(other._capacity);
+		core_memcpy(_distances, other._distances, other._capacity);
+		_capacity = other._capacity;
+		_shift = other._shift;
+		_size = other._size;
+		for (size_t i = 0u; i < _capacity; ++i) {
+			if (_distances[i] != 0u) {
+				new ((void *)&_entries[i]) KeyValue(other._entries[i]);
+			}
+		}
+	}
+
+	void release() {
+		clear();
+		core_free(_entries);
+		core_free(_distances);
+		_entries = nullptr;
+		_distances = nullptr;
+		_capacity = 0u;
+		_shift = 64;
+	}
+
+public:
+	FlatHashMap() {
+	}
+
+	FlatHashMap(std::initializer_list<KeyValue> other) {
+		for (auto i = other.begin(); i != other.end(); ++i) {
+			put(i->key, i->value);
+		}
+	}
+
+	FlatHashMap(const FlatHashMap &other) : _hasher(other._hasher) {
+		copyFrom(other);
+	}
+
+	FlatHashMap(FlatHashMap &&other) noexcept
+		: _entries(other._entries), _distances(other._distances), _capacity(other._capacity), _size(other._size),
+		  _shift(other._shift), _hasher(other._hasher) {
+		other._entries = nullptr;
+		other._distances = nullptr;
+		other._capacity = 0u;
+		other._size = 0u;
+		other._shift = 64;
+	}
+
+	~FlatHashMap() {
+		release();
+	}
+
+	FlatHashMap &operator=(const FlatHashMap &other) {
+		if (this != &other) {
+			release();
+			_hasher = other._hasher;
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	FlatHashMap &operator=(FlatHashMap &&other) noexcept {
+		if (this != &other) {
+			release();
+			_entries = other._entries;
+			_distances = other._distances;
+			_capacity = other._capacity;
+			_size = other._size;
+			_shift = other._shift;
+			_hasher = other._hasher;
+			other._entries = nullptr;
+			other._distances = nullptr;
+			other._capacity = 0u;
+			other._size = 0u;
+			other._shift = 64;
+		}
+		return *this;
+	}
+
+	class iterator {
+	private:
+		const FlatHashMap *_map;
+		size_t _idx;
+
+	public:
+		constexpr iterator() : _map(nullptr), _idx(0u) {
+		}
+
+		iterator(const FlatHashMap *map, size_t idx) : _map(map), _idx(idx) {
+		}
+
+		inline KeyValue *operator*() const {
+			return &_map->_entries[_idx];
+		}
+
+		iterator &operator++() {
+			for (++_idx; _idx < _map->_capacity; ++_idx) {
+				if (_map->_distances[_idx] != 0u) {
+					return *this;
+				}
+			}
+			_map = nullptr;
+			_idx = 0u;
+			return *this;
+		}
+
+		inline KeyValue *operator->() const {
+			return &_map->_entries[_idx];
+		}
+
+		inline bool operator!=(const iterator &rhs) const {
+			return _map != rhs._map || _idx != rhs._idx;
+		}
+
+		inline bool operator==(const iterator &rhs) const {
+			return _map == rhs._map && _idx == rhs._idx;
+		}
+	};
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	inline size_t capacity() const {
+		return _capacity;
+	}
+
+	/**
+	 * @brief Make sure that the given amount of entries can be stored without a rehash
+	 */
+	void reserve(size_t entries) {
+		size_t newCapacity = _capacity == 0u ? MinCapacity : _capacity;
+		while (newCapacity - (newCapacity >> 3u) < entries) {
+			newCapacity *= 2u;
+		}
+		if (newCapacity != _capacity) {
+			rehash(newCapacity);
+		}
+	}
+
+	bool get(const KEYTYPE &key, VALUETYPE &value) const {
+		const size_t idx = findIndex(key);
+		if (idx == _capacity) {
+			return false;
+		}
+		value = _entries[idx].value;
+		return true;
+	}
+
+	bool hasKey(const KEYTYPE &key) const {
+		return findIndex(key) != _capacity;
+	}
+
+	iterator find(const KEYTYPE &key) const {
+		const size_t idx = findIndex(key);
+		if (idx == _capacity) {
+			return end();
+		}
+		return iterator(this, idx);
+	}
+
+	void emplace(const KEYTYPE &key, VALUETYPE &&value) {
+		const size_t idx = findIndex(key);
+		if (idx != _capacity) {
+			_entries[idx].value = core::forward<VALUETYPE>(value);
+			return;
+		}
+		insertUnique(KeyValue(key, core::forward<VALUETYPE>(value)));
+	}
+
+	void put(const KEYTYPE &key, const VALUETYPE &value) {
+		const size_t idx = findIndex(key);
+		if (idx != _capacity) {
+			_entries[idx].value = value;
+			return;
+		}
+		insertUnique(KeyValue(key, value));
+	}
+
+	iterator begin() const {
+		for (size_t i = 0u; i < _capacity; ++i) {
+			if (_distances[i] != 0u) {
+				return iterator(this, i);
+			}
+		}
+		return end();
+	}
+
+	constexpr iterator end() const {
+		return iterator();
+	}
+
+	/**
+	 * @note Keeps the allocated memory
+	 */
+	void clear() {
+		for (size_t i = 0u; i < _capacity; ++i) {
+			if (_distances[i] != 0u) {
+				_entries[i].~KeyValue();
+				_distances[i] = 0u;
+			}
+		}
+		_size = 0u;
+	}
+
+	inline void erase(const iterator &iter) {
+		remove(iter->key);
+	}
+
+	bool remove(const KEYTYPE &key) {
+		size_t idx = findIndex(key);
+		if (idx == _capacity) {
+			return false;
+		}
+		_entries[idx].~KeyValue();
+		// backward shift deletion - no tombstones needed
+		const size_t mask = _capacity - 1u;
+		size_t next = (idx + 1u) & mask;
+		while (_distances[next] > 1u) {
+			new ((void *)&_entries[idx]) KeyValue(core::move(_entries[next]));
+			_entries[next].~KeyValue();
+			_distances[idx] = _distances[next] - 1u;
+			idx = next;
+			next = (next + 1u) & mask;
+		}
+		_distances[idx] = 0u;
+		--_size;
+		return true;
+	}
+};
+
+} // namespace core
@@ -10,17 +10,104 @@
 
 namespace core {
 
+// the pool and queue index of the current worker thread
+static thread_local const ThreadPool *tlsPool = nullptr;
+static thread_local int tlsWorkerIndex = -1;
+
 ThreadPool::ThreadPool(size_t threads, const char *name) :
 		_threads(threads), _name(name) {
 	if (_name == nullptr) {
 		_name = "ThreadPool";
 	}
+	const size_t queues = threads == 0u ? 1u : threads;
+	_queues.reserve(queues);
+	for (size_t i = 0; i < queues; ++i) {
+		_queues.push_back(new WorkQueue());
+	}
+}
+
+int ThreadPool::workerIndex() const {
+	if (tlsPool != this) {
+		return -1;
+	}
+	return tlsWorkerIndex;
+}
+
+bool ThreadPool::schedule(Task &&task) {
+	if (_stop) {
+		return false;
+	}
+	int queueIdx = workerIndex();
+	if (queueIdx < 0) {
+		queueIdx = (int)((uint32_t)_nextQueue.increment() % (uint32_t)_queues.size());
+	}
+	WorkQueue *queue = _queues[queueIdx];
+	// count the task before it can get popped - the counter must never be lower than the amount of queued tasks
+	_pending.increment();
+	{
+		core::ScopedLock lock(queue->mutex);
+		queue->tasks.emplace_back(core::move(task));
+	}
+	{
+		// lock to not miss a worker that just checked the predicate and is about to wait
+		core::ScopedLock lock(_sleepMutex);
+	}
+	_sleepCondition.notify_one();
+	return true;
+}
+
+bool ThreadPool::popTask(int queueIdx, Task &task) {
+	WorkQueue *queue = _queues[queueIdx];
+	core::ScopedLock lock(queue->mutex);
+	if (queue->tasks.empty()) {
+		return false;
+	}
+	// newest first - the data of the task that was just scheduled is most likely still in the cache
+	task = core::move(queue->tasks.back());
+	queue->tasks.pop_back();
+	_pending.decrement();
+	return true;
+}
+
+bool ThreadPool::stealTask(int startIdx, Task &task) {
+	const int n = (int)_queues.size();
+	for (int i = 0; i < n; ++i) {
+		WorkQueue *queue = _queues[(startIdx + i) % n];
+		core::ScopedLock lock(queue->mutex);
+		if (queue->tasks.empty()) {
+			continue;
+		}
+		// oldest first - these tasks are most likely the biggest ones
+		task = core::move(queue->tasks.front());
+		queue->tasks.pop_front();
+		_pending.decrement();
+		return true;
+	}
+	return false;
+}
+
+bool ThreadPool::runPendingTask() {
+	if (_pending <= 0) {
+		return false;
+	}
+	Task task;
+	const int queueIdx = workerIndex();
+	if (queueIdx >= 0) {
+		if (!popTask(queueIdx, task) && !stealTask(queueIdx + 1, task)) {
+			return false;
+		}
+	} else if (!stealTask((int)((uint32_t)_nextQueue % (uint32_t)_queues.size()), task)) {
+		return false;
+	}
+	task();
+	return true;
 }
 
 void ThreadPool::abort() {
-	core::ScopedLock lock(_queueMutex);
-	while (!_tasks.empty()) {
-		_tasks.pop();
+	for (WorkQueue *queue : _queues) {
+		core::ScopedLock lock(queue->mutex);
+		_pending.decrement((int)queue->tasks.size());
+		queue->tasks.clear();
 	}
 }
 
@@ -41,29 +128,21 @@ void ThreadPool::init() {
 				Log::debug("Failed to set thread name for pool thread %i", (int)i);
 			}
 			core_trace_thread(n.c_str());
+			tlsPool = this;
+			tlsWorkerIndex = (int)i;
 			for (;;) {
-				std::function<void()> task;
-				{
-					core::ScopedLock lock(this->_queueMutex);
-					if (!this->_stop) {
-						this->_queueCondition.wait(this->_queueMutex, [this] {
-							// predicate must return false if the waiting should continue
-							if (this->_stop) {
-								return true;
-							}
-							core::ScopedLock queueLock(this->_queueMutex);
-							if (!this->_tasks.empty()) {
-								return true;
-							}
-							return false;
-						});
-					}
-					if (this->_stop && (this->_force || this->_tasks.empty())) {
+				Task task;
+				if (!popTask((int)i, task) && !stealTask((int)i + 1, task)) {
+					core::ScopedLock lock(this->_sleepMutex);
+					this->_sleepCondition.wait(this->_sleepMutex, [this] {
+						// predicate must return false if the waiting should continue
+						return this->_stop || this->_pending > 0;
+					});
+					if (this->_stop && (this->_force || this->_pending <= 0)) {
 						Log::debug("Shutdown worker thread for %i", (int)i);
 						break;
 					}
-					task = core::move(this->_tasks.front());
-					this->_tasks.pop();
+					continue;
 				}
 
 				core_trace_begin_frame(n.c_str());
@@ -73,12 +152,18 @@ void ThreadPool::init() {
 				Log::trace("End of task in %i", (int)i);
 				core_trace_end_frame(n.c_str());
 			}
+			tlsPool = nullptr;
+			tlsWorkerIndex = -1;
 		});
 	}
 }
 
 ThreadPool::~ThreadPool() {
 	shutdown();
+	for (WorkQueue *queue : _queues) {
+		delete queue;
+	}
+	_queues.clear();
 }
 
 void ThreadPool::shutdown(bool wait) {
@@ -86,12 +171,35 @@ void ThreadPool::shutdown(bool wait) {
 		return;
 	}
 	_force = !wait;
-	_stop = true;
-	_queueCondition.notify_all();
+	{
+		core::ScopedLock lock(_sleepMutex);
+		_stop = true;
+	}
+	_sleepCondition.notify_all();
 	for (std::thread &worker : _workers) {
 		worker.join();
 	}
 	_workers.clear();
 }
 
+void TaskGroup::finish() {
+	// the lock makes sure that the waiting thread doesn't destroy the group before the notification is done
+	core::ScopedLock lock(_mutex);
+	if (_pending.decrement() == 1) {
+		_condition.notify_all();
+	}
+}
+
+void TaskGroup::wait() {
+	// help to execute the queued tasks of the pool - these might be the tasks of this group
+	while (_pending > 0 && _pool.runPendingTask()) {
+	}
+	// the remaining tasks of this group are executed by the workers
+	core::ScopedLock lock(_mutex);
+	_condition.wait(_mutex, [this] {
+		// predicate must return false if the waiting should continue
+		return _pending <= 0;
+	});
+}
+
 }
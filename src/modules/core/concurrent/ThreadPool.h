@@ -30,8 +30,8 @@
 #include <thread>
 #include <future>
 #include <functional>
+#include <deque>
 #include "core/collection/DynamicArray.h"
-#include "core/collection/Queue.h"
 #include "core/concurrent/Atomic.h"
 #include "core/concurrent/Lock.h"
 #include "core/concurrent/ConditionVariable.h"
@@ -40,8 +40,19 @@
 
 namespace core {
 
+/**
+ * @brief Thread pool with one task queue per worker.
+ *
+ * Tasks that are scheduled from a worker thread are put into the queue of that worker, all other tasks are
+ * distributed over the worker queues. A worker executes the newest task of its own queue first and steals the oldest
+ * tasks from the other workers if its own queue is empty.
+ *
+ * @sa TaskGroup
+ */
 class ThreadPool final {
 public:
+	using Task = std::function<void()>;
+
 	explicit ThreadPool(size_t, const char *name = nullptr);
 	~ThreadPool();
 
@@ -51,6 +62,19 @@ public:
 	template<class F, class ... Args>
 	auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
 
+	/**
+	 * @brief Enqueue a task without the overhead of a future
+	 * @return @c false if the pool was already shut down and the task was not queued
+	 * @sa TaskGroup
+	 */
+	bool schedule(Task &&task);
+
+	/**
+	 * @brief Execute one queued task in the calling thread
+	 * @return @c false if there was no task to execute
+	 */
+	bool runPendingTask();
+
 	size_t size() const;
 	void init();
 	/**
@@ -59,27 +83,35 @@ public:
 	 */
 	void abort();
 	void shutdown(bool wait = false);
-
-	void reserve(size_t n);
 private:
+	struct WorkQueue {
+		core_trace_mutex(core::Lock, mutex, "ThreadPoolQueue");
+		std::deque<Task> tasks core_thread_guarded_by(mutex);
+	};
+
 	const size_t _threads;
 	const char *_name;
 	// need to keep track of threads so we can join them
 	core::DynamicArray<std::thread> _workers;
-	// the task queue
-	core::Queue<std::function<void()> > _tasks core_thread_guarded_by(_queueMutex);
-
-	// synchronization
-	core_trace_mutex(core::Lock, _queueMutex, "ThreadPoolQueue");
-	core::ConditionVariable _queueCondition;
+	// one queue per worker - at least one queue
+	core::DynamicArray<WorkQueue *> _queues;
+	// amount of queued tasks over all queues
+	core::AtomicInt _pending { 0 };
+	core::AtomicInt _nextQueue { 0 };
+
+	// synchronization for sleeping workers
+	core_trace_mutex(core::Lock, _sleepMutex, "ThreadPoolSleep");
+	core::ConditionVariable _sleepCondition;
 	core::AtomicBool _stop { false };
 	core::AtomicBool _force { false };
-};
 
-inline void ThreadPool::reserve(size_t n) {
-	core::ScopedLock lock(_queueMutex);
-	_tasks.reserve(n);
-}
+	/**
+	 * @return The queue index of the calling thread if it is a worker of this pool, @c -1 otherwise
+	 */
+	int workerIndex() const;
+	bool popTask(int queueIdx, Task &task);
+	bool stealTask(int startIdx, Task &task);
+};
 
 // add new work item to the pool
 template<class F, class ... Args>
@@ -93,14 +125,9 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
 	core::SharedPtr<std::packaged_task<return_type()> > task = core::make_shared<std::packaged_task<return_type()> >(std::bind(core::forward<F>(f), core::forward<Args>(args)...));
 
 	std::future<return_type> res = task->get_future();
-	{
-		core::ScopedLock lock(_queueMutex);
-		if (_stop) {
-			return std::future<return_type>();
-		}
-		_tasks.emplace([task]() {(*task.get())();});
+	if (!schedule([task]() {(*task.get())();})) {
+		return std::future<return_type>();
 	}
-	_queueCondition.notify_one();
 	return res;
 }
 
@@ -108,4 +135,68 @@ inline size_t ThreadPool::size() const {
 	return _threads;
 }
 
+/**
+ * @brief Wait for a batch of tasks. The waiting thread helps to execute the queued tasks of the pool, so it's safe to
+ * wait for a task group from within a task of the same pool.
+ *
+ * @note The task group must outlive its tasks - the destructor waits for them.
+ */
+class TaskGroup {
+private:
+	ThreadPool &_pool;
+	core::AtomicInt _pending { 0 };
+	// the last finished task wakes up the waiting thread
+	core_trace_mutex(core::Lock, _mutex, "TaskGroup");
+	core::ConditionVariable _condition;
+
+	void finish();
+
+public:
+	explicit TaskGroup(ThreadPool &pool) : _pool(pool) {
+	}
+	~TaskGroup() {
+		wait();
+	}
+
+	template<class F>
+	void run(F &&f) {
+		_pending.increment();
+		ThreadPool::Task task([this, func = core::forward<F>(f)]() mutable {
+			func();
+			finish();
+		});
+		if (!_pool.schedule(core::move(task))) {
+			// the pool is shut down - the task was not consumed
+			task();
+		}
+	}
+
+	void wait();
+};
+
+/**
+ * @brief Split the range [begin, end) into chunks of @c grain elements and execute them in parallel
+ * @param func Called with the start (inclusive) and end (exclusive) index of a chunk
+ * @note The calling thread helps to execute the chunks and returns once all of them are done
+ */
+template<class F>
+void for_parallel(ThreadPool &pool, int begin, int end, int grain, F &&func) {
+	if (end <= begin) {
+		return;
+	}
+	if (grain < 1) {
+		grain = 1;
+	}
+	if (end - begin <= grain) {
+		func(begin, end);
+		return;
+	}
+	TaskGroup group(pool);
+	for (int start = begin; start < end; start += grain) {
+		const int stop = start + grain < end ? start + grain : end;
+		group.run([&func, start, stop]() { func(start, stop); });
+	}
+	group.wait();
+}
+
 }
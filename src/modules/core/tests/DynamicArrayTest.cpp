@@ -138,7 +138,8 @@ TEST(DynamicArrayTest, testErase) {
 		array.push_back(DynamicArrayStruct("", i));
 	}
 	EXPECT_EQ(128u, array.size()) << array;
-	EXPECT_EQ(128u, array.capacity()) << array;
+	// 32, 64, 96, 160 - growing by half of the capacity aligned to 32
+	EXPECT_EQ(160u, array.capacity()) << array;
 	array.erase(0, 10);
 	EXPECT_EQ(118u, array.size()) << array;
 	EXPECT_EQ(10, array[0]._bar) << array;
@@ -361,4 +362,111 @@ TEST(DynamicArrayTest, testInsertIteratorOperatorInt) {
 	EXPECT_EQ(6, other.end() - other.begin());
 }
 
+TEST(DynamicArrayTest, testGeometricGrowth) {
+	DynamicArray<int> array;
+	for (int i = 0; i < 100000; ++i) {
+		array.push_back(i);
+	}
+	// growing by the fixed increase of 32 elements would need 3125 allocations
+	EXPECT_LT(array.allocations(), 40u);
+	EXPECT_GE(array.capacity(), array.size());
+	for (int i = 0; i < 100000; ++i) {
+		ASSERT_EQ(i, array[i]);
+	}
+}
+
+TEST(DynamicArrayTest, testGrowthCap) {
+	DynamicArray<int, 32u, 64u> array;
+	for (int i = 0; i < 10000; ++i) {
+		array.push_back(i);
+	}
+	EXPECT_LE(array.capacity(), array.size() + 64u);
+	EXPECT_GE(array.allocations(), 10000u / 64u);
+}
+
+TEST(DynamicArrayTest, testReserveExact) {
+	DynamicArray<int> array;
+	array.reserve(100);
+	EXPECT_EQ(128u, array.capacity());
+	EXPECT_EQ(1u, array.allocations());
+	for (int i = 0; i < 100; ++i) {
+		array.push_back(i);
+	}
+	EXPECT_EQ(1u, array.allocations());
+	DynamicArray<int> copy(array);
+	EXPECT_EQ(1u, copy.allocations());
+	EXPECT_EQ(128u, copy.capacity());
+}
+
+TEST(DynamicArrayTest, testGrowthNonRelocatable) {
+	static_assert(!is_trivially_relocatable<DynamicArrayStruct>::value, "The struct has a non trivial member");
+	DynamicArray<DynamicArrayStruct> array;
+	for (int i = 0; i < 1000; ++i) {
+		array.emplace_back(core::String::format("%i", i), i);
+	}
+	array.insert(array.begin() + 10, DynamicArrayStruct("inserted", -1));
+	array.erase(0, 5);
+	ASSERT_EQ(996u, array.size());
+	EXPECT_EQ(5, array[0]._bar);
+	EXPECT_EQ(-1, array[5]._bar);
+	EXPECT_EQ("inserted", array[5]._foo);
+	EXPECT_EQ(10, array[6]._bar);
+	EXPECT_EQ("999", array.back()._foo);
+}
+
+TEST(DynamicArrayTest, testEraseInsertRelocatable) {
+	static_assert(is_trivially_relocatable<int>::value, "int must be relocatable");
+	DynamicArray<int> array;
+	for (int i = 0; i < 100; ++i) {
+		array.push_back(i);
+	}
+	const int values[]{-1, -2};
+	array.insert(array.begin() + 50, values, 2);
+	ASSERT_EQ(102u, array.size());
+	EXPECT_EQ(49, array[49]);
+	EXPECT_EQ(-1, array[50]);
+	EXPECT_EQ(-2, array[51]);
+	EXPECT_EQ(50, array[52]);
+	array.erase(50, 2);
+	ASSERT_EQ(100u, array.size());
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(i, array[i]);
+	}
+}
+
+struct DynamicArrayRelocatable {
+	static int dtors;
+	int _value;
+	DynamicArrayRelocatable(int value) : _value(value) {
+	}
+	~DynamicArrayRelocatable() {
+		++dtors;
+	}
+};
+int DynamicArrayRelocatable::dtors = 0;
+
+template<>
+struct is_trivially_relocatable<DynamicArrayRelocatable> : std::true_type {};
+
+TEST(DynamicArrayTest, testEraseRelocatableDestructs) {
+	DynamicArrayRelocatable::dtors = 0;
+	{
+		DynamicArray<DynamicArrayRelocatable> array;
+		for (int i = 0; i < 10; ++i) {
+			array.emplace_back(i);
+		}
+		ASSERT_EQ(0, DynamicArrayRelocatable::dtors);
+		array.erase(3, 2);
+		ASSERT_EQ(8u, array.size());
+		EXPECT_EQ(2, DynamicArrayRelocatable::dtors);
+		EXPECT_EQ(2, array[2]._value);
+		EXPECT_EQ(5, array[3]._value);
+		EXPECT_EQ(9, array.back()._value);
+		array.erase(6, 5);
+		ASSERT_EQ(6u, array.size());
+		EXPECT_EQ(4, DynamicArrayRelocatable::dtors);
+	}
+	EXPECT_EQ(10, DynamicArrayRelocatable::dtors);
+}
+
 }
@@ -0,0 +1,111 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/FlatHashMap.h"
+#include "core/SharedPtr.h"
+#include "core/String.h"
+
+namespace core {
+
+TEST(FlatHashMapTest, testPutGet) {
+	core::FlatHashMap<int64_t, int64_t, std::hash<int64_t>> map;
+	map.put(1, 1);
+	map.put(1, 2);
+	map.put(2, 1);
+	map.put(3, 1337);
+	map.put(4, 42);
+	EXPECT_EQ(4u, map.size());
+	int64_t value;
+	EXPECT_TRUE(map.get(1, value));
+	EXPECT_EQ(2, value);
+	EXPECT_TRUE(map.get(2, value));
+	EXPECT_EQ(1, value);
+	EXPECT_TRUE(map.get(3, value));
+	EXPECT_EQ(1337, value);
+	EXPECT_TRUE(map.get(4, value));
+	EXPECT_EQ(42, value);
+	EXPECT_FALSE(map.get(5, value));
+}
+
+TEST(FlatHashMapTest, testGrow) {
+	core::FlatHashMap<int64_t, int64_t> map;
+	for (int64_t i = 0; i < 100000; ++i) {
+		map.put(i, i * 2);
+	}
+	EXPECT_EQ(100000u, map.size());
+	EXPECT_GE(map.capacity(), map.size());
+	int64_t value = 0;
+	for (int64_t i = 0; i < 100000; ++i) {
+		ASSERT_TRUE(map.get(i, value));
+		ASSERT_EQ(i * 2, value);
+	}
+}
+
+TEST(FlatHashMapTest, testRemove) {
+	core::FlatHashMap<int64_t, int64_t> map;
+	for (int64_t i = 0; i < 1000; ++i) {
+		map.put(i, i);
+	}
+	for (int64_t i = 0; i < 1000; i += 2) {
+		EXPECT_TRUE(map.remove(i));
+	}
+	EXPECT_FALSE(map.remove(0));
+	EXPECT_EQ(500u, map.size());
+	for (int64_t i = 0; i < 1000; ++i) {
+		EXPECT_EQ(i % 2 == 1, map.hasKey(i)) << i;
+	}
+}
+
+TEST(FlatHashMapTest, testIterate) {
+	core::FlatHashMap<int, int> map;
+	int sum = 0;
+	for (int i = 0; i < 100; ++i) {
+		map.put(i, i);
+		sum += i;
+	}
+	int cnt = 0;
+	for (auto *e : map) {
+		EXPECT_EQ(e->key, e->value);
+		sum -= e->value;
+		++cnt;
+	}
+	EXPECT_EQ(100, cnt);
+	EXPECT_EQ(0, sum);
+}
+
+TEST(FlatHashMapTest, testCopyAndMove) {
+	core::FlatHashMap<int, core::String> map;
+	map.put(1, "one");
+	map.put(2, "two");
+	core::FlatHashMap<int, core::String> copy(map);
+	map.put(1, "uno");
+	core::String value;
+	ASSERT_TRUE(copy.get(1, value));
+	EXPECT_EQ("one", value);
+	core::FlatHashMap<int, core::String> moved(core::move(map));
+	EXPECT_TRUE(map.empty());
+	ASSERT_TRUE(moved.get(1, value));
+	EXPECT_EQ("uno", value);
+	moved.clear();
+	EXPECT_TRUE(moved.empty());
+	EXPECT_FALSE(moved.hasKey(2));
+}
+
+TEST(FlatHashMapTest, testSharedPtr) {
+	core::FlatHashMap<int, core::SharedPtr<int>> map;
+	core::SharedPtr<int> ptr = core::make_shared<int>(42);
+	for (int i = 0; i < 64; ++i) {
+		map.put(i, ptr);
+	}
+	EXPECT_EQ(65, (int)*ptr.refCnt());
+	for (int i = 0; i < 32; ++i) {
+		map.remove(i);
+	}
+	EXPECT_EQ(33, (int)*ptr.refCnt());
+	map.clear();
+	EXPECT_EQ(1, (int)*ptr.refCnt());
+}
+
+} // namespace core
@@ -70,6 +70,27 @@ TEST_F(PoolAllocatorTest, testMaxSize) {
 	a.shutdown();
 }
 
+TEST_F(PoolAllocatorTest, testReuseFreedSlots) {
+	IntAllocator a;
+	ASSERT_TRUE(a.init(3)) << "Failed to init the pool allocator";
+	IntAllocator::PointerType first = a.alloc();
+	IntAllocator::PointerType second = a.alloc();
+	ASSERT_NE(nullptr, first);
+	ASSERT_NE(nullptr, second);
+	EXPECT_EQ(first + 1, second) << "Expected to get the slots in order";
+	EXPECT_TRUE(a.free(first));
+	EXPECT_EQ(first, a.alloc()) << "Expected to get the freed slot back";
+	IntAllocator::PointerType third = a.alloc();
+	EXPECT_EQ(second + 1, third);
+	EXPECT_EQ(nullptr, a.alloc()) << "There are more than the allowed slots in the pool";
+	EXPECT_TRUE(a.free(second));
+	EXPECT_EQ(second, a.alloc());
+	EXPECT_TRUE(a.free(first));
+	EXPECT_TRUE(a.free(second));
+	EXPECT_TRUE(a.free(third));
+	a.shutdown();
+}
+
 TEST_F(PoolAllocatorTest, testAllocFree) {
 	IntAllocator a;
 	ASSERT_TRUE(a.init(size)) << "Failed to init the pool allocator";
@@ -42,4 +42,87 @@ TEST_F(ThreadPoolTest, testMultiplePush) {
 	ASSERT_EQ(x, _count) << "Not all threads were executed";
 }
 
+TEST_F(ThreadPoolTest, testTaskGroup) {
+	const int x = 1000;
+	core::ThreadPool pool(4);
+	pool.init();
+	core::TaskGroup group(pool);
+	for (int i = 0; i < x; ++i) {
+		group.run([this] () {
+			++_count;
+		});
+	}
+	group.wait();
+	ASSERT_EQ(x, _count) << "Not all tasks were executed";
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupNested) {
+	// a single worker that waits for tasks of its own pool must not deadlock
+	core::ThreadPool pool(1);
+	pool.init();
+	core::TaskGroup group(pool);
+	for (int i = 0; i < 10; ++i) {
+		group.run([this, &pool] () {
+			core::TaskGroup inner(pool);
+			for (int j = 0; j < 10; ++j) {
+				inner.run([this] () {
+					++_count;
+				});
+			}
+			inner.wait();
+		});
+	}
+	group.wait();
+	ASSERT_EQ(100, _count) << "Not all nested tasks were executed";
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupWaitForRunningTask) {
+	// the task is already executed by the worker - the waiting thread can't help and must block until it's done
+	core::ThreadPool pool(1);
+	pool.init();
+	core::AtomicBool started{false};
+	core::TaskGroup group(pool);
+	group.run([this, &started] () {
+		started = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		++_count;
+	});
+	while (!started) {
+		std::this_thread::yield();
+	}
+	group.wait();
+	ASSERT_EQ(1, _count) << "Wait returned before the task was finished";
+}
+
+TEST_F(ThreadPoolTest, testTaskGroupWithoutWorkers) {
+	core::ThreadPool pool(2);
+	pool.init();
+	pool.shutdown(true);
+	core::TaskGroup group(pool);
+	group.run([this] () {
+		_executed = true;
+	});
+	group.wait();
+	ASSERT_TRUE(_executed) << "Task wasn't executed after the pool was shut down";
+}
+
+TEST_F(ThreadPoolTest, testForParallel) {
+	const int x = 1001;
+	core::ThreadPool pool(3);
+	pool.init();
+	core::DynamicArray<int> visited;
+	visited.resize(x);
+	for (int i = 0; i < x; ++i) {
+		visited[i] = 0;
+	}
+	core::for_parallel(pool, 0, x, 64, [&visited] (int start, int end) {
+		for (int i = start; i < end; ++i) {
+			++visited[i];
+		}
+	});
+	for (int i = 0; i < x; ++i) {
+		ASSERT_EQ(1, visited[i]) << "Index " << i << " was not visited exactly once";
+	}
+}
+
 }
@@ -5,6 +5,7 @@
 #include "FileStream.h"
 #include "core/Assert.h"
 #include "core/Log.h"
+#include "core/StandardLib.h"
 #include "io/File.h"
 #include <SDL_endian.h>
 #include <SDL_rwops.h>
@@ -18,11 +19,13 @@ FileStream::FileStream(const FilePtr &file) : _file(file) {
 		_rwops = _file->_file;
 		if (_rwops) {
 			_size = SDL_RWsize(_rwops);
+			_pos = _filePos = SDL_RWtell(_rwops);
 		}
 	}
 }
 
 FileStream::~FileStream() {
+	core_free(_buffer);
 }
 
 bool FileStream::valid() const {
@@ -33,7 +36,37 @@ bool FileStream::flush() {
 	if (_rwops == nullptr) {
 		return false;
 	}
-	return _file->flush();
+	const bool ret = _file->flush();
+	// the file handle was re-opened
+	_rwops = _file->_file;
+	_filePos = -1;
+	_bufferSize = 0;
+	return ret;
+}
+
+bool FileStream::syncFilePos() {
+	if (_filePos == _pos) {
+		return true;
+	}
+	if (SDL_RWseek(_rwops, _pos, RW_SEEK_SET) == -1) {
+		_filePos = -1;
+		return false;
+	}
+	_filePos = _pos;
+	return true;
+}
+
+int FileStream::readFile(uint8_t *buf, size_t size) {
+	size_t completeBytesRead = 0;
+	while (completeBytesRead < size) {
+		const size_t bytesRead = SDL_RWread(_rwops, buf + completeBytesRead, 1, size - completeBytesRead);
+		if (bytesRead == 0) {
+			break;
+		}
+		completeBytesRead += bytesRead;
+	}
+	_filePos += (int64_t)completeBytesRead;
+	return (int)completeBytesRead;
 }
 
 int FileStream::write(const void *buf, size_t size) {
@@ -44,12 +77,20 @@ int FileStream::write(const void *buf, size_t size) {
 	if (size == 0) {
 		return 0;
 	}
+	// the read-ahead data might get stale
+	_bufferSize = 0;
+	if (!syncFilePos()) {
+		Log::error("Failed to seek to the write position %i", (int)_pos);
+		return -1;
+	}
 	const int64_t written = (int64_t)SDL_RWwrite(_rwops, buf, 1, size);
 	if (written != (int64_t)size) {
 		Log::error("File write error: %s (%i vs %i)", SDL_GetError(), (int)written, (int)size);
+		_filePos = -1;
 		return -1;
 	}
-	_pos = SDL_RWtell(_rwops);
+	_pos += written;
+	_filePos = _pos;
 	_size = core_max(_size, _pos);
 	return (int)written;
 }
@@ -58,17 +99,38 @@ int FileStream::read(void *dataPtr, size_t dataSize) {
 	if (_rwops == nullptr) {
 		return -1;
 	}
-	uint8_t *b = (uint8_t*)dataPtr;
+	uint8_t *b = (uint8_t *)dataPtr;
 	size_t completeBytesRead = 0;
 	while (completeBytesRead < dataSize) {
-		size_t bytesRead = SDL_RWread(_rwops, b, 1, (dataSize - completeBytesRead));
-		b += bytesRead;
-		completeBytesRead += bytesRead;
-		if (bytesRead == 0) {
+		const size_t needed = dataSize - completeBytesRead;
+		if (_pos >= _bufferPos && _pos < _bufferPos + _bufferSize) {
+			const size_t available = (size_t)(_bufferPos + _bufferSize - _pos);
+			const size_t n = core_min(available, needed);
+			core_memcpy(b, _buffer + (_pos - _bufferPos), n);
+			b += n;
+			completeBytesRead += n;
+			_pos += (int64_t)n;
+			continue;
+		}
+		if (!syncFilePos()) {
+			break;
+		}
+		if ((int64_t)needed >= BufferSize) {
+			// large reads bypass the read-ahead buffer
+			const int bytesRead = readFile(b, needed);
+			completeBytesRead += bytesRead;
+			_pos += bytesRead;
+			break;
+		}
+		if (_buffer == nullptr) {
+			_buffer = (uint8_t *)core_malloc(BufferSize);
+		}
+		_bufferPos = _pos;
+		_bufferSize = readFile(_buffer, BufferSize);
+		if (_bufferSize == 0) {
 			break;
 		}
 	}
-	_pos = SDL_RWtell(_rwops);
 	if (completeBytesRead == 0) {
 		return -1;
 	}
@@ -79,11 +141,29 @@ int64_t FileStream::seek(int64_t position, int whence) {
 	if (_rwops == nullptr) {
 		return -1;
 	}
-	int64_t p = SDL_RWseek(_rwops, position, whence);
-	_pos = SDL_RWtell(_rwops);
-	if (p == -1) {
+	int64_t newPos;
+	switch (whence) {
+	case SEEK_SET:
+		newPos = position;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + position;
+		break;
+	case SEEK_END:
+		newPos = _size + position;
+		break;
+	default:
+		return -1;
+	}
+	const FileMode mode = _file->mode();
+	// writing streams may skip data that is written later - reading streams must stay inside the file
+	const bool reading = mode == FileMode::Read || mode == FileMode::SysRead || mode == FileMode::ReadNoHome;
+	if (newPos < 0 || (reading && newPos > _size)) {
+		Log::debug("Invalid seek to %i (size: %i)", (int)newPos, (int)_size);
 		return -1;
 	}
+	// the underlying file handle is only moved on the next access that misses the buffer
+	_pos = newPos;
 	return _pos;
 }
 
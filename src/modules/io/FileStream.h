@@ -19,6 +19,9 @@ typedef core::SharedPtr<File> FilePtr;
 /**
  * @brief File read and write capable stream
  *
+ * Reads are served from an internal read-ahead window of @c BufferSize bytes. The stream position is tracked
+ * internally - the underlying file handle is only repositioned if it is really needed.
+ *
  * @note the stream is not flushed automatically. This is either done by calling flush() manually - or when the
  * used file instance is closed.
  * @ingroup IO
@@ -31,7 +34,25 @@ private:
 	FilePtr _file;
 	int64_t _size = -1;
 	int64_t _pos = 0;
+	/**
+	 * @brief The position of the underlying file handle - @c -1 if unknown
+	 */
+	int64_t _filePos = 0;
+	uint8_t *_buffer = nullptr;
+	/**
+	 * @brief The file offset of the first byte in the read-ahead buffer
+	 */
+	int64_t _bufferPos = 0;
+	/**
+	 * @brief The amount of valid bytes in the read-ahead buffer
+	 */
+	int64_t _bufferSize = 0;
+
+	bool syncFilePos();
+	int readFile(uint8_t *buf, size_t size);
 public:
+	static constexpr int64_t BufferSize = 64 * 1024;
+
 	FileStream(const FilePtr &file);
 	virtual ~FileStream();
 
@@ -8,6 +8,7 @@
 #include "io/File.h"
 #include "io/FileStream.h"
 #include "io/Filesystem.h"
+#include "io/MMapReadStream.h"
 
 namespace io {
 
@@ -51,6 +52,13 @@ SeekableReadStream *FilesystemArchive::readStream(const core::String &filePath)
 		Log::error("Could not open file %s for reading: %s", file->name().c_str(), file->lastError().c_str());
 		return nullptr;
 	}
+	if (file->length() >= MMapThreshold) {
+		io::MMapReadStream *mmapStream = new io::MMapReadStream(file);
+		if (mmapStream->valid()) {
+			return mmapStream;
+		}
+		delete mmapStream;
+	}
 	io::FileStream *stream = new io::FileStream(file);
 	core_assert(stream->valid());
 	return stream;
@@ -21,6 +21,11 @@ protected:
 	bool _sysmode;
 
 public:
+	/**
+	 * @brief Files of at least this size are memory mapped for reading if the platform supports it
+	 */
+	static constexpr long MMapThreshold = 1024 * 1024;
+
 	using Archive::list;
 	FilesystemArchive(const io::FilesystemPtr &filesytem, bool sysmode = true);
 	virtual ~FilesystemArchive();
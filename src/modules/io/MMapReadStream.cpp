@@ -0,0 +1,27 @@
+/**
+ * @file
+ */
+
+#include "MMapReadStream.h"
+#include "io/File.h"
+#include "io/system/System.h"
+
+namespace io {
+
+MMapReadStream::MMapReadStream(const FilePtr &file) : Super(nullptr, 0) {
+	if (!file) {
+		return;
+	}
+	int64_t size = 0;
+	_mapped = fs_mmap(file->name().c_str(), size);
+	if (_mapped != nullptr) {
+		_buf = (const uint8_t *)_mapped;
+		_size = size;
+	}
+}
+
+MMapReadStream::~MMapReadStream() {
+	fs_munmap(_mapped, _size);
+}
+
+} // namespace io
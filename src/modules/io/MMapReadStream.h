@@ -0,0 +1,41 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/SharedPtr.h"
+#include "io/MemoryReadStream.h"
+
+namespace io {
+
+class File;
+typedef core::SharedPtr<File> FilePtr;
+
+/**
+ * @brief Read-only stream that maps the whole file into memory
+ *
+ * Avoids the copies and syscalls of the buffered @c FileStream for large files. Check @c valid() after
+ * construction - the mapping is not supported on every platform.
+ *
+ * @ingroup IO
+ * @see FileStream
+ * @see MemoryReadStream
+ */
+class MMapReadStream : public MemoryReadStream {
+private:
+	using Super = MemoryReadStream;
+	void *_mapped = nullptr;
+
+public:
+	MMapReadStream(const FilePtr &file);
+	virtual ~MMapReadStream();
+
+	bool valid() const;
+};
+
+inline bool MMapReadStream::valid() const {
+	return _mapped != nullptr;
+}
+
+} // namespace io
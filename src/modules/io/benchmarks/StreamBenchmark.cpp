@@ -0,0 +1,124 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ArrayLength.h"
+#include "core/collection/DynamicArray.h"
+#include "io/File.h"
+#include "io/FileStream.h"
+#include "io/MMapReadStream.h"
+#include "io/MemoryReadStream.h"
+
+class StreamBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int FileSize = 8 * 1024 * 1024;
+	const char *_filename = "streambenchmark.bin";
+	io::FilePtr _file;
+	core::DynamicArray<uint8_t> _data;
+	// real files from the test data - the benchmarks take the index as argument
+	static constexpr const char *TestDataFiles[]{"test_material.vox", "aceofspades.vxl"};
+	io::FilePtr _testDataFiles[lengthof(TestDataFiles)];
+
+	template<class STREAM>
+	void readSmallChunks(STREAM &stream) {
+		uint32_t sum = 0u;
+		uint32_t val;
+		while (stream.readUInt32(val) == 0) {
+			sum += val;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_data.resize(FileSize);
+		for (int i = 0; i < FileSize; ++i) {
+			_data[i] = (uint8_t)(i * 31);
+		}
+		const io::FilePtr &file = _benchmarkApp->filesystem()->open(_filename, io::FileMode::SysWrite);
+		io::FileStream stream(file);
+		stream.write(_data.data(), _data.size());
+		file->close();
+		_file = _benchmarkApp->filesystem()->open(_filename, io::FileMode::SysRead);
+		for (int i = 0; i < lengthof(TestDataFiles); ++i) {
+			_testDataFiles[i] = _benchmarkApp->filesystem()->open(TestDataFiles[i]);
+		}
+	}
+
+	const io::FilePtr &testDataFile(benchmark::State &state) {
+		const io::FilePtr &file = _testDataFiles[state.range(0)];
+		if (!file->exists()) {
+			state.SkipWithError("Could not find the test data file");
+		}
+		return file;
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_file = io::FilePtr();
+		for (io::FilePtr &file : _testDataFiles) {
+			file = io::FilePtr();
+		}
+		_benchmarkApp->filesystem()->sysRemoveFile(_filename);
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+BENCHMARK_DEFINE_F(StreamBenchmark, FileStream)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::FileStream stream(_file);
+		stream.seek(0);
+		readSmallChunks(stream);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * FileSize);
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, MMapReadStream)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::MMapReadStream stream(_file);
+		readSmallChunks(stream);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * FileSize);
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, MemoryReadStream)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::MemoryReadStream stream(_data.data(), _data.size());
+		readSmallChunks(stream);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * FileSize);
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, FileStreamTestData)(benchmark::State &state) {
+	const io::FilePtr &file = testDataFile(state);
+	if (state.error_occurred()) {
+		return;
+	}
+	for (auto _ : state) {
+		io::FileStream stream(file);
+		stream.seek(0);
+		readSmallChunks(stream);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * file->length());
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, MMapReadStreamTestData)(benchmark::State &state) {
+	const io::FilePtr &file = testDataFile(state);
+	if (state.error_occurred()) {
+		return;
+	}
+	for (auto _ : state) {
+		io::MMapReadStream stream(file);
+		readSmallChunks(stream);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * file->length());
+}
+
+BENCHMARK_REGISTER_F(StreamBenchmark, FileStream);
+BENCHMARK_REGISTER_F(StreamBenchmark, MMapReadStream);
+BENCHMARK_REGISTER_F(StreamBenchmark, MemoryReadStream);
+BENCHMARK_REGISTER_F(StreamBenchmark, FileStreamTestData)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(StreamBenchmark, MMapReadStreamTestData)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
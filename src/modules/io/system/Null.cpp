@@ -62,6 +62,14 @@ core::String fs_cwd() {
 	return "/";
 }
 
+void *fs_mmap(const char *path, int64_t &size) {
+	size = 0;
+	return nullptr;
+}
+
+void fs_munmap(void *ptr, int64_t size) {
+}
+
 } // namespace io
 
 #endif
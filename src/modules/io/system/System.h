@@ -21,5 +21,12 @@ bool fs_stat(const char *path, FilesystemEntry &entry);
 core::DynamicArray<FilesystemEntry> fs_scandir(const char *path);
 core::String fs_readlink(const char *path);
 core::String fs_cwd();
+/**
+ * @brief Maps the given file read-only into memory
+ * @param[out] size The size of the mapped file
+ * @return @c nullptr if the platform doesn't support memory mapped files or the file could not get mapped
+ */
+void *fs_mmap(const char *path, int64_t &size);
+void fs_munmap(void *ptr, int64_t size);
 
 } // namespace io
@@ -17,6 +17,8 @@
 #include <errno.h>
 #include <pwd.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -332,6 +334,35 @@ bool fs_hidden(const char *path) {
 	return path[0] == '.';
 }
 
+void *fs_mmap(const char *path, int64_t &size) {
+	size = 0;
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1) {
+		Log::debug("Failed to open %s: %s", path, strerror(errno));
+		return nullptr;
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0 || s.st_size <= 0) {
+		::close(fd);
+		return nullptr;
+	}
+	void *ptr = mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps a reference to the file
+	::close(fd);
+	if (ptr == MAP_FAILED) {
+		Log::debug("Failed to mmap %s: %s", path, strerror(errno));
+		return nullptr;
+	}
+	size = (int64_t)s.st_size;
+	return ptr;
+}
+
+void fs_munmap(void *ptr, int64_t size) {
+	if (ptr != nullptr) {
+		munmap(ptr, (size_t)size);
+	}
+}
+
 } // namespace io
 
 #endif
@@ -261,6 +261,44 @@ core::DynamicArray<FilesystemEntry> fs_scandir(const char *path) {
 	return entries;
 }
 
+void *fs_mmap(const char *path, int64_t &size) {
+	size = 0;
+	WCHAR *wpath = io_UTF8ToStringW(path);
+	priv::denormalizePath(wpath);
+	HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	SDL_free(wpath);
+	if (file == INVALID_HANDLE_VALUE) {
+		Log::debug("Failed to open %s", path);
+		return nullptr;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		Log::debug("Failed to create file mapping for %s", path);
+		return nullptr;
+	}
+	void *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// the view keeps a reference to the mapping
+	CloseHandle(mapping);
+	if (ptr == nullptr) {
+		Log::debug("Failed to map %s", path);
+		return nullptr;
+	}
+	size = (int64_t)fileSize.QuadPart;
+	return ptr;
+}
+
+void fs_munmap(void *ptr, int64_t size) {
+	if (ptr != nullptr) {
+		UnmapViewOfFile(ptr);
+	}
+}
+
 #undef io_StringToUTF8W
 #undef io_UTF8ToStringW
 
@@ -4,6 +4,7 @@
 
 #include "io/FileStream.h"
 #include "core/FourCC.h"
+#include "core/collection/DynamicArray.h"
 #include "io/Filesystem.h"
 #include <gtest/gtest.h>
 
@@ -44,6 +45,18 @@ TEST_F(FileStreamTest, testFileStreamReadPastEndOfFile) {
 	EXPECT_EQ(-1, stream.readInt8(val));
 }
 
+TEST_F(FileStreamTest, testFileStreamInvalidSeek) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	FileStream stream(file);
+	const int64_t size = stream.size();
+	EXPECT_EQ(4, stream.seek(4));
+	EXPECT_EQ(-1, stream.seek(size + 1));
+	EXPECT_EQ(-1, stream.seek(1, SEEK_END));
+	EXPECT_EQ(-1, stream.seek(-5, SEEK_CUR));
+	EXPECT_EQ(4, stream.pos());
+	EXPECT_EQ(size, stream.seek(0, SEEK_END));
+}
+
 TEST_F(FileStreamTest, testFileStreamReadLine) {
 	const FilePtr &file = _fs.open("iotest.txt");
 	FileStream stream(file);
@@ -121,4 +134,89 @@ TEST_F(FileStreamTest, testFileStreamWrite) {
 	EXPECT_EQ(8l, file->length());
 }
 
+TEST_F(FileStreamTest, testFileStreamSeekReadAhead) {
+	const int64_t n = FileStream::BufferSize * 2 + 13;
+	{
+		const FilePtr &file = _fs.open("filestream-seektest", io::FileMode::SysWrite);
+		ASSERT_TRUE(file->validHandle());
+		FileStream stream(file);
+		for (int64_t i = 0; i < n; ++i) {
+			ASSERT_TRUE(stream.writeUInt8((uint8_t)(i % 251)));
+		}
+		EXPECT_EQ(n, stream.size());
+	}
+	const FilePtr &file = _fs.open("filestream-seektest", io::FileMode::SysRead);
+	ASSERT_TRUE(file->validHandle());
+	FileStream stream(file);
+	ASSERT_EQ(n, stream.size());
+	uint8_t val;
+	const int64_t offsets[] = {0, 1, FileStream::BufferSize - 1, FileStream::BufferSize, 5, FileStream::BufferSize + 3, n - 1};
+	for (int64_t offset : offsets) {
+		EXPECT_EQ(offset, stream.seek(offset));
+		EXPECT_EQ(0, stream.readUInt8(val));
+		EXPECT_EQ((uint8_t)(offset % 251), val) << "at offset " << offset;
+		EXPECT_EQ(offset + 1, stream.pos());
+	}
+	EXPECT_EQ(-1, stream.readUInt8(val));
+
+	// a read that is larger than the read-ahead buffer and spans already buffered data
+	EXPECT_EQ(10, stream.seek(10));
+	EXPECT_EQ(0, stream.readUInt8(val));
+	core::DynamicArray<uint8_t> buf;
+	buf.resize(FileStream::BufferSize + 100);
+	EXPECT_EQ((int)buf.size(), stream.read(buf.data(), buf.size()));
+	for (size_t i = 0; i < buf.size(); ++i) {
+		ASSERT_EQ((uint8_t)((i + 11) % 251), buf[i]) << "at index " << i;
+	}
+	EXPECT_EQ(11 + (int64_t)buf.size(), stream.pos());
+}
+
+TEST_F(FileStreamTest, testFileStreamWriteAfterRead) {
+	const FilePtr &file = _fs.open("filestream-readwritetest", io::FileMode::SysWrite);
+	ASSERT_TRUE(file->validHandle());
+	FileStream stream(file);
+	EXPECT_TRUE(stream.writeUInt32(1));
+	EXPECT_TRUE(stream.writeUInt32(2));
+	EXPECT_EQ(4, stream.seek(-4, SEEK_CUR));
+	EXPECT_TRUE(stream.writeUInt32(3));
+	EXPECT_EQ(8, stream.pos());
+	EXPECT_EQ(8, stream.size());
+	file->close();
+	file->open(io::FileMode::Read);
+	FileStream readStream(file);
+	uint32_t val;
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(1u, val);
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(3u, val);
+}
+
+TEST_F(FileStreamTest, testFileStreamWriteSeekPastEnd) {
+	const FilePtr &file = _fs.open("filestream-writeseektest", io::FileMode::SysWrite);
+	ASSERT_TRUE(file->validHandle());
+	FileStream stream(file);
+	EXPECT_TRUE(stream.writeUInt32(1));
+	// skip data that is filled later
+	EXPECT_EQ(12, stream.seek(8, SEEK_CUR));
+	EXPECT_TRUE(stream.writeUInt32(3));
+	EXPECT_EQ(16, stream.size());
+	EXPECT_EQ(4, stream.seek(4));
+	EXPECT_TRUE(stream.writeUInt32(2));
+	EXPECT_EQ(-1, stream.seek(-1));
+	file->close();
+	file->open(io::FileMode::Read);
+	FileStream readStream(file);
+	ASSERT_EQ(16, readStream.size());
+	uint32_t val;
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(1u, val);
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(2u, val);
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(0u, val);
+	EXPECT_EQ(0, readStream.readUInt32(val));
+	EXPECT_EQ(3u, val);
+	EXPECT_EQ(-1, readStream.seek(17));
+}
+
 } // namespace io
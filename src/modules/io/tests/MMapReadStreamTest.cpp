@@ -0,0 +1,71 @@
+/**
+ * @file
+ */
+
+#include "io/MMapReadStream.h"
+#include "core/FourCC.h"
+#include "io/FileStream.h"
+#include "io/Filesystem.h"
+#include <gtest/gtest.h>
+
+namespace io {
+
+class MMapReadStreamTest : public testing::Test {
+protected:
+	io::Filesystem _fs;
+
+public:
+	void SetUp() override {
+		_fs.init("test", "test");
+	}
+
+	void TearDown() override {
+		_fs.shutdown();
+	}
+};
+
+TEST_F(MMapReadStreamTest, testInvalidFile) {
+	const FilePtr file;
+	MMapReadStream stream(file);
+	EXPECT_FALSE(stream.valid());
+	EXPECT_TRUE(stream.empty());
+	EXPECT_TRUE(stream.eos());
+}
+
+TEST_F(MMapReadStreamTest, testRead) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	ASSERT_TRUE(file->exists());
+	MMapReadStream stream(file);
+	if (!stream.valid()) {
+		GTEST_SKIP() << "Memory mapped files are not supported on this platform";
+	}
+	EXPECT_EQ((int64_t)file->length(), stream.size());
+	uint32_t magic;
+	EXPECT_EQ(0, stream.peekUInt32(magic));
+	EXPECT_EQ(FourCC('W', 'i', 'n', 'd'), magic);
+	core::String line;
+	EXPECT_TRUE(stream.readLine(line));
+	EXPECT_EQ("WindowInfo", line);
+}
+
+TEST_F(MMapReadStreamTest, testSameContentAsFileStream) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	ASSERT_TRUE(file->exists());
+	MMapReadStream mmapStream(file);
+	if (!mmapStream.valid()) {
+		GTEST_SKIP() << "Memory mapped files are not supported on this platform";
+	}
+	FileStream fileStream(file);
+	ASSERT_EQ(fileStream.size(), mmapStream.size());
+	EXPECT_EQ(7, mmapStream.seek(7));
+	EXPECT_EQ(7, fileStream.seek(7));
+	uint8_t a, b;
+	while (!fileStream.eos()) {
+		ASSERT_EQ(0, fileStream.readUInt8(a));
+		ASSERT_EQ(0, mmapStream.readUInt8(b));
+		ASSERT_EQ(a, b);
+	}
+	EXPECT_TRUE(mmapStream.eos());
+}
+
+} // namespace io
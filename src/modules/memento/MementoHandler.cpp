@@ -11,6 +11,7 @@
 #include "core/ScopedPtr.h"
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "io/BufferedReadWriteStream.h"
 #include "io/MemoryReadStream.h"
 #include "io/ZipReadStream.h"
@@ -125,8 +126,9 @@ MementoState::MementoState(MementoType _type, const core::DynamicArray<core::Str
 	: type(_type), stringList(_stringList) {
 }
 
-MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
+MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region,
+						 const voxel::Region &volumeRegion)
+	: _compressedSize(bufSize), _region(region), _volumeRegion(volumeRegion) {
 	if (buf != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = buf;
@@ -135,8 +137,9 @@ MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &regi
 	}
 }
 
-MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
+MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region,
+						 const voxel::Region &volumeRegion)
+	: _compressedSize(bufSize), _region(region), _volumeRegion(volumeRegion) {
 	if (buf != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t *)core_malloc(_compressedSize);
@@ -147,7 +150,7 @@ MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region
 }
 
 MementoData::MementoData(MementoData &&o) noexcept
-	: _compressedSize(o._compressedSize), _buffer(o._buffer), _region(o._region) {
+	: _compressedSize(o._compressedSize), _buffer(o._buffer), _region(o._region), _volumeRegion(o._volumeRegion) {
 	o._compressedSize = 0;
 	o._buffer = nullptr;
 }
@@ -159,7 +162,8 @@ MementoData::~MementoData() {
 	}
 }
 
-MementoData::MementoData(const MementoData &o) : _compressedSize(o._compressedSize), _region(o._region) {
+MementoData::MementoData(const MementoData &o)
+	: _compressedSize(o._compressedSize), _region(o._region), _volumeRegion(o._volumeRegion) {
 	if (o._buffer != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t *)core_malloc(_compressedSize);
@@ -179,6 +183,7 @@ MementoData &MementoData::operator=(MementoData &&o) noexcept {
 		_buffer = o._buffer;
 		o._buffer = nullptr;
 		_region = o._region;
+		_volumeRegion = o._volumeRegion;
 	}
 	return *this;
 }
@@ -198,6 +203,7 @@ MementoData &MementoData::operator=(const MementoData &o) noexcept {
 			core_assert(_compressedSize == 0);
 		}
 		_region = o._region;
+		_volumeRegion = o._volumeRegion;
 	}
 	return *this;
 }
@@ -206,26 +212,40 @@ MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel:
 	if (volume == nullptr) {
 		return MementoData();
 	}
+	const voxel::Region &volumeRegion = volume->region();
 	voxel::Region mementoRegion = region;
-	// TODO: MEMENTO: see issue https://github.com/vengi-voxel/vengi/issues/200
-	// const bool partialMemento = mementoRegion.isValid();
-	const bool partialMemento = false;
-	if (!partialMemento) {
-		mementoRegion = volume->region();
+	if (!mementoRegion.isValid() || !mementoRegion.cropTo(volumeRegion)) {
+		mementoRegion = volumeRegion;
 	}
+	const bool partialMemento = mementoRegion != volumeRegion;
 
-	const int allVoxels = volume->region().voxels();
-	io::BufferedReadWriteStream outStream(allVoxels * sizeof(voxel::Voxel));
+	const int voxels = mementoRegion.voxels();
+	io::BufferedReadWriteStream outStream(voxels * sizeof(voxel::Voxel));
 	io::ZipWriteStream stream(outStream);
 	if (partialMemento) {
-		voxel::RawVolume v(volume, region);
-		stream.write(v.data(), allVoxels * sizeof(voxel::Voxel));
+		voxel::RawVolume v(*volume, mementoRegion);
+		stream.write(v.data(), voxels * sizeof(voxel::Voxel));
 	} else {
-		stream.write(volume->data(), allVoxels * sizeof(voxel::Voxel));
+		stream.write(volume->data(), voxels * sizeof(voxel::Voxel));
 	}
 	stream.flush();
 	const size_t size = (size_t)outStream.size();
-	return {outStream.release(), size, mementoRegion};
+	return {outStream.release(), size, mementoRegion, volumeRegion};
+}
+
+voxel::RawVolume *MementoData::uncompressVolume() const {
+	if (_buffer == nullptr) {
+		return nullptr;
+	}
+	const size_t uncompressedBufferSize = _region.voxels() * sizeof(voxel::Voxel);
+	io::MemoryReadStream dataStream(_buffer, _compressedSize);
+	io::ZipReadStream stream(dataStream, (int)dataStream.size());
+	uint8_t *uncompressedBuf = (uint8_t *)core_malloc(uncompressedBufferSize);
+	if (stream.read(uncompressedBuf, uncompressedBufferSize) == -1) {
+		core_free(uncompressedBuf);
+		return nullptr;
+	}
+	return voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, _region);
 }
 
 bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoData) {
@@ -236,16 +256,10 @@ bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoD
 	if (volume == nullptr) {
 		return false;
 	}
-	const size_t uncompressedBufferSize = mementoData.region().voxels() * sizeof(voxel::Voxel);
-	io::MemoryReadStream dataStream(mementoData._buffer, mementoData._compressedSize);
-	io::ZipReadStream stream(dataStream, (int)dataStream.size());
-	uint8_t *uncompressedBuf = (uint8_t *)core_malloc(uncompressedBufferSize);
-	if (stream.read(uncompressedBuf, uncompressedBufferSize) == -1) {
-		core_free(uncompressedBuf);
+	core::ScopedPtr<voxel::RawVolume> v(mementoData.uncompressVolume());
+	if (!v) {
 		return false;
 	}
-	core::ScopedPtr<voxel::RawVolume> v(
-		voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, mementoData.region()));
 	voxelutil::copyIntoRegion(*v, *volume, mementoData.region());
 	return true;
 }
@@ -282,7 +296,7 @@ void MementoHandler::beginGroup(const core::String &name) {
 	if (_groupState <= 0) {
 		cutFromGroupStatePosition();
 		_groups.emplace_back(MementoStateGroup{name, {}});
-		_groupStatePosition = stateSize() - 1;
+		_groupStatePosition = (int)stateSize() - 1;
 	}
 	++_groupState;
 }
@@ -329,6 +343,7 @@ void MementoHandler::printState(const MementoState &state) const {
 	const glm::ivec3 &mins = state.dataRegion().getLowerCorner();
 	const glm::ivec3 &maxs = state.dataRegion().getUpperCorner();
 	Log::info(" - region: mins(%i:%i:%i)/maxs(%i:%i:%i)", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
+	Log::info(" - volume region: %s", state.volumeRegion().toString().c_str());
 	Log::info(" - size: %ib", (int)state.data.size());
 	Log::info(" - palette: %s", palHash.c_str());
 	Log::info(" - normalPalette: %s", normalPalHash.c_str());
@@ -363,6 +378,7 @@ void MementoHandler::printState(const MementoState &state) const {
 
 void MementoHandler::print() const {
 	Log::info("Current memento state index: %i", _groupStatePosition);
+	Log::info("Memory usage: %i/%i bytes", (int)memoryUsage(), (int)_maxMemory);
 
 	for (const MementoStateGroup &group : _groups) {
 		Log::info("Group: %s", group.name.c_str());
@@ -379,10 +395,10 @@ void MementoHandler::construct() {
 void MementoHandler::clearStates() {
 	core_assert_msg(_groupState <= 0, "You should not clear the states while you are recording a group state");
 	_groups.clear();
-	_groupStatePosition = 0u;
+	_groupStatePosition = 0;
 }
 
-void MementoHandler::undoModification(MementoState &s) {
+bool MementoHandler::undoModification(MementoState &s) {
 	core_assert(s.hasVolumeData());
 	for (int i = _groupStatePosition; i >= 0; --i) {
 		const MementoStateGroup &group = _groups[i];
@@ -392,19 +408,33 @@ void MementoHandler::undoModification(MementoState &s) {
 			}
 			if (prevS.type == MementoType::Modification || prevS.type == MementoType::SceneNodeAdded) {
 				core_assert(prevS.hasVolumeData() || !prevS.referenceUUID.empty());
-				s.data = prevS.data;
 				// undo for un-reference node - so we have to make it a reference node again
 				if (s.nodeType != prevS.nodeType) {
 					core_assert(prevS.nodeType == scenegraph::SceneGraphNodeType::ModelReference);
 					s.nodeType = prevS.nodeType;
 					s.referenceUUID = prevS.referenceUUID;
 				}
-				return;
+				if (!prevS.hasVolumeData()) {
+					s.data = prevS.data;
+					return true;
+				}
+				core::DynamicArray<const MementoState *> chain;
+				if (!collectVolumeStates(_groupStatePosition, -1, s.nodeUUID, chain) || chain.empty()) {
+					Log::error("No full volume state found for node %s", s.nodeUUID.c_str());
+					return false;
+				}
+				// if the volume was resized, the whole previous volume must be restored
+				const voxel::Region &prevVolumeRegion = chain.front()->volumeRegion();
+				const voxel::Region &region =
+					prevVolumeRegion == s.volumeRegion() ? s.dataRegion() : prevVolumeRegion;
+				s.data = restoreVolumeData(chain, prevVolumeRegion, region);
+				return true;
 			}
 		}
 	}
 
 	Log::warn("No previous modification state found for node %s", s.nodeUUID.c_str());
+	return true;
 }
 
 void MementoHandler::undoPaletteChange(MementoState &s) {
@@ -511,7 +541,11 @@ MementoStateGroup MementoHandler::undo() {
 	for (MementoState &s : group.states) {
 		Log::debug("Undo memento type %s", typeToString(s.type));
 		if (s.type == MementoType::Modification) {
-			undoModification(s);
+			if (!undoModification(s)) {
+				// the volume can't get restored - stay at the current state
+				++_groupStatePosition;
+				return InvalidMementoGroup;
+			}
 		} else if (s.type == MementoType::SceneNodePaletteChanged) {
 			undoPaletteChange(s);
 		} else if (s.type == MementoType::SceneNodeNormalPaletteChanged) {
@@ -685,7 +719,7 @@ bool MementoHandler::markUndoPreamble() {
 		// every other state that follows the new one (everything after
 		// the current state position)
 		const size_t n = _groups.size() - (_groupStatePosition + 1);
-		_groups.erase_back(n);
+		_groups.erase(_groups.size() - n, n);
 	}
 	return true;
 }
@@ -694,10 +728,10 @@ bool MementoHandler::removeLast() {
 	if (_groups.empty()) {
 		return false;
 	}
-	if (_groupStatePosition == stateSize() - 1) {
+	if (_groupStatePosition == (int)stateSize() - 1) {
 		--_groupStatePosition;
 	}
-	_groups.erase_back(1);
+	_groups.erase(_groups.size() - 1);
 	return true;
 }
 
@@ -727,23 +761,164 @@ bool MementoHandler::markUndo(const core::String &parentId, const core::String &
 		!recordVolumeStates(volume)) {
 		volume = nullptr;
 	}
-	const MementoData &data = MementoData::fromVolume(volume, modifiedRegion);
+	voxel::Region region = voxel::Region::InvalidRegion;
+	if (volume != nullptr && type == MementoType::Modification) {
+		// only store the modified region if the remaining voxels can get restored from a previous state
+		const MementoState *prevState = lastVolumeState(nodeId);
+		if (prevState != nullptr && prevState->volumeRegion() == volume->region()) {
+			region = modifiedRegion;
+		}
+	}
+	const MementoData &data = MementoData::fromVolume(volume, region);
 	MementoState state(type, data, parentId, nodeId, referenceId, name, nodeType, pivot, allKeyFrames, palette,
 					   normalPalette, properties);
 	addState(core::move(state));
 	return true;
 }
 
+const MementoState *MementoHandler::lastVolumeState(const core::String &nodeUUID) const {
+	for (int i = (int)_groups.size() - 1; i >= 0; --i) {
+		const MementoStateGroup &group = _groups[i];
+		for (int j = (int)group.states.size() - 1; j >= 0; --j) {
+			const MementoState &state = group.states[j];
+			if (state.nodeUUID != nodeUUID || !state.hasVolumeData()) {
+				continue;
+			}
+			if (state.type == MementoType::Modification || state.type == MementoType::SceneNodeAdded) {
+				return &state;
+			}
+		}
+	}
+	return nullptr;
+}
+
+bool MementoHandler::collectVolumeStates(int groupIdx, int stateIdx, const core::String &nodeUUID,
+										 core::DynamicArray<const MementoState *> &chain) const {
+	for (int i = groupIdx; i >= 0; --i) {
+		const MementoStateGroup &group = _groups[i];
+		const int start = (i == groupIdx && stateIdx >= 0) ? stateIdx : (int)group.states.size() - 1;
+		for (int j = start; j >= 0; --j) {
+			const MementoState &state = group.states[j];
+			if (state.nodeUUID != nodeUUID || !state.hasVolumeData()) {
+				continue;
+			}
+			if (state.type != MementoType::Modification && state.type != MementoType::SceneNodeAdded) {
+				continue;
+			}
+			chain.push_back(&state);
+			if (!state.data.isPartial()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+MementoData MementoHandler::restoreVolumeData(const core::DynamicArray<const MementoState *> &chain,
+											  const voxel::Region &volumeRegion, const voxel::Region &region) const {
+	core_trace_scoped(RestoreVolumeData);
+	voxel::Region restoreRegion = region;
+	if (!restoreRegion.cropTo(volumeRegion)) {
+		restoreRegion = volumeRegion;
+	}
+	voxel::RawVolume volume(restoreRegion);
+	// apply the states from the oldest to the newest
+	for (int i = (int)chain.size() - 1; i >= 0; --i) {
+		const MementoData &data = chain[i]->data;
+		voxel::Region intersection = data.region();
+		if (!intersection.cropTo(restoreRegion)) {
+			continue;
+		}
+		core::ScopedPtr<voxel::RawVolume> v(data.uncompressVolume());
+		if (!v) {
+			Log::error("Failed to uncompress the memento data");
+			continue;
+		}
+		voxelutil::copy(*v, intersection, volume, intersection);
+	}
+	MementoData data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion);
+	data._volumeRegion = volumeRegion;
+	return data;
+}
+
+void MementoHandler::removeFirst() {
+	core_trace_scoped(MementoRemoveFirst);
+	const MementoStateGroup &first = _groups.front();
+	for (const MementoState &state : first.states) {
+		if (!state.hasVolumeData()) {
+			continue;
+		}
+		// find the next volume state of the node - if it's a partial state, it depends on the states that are
+		// going to get removed
+		for (int i = 1; i < (int)_groups.size(); ++i) {
+			MementoStateGroup &group = _groups[i];
+			int stateIdx = -1;
+			for (int j = 0; j < (int)group.states.size(); ++j) {
+				const MementoState &nextState = group.states[j];
+				if (nextState.nodeUUID != state.nodeUUID || !nextState.hasVolumeData()) {
+					continue;
+				}
+				if (nextState.type == MementoType::Modification || nextState.type == MementoType::SceneNodeAdded) {
+					stateIdx = j;
+					break;
+				}
+			}
+			if (stateIdx == -1) {
+				continue;
+			}
+			MementoState &nextState = group.states[stateIdx];
+			if (nextState.data.isPartial()) {
+				core::DynamicArray<const MementoState *> chain;
+				collectVolumeStates(i, stateIdx, nextState.nodeUUID, chain);
+				const voxel::Region volumeRegion = nextState.volumeRegion();
+				nextState.data = restoreVolumeData(chain, volumeRegion, volumeRegion);
+			}
+			break;
+		}
+	}
+	_groups.erase(0);
+	--_groupStatePosition;
+}
+
+void MementoHandler::enforceMaxMemory() {
+	// the current state is never removed
+	while (_groupStatePosition > 0 && memoryUsage() > _maxMemory) {
+		Log::debug("Memento memory budget of %i bytes exceeded - remove the oldest state", (int)_maxMemory);
+		removeFirst();
+	}
+}
+
+size_t MementoHandler::memoryUsage() const {
+	size_t bytes = _groups.bytes();
+	for (const MementoStateGroup &group : _groups) {
+		bytes += group.states.bytes();
+		for (const MementoState &state : group.states) {
+			bytes += state.data.size();
+		}
+	}
+	return bytes;
+}
+
+void MementoHandler::setMaxMemory(size_t bytes) {
+	_maxMemory = bytes;
+	enforceMaxMemory();
+}
+
+size_t MementoHandler::maxMemory() const {
+	return _maxMemory;
+}
+
 void MementoHandler::cutFromGroupStatePosition() {
-	const int cutOff = core_max(0, (int)(stateSize() - _groupStatePosition - 1));
+	const int cutOff = core_max(0, (int)stateSize() - _groupStatePosition - 1);
 	Log::debug("Cut off %i states", cutOff);
-	_groups.erase_back(cutOff);
+	_groups.erase(stateSize() - cutOff, cutOff);
 }
 
 void MementoHandler::addState(MementoState &&state) {
 	if (_groupState > 0) {
 		Log::debug("add group state: %i", _groupState);
 		_groups.back().states.emplace_back(state);
+		enforceMaxMemory();
 		return;
 	}
 	MementoStateGroup group;
@@ -751,7 +926,8 @@ void MementoHandler::addState(MementoState &&state) {
 	group.states.emplace_back(state);
 	cutFromGroupStatePosition();
 	_groups.emplace_back(core::move(group));
-	_groupStatePosition = stateSize() - 1;
+	_groupStatePosition = (int)stateSize() - 1;
+	enforceMaxMemory();
 }
 
 void MementoHandler::setMaxUndoRegion(const voxel::Region &region) {
@@ -7,7 +7,7 @@
 #include "core/IComponent.h"
 #include "core/Optional.h"
 #include "core/String.h"
-#include "core/collection/RingBuffer.h"
+#include "core/collection/DynamicArray.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraph.h"
@@ -45,7 +45,8 @@ enum class MementoType {
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * The given buffer is owned by this class and represents a compressed volume. This is either the whole volume or only
+ * the part of the volume that was modified (see @c isPartial()).
  */
 class MementoData {
 	friend struct MementoState;
@@ -64,9 +65,19 @@ private:
 	 * The region the given volume data is for
 	 */
 	voxel::Region _region{};
+	/**
+	 * The region of the whole volume at the time the data was recorded - this is the same as @c _region if the whole
+	 * volume is included in the data
+	 */
+	voxel::Region _volumeRegion{};
 
-	MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region);
-	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region);
+	MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region, const voxel::Region &volumeRegion);
+	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region, const voxel::Region &volumeRegion);
+
+	/**
+	 * @return A new volume with the uncompressed voxels of the data region or @c nullptr on error
+	 */
+	voxel::RawVolume *uncompressVolume() const;
 
 public:
 	MementoData() {
@@ -86,6 +97,17 @@ public:
 		return _region;
 	}
 
+	inline const voxel::Region &volumeRegion() const {
+		return _volumeRegion;
+	}
+
+	/**
+	 * @return @c true if only a part of the volume is stored in this data
+	 */
+	inline bool isPartial() const {
+		return _region != _volumeRegion;
+	}
+
 	inline bool hasVolume() const {
 		return _buffer != nullptr;
 	}
@@ -99,7 +121,7 @@ public:
 	 * @brief Converts the given volume into a @c MementoData structure (and perform the compression)
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 * @param[in] region The region of the volume to create the memento data for - if this is not a valid region,
-	 * the whole volume is going to added to the memento data.
+	 * the whole volume is going to added to the memento data. The region is cropped to the volume region.
 	 */
 	static MementoData fromVolume(const voxel::RawVolume *volume, const voxel::Region &region);
 };
@@ -154,6 +176,10 @@ struct MementoState {
 	inline const voxel::Region &dataRegion() const {
 		return data._region;
 	}
+
+	inline const voxel::Region &volumeRegion() const {
+		return data._volumeRegion;
+	}
 };
 
 struct MementoStateGroup {
@@ -161,22 +187,53 @@ struct MementoStateGroup {
 	core::DynamicArray<MementoState> states;
 };
 
-using MementoStates = core::RingBuffer<MementoStateGroup, 64u>;
+using MementoStates = core::DynamicArray<MementoStateGroup>;
 /**
  * @brief Class that manages the undo and redo steps for the scene
  *
- * @note For the volumes only the dirty regions are stored in a compressed form.
+ * @note For the volumes only the dirty regions are stored in a compressed form. The full volume is only stored for
+ * the initial state of a node and if the volume was resized. The voxels outside of the dirty region are restored
+ * from the previous states of the node on undo.
+ * @note The oldest states are removed if the memory budget (see @c setMaxMemory()) is exceeded.
  */
 class MementoHandler : public core::IComponent {
 private:
 	MementoStates _groups;
 	int _groupState = 0;
-	uint8_t _groupStatePosition = 0u;
+	int _groupStatePosition = 0;
 	int _locked = 0;
+	size_t _maxMemory = 256u * 1024u * 1024u;
 	voxel::Region _maxUndoRegion = voxel::Region::InvalidRegion;
 
 	void cutFromGroupStatePosition();
 	void addState(MementoState &&state);
+	/**
+	 * @brief Removes the oldest group - the following partial volume states are converted into full volume states
+	 * if they depend on the removed states
+	 */
+	void removeFirst();
+	/**
+	 * @brief Removes the oldest groups until the memory budget is no longer exceeded
+	 */
+	void enforceMaxMemory();
+	/**
+	 * @return The last state with volume data of the given node or @c nullptr if there is none
+	 */
+	const MementoState *lastVolumeState(const core::String &nodeUUID) const;
+	/**
+	 * @brief Collects the states with volume data of the given node - starting at the given state index of the group
+	 * and walking backwards until a state with the full volume was found.
+	 * @param[in] stateIdx The state index in the given group to start at - @c -1 for the last state of the group
+	 * @param[out] chain The states - newest first
+	 * @return @c false if no state with the full volume was found
+	 */
+	bool collectVolumeStates(int groupIdx, int stateIdx, const core::String &nodeUUID,
+							 core::DynamicArray<const MementoState *> &chain) const;
+	/**
+	 * @brief Assembles the voxels of the given region from the collected states (see @c collectVolumeStates())
+	 */
+	MementoData restoreVolumeData(const core::DynamicArray<const MementoState *> &chain,
+								  const voxel::Region &volumeRegion, const voxel::Region &region) const;
 	/**
 	 * @return @c true if it's allowed to create an undo state
 	 */
@@ -195,7 +252,10 @@ private:
 	void undoNodeProperties(MementoState &s);
 	void undoKeyFrames(MementoState &s);
 	void undoAnimations(MementoState &s);
-	void undoModification(MementoState &s);
+	/**
+	 * @return @c false if the previous volume state can't get restored
+	 */
+	bool undoModification(MementoState &s);
 
 protected:
 	/**
@@ -222,6 +282,16 @@ public:
 	bool init() override;
 	void shutdown() override;
 
+	/**
+	 * @brief The memory budget in bytes for all recorded states
+	 */
+	void setMaxMemory(size_t bytes);
+	size_t maxMemory() const;
+	/**
+	 * @return The (approximated) amount of memory in bytes that is used by all recorded states
+	 */
+	size_t memoryUsage() const;
+
 	/**
 	 * @brief Allow to set the max region to record volume states for
 	 */
@@ -280,7 +350,7 @@ public:
 	const MementoStates &states() const;
 
 	size_t stateSize() const;
-	uint8_t statePosition() const;
+	int statePosition() const;
 };
 
 class ScopedMementoGroup {
@@ -335,7 +405,7 @@ inline const MementoStates &MementoHandler::states() const {
 	return _groups;
 }
 
-inline uint8_t MementoHandler::statePosition() const {
+inline int MementoHandler::statePosition() const {
 	return _groupStatePosition;
 }
 
@@ -360,7 +430,7 @@ inline bool MementoHandler::canRedo() const {
 	if (stateSize() <= 1) {
 		return false;
 	}
-	return _groupStatePosition <= stateSize() - 2;
+	return _groupStatePosition <= (int)stateSize() - 2;
 }
 
 } // namespace memento
@@ -777,4 +777,98 @@ TEST_F(MementoHandlerTest, testAllAnimations) {
 	_sceneGraph.setAnimations(*stateRedo.stringList.value());
 }
 
+TEST_F(MementoHandlerTest, testPartialModification) {
+	voxel::RawVolume volume(voxel::Region(0, 9));
+	volume.setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::SceneNodeAdded));
+	volume.setVoxel(5, 5, 5, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, voxel::Region(5, 5)));
+	volume.setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	volume.setVoxel(5, 5, 5, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, voxel::Region(0, 5)));
+
+	const MementoStateGroup &group = _mementoHandler.stateGroup();
+	ASSERT_EQ(1u, group.states.size());
+	EXPECT_TRUE(group.states[0].data.isPartial());
+	EXPECT_EQ(voxel::Region(0, 5), group.states[0].dataRegion());
+	EXPECT_EQ(volume.region(), group.states[0].volumeRegion());
+
+	// the voxels of the undo region are assembled from the initial state and the first modification
+	MementoState state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(voxel::Region(0, 5), state.dataRegion());
+	EXPECT_EQ(volume.region(), state.volumeRegion());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_EQ(1, volume.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(2, volume.voxel(5, 5, 5).getColor());
+
+	state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(voxel::Region(5, 5), state.dataRegion());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_TRUE(voxel::isAir(volume.voxel(5, 5, 5).getMaterial()));
+
+	state = firstState(_mementoHandler.redo());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_EQ(2, volume.voxel(5, 5, 5).getColor());
+}
+
+TEST_F(MementoHandlerTest, testPartialModificationResize) {
+	voxel::RawVolume volume(voxel::Region(0, 3));
+	volume.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::SceneNodeAdded));
+	voxel::RawVolume resized(voxel::Region(0, 7));
+	resized.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	resized.setVoxel(6, 6, 6, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &resized,
+										 MementoType::Modification, voxel::Region(6, 6)));
+	EXPECT_FALSE(_mementoHandler.stateGroup().states[0].data.isPartial())
+		<< "A resized volume must be recorded completely";
+	resized.setVoxel(2, 2, 2, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &resized,
+										 MementoType::Modification, voxel::Region(2, 2)));
+	EXPECT_TRUE(_mementoHandler.stateGroup().states[0].data.isPartial());
+
+	MementoState state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(voxel::Region(2, 2), state.dataRegion());
+	EXPECT_EQ(resized.region(), state.volumeRegion());
+
+	// undo the resize - the whole previous volume is restored
+	state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(volume.region(), state.dataRegion());
+	EXPECT_EQ(volume.region(), state.volumeRegion());
+	voxel::RawVolume restored(state.volumeRegion());
+	ASSERT_TRUE(MementoData::toVolume(&restored, state.data));
+	EXPECT_EQ(1, restored.voxel(1, 1, 1).getColor());
+}
+
+TEST_F(MementoHandlerTest, testMaxMemory) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::SceneNodeAdded));
+	for (int i = 0; i < 4; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 1, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+											 MementoType::Modification, voxel::Region(i, i)));
+	}
+	EXPECT_EQ(5, (int)_mementoHandler.stateSize());
+
+	// a budget that can't be fulfilled removes everything but the current state - the partial state that is left
+	// is converted into a full state
+	_mementoHandler.setMaxMemory(1u);
+	ASSERT_EQ(1, (int)_mementoHandler.stateSize());
+	EXPECT_EQ(0, _mementoHandler.statePosition());
+	EXPECT_FALSE(_mementoHandler.canUndo());
+
+	const MementoState &state = firstState(_mementoHandler.stateGroup());
+	EXPECT_FALSE(state.data.isPartial());
+	voxel::RawVolume restored(state.volumeRegion());
+	ASSERT_TRUE(MementoData::toVolume(&restored, state.data));
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(i + 1, restored.voxel(i, i, i).getColor());
+	}
+}
+
 } // namespace memento
@@ -400,6 +400,12 @@ int Palette::getClosestMatch(core::RGBA rgba, int skipPaletteColorIdx) const {
 	return minIndex;
 }
 
+void Palette::createRemapTable(const Palette &target, PaletteIndicesArray &table) const {
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		table[i] = (uint8_t)target.getClosestMatch(color(i));
+	}
+}
+
 uint8_t Palette::findReplacement(uint8_t paletteColorIdx) const {
 	if (size() == 0) {
 		return paletteColorIdx;
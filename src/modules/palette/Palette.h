@@ -263,6 +263,12 @@ public:
 	 */
 	int getClosestMatch(core::RGBA rgba, int skipPaletteColorIdx = -1) const;
 	uint8_t findReplacement(uint8_t paletteColorIdx) const;
+	/**
+	 * @brief Fill a lookup table that maps every color index of this palette to the closest color index of the
+	 * given target palette.
+	 * @note This avoids to search the closest match for every voxel when converting volumes between palettes
+	 */
+	void createRemapTable(const Palette &target, PaletteIndicesArray &table) const;
 	/**
 	 * @brief Will add the given color to the palette - and if the max colors are reached it will try
 	 * to match the color to another already existing color in the palette.
@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#include "PaletteColorGrid.h"
+#include "core/Color.h"
+
+namespace palette {
+
+namespace {
+
+/**
+ * @brief Lower and upper bound of the distance between the given palette color and any color inside the cell. This
+ * mirrors the integer math of the approximation in @c core::Color::getDistance()
+ */
+void distanceBounds(core::RGBA c, int r0, int g0, int b0, int &lower, int &upper) {
+	const int r1 = r0 + PaletteColorGrid::CellSize - 1;
+	const int g1 = g0 + PaletteColorGrid::CellSize - 1;
+	const int b1 = b0 + PaletteColorGrid::CellSize - 1;
+	auto axisRange = [](int v, int lo, int hi, int &dmin, int &dmax) {
+		dmin = v < lo ? lo - v : (v > hi ? v - hi : 0);
+		dmax = core_max(v - lo < 0 ? lo - v : v - lo, hi - v < 0 ? v - hi : hi - v);
+	};
+	int drMin, drMax, dgMin, dgMax, dbMin, dbMax;
+	axisRange(c.r, r0, r1, drMin, drMax);
+	axisRange(c.g, g0, g1, dgMin, dgMax);
+	axisRange(c.b, b0, b1, dbMin, dbMax);
+	const int rmeanMin = (c.r + r0) / 2;
+	const int rmeanMax = (c.r + r1) / 2;
+	lower = (((512 + rmeanMin) * drMin * drMin) >> 8) + 4 * dgMin * dgMin + (((767 - rmeanMax) * dbMin * dbMin) >> 8);
+	upper = (((512 + rmeanMax) * drMax * drMax) >> 8) + 4 * dgMax * dgMax + (((767 - rmeanMin) * dbMax * dbMax) >> 8);
+}
+
+} // namespace
+
+void PaletteColorGrid::build(const Palette &palette) {
+	_colorCount = palette.colorCount();
+	_firstTransparent = PaletteColorNotFound;
+	_cellOffsets.clear();
+	_candidates.clear();
+	if (palette.size() == 0) {
+		_colorCount = 0;
+		return;
+	}
+	for (int i = 0; i < _colorCount; ++i) {
+		_colors[i] = palette.color(i);
+		if (_colors[i].a == 0 && _firstTransparent == PaletteColorNotFound) {
+			_firstTransparent = i;
+		}
+	}
+
+	constexpr int cells = CellsPerAxis * CellsPerAxis * CellsPerAxis;
+	_cellOffsets.reserve(cells + 1);
+	int lower[PaletteMaxColors];
+	for (int cell = 0; cell < cells; ++cell) {
+		const int r0 = ((cell >> (CellBits * 2)) & (CellsPerAxis - 1)) * CellSize;
+		const int g0 = ((cell >> CellBits) & (CellsPerAxis - 1)) * CellSize;
+		const int b0 = (cell & (CellsPerAxis - 1)) * CellSize;
+		int minUpper = INT32_MAX;
+		for (int i = 0; i < _colorCount; ++i) {
+			if (_colors[i].a == 0) {
+				continue;
+			}
+			int upper;
+			distanceBounds(_colors[i], r0, g0, b0, lower[i], upper);
+			minUpper = core_min(minUpper, upper);
+		}
+		_cellOffsets.push_back((uint32_t)_candidates.size());
+		for (int i = 0; i < _colorCount; ++i) {
+			if (_colors[i].a == 0) {
+				continue;
+			}
+			// every color that could be at least as close as the best guaranteed distance is a candidate
+			if (lower[i] <= minUpper) {
+				_candidates.push_back((uint8_t)i);
+			}
+		}
+	}
+	_cellOffsets.push_back((uint32_t)_candidates.size());
+}
+
+int PaletteColorGrid::getClosestMatch(core::RGBA rgba) const {
+	if (_colorCount <= 0) {
+		return PaletteColorNotFound;
+	}
+	if (rgba.a == 0) {
+		for (int i = 0; i < _colorCount; ++i) {
+			if (_colors[i] == rgba) {
+				return i;
+			}
+		}
+		return _firstTransparent;
+	}
+
+	const int cell = cellIndex(rgba);
+	const uint32_t start = _cellOffsets[cell];
+	const uint32_t end = _cellOffsets[cell + 1];
+	float minDistance = FLT_MAX;
+	int minIndex = PaletteColorNotFound;
+	// all exact matches and all colors with the minimal distance are candidates of the cell - and the candidates are
+	// sorted by their index. This gives the same result as the linear search.
+	for (uint32_t n = start; n < end; ++n) {
+		const int i = _candidates[n];
+		if (_colors[i] == rgba) {
+			return i;
+		}
+		const float val = core::Color::getDistance(_colors[i], rgba, core::Color::Distance::Approximation);
+		if (val < minDistance) {
+			minDistance = val;
+			minIndex = i;
+		}
+	}
+	return minIndex;
+}
+
+} // namespace palette
@@ -0,0 +1,58 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/RGBA.h"
+#include "core/collection/DynamicArray.h"
+#include "palette/Palette.h"
+
+namespace palette {
+
+/**
+ * @brief Accelerates the nearest color search of @c Palette::getClosestMatch()
+ *
+ * The rgb space is split into cells. For each cell the palette colors that can be the closest match for any color
+ * inside the cell are pre-computed with conservative distance bounds of the @c core::Color::Distance::Approximation
+ * metric. A lookup only has to check the candidates of one cell and returns exactly the same index as the linear
+ * search.
+ */
+class PaletteColorGrid {
+public:
+	static constexpr int CellBits = 4;
+	static constexpr int CellsPerAxis = 1 << CellBits;
+	static constexpr int CellSize = 256 / CellsPerAxis;
+
+private:
+	core::RGBA _colors[PaletteMaxColors];
+	int _colorCount = 0;
+	int _firstTransparent = PaletteColorNotFound;
+	/**
+	 * @brief Start offset of the candidates of a cell in @c _candidates - one more entry than cells
+	 */
+	core::DynamicArray<uint32_t> _cellOffsets;
+	/**
+	 * @brief The palette indices of the candidates, sorted by index for each cell
+	 */
+	core::DynamicArray<uint8_t> _candidates;
+
+	static inline int cellIndex(core::RGBA rgba) {
+		return ((rgba.r >> (8 - CellBits)) << (CellBits * 2)) | ((rgba.g >> (8 - CellBits)) << CellBits) |
+			   (rgba.b >> (8 - CellBits));
+	}
+
+public:
+	void build(const Palette &palette);
+
+	inline bool valid() const {
+		return _colorCount > 0;
+	}
+
+	/**
+	 * @return The same as @c Palette::getClosestMatch() for the palette that was given to @c build()
+	 */
+	int getClosestMatch(core::RGBA rgba) const;
+};
+
+} // namespace palette
@@ -0,0 +1,30 @@
+/**
+ * @file
+ */
+
+#include "PaletteLookup.h"
+
+namespace palette {
+
+int PaletteLookup::findClosestMatch(core::RGBA rgba) {
+	if (_grid.valid() && (_gridHash != _palette.hash() || _gridColorCount != _palette.colorCount())) {
+		// the palette was modified - the cached results are no longer valid
+		_paletteMap.clear();
+		_grid = PaletteColorGrid();
+		_misses = 0;
+	}
+	if (!_grid.valid()) {
+		if (++_misses <= GridMissThreshold) {
+			return _palette.getClosestMatch(rgba);
+		}
+		_grid.build(_palette);
+		_gridHash = _palette.hash();
+		_gridColorCount = _palette.colorCount();
+		if (!_grid.valid()) {
+			return _palette.getClosestMatch(rgba);
+		}
+	}
+	return _grid.getClosestMatch(rgba);
+}
+
+} // namespace palette
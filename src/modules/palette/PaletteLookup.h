@@ -7,6 +7,7 @@
 #include "core/Color.h"
 #include "core/collection/Map.h"
 #include "palette/Palette.h"
+#include "palette/PaletteColorGrid.h"
 
 namespace palette {
 
@@ -14,6 +15,17 @@ class PaletteLookup {
 private:
 	palette::Palette _palette;
 	core::Map<core::RGBA, uint8_t, 521> _paletteMap;
+	/**
+	 * @brief Building the grid costs about as much as a few thousand linear searches - so it's only built after
+	 * @c GridMissThreshold cache misses and rebuilt if the palette was modified in the meantime
+	 */
+	static constexpr int GridMissThreshold = 4096;
+	PaletteColorGrid _grid;
+	uint64_t _gridHash = 0;
+	int _gridColorCount = 0;
+	int _misses = 0;
+
+	int findClosestMatch(core::RGBA rgba);
 public:
 	PaletteLookup(const palette::Palette &palette, int maxSize = 32768) : _palette(palette), _paletteMap(maxSize) {
 		if (_palette.colorCount() <= 0) {
@@ -48,7 +60,7 @@ public:
 	uint8_t findClosestIndex(core::RGBA rgba) {
 		uint8_t paletteIndex = 0;
 		if (!_paletteMap.get(rgba, paletteIndex)) {
-			paletteIndex = _palette.getClosestMatch(rgba);
+			paletteIndex = findClosestMatch(rgba);
 			if (_paletteMap.size() < _paletteMap.capacity()) {
 				_paletteMap.put(rgba, paletteIndex);
 			}
@@ -57,4 +69,4 @@ public:
 	}
 };
 
-} // namespace voxel
+} // namespace palette
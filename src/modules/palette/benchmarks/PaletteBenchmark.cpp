@@ -0,0 +1,61 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "palette/Palette.h"
+#include "palette/PaletteColorGrid.h"
+
+class PaletteBenchmark : public app::AbstractBenchmark {
+protected:
+	palette::Palette _palette;
+
+	template<class FUNC>
+	void closestMatch(FUNC &&func) {
+		int sum = 0;
+		for (int r = 0; r < 256; r += 4) {
+			for (int g = 0; g < 256; g += 4) {
+				for (int b = 0; b < 256; b += 4) {
+					sum += func(core::RGBA((uint8_t)r, (uint8_t)g, (uint8_t)b, 255));
+				}
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_palette.nippon();
+	}
+};
+
+BENCHMARK_DEFINE_F(PaletteBenchmark, GetClosestMatch)(benchmark::State &state) {
+	for (auto _ : state) {
+		closestMatch([this](core::RGBA rgba) { return _palette.getClosestMatch(rgba); });
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * 64 * 64 * 64);
+}
+
+BENCHMARK_DEFINE_F(PaletteBenchmark, ColorGridClosestMatch)(benchmark::State &state) {
+	palette::PaletteColorGrid grid;
+	grid.build(_palette);
+	for (auto _ : state) {
+		closestMatch([&grid](core::RGBA rgba) { return grid.getClosestMatch(rgba); });
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * 64 * 64 * 64);
+}
+
+BENCHMARK_DEFINE_F(PaletteBenchmark, ColorGridBuild)(benchmark::State &state) {
+	for (auto _ : state) {
+		palette::PaletteColorGrid grid;
+		grid.build(_palette);
+		benchmark::DoNotOptimize(grid);
+	}
+}
+
+BENCHMARK_REGISTER_F(PaletteBenchmark, GetClosestMatch);
+BENCHMARK_REGISTER_F(PaletteBenchmark, ColorGridClosestMatch);
+BENCHMARK_REGISTER_F(PaletteBenchmark, ColorGridBuild);
+
+BENCHMARK_MAIN();
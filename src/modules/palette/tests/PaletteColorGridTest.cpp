@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "palette/PaletteColorGrid.h"
+#include "app/tests/AbstractTest.h"
+#include "palette/PaletteLookup.h"
+
+namespace palette {
+
+class PaletteColorGridTest : public app::AbstractTest {
+protected:
+	void verify(const Palette &palette) {
+		PaletteColorGrid grid;
+		grid.build(palette);
+		ASSERT_TRUE(grid.valid());
+		for (int r = 0; r < 256; r += 7) {
+			for (int g = 0; g < 256; g += 7) {
+				for (int b = 0; b < 256; b += 7) {
+					const core::RGBA rgba((uint8_t)r, (uint8_t)g, (uint8_t)b, 255);
+					ASSERT_EQ(palette.getClosestMatch(rgba), grid.getClosestMatch(rgba))
+						<< "Mismatch for " << (int)rgba.r << ":" << (int)rgba.g << ":" << (int)rgba.b;
+				}
+			}
+		}
+		for (int i = 0; i < palette.colorCount(); ++i) {
+			const core::RGBA rgba = palette.color(i);
+			EXPECT_EQ(palette.getClosestMatch(rgba), grid.getClosestMatch(rgba));
+		}
+		const core::RGBA transparent(10, 20, 30, 0);
+		EXPECT_EQ(palette.getClosestMatch(transparent), grid.getClosestMatch(transparent));
+	}
+};
+
+TEST_F(PaletteColorGridTest, testBuiltIn) {
+	Palette palette;
+	ASSERT_TRUE(palette.nippon());
+	verify(palette);
+	ASSERT_TRUE(palette.minecraft());
+	verify(palette);
+	ASSERT_TRUE(palette.magicaVoxel());
+	verify(palette);
+	ASSERT_TRUE(palette.quake1());
+	verify(palette);
+}
+
+TEST_F(PaletteColorGridTest, testDuplicatesAndAlpha) {
+	Palette palette;
+	palette.setSize(PaletteMaxColors);
+	uint32_t seed = 1337u;
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		// only a few distinct values to get a lot of equal distances and duplicated colors
+		const uint8_t r = (uint8_t)(((seed >> 8) & 7) * 36);
+		const uint8_t g = (uint8_t)(((seed >> 12) & 7) * 36);
+		const uint8_t b = (uint8_t)(((seed >> 16) & 7) * 36);
+		const uint8_t a = (i % 17) == 0 ? 0 : (uint8_t)(128 + (i % 2) * 127);
+		palette.setColor(i, core::RGBA(r, g, b, a));
+	}
+	verify(palette);
+}
+
+TEST_F(PaletteColorGridTest, testLookupPaletteModified) {
+	PaletteLookup lookup;
+	// enough cache misses to switch to the grid
+	for (int i = 0; i < 8192; ++i) {
+		const core::RGBA rgba((uint8_t)(i & 255), (uint8_t)(i >> 8), 200, 255);
+		ASSERT_EQ(lookup.palette().getClosestMatch(rgba), lookup.findClosestIndex(rgba));
+	}
+	const core::RGBA rgba(1, 2, 3, 255);
+	lookup.palette().setColor(7, rgba);
+	EXPECT_EQ(7, lookup.findClosestIndex(core::RGBA(2, 2, 3, 255)));
+}
+
+} // namespace palette
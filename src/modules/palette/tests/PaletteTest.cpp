@@ -156,6 +156,18 @@ TEST_F(PaletteTest, testGetClosestMatch) {
 	}
 }
 
+TEST_F(PaletteTest, testCreateRemapTable) {
+	Palette source;
+	source.nippon();
+	Palette target;
+	target.magicaVoxel();
+	PaletteIndicesArray table;
+	source.createRemapTable(target, table);
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		EXPECT_EQ((uint8_t)target.getClosestMatch(source.color(i)), table[i]) << "Unexpected remap for index " << i;
+	}
+}
+
 TEST_F(PaletteTest, testAddColorsNoDup) {
 	Palette pal;
 	const uint32_t colors[] = {
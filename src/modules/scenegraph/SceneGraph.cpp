@@ -3,12 +3,16 @@
  */
 
 #include "SceneGraph.h"
+#include "app/App.h"
 #include "core/Algorithm.h"
+#include "core/ArrayLength.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraphAnimation.h"
 #include "scenegraph/SceneGraphKeyFrame.h"
@@ -83,6 +87,7 @@ SceneGraph::SceneGraph(SceneGraph &&other) noexcept
 	other._nextNodeId = 0;
 	other._activeNodeId = InvalidNodeId;
 	_dirty = other.dirty();
+	other.resetFrameTransformCache();
 }
 
 SceneGraph &SceneGraph::operator=(SceneGraph &&other) noexcept {
@@ -96,6 +101,8 @@ SceneGraph &SceneGraph::operator=(SceneGraph &&other) noexcept {
 		_activeAnimation = core::move(other._activeAnimation);
 		_cachedMaxFrame = other._cachedMaxFrame;
 		_dirty = other.dirty();
+		resetFrameTransformCache();
+		other.resetFrameTransformCache();
 	}
 	return *this;
 }
@@ -242,6 +249,20 @@ const core::String &SceneGraph::activeAnimation() const {
 
 void SceneGraph::markMaxFramesDirty() {
 	_cachedMaxFrame = -1;
+	markKeyFramesDirty();
+}
+
+void SceneGraph::markKeyFramesDirty() const {
+	++_keyFramesRevision;
+}
+
+void SceneGraph::resetFrameTransformCache() {
+	_evalOrder.clear();
+	_evalOrderRevision = 0;
+	for (FrameTransformCache &cache : _frameTransformCache) {
+		cache.revision = 0;
+		cache.transforms.clear();
+	}
 }
 
 FrameIndex SceneGraph::maxFrames() const {
@@ -295,19 +316,15 @@ const core::String &SceneGraph::uuid(int nodeId) const {
 }
 
 SceneGraphNode &SceneGraph::node(int nodeId) const {
-	auto iter = _nodes.find(nodeId);
-	if (iter == _nodes.end()) {
-		Log::error("No node for id %i found in the scene graph - returning root node", nodeId);
-		return _nodes.find(0)->value;
+	if (SceneGraphNode *n = _nodes.get(nodeId)) {
+		return *n;
 	}
-	return iter->value;
+	Log::error("No node for id %i found in the scene graph - returning root node", nodeId);
+	return *_nodes.get(0);
 }
 
 bool SceneGraph::hasNode(int nodeId) const {
-	if (nodeId == InvalidNodeId) {
-		return false;
-	}
-	return _nodes.find(nodeId) != _nodes.end();
+	return _nodes.hasKey(nodeId);
 }
 
 const SceneGraphNode &SceneGraph::root() const {
@@ -383,6 +400,56 @@ FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, FrameIn
 	return transformForFrame(node, _activeAnimation, frameIdx);
 }
 
+glm::mat4 SceneGraph::localMatrixForFrame(const SceneGraphKeyFrames &keyFrames, FrameIndex frameIdx) {
+	const int n = (int)keyFrames.size();
+	if (n == 0) {
+		return glm::mat4(1.0f);
+	}
+	if (n == 1) {
+		return keyFrames[0].transform().localMatrix();
+	}
+	// this assumes that the key frames are sorted by their frame
+	KeyFrameIndex start = 0;
+	KeyFrameIndex end = InvalidKeyFrame;
+	for (int i = 0; i < n; ++i) {
+		const SceneGraphKeyFrame &kf = keyFrames[i];
+		if (kf.frameIdx == frameIdx) {
+			return kf.transform().localMatrix();
+		}
+		if (kf.frameIdx < frameIdx) {
+			start = i;
+		} else {
+			end = i;
+			break;
+		}
+	}
+	if (end == InvalidKeyFrame || start == end) {
+		return keyFrames[start].transform().localMatrix();
+	}
+	const SceneGraphKeyFrame &source = keyFrames[start];
+	const SceneGraphKeyFrame &target = keyFrames[end];
+	const InterpolationType interpolationType = source.interpolation;
+	const double deltaFrame = scenegraph::interpolate(interpolationType, (double)frameIdx, (double)source.frameIdx, (double)target.frameIdx);
+	const float lerpFactor = glm::clamp((float)(deltaFrame - (double)source.frameIdx), 0.0f, 1.0f);
+
+	const glm::vec3 translation = glm::mix(source.transform().localTranslation(), target.transform().localTranslation(), lerpFactor);
+	const glm::quat orientation = glm::slerp(source.transform().localOrientation(), target.transform().localOrientation(), lerpFactor);
+	const glm::vec3 scale = glm::mix(source.transform().localScale(), target.transform().localScale(), lerpFactor);
+	return glm::translate(translation) * glm::mat4_cast(orientation) * glm::scale(scale);
+}
+
+const SceneGraphKeyFrames &SceneGraph::animationKeyFrames(const SceneGraphNode &node, const core::String &animation,
+														  bool activeAnimation) const {
+	if (activeAnimation) {
+		return node.keyFrames();
+	}
+	auto iter = node.allKeyFrames().find(animation);
+	if (iter == node.allKeyFrames().end()) {
+		return node.keyFrames();
+	}
+	return iter->value;
+}
+
 FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, const core::String &animation,
 											 FrameIndex frameIdx) const {
 	// TODO: SCENEGRAPH: ik solver https://github.com/vengi-voxel/vengi/issues/182
@@ -397,34 +464,68 @@ FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, const c
 	}
 
 	FrameTransform transform;
-	KeyFrameIndex keyFrameIdx = InvalidKeyFrame;
-	if (node.keyFrames().size() == 1) {
-		const SceneGraphKeyFrame *kf = node.keyFrame(0);
-		transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
-	} else if (node.hasKeyFrameForFrame(frameIdx, &keyFrameIdx)) {
-		const SceneGraphKeyFrame *kf = node.keyFrame(keyFrameIdx);
-		transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
-	} else {
-		const KeyFrameIndex start = node.previousKeyFrameForFrame(frameIdx);
-		const KeyFrameIndex end = node.nextKeyFrameForFrame(frameIdx);
-		if (start == end) {
-			const SceneGraphKeyFrame *kf = node.keyFrame(start);
-			transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
+	const SceneGraphKeyFrames &keyFrames = animationKeyFrames(node, animation, animation == _activeAnimation);
+	transform.matrix = parentTransform.matrix * localMatrixForFrame(keyFrames, frameIdx);
+	return transform;
+}
+
+const FrameTransforms &SceneGraph::transformsForFrame(FrameIndex frameIdx) const {
+	return transformsForFrame(_activeAnimation, frameIdx);
+}
+
+const FrameTransforms &SceneGraph::transformsForFrame(const core::String &animation, FrameIndex frameIdx) const {
+	core_trace_scoped(TransformsForFrame);
+	const int revision = _keyFramesRevision;
+	if (_evalOrderRevision != revision) {
+		_evalOrder.clear();
+		_evalOrder.reserve(_nodes.size());
+		if (hasNode(0)) {
+			_evalOrder.push_back(0);
+		}
+		// breadth first - every parent is evaluated before its children
+		for (size_t i = 0; i < _evalOrder.size(); ++i) {
+			const SceneGraphNode &n = node(_evalOrder[i]);
+			for (int childId : n.children()) {
+				_evalOrder.push_back(childId);
+			}
+		}
+		_evalOrderRevision = revision;
+	}
+
+	// the node revisions only grow as long as the hierarchy doesn't change
+	uint32_t nodesRevision = 0u;
+	for (int nodeId : _evalOrder) {
+		nodesRevision += node(nodeId).keyFramesRevision();
+	}
+	for (const FrameTransformCache &cache : _frameTransformCache) {
+		if (cache.revision == revision && cache.nodesRevision == nodesRevision && cache.frameIdx == frameIdx &&
+			cache.animation == animation) {
+			return cache.transforms;
+		}
+	}
+
+	FrameTransformCache &cache = _frameTransformCache[_frameTransformCacheNext];
+	_frameTransformCacheNext = (_frameTransformCacheNext + 1) % (int)lengthof(_frameTransformCache);
+	cache.animation = animation;
+	cache.frameIdx = frameIdx;
+	cache.revision = revision;
+	cache.nodesRevision = nodesRevision;
+	cache.transforms.resize(_nextNodeId);
+	for (FrameTransform &transform : cache.transforms) {
+		transform.matrix = glm::mat4(1.0f);
+	}
+
+	const bool activeAnimation = animation == _activeAnimation;
+	for (int nodeId : _evalOrder) {
+		const SceneGraphNode &n = node(nodeId);
+		const glm::mat4 &localMatrix = localMatrixForFrame(animationKeyFrames(n, animation, activeAnimation), frameIdx);
+		if (n.parent() == InvalidNodeId) {
+			cache.transforms[nodeId].matrix = localMatrix;
 		} else {
-			const SceneGraphKeyFrame *source = node.keyFrame(start);
-			const SceneGraphKeyFrame *target = node.keyFrame(end);
-			core_assert_always(source && target);
-			const InterpolationType interpolationType = source->interpolation;
-			const double deltaFrame = scenegraph::interpolate(interpolationType, (double)frameIdx, (double)source->frameIdx, (double)target->frameIdx);
-			const float lerpFactor = glm::clamp((float)(deltaFrame - (double)source->frameIdx), 0.0f, 1.0f);
-
-			const glm::vec3 translation = glm::mix(source->transform().localTranslation(), target->transform().localTranslation(), lerpFactor);
-			const glm::quat orientation = glm::slerp(source->transform().localOrientation(), target->transform().localOrientation(), lerpFactor);
-			const glm::vec3 scale = glm::mix(source->transform().localScale(), target->transform().localScale(), lerpFactor);
-			transform.matrix = parentTransform.matrix * (glm::translate(translation) * glm::mat4_cast(orientation) * glm::scale(scale));
+			cache.transforms[nodeId].matrix = cache.transforms[n.parent()].matrix * localMatrix;
 		}
 	}
-	return transform;
+	return cache.transforms;
 }
 
 void SceneGraph::updateTransforms_r(SceneGraphNode &n) {
@@ -666,6 +767,7 @@ bool SceneGraph::changeParent(int nodeId, int newParentId, bool updateTransform)
 		return false;
 	}
 	n.setParent(newParentId);
+	markKeyFramesDirty();
 	if (updateTransform) {
 		for (const core::String &animation : animations()) {
 			for (SceneGraphKeyFrame &keyframe : n.keyFrames(animation)) {
@@ -718,6 +820,7 @@ bool SceneGraph::removeNode(int nodeId, bool recursive) {
 		listener->onNodeRemove(nodeId);
 	}
 	core_assert_always(_nodes.erase(iter));
+	markKeyFramesDirty();
 	if (_activeNodeId == nodeId) {
 		if (!empty(SceneGraphNodeType::Model)) {
 			// get the first model node
@@ -745,30 +848,23 @@ void SceneGraph::setAllKeyFramesForNode(SceneGraphNode &node, const SceneGraphKe
 }
 
 void SceneGraph::reserve(size_t size) {
+	_nodes.reserve((int)size);
 }
 
 bool SceneGraph::empty(SceneGraphNodeType type) const {
-	for (const auto &entry : _nodes) {
-		if (entry->value.type() == type) {
-			return false;
-		}
-	}
-	return true;
+	return begin(type) == end();
 }
 
 size_t SceneGraph::size(SceneGraphNodeType type) const {
 	if (type == SceneGraphNodeType::All) {
 		return _nodes.size();
 	}
+	if (type == SceneGraphNodeType::AllModels) {
+		return _nodes.ids(SceneGraphNodeType::Model).size();
+	}
 	size_t n = 0;
-	for (const auto &entry : _nodes) {
-		if (entry->value.type() == type) {
-			++n;
-		} else if (type == SceneGraphNodeType::AllModels) {
-			if (entry->value.isAnyModelNode()) {
-				++n;
-			}
-		}
+	for (auto iter = begin(type); iter != end(); ++iter) {
+		++n;
 	}
 	return n;
 }
@@ -925,6 +1021,34 @@ voxel::RawVolume *SceneGraph::resolveVolume(SceneGraphNode &n) {
 	return n.volume();
 }
 
+/**
+ * @brief Copy the voxels of a rotated volume into the destination volume. The destination voxels are mapped back into
+ * the source volume to not produce holes.
+ */
+static void mergeRotatedVolume(voxel::RawVolume *destination, const voxel::RawVolume *source,
+							   const voxel::Region &sourceRegion, const voxel::Region &destRegion,
+							   const glm::mat4 &sceneMatrix, const palette::PaletteIndicesArray &remap) {
+	core_trace_scoped(MergeRotatedVolume);
+	const glm::mat4 &inverse = glm::inverse(sceneMatrix);
+	for (int32_t z = destRegion.getLowerZ(); z <= destRegion.getUpperZ(); ++z) {
+		for (int32_t y = destRegion.getLowerY(); y <= destRegion.getUpperY(); ++y) {
+			for (int32_t x = destRegion.getLowerX(); x <= destRegion.getUpperX(); ++x) {
+				const glm::vec4 center((float)x + 0.5f, (float)y + 0.5f, (float)z + 0.5f, 1.0f);
+				const glm::ivec3 pos(glm::floor(glm::vec3(inverse * center)));
+				if (!sourceRegion.containsPoint(pos)) {
+					continue;
+				}
+				voxel::Voxel voxel = source->voxel(pos);
+				if (isAir(voxel.getMaterial())) {
+					continue;
+				}
+				voxel.setColor(remap[voxel.getColor()]);
+				destination->setVoxel(x, y, z, voxel);
+			}
+		}
+	}
+}
+
 SceneGraph::MergeResult SceneGraph::merge(bool skipHidden) const {
 	const size_t n = size(SceneGraphNodeType::AllModels);
 	if (n == 0) {
@@ -943,7 +1067,17 @@ SceneGraph::MergeResult SceneGraph::merge(bool skipHidden) const {
 	const palette::Palette &mergedPalette = mergePalettes(true);
 	const palette::NormalPalette &normalPalette = firstModelNode()->normalPalette();
 
-	voxel::RawVolume *merged = new voxel::RawVolume(mergedRegion);
+	struct MergeNode {
+		const voxel::RawVolume *volume;
+		voxel::Region sourceRegion;
+		voxel::Region destRegion;
+		// only set for rotated nodes
+		glm::mat4 sceneMatrix{1.0f};
+		bool rotated;
+		palette::PaletteIndicesArray remap;
+	};
+	core::DynamicArray<MergeNode> mergeNodes;
+	mergeNodes.reserve(n);
 	for (const auto &e : nodes()) {
 		const SceneGraphNode &node = e->second;
 		if (!node.isAnyModelNode()) {
@@ -952,21 +1086,65 @@ SceneGraph::MergeResult SceneGraph::merge(bool skipHidden) const {
 		if (skipHidden && !node.visible()) {
 			continue;
 		}
-		const voxel::Region &sourceRegion = resolveRegion(node);
-		const voxel::Region &destRegion = sceneRegion(node, keyFrameIdx);
+		mergeNodes.emplace_back();
+		MergeNode &mergeNode = mergeNodes.back();
+		mergeNode.volume = resolveVolume(node);
+		mergeNode.sourceRegion = resolveRegion(node);
+		mergeNode.destRegion = sceneRegion(node, keyFrameIdx);
+		mergeNode.rotated = node.isRotated(keyFrameIdx);
+		if (mergeNode.rotated) {
+			mergeNode.sceneMatrix = node.sceneMatrix(mergeNode.sourceRegion, node.pivot(), keyFrameIdx);
+		}
+		// map the palette indices once per node instead of searching the closest color for every voxel
+		node.palette().createRemapTable(mergedPalette, mergeNode.remap);
+	}
 
-		auto func = [&node, &mergedPalette](voxel::Voxel &voxel) {
+	voxel::RawVolume *merged = new voxel::RawVolume(mergedRegion);
+	auto mergeNodeFunc = [merged](const MergeNode &mergeNode) {
+		if (mergeNode.rotated) {
+			mergeRotatedVolume(merged, mergeNode.volume, mergeNode.sourceRegion, mergeNode.destRegion,
+							   mergeNode.sceneMatrix, mergeNode.remap);
+			return;
+		}
+		const palette::PaletteIndicesArray &remap = mergeNode.remap;
+		auto func = [&remap](voxel::Voxel &voxel) {
 			if (isAir(voxel.getMaterial())) {
 				return false;
 			}
-			const core::RGBA color = node.palette().color(voxel.getColor());
-			const uint8_t index = mergedPalette.getClosestMatch(color);
-			voxel.setColor(index);
+			voxel.setColor(remap[voxel.getColor()]);
 			return true;
 		};
-		const voxel::RawVolume *v = resolveVolume(node);
-		// TODO: SCENEGRAPH: rotation
-		voxelutil::mergeVolumes(merged, v, destRegion, sourceRegion, func);
+		voxelutil::mergeVolumes(merged, mergeNode.volume, mergeNode.destRegion, mergeNode.sourceRegion, func);
+	};
+
+	// nodes that don't overlap are merged in parallel - overlapping nodes must keep their order because later nodes
+	// overwrite the voxels of earlier nodes
+	size_t batchStart = 0;
+	while (batchStart < mergeNodes.size()) {
+		size_t batchEnd = batchStart + 1;
+		for (; batchEnd < mergeNodes.size(); ++batchEnd) {
+			bool overlaps = false;
+			for (size_t i = batchStart; i < batchEnd; ++i) {
+				if (voxel::intersects(mergeNodes[i].destRegion, mergeNodes[batchEnd].destRegion)) {
+					overlaps = true;
+					break;
+				}
+			}
+			if (overlaps) {
+				break;
+			}
+		}
+		if (batchEnd - batchStart == 1) {
+			mergeNodeFunc(mergeNodes[batchStart]);
+		} else {
+			core::TaskGroup group(app::App::getInstance()->threadPool());
+			for (size_t i = batchStart; i < batchEnd; ++i) {
+				const MergeNode *mergeNode = &mergeNodes[i];
+				group.run([&mergeNodeFunc, mergeNode]() { mergeNodeFunc(*mergeNode); });
+			}
+			group.wait();
+		}
+		batchStart = batchEnd;
 	}
 	return MergeResult{merged, mergedPalette, normalPalette};
 }
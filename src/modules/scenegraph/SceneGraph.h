@@ -9,6 +9,7 @@
 #pragma once
 
 #include "SceneGraphNode.h"
+#include "SceneGraphNodes.h"
 #include "core/DirtyState.h"
 #include "core/collection/DynamicArray.h"
 #include "palette/NormalPalette.h"
@@ -24,7 +25,6 @@ class RawVolume;
 namespace scenegraph {
 
 using SceneGraphAnimationIds = core::DynamicArray<core::String>;
-using SceneGraphNodes = core::Map<int, SceneGraphNode, 251>;
 
 struct FrameTransform {
 	glm::mat4 matrix;
@@ -38,6 +38,11 @@ struct FrameTransform {
 	void decompose(glm::vec3 &scale, glm::quat &orientation, glm::vec3 &translation) const;
 };
 
+/**
+ * @brief The frame transforms of all nodes of a scene graph - indexed by the node id
+ */
+using FrameTransforms = core::DynamicArray<FrameTransform>;
+
 /**
  * @brief The internal format for the save/load methods.
  *
@@ -57,7 +62,30 @@ protected:
 	const core::String _emptyUUID;
 	core::DynamicArray<SceneGraphListener*> _listeners;
 
+	struct FrameTransformCache {
+		core::String animation;
+		FrameIndex frameIdx = InvalidFrame;
+		int revision = 0;
+		uint32_t nodesRevision = 0u;
+		FrameTransforms transforms;
+	};
+	/**
+	 * the node ids sorted parent first - used to evaluate the transforms of all nodes in one linear pass
+	 */
+	mutable core::DynamicArray<int> _evalOrder;
+	/**
+	 * increased by changes of the hierarchy and transform updates - the nodes track the modifications of their key
+	 * frames themselves
+	 */
+	mutable int _keyFramesRevision = 1;
+	mutable int _evalOrderRevision = 0;
+	mutable FrameTransformCache _frameTransformCache[8];
+	mutable int _frameTransformCacheNext = 0;
+
 	void updateTransforms_r(SceneGraphNode &node);
+	void resetFrameTransformCache();
+	const SceneGraphKeyFrames &animationKeyFrames(const SceneGraphNode &node, const core::String &animation,
+												  bool activeAnimation) const;
 	voxel::Region calcRegion() const;
 
 public:
@@ -148,6 +176,25 @@ public:
 	FrameTransform transformForFrame(const SceneGraphNode &node, FrameIndex frameIdx) const;
 	FrameTransform transformForFrame(const SceneGraphNode &node, const core::String &animation, FrameIndex frameIdx) const;
 
+	/**
+	 * @brief Evaluates the transforms of all nodes for the given frame in one pass over the hierarchy
+	 *
+	 * Other than calling @c transformForFrame() for every node, the parent transforms are not evaluated again for
+	 * each child. The results are cached per animation and frame until the key frames or the hierarchy are modified.
+	 * Key frames that are modified through a reference (e.g. @c SceneGraphNode::keyFrame()) are not tracked - call
+	 * @c SceneGraphTransform::update() or @c markKeyFramesDirty() afterwards.
+	 *
+	 * @return The transforms indexed by the node id. Only valid until the next call - don't keep the reference.
+	 * @note This is not thread safe
+	 * @sa SceneGraphNode::keyFramesRevision()
+	 */
+	const FrameTransforms &transformsForFrame(FrameIndex frameIdx) const;
+	const FrameTransforms &transformsForFrame(const core::String &animation, FrameIndex frameIdx) const;
+	/**
+	 * @brief Interpolates the local matrix of the given key frames for the given frame
+	 */
+	static glm::mat4 localMatrixForFrame(const SceneGraphKeyFrames &keyFrames, FrameIndex frameIdx);
+
 	void setAllKeyFramesForNode(SceneGraphNode &node, const SceneGraphKeyFramesMap &keyFrames);
 
 	/**
@@ -159,6 +206,10 @@ public:
 
 	void updateTransforms();
 	void markMaxFramesDirty();
+	/**
+	 * @brief Invalidates the cached transforms of @c transformsForFrame()
+	 */
+	void markKeyFramesDirty() const;
 
 	/**
 	 * @brief We move into the scene graph to make it clear who is owning the volume.
@@ -269,26 +320,51 @@ public:
 		int _endNodeId = -1;
 		SceneGraphNodeType _filter = SceneGraphNodeType::Max;
 		const SceneGraph *_sceneGraph = nullptr;
+		// the ids of the nodes of the filtered type - or nullptr if all nodes are iterated
+		const core::DynamicArray<int> *_ids = nullptr;
+		size_t _idx = 0u;
+
+		/**
+		 * @brief Move to the next node in the id list starting at @c _idx
+		 */
+		void nextId() {
+			// model and model reference nodes are sharing one list
+			const bool checkType = _filter == SceneGraphNodeType::Model || _filter == SceneGraphNodeType::ModelReference;
+			for (; _idx < _ids->size(); ++_idx) {
+				const int nodeId = (*_ids)[_idx];
+				if (checkType && _sceneGraph->_nodes.get(nodeId)->type() != _filter) {
+					continue;
+				}
+				_startNodeId = nodeId;
+				return;
+			}
+			_startNodeId = _endNodeId;
+		}
+
+		/**
+		 * @brief Move to the next node slot starting at @c _startNodeId
+		 */
+		void nextSlot() {
+			while (_startNodeId != _endNodeId && _sceneGraph->_nodes.get(_startNodeId) == nullptr) {
+				++_startNodeId;
+			}
+		}
 	public:
 		constexpr iterator() {
 		}
 
 		iterator(int startNodeId, int endNodeId, SceneGraphNodeType filter, const SceneGraph *sceneGraph) :
 				_startNodeId(startNodeId), _endNodeId(endNodeId), _filter(filter), _sceneGraph(sceneGraph) {
-			while (_startNodeId != _endNodeId) {
-				if (!_sceneGraph->hasNode(_startNodeId)) {
-					++_startNodeId;
-					continue;
-				}
-				SceneGraphNodeType type = _sceneGraph->node(_startNodeId).type();
-				if (type == _filter || _filter == SceneGraphNodeType::All) {
-					break;
-				} else if (_filter == SceneGraphNodeType::AllModels) {
-					if (type == SceneGraphNodeType::Model || type == SceneGraphNodeType::ModelReference) {
-						break;
-					}
-				}
-				++_startNodeId;
+			if (_filter == SceneGraphNodeType::All) {
+				nextSlot();
+			} else if (_filter == SceneGraphNodeType::Max) {
+				_startNodeId = _endNodeId;
+			} else {
+				const SceneGraphNodeType type =
+					_filter == SceneGraphNodeType::AllModels ? SceneGraphNodeType::Model : _filter;
+				_ids = &_sceneGraph->_nodes.ids(type);
+				_idx = SceneGraphNodes::lowerBound(*_ids, _startNodeId);
+				nextId();
 			}
 		}
 
@@ -298,26 +374,21 @@ public:
 
 		iterator &operator++() {
 			core_assert_msg(_sceneGraph->_nextNodeId == _endNodeId, "Concurrent modification detected!");
-			if (_startNodeId != _endNodeId) {
-				for (;;) {
-					++_startNodeId;
-					if (_startNodeId == _endNodeId) {
-						break;
-					}
-					if (!_sceneGraph->hasNode(_startNodeId)) {
-						continue;
-					}
-					SceneGraphNodeType type = _sceneGraph->node(_startNodeId).type();
-					if (type == _filter || _filter == SceneGraphNodeType::All) {
-						break;
-					} else if (_filter == SceneGraphNodeType::AllModels) {
-						if (type == SceneGraphNodeType::Model || type == SceneGraphNodeType::ModelReference) {
-							break;
-						}
-					}
-				}
+			if (_startNodeId == _endNodeId) {
+				return *this;
 			}
-
+			if (_ids == nullptr) {
+				++_startNodeId;
+				nextSlot();
+				return *this;
+			}
+			// the current node might have been removed from the list in the meantime
+			if (_idx < _ids->size() && (*_ids)[_idx] == _startNodeId) {
+				++_idx;
+			} else {
+				_idx = SceneGraphNodes::lowerBound(*_ids, _startNodeId + 1);
+			}
+			nextId();
 			return *this;
 		}
 
@@ -17,6 +17,9 @@
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
 #include "voxelutil/VoxelUtil.h"
+#include <float.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/ext/matrix_transform.hpp>
 
 namespace scenegraph {
 
@@ -38,6 +41,7 @@ SceneGraphNode::SceneGraphNode(SceneGraphNode &&move) noexcept {
 	_keyFrames = move._keyFrames;
 	move._keyFrames = nullptr;
 	_keyFramesMap = core::move(move._keyFramesMap);
+	_keyFramesRevision = move._keyFramesRevision;
 	_properties = core::move(move._properties);
 	_children = core::move(move._children);
 	_type = move._type;
@@ -71,6 +75,8 @@ SceneGraphNode &SceneGraphNode::operator=(SceneGraphNode &&move) noexcept {
 	_keyFrames = move._keyFrames;
 	move._keyFrames = nullptr;
 	_keyFramesMap = core::move(move._keyFramesMap);
+	// the revision must grow to invalidate the cached transforms of the previous key frames
+	_keyFramesRevision = core_max(_keyFramesRevision, move._keyFramesRevision) + 1u;
 	_properties = core::move(move._properties);
 	_children = core::move(move._children);
 	_type = move._type;
@@ -96,6 +102,7 @@ bool SceneGraphNode::addAnimation(const core::String &anim) {
 	SceneGraphKeyFrames frames;
 	frames.emplace_back(SceneGraphKeyFrame{});
 	_keyFramesMap.emplace(anim, core::move(frames));
+	++_keyFramesRevision;
 	Log::debug("Added animation %s to node %s (%i)", anim.c_str(), _name.c_str(), _id);
 	return true;
 }
@@ -109,6 +116,7 @@ bool SceneGraphNode::removeAnimation(const core::String &anim) {
 		_keyFrames = nullptr;
 	}
 	_keyFramesMap.erase(iter);
+	++_keyFramesRevision;
 	if (_keyFramesMap.empty()) {
 		setAnimation(DEFAULT_ANIMATION);
 	}
@@ -132,6 +140,7 @@ bool SceneGraphNode::setAnimation(const core::String &anim) {
 
 	Log::debug("Switched animation for node %s (%i) to %s", _name.c_str(), _id, anim.c_str());
 	_keyFrames = &iter->value;
+	++_keyFramesRevision;
 	core_assert_msg(!_keyFrames->empty(), "Empty keyframes for anim %s", anim.c_str());
 	core_assert(keyFramesValidate());
 	return true;
@@ -388,11 +397,43 @@ const voxel::Region &SceneGraphNode::region() const {
 	return _volume->region();
 }
 
+bool SceneGraphNode::isRotated(KeyFrameIndex keyFrameIdx) const {
+	const glm::quat &orientation = transform(keyFrameIdx).worldOrientation();
+	return orientation != glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+glm::mat4 SceneGraphNode::sceneMatrix(const voxel::Region &volumeRegion, const glm::vec3 &pivot,
+									  KeyFrameIndex keyFrameIdx) const {
+	const SceneGraphTransform &transform = this->transform(keyFrameIdx);
+	const glm::vec3 &lower = volumeRegion.getLowerCornerf();
+	const glm::vec3 pivotPos = lower + pivot * glm::vec3(volumeRegion.getDimensionsInVoxels());
+	// without rotation and scale this is the same translation that is used for the scene region
+	glm::mat4 mat = glm::translate(glm::mat4(1.0f), lower + transform.worldTranslation());
+	mat *= glm::mat4_cast(transform.worldOrientation());
+	mat = glm::scale(mat, transform.worldScale());
+	return glm::translate(mat, -pivotPos);
+}
+
 voxel::Region SceneGraphNode::sceneRegion(const voxel::Region &volumeRegion, const glm::vec3 &pivot,
 										  KeyFrameIndex keyFrameIdx) const {
+	if (isRotated(keyFrameIdx)) {
+		const glm::mat4 &mat = sceneMatrix(volumeRegion, pivot, keyFrameIdx);
+		const glm::vec3 &lower = volumeRegion.getLowerCornerf();
+		const glm::vec3 upper = volumeRegion.getUpperCornerf() + 1.0f;
+		glm::vec3 mins(FLT_MAX);
+		glm::vec3 maxs(-FLT_MAX);
+		for (int i = 0; i < 8; ++i) {
+			const glm::vec3 corner(i & 1 ? upper.x : lower.x, i & 2 ? upper.y : lower.y, i & 4 ? upper.z : lower.z);
+			const glm::vec3 pos(mat * glm::vec4(corner, 1.0f));
+			mins = glm::min(mins, pos);
+			maxs = glm::max(maxs, pos);
+		}
+		// the epsilon compensates the float inaccuracy of the rotation for axis aligned results
+		const float epsilon = 0.001f;
+		return {glm::ivec3(glm::floor(mins + epsilon)), glm::ivec3(glm::ceil(maxs - epsilon)) - 1};
+	}
 	const SceneGraphTransform &transform = this->transform(keyFrameIdx);
 	const glm::vec3 &scale = transform.worldScale();
-	// TODO: SCENEGRAPH: rotation
 	const glm::vec3 translation = transform.worldTranslation() - pivot * glm::vec3(volumeRegion.getDimensionsInVoxels());
 	const glm::vec3 mins = (volumeRegion.getLowerCornerf() + translation) * scale;
 	const glm::vec3 maxs = mins + glm::vec3(volumeRegion.getDimensionsInCells());
@@ -547,6 +588,7 @@ const SceneGraphTransform &SceneGraphNode::transform(KeyFrameIndex keyFrameIdx)
 void SceneGraphNode::setTransform(KeyFrameIndex keyFrameIdx, const SceneGraphTransform &transform) {
 	SceneGraphKeyFrame &nodeFrame = keyFrame(keyFrameIdx);
 	nodeFrame.setTransform(transform);
+	++_keyFramesRevision;
 }
 
 const SceneGraphKeyFrames &SceneGraphNode::keyFrames() const {
@@ -607,6 +649,7 @@ KeyFrameIndex SceneGraphNode::addKeyFrame(FrameIndex frameIdx) {
 	keyFrame.frameIdx = frameIdx;
 	kfs->push_back(keyFrame);
 	sortKeyFrames();
+	++_keyFramesRevision;
 	size_t i = 0;
 	for (; i < kfs->size(); ++i) {
 		const SceneGraphKeyFrame &kf = (*kfs)[i];
@@ -642,11 +685,13 @@ bool SceneGraphNode::removeKeyFrameByIndex(KeyFrameIndex keyFrameIdx) {
 		return false;
 	}
 	kfs->erase(keyFrameIdx);
+	++_keyFramesRevision;
 	return true;
 }
 
 bool SceneGraphNode::duplicateKeyFrames(const core::String &fromAnimation, const core::String &toAnimation) {
 	_keyFramesMap.put(toAnimation, keyFrames(fromAnimation));
+	++_keyFramesRevision;
 	return true;
 }
 
@@ -656,6 +701,7 @@ bool SceneGraphNode::setKeyFrames(const SceneGraphKeyFrames &kf) {
 	}
 	if (SceneGraphKeyFrames *kfs = keyFrames()) {
 		*kfs = kf;
+		++_keyFramesRevision;
 		return true;
 	}
 	return false;
@@ -663,6 +709,7 @@ bool SceneGraphNode::setKeyFrames(const SceneGraphKeyFrames &kf) {
 
 void SceneGraphNode::setAllKeyFrames(const SceneGraphKeyFramesMap &map, const core::String &animation) {
 	_keyFramesMap = map;
+	++_keyFramesRevision;
 	setAnimation(animation);
 }
 
@@ -94,6 +94,7 @@ protected:
 	voxel::RawVolume *_volume = nullptr;
 	SceneGraphKeyFramesMap _keyFramesMap;
 	SceneGraphKeyFrames *_keyFrames = nullptr;
+	uint32_t _keyFramesRevision = 0u;
 	core::Buffer<int, 32> _children;
 	SceneGraphNodeProperties _properties;
 	mutable core::Optional<palette::Palette> _palette;
@@ -204,7 +205,20 @@ public:
 	 * @return voxel::Region instance that is invalid when the volume is not set for this instance.
 	 */
 	const voxel::Region &region() const;
+	/**
+	 * @note For rotated nodes this is the bounding box of the rotated volume
+	 * @sa sceneMatrix()
+	 */
 	voxel::Region sceneRegion(const voxel::Region &volumeRegion, const glm::vec3 &pivot, KeyFrameIndex keyFrameIdx) const;
+	/**
+	 * @brief The matrix that transforms volume coordinates into scene coordinates for the given key frame. The
+	 * rotation is applied around the pivot.
+	 */
+	glm::mat4 sceneMatrix(const voxel::Region &volumeRegion, const glm::vec3 &pivot, KeyFrameIndex keyFrameIdx) const;
+	/**
+	 * @return @c true if the world transform of the given key frame contains a rotation
+	 */
+	bool isRotated(KeyFrameIndex keyFrameIdx) const;
 	/**
 	 * @param volume voxel::RawVolume instance. Might be @c nullptr.
 	 * @param transferOwnership this is @c true if the volume should get deleted by this class, @c false if
@@ -268,6 +282,12 @@ public:
 	 * @brief Check that all key frames are valid. This basically means that they are sorted in the right order
 	 */
 	bool keyFramesValidate() const;
+	/**
+	 * @brief Increased by the methods of this node that modify the key frames or the animations. Modifications
+	 * through the mutable key frame accessors are not tracked.
+	 * @sa SceneGraph::transformsForFrame()
+	 */
+	uint32_t keyFramesRevision() const;
 	bool hasActiveAnimation() const;
 	bool addAnimation(const core::String &anim);
 	bool removeAnimation(const core::String &anim);
@@ -375,6 +395,10 @@ inline void SceneGraphNode::setId(int id) {
 	_id = id;
 }
 
+inline uint32_t SceneGraphNode::keyFramesRevision() const {
+	return _keyFramesRevision;
+}
+
 inline int SceneGraphNode::parent() const {
 	return _parent;
 }
@@ -0,0 +1,351 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Assert.h"
+#include "core/NonCopyable.h"
+#include "core/StandardLib.h"
+#include "core/collection/DynamicArray.h"
+#include "scenegraph/SceneGraphNode.h"
+#include <new>
+
+namespace scenegraph {
+
+/**
+ * @brief Storage for the nodes of a @c SceneGraph - indexed by the node id
+ *
+ * The node ids are small increasing integers that are not reused until the scene graph is cleared. That's why the
+ * nodes are stored in pages of @c PageSize slots instead of a hash map. The lookup is O(1), removing a node just
+ * destroys it in its slot and the iteration walks the slots in the order of the node ids. The addresses of the nodes
+ * are stable when other nodes are added or removed.
+ *
+ * The ids of the nodes of each @c SceneGraphNodeType are additionally kept in ascending order (see @c ids()) - this
+ * allows to iterate over the nodes of one type without checking every slot.
+ *
+ * The interface mimics the parts of @c core::Map that the scene graph is using.
+ *
+ * @ingroup SceneGraph
+ */
+class SceneGraphNodes : public core::NonCopyable {
+public:
+	static constexpr int PageBits = 8;
+	static constexpr int PageSize = 1 << PageBits;
+
+	struct KeyValue {
+		inline KeyValue(int _key, SceneGraphNode &&_value)
+			: key(_key), value(core::forward<SceneGraphNode>(_value)), first(key), second(value) {
+		}
+
+		int key;
+		SceneGraphNode value;
+		const int &first;
+		const SceneGraphNode &second;
+	};
+
+private:
+	struct Page {
+		alignas(KeyValue) uint8_t slots[PageSize * sizeof(KeyValue)];
+		bool used[PageSize];
+		// the type id list the node of the slot is registered in - see typeIdx()
+		uint8_t typeIdx[PageSize];
+		int count = 0;
+
+		Page() {
+			core_memset(used, 0, sizeof(used));
+			core_memset(typeIdx, 0, sizeof(typeIdx));
+		}
+
+		inline KeyValue *slot(int idx) {
+			return (KeyValue *)&slots[idx * sizeof(KeyValue)];
+		}
+	};
+	static constexpr int TypeIds = (int)SceneGraphNodeType::Max;
+	static constexpr uint8_t NoTypeIdx = 0xFF;
+	core::DynamicArray<Page *> _pages;
+	/**
+	 * @brief The node ids per type in ascending order
+	 */
+	core::DynamicArray<int> _typeIds[TypeIds];
+	size_t _size = 0;
+
+	/**
+	 * @brief Model and model reference nodes share one list - @c SceneGraphNode::setReference() and
+	 * @c SceneGraphNode::unreferenceModelNode() are converting the nodes between these types
+	 */
+	static inline uint8_t typeIdx(SceneGraphNodeType type) {
+		if (type == SceneGraphNodeType::ModelReference) {
+			return (uint8_t)SceneGraphNodeType::Model;
+		}
+		if ((int)type >= TypeIds) {
+			return NoTypeIdx;
+		}
+		return (uint8_t)type;
+	}
+
+	void addTypeId(uint8_t idx, int key) {
+		if (idx == NoTypeIdx) {
+			return;
+		}
+		core::DynamicArray<int> &ids = _typeIds[idx];
+		// the node ids are increasing - so this is usually just appending
+		if (ids.empty() || ids.back() < key) {
+			ids.push_back(key);
+			return;
+		}
+		ids.insert(ids.begin() + lowerBound(ids, key), key);
+	}
+
+	void removeTypeId(uint8_t idx, int key) {
+		if (idx == NoTypeIdx) {
+			return;
+		}
+		core::DynamicArray<int> &ids = _typeIds[idx];
+		const size_t pos = lowerBound(ids, key);
+		core_assert(pos < ids.size() && ids[pos] == key);
+		ids.erase(pos);
+	}
+
+	inline KeyValue *slot(int key) const {
+		if (key < 0) {
+			return nullptr;
+		}
+		const int pageIdx = key >> PageBits;
+		if (pageIdx >= (int)_pages.size()) {
+			return nullptr;
+		}
+		Page *page = _pages[pageIdx];
+		const int idx = key & (PageSize - 1);
+		if (page == nullptr || !page->used[idx]) {
+			return nullptr;
+		}
+		return page->slot(idx);
+	}
+
+	/**
+	 * @return The first used slot id starting at the given key or @c -1 if there is none
+	 */
+	int next(int key) const {
+		const int pageCnt = (int)_pages.size();
+		for (int pageIdx = key >> PageBits; pageIdx < pageCnt; ++pageIdx) {
+			const Page *page = _pages[pageIdx];
+			if (page == nullptr || page->count == 0) {
+				key = (pageIdx + 1) << PageBits;
+				continue;
+			}
+			for (int idx = key & (PageSize - 1); idx < PageSize; ++idx) {
+				if (page->used[idx]) {
+					return (pageIdx << PageBits) + idx;
+				}
+			}
+			key = (pageIdx + 1) << PageBits;
+		}
+		return -1;
+	}
+
+public:
+	/**
+	 * @return The index of the first entry that is not smaller than the given key
+	 */
+	static size_t lowerBound(const core::DynamicArray<int> &ids, int key) {
+		size_t low = 0;
+		size_t high = ids.size();
+		while (low < high) {
+			const size_t mid = low + (high - low) / 2;
+			if (ids[mid] < key) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+		return low;
+	}
+
+	SceneGraphNodes(int reserveNodes = 0) {
+		reserve(reserveNodes);
+	}
+
+	SceneGraphNodes(SceneGraphNodes &&other) noexcept : _pages(core::move(other._pages)), _size(other._size) {
+		for (int i = 0; i < TypeIds; ++i) {
+			_typeIds[i] = core::move(other._typeIds[i]);
+		}
+		other._size = 0;
+	}
+
+	~SceneGraphNodes() {
+		clear();
+	}
+
+	SceneGraphNodes &operator=(SceneGraphNodes &&other) noexcept {
+		if (this != &other) {
+			clear();
+			_pages = core::move(other._pages);
+			for (int i = 0; i < TypeIds; ++i) {
+				_typeIds[i] = core::move(other._typeIds[i]);
+			}
+			_size = other._size;
+			other._size = 0;
+		}
+		return *this;
+	}
+
+	class iterator {
+	private:
+		const SceneGraphNodes *_nodes = nullptr;
+		int _key = -1;
+
+	public:
+		constexpr iterator() {
+		}
+
+		iterator(const SceneGraphNodes *nodes, int key) : _nodes(nodes), _key(key) {
+		}
+
+		inline KeyValue *operator*() const {
+			return _nodes->slot(_key);
+		}
+
+		inline KeyValue *operator->() const {
+			return _nodes->slot(_key);
+		}
+
+		iterator &operator++() {
+			_key = _nodes->next(_key + 1);
+			return *this;
+		}
+
+		inline bool operator!=(const iterator &rhs) const {
+			return _key != rhs._key;
+		}
+
+		inline bool operator==(const iterator &rhs) const {
+			return _key == rhs._key;
+		}
+	};
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0;
+	}
+
+	void reserve(int nodes) {
+		_pages.reserve((nodes + PageSize - 1) / PageSize);
+	}
+
+	/**
+	 * @return The node for the given id or @c nullptr if there is no such node
+	 */
+	inline SceneGraphNode *get(int key) const {
+		KeyValue *kv = slot(key);
+		if (kv == nullptr) {
+			return nullptr;
+		}
+		return &kv->value;
+	}
+
+	/**
+	 * @return The ids of the nodes of the given type in ascending order. @c SceneGraphNodeType::Model and
+	 * @c SceneGraphNodeType::ModelReference are sharing one list - it contains the nodes of both types.
+	 */
+	inline const core::DynamicArray<int> &ids(SceneGraphNodeType type) const {
+		const uint8_t idx = typeIdx(type);
+		core_assert_msg(idx != NoTypeIdx, "No id list for node type %i", (int)type);
+		return _typeIds[idx];
+	}
+
+	inline bool hasKey(int key) const {
+		return slot(key) != nullptr;
+	}
+
+	inline iterator find(int key) const {
+		if (slot(key) == nullptr) {
+			return end();
+		}
+		return iterator(this, key);
+	}
+
+	inline iterator begin() const {
+		return iterator(this, next(0));
+	}
+
+	constexpr iterator end() const {
+		return iterator();
+	}
+
+	void emplace(int key, SceneGraphNode &&value) {
+		core_assert_msg(key >= 0, "Invalid node id %i", key);
+		const int pageIdx = key >> PageBits;
+		if (pageIdx >= (int)_pages.size()) {
+			_pages.resize(pageIdx + 1);
+		}
+		if (_pages[pageIdx] == nullptr) {
+			_pages[pageIdx] = new Page();
+		}
+		Page *page = _pages[pageIdx];
+		const int idx = key & (PageSize - 1);
+		const uint8_t newTypeIdx = typeIdx(value.type());
+		if (page->used[idx]) {
+			if (page->typeIdx[idx] != newTypeIdx) {
+				removeTypeId(page->typeIdx[idx], key);
+				addTypeId(newTypeIdx, key);
+				page->typeIdx[idx] = newTypeIdx;
+			}
+			page->slot(idx)->value = core::forward<SceneGraphNode>(value);
+			return;
+		}
+		new (page->slot(idx)) KeyValue(key, core::forward<SceneGraphNode>(value));
+		addTypeId(newTypeIdx, key);
+		page->typeIdx[idx] = newTypeIdx;
+		page->used[idx] = true;
+		++page->count;
+		++_size;
+	}
+
+	inline bool erase(const iterator &iter) {
+		return remove(iter->key);
+	}
+
+	bool remove(int key) {
+		KeyValue *kv = slot(key);
+		if (kv == nullptr) {
+			return false;
+		}
+		const int pageIdx = key >> PageBits;
+		Page *page = _pages[pageIdx];
+		const int idx = key & (PageSize - 1);
+		removeTypeId(page->typeIdx[idx], key);
+		kv->~KeyValue();
+		page->used[idx] = false;
+		--_size;
+		if (--page->count == 0) {
+			delete page;
+			_pages[pageIdx] = nullptr;
+		}
+		return true;
+	}
+
+	void clear() {
+		for (Page *page : _pages) {
+			if (page == nullptr) {
+				continue;
+			}
+			for (int idx = 0; idx < PageSize; ++idx) {
+				if (page->used[idx]) {
+					page->slot(idx)->~KeyValue();
+				}
+			}
+			delete page;
+		}
+		_pages.clear();
+		for (int i = 0; i < TypeIds; ++i) {
+			_typeIds[i].clear();
+		}
+		_size = 0;
+	}
+};
+
+} // namespace scenegraph
@@ -0,0 +1,90 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+
+/**
+ * @brief A scene graph with 10k animated group nodes in chains of 100 nested nodes - compares the evaluation of the
+ * transforms for each node with the batched evaluation of all nodes in one pass
+ */
+class SceneGraphBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int Chains = 100;
+	static constexpr int Depth = 100;
+	static constexpr scenegraph::FrameIndex Frames = 40;
+	// the nodes are quite heavy - share the scene graph between all benchmarks
+	static scenegraph::SceneGraph *_sceneGraphPtr;
+	scenegraph::SceneGraph *_sceneGraph = nullptr;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		if (_sceneGraphPtr != nullptr) {
+			_sceneGraph = _sceneGraphPtr;
+			return;
+		}
+		_sceneGraphPtr = _sceneGraph = new scenegraph::SceneGraph();
+		for (int chain = 0; chain < Chains; ++chain) {
+			int parentId = _sceneGraph->root().id();
+			for (int depth = 0; depth < Depth; ++depth) {
+				scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Group);
+				scenegraph::SceneGraphTransform transform0;
+				transform0.setLocalTranslation(glm::vec3(1.0f, 0.0f, 0.0f));
+				node.setTransform(0, transform0);
+				scenegraph::SceneGraphTransform transform1;
+				transform1.setLocalTranslation(glm::vec3(0.0f, 1.0f, 0.0f));
+				transform1.setLocalOrientation(glm::quat(glm::vec3(0.0f, glm::radians(10.0f), 0.0f)));
+				node.keyFrame(1).frameIdx = Frames;
+				node.setTransform(1, transform1);
+				parentId = _sceneGraph->emplace(core::move(node), parentId);
+			}
+		}
+		_sceneGraph->updateTransforms();
+	}
+};
+
+scenegraph::SceneGraph *SceneGraphBenchmark::_sceneGraphPtr = nullptr;
+
+BENCHMARK_DEFINE_F(SceneGraphBenchmark, TransformForFrame)(benchmark::State &state) {
+	scenegraph::FrameIndex frameIdx = 0;
+	for (auto _ : state) {
+		for (const auto &entry : _sceneGraph->nodes()) {
+			benchmark::DoNotOptimize(_sceneGraph->transformForFrame(entry->second, frameIdx));
+		}
+		frameIdx = (frameIdx + 1) % Frames;
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() *
+							(int64_t)_sceneGraph->size(scenegraph::SceneGraphNodeType::All));
+}
+
+BENCHMARK_DEFINE_F(SceneGraphBenchmark, TransformsForFrame)(benchmark::State &state) {
+	scenegraph::FrameIndex frameIdx = 0;
+	for (auto _ : state) {
+		// every frame is evaluated only once - the cache doesn't kick in
+		benchmark::DoNotOptimize(_sceneGraph->transformsForFrame(frameIdx).data());
+		frameIdx = (frameIdx + 1) % Frames;
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() *
+							(int64_t)_sceneGraph->size(scenegraph::SceneGraphNodeType::All));
+}
+
+BENCHMARK_DEFINE_F(SceneGraphBenchmark, TransformsForFrameCached)(benchmark::State &state) {
+	for (auto _ : state) {
+		const scenegraph::FrameTransforms &transforms = _sceneGraph->transformsForFrame(Frames / 2);
+		for (const auto &entry : _sceneGraph->nodes()) {
+			float x = transforms[entry->second.id()].matrix[3].x;
+			benchmark::DoNotOptimize(x);
+		}
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() *
+							(int64_t)_sceneGraph->size(scenegraph::SceneGraphNodeType::All));
+}
+
+BENCHMARK_REGISTER_F(SceneGraphBenchmark, TransformForFrame)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphBenchmark, TransformsForFrame)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphBenchmark, TransformsForFrameCached)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
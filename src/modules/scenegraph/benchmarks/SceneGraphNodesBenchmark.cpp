@@ -0,0 +1,95 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/collection/Map.h"
+#include "scenegraph/SceneGraphNodes.h"
+
+/**
+ * @brief Compares the hash map that was used to store the scene graph nodes with the paged @c SceneGraphNodes storage
+ * at 100k nodes
+ */
+template<class NODES>
+class SceneGraphNodesBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int Nodes = 100000;
+	NODES *_nodes = nullptr;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_nodes = new NODES(Nodes);
+		for (int id = 0; id < Nodes; ++id) {
+			// every fourth node is a model node
+			const scenegraph::SceneGraphNodeType type =
+				id % 4 == 0 ? scenegraph::SceneGraphNodeType::Model : scenegraph::SceneGraphNodeType::Group;
+			_nodes->emplace(id, scenegraph::SceneGraphNode(type));
+		}
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		delete _nodes;
+		_nodes = nullptr;
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+using SceneGraphNodesMap = core::Map<int, scenegraph::SceneGraphNode, 251>;
+
+BENCHMARK_TEMPLATE_DEFINE_F(SceneGraphNodesBenchmark, LookupMap, SceneGraphNodesMap)(benchmark::State &state) {
+	for (auto _ : state) {
+		int models = 0;
+		for (int id = 0; id < Nodes; ++id) {
+			if (_nodes->find(id)->value.type() == scenegraph::SceneGraphNodeType::Model) {
+				++models;
+			}
+		}
+		benchmark::DoNotOptimize(models);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * Nodes);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(SceneGraphNodesBenchmark, LookupNodes, scenegraph::SceneGraphNodes)(benchmark::State &state) {
+	for (auto _ : state) {
+		int models = 0;
+		for (int id = 0; id < Nodes; ++id) {
+			if (_nodes->find(id)->value.type() == scenegraph::SceneGraphNodeType::Model) {
+				++models;
+			}
+		}
+		benchmark::DoNotOptimize(models);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * Nodes);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(SceneGraphNodesBenchmark, IterateMap, SceneGraphNodesMap)(benchmark::State &state) {
+	for (auto _ : state) {
+		int models = 0;
+		for (const auto &entry : *_nodes) {
+			if (entry->value.type() == scenegraph::SceneGraphNodeType::Model) {
+				++models;
+			}
+		}
+		benchmark::DoNotOptimize(models);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * Nodes);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(SceneGraphNodesBenchmark, IterateNodes, scenegraph::SceneGraphNodes)(benchmark::State &state) {
+	for (auto _ : state) {
+		int models = 0;
+		for (const auto &entry : *_nodes) {
+			if (entry->value.type() == scenegraph::SceneGraphNodeType::Model) {
+				++models;
+			}
+		}
+		benchmark::DoNotOptimize(models);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * Nodes);
+}
+
+BENCHMARK_REGISTER_F(SceneGraphNodesBenchmark, LookupMap)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphNodesBenchmark, LookupNodes)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphNodesBenchmark, IterateMap)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphNodesBenchmark, IterateNodes)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,111 @@
+/**
+ * @file
+ */
+
+#include "scenegraph/SceneGraphNodes.h"
+#include "app/tests/AbstractTest.h"
+#include "core/StringUtil.h"
+
+namespace scenegraph {
+
+class SceneGraphNodesTest : public app::AbstractTest {
+protected:
+	void add(SceneGraphNodes &nodes, int id) {
+		SceneGraphNode node(SceneGraphNodeType::Group);
+		node.setName(core::string::toString(id));
+		nodes.emplace(id, core::move(node));
+	}
+};
+
+TEST_F(SceneGraphNodesTest, testEmplaceFind) {
+	SceneGraphNodes nodes;
+	EXPECT_TRUE(nodes.empty());
+	EXPECT_EQ(nodes.end(), nodes.begin());
+	add(nodes, 0);
+	add(nodes, 1000);
+	EXPECT_EQ(2u, nodes.size());
+	EXPECT_TRUE(nodes.hasKey(0));
+	EXPECT_TRUE(nodes.hasKey(1000));
+	EXPECT_FALSE(nodes.hasKey(1));
+	EXPECT_FALSE(nodes.hasKey(InvalidNodeId));
+	EXPECT_FALSE(nodes.hasKey(100000));
+	EXPECT_EQ(nodes.end(), nodes.find(999));
+	auto iter = nodes.find(1000);
+	ASSERT_NE(nodes.end(), iter);
+	EXPECT_EQ(1000, iter->key);
+	EXPECT_EQ("1000", iter->second.name());
+	EXPECT_EQ(&iter->value, nodes.get(1000));
+}
+
+TEST_F(SceneGraphNodesTest, testIterationOrder) {
+	SceneGraphNodes nodes;
+	for (int id : {700, 3, 256, 0, 255}) {
+		add(nodes, id);
+	}
+	core::DynamicArray<int> ids;
+	for (const auto &entry : nodes) {
+		ids.push_back(entry->first);
+		EXPECT_EQ(core::string::toString(entry->key), entry->value.name());
+	}
+	ASSERT_EQ(5u, ids.size());
+	EXPECT_EQ(0, ids[0]);
+	EXPECT_EQ(3, ids[1]);
+	EXPECT_EQ(255, ids[2]);
+	EXPECT_EQ(256, ids[3]);
+	EXPECT_EQ(700, ids[4]);
+}
+
+TEST_F(SceneGraphNodesTest, testRemoveStableAddress) {
+	SceneGraphNodes nodes;
+	add(nodes, 1);
+	const SceneGraphNode *node = nodes.get(1);
+	for (int id = 2; id < 2000; ++id) {
+		add(nodes, id);
+	}
+	EXPECT_EQ(node, nodes.get(1)) << "Adding nodes must not move the existing nodes";
+	for (int id = 2; id < 2000; ++id) {
+		ASSERT_TRUE(nodes.remove(id));
+	}
+	EXPECT_FALSE(nodes.remove(2));
+	EXPECT_EQ(1u, nodes.size());
+	EXPECT_EQ(node, nodes.get(1));
+	EXPECT_TRUE(nodes.erase(nodes.find(1)));
+	EXPECT_TRUE(nodes.empty());
+	EXPECT_EQ(nodes.end(), nodes.begin());
+}
+
+TEST_F(SceneGraphNodesTest, testTypeIds) {
+	SceneGraphNodes nodes;
+	for (int id : {9, 2, 5, 300}) {
+		add(nodes, id);
+	}
+	nodes.emplace(4, SceneGraphNode(SceneGraphNodeType::Model));
+	nodes.emplace(1, SceneGraphNode(SceneGraphNodeType::ModelReference));
+	const core::DynamicArray<int> &groups = nodes.ids(SceneGraphNodeType::Group);
+	ASSERT_EQ(4u, groups.size());
+	EXPECT_EQ(2, groups[0]);
+	EXPECT_EQ(5, groups[1]);
+	EXPECT_EQ(9, groups[2]);
+	EXPECT_EQ(300, groups[3]);
+	const core::DynamicArray<int> &models = nodes.ids(SceneGraphNodeType::Model);
+	EXPECT_EQ(&models, &nodes.ids(SceneGraphNodeType::ModelReference));
+	ASSERT_EQ(2u, models.size());
+	EXPECT_EQ(1, models[0]);
+	EXPECT_EQ(4, models[1]);
+	EXPECT_TRUE(nodes.ids(SceneGraphNodeType::Camera).empty());
+
+	ASSERT_TRUE(nodes.remove(5));
+	ASSERT_TRUE(nodes.remove(9));
+	nodes.emplace(9, SceneGraphNode(SceneGraphNodeType::Camera));
+	ASSERT_EQ(2u, groups.size());
+	EXPECT_EQ(2, groups[0]);
+	EXPECT_EQ(300, groups[1]);
+	ASSERT_EQ(1u, nodes.ids(SceneGraphNodeType::Camera).size());
+	EXPECT_EQ(9, nodes.ids(SceneGraphNodeType::Camera)[0]);
+
+	nodes.clear();
+	EXPECT_TRUE(nodes.ids(SceneGraphNodeType::Group).empty());
+	EXPECT_TRUE(nodes.ids(SceneGraphNodeType::Model).empty());
+}
+
+} // namespace scenegraph
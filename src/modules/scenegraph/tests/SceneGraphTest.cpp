@@ -326,44 +326,37 @@ TEST_F(SceneGraphTest, testMergeWithTranslationAndPivot) {
 	EXPECT_TRUE(voxel::isBlocked(v->voxel(12, 12, 12).getMaterial()));
 }
 
-// TODO: implement rotation here
-TEST_F(SceneGraphTest, DISABLED_testMergeWithTranslationPivotAndRotation) {
+TEST_F(SceneGraphTest, testMergeWithRotation) {
 	SceneGraph sceneGraph;
 	{
 		SceneGraphNode node(SceneGraphNodeType::Model);
 		node.setName("node1");
-		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 10));
-		v->setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
-		v->setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 3));
+		v->setVoxel(3, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
 		node.setVolume(v, true);
-		const glm::vec3 euler(45.0f, 0.0f, 0.0f);
 		SceneGraphTransform transform;
-		transform.setWorldOrientation(glm::quat(euler));
-		transform.setWorldTranslation(glm::vec3(-10));
+		// rotates the positive x axis onto the negative z axis
+		transform.setWorldOrientation(glm::angleAxis(glm::half_pi<float>(), glm::vec3(0.0f, 1.0f, 0.0f)));
 		node.setTransform(0, transform);
-		node.setPivot(glm::vec3(1.0f) / glm::vec3(v->region().getDimensionsInVoxels()));
+		node.setPivot(glm::vec3(0.0f));
 		sceneGraph.emplace(core::move(node));
 	}
 	{
 		SceneGraphNode node(SceneGraphNodeType::Model);
 		node.setName("node2");
-		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(1, 5));
-		v->setVoxel(2, 2, 2, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(10, 11));
+		v->setVoxel(10, 10, 10, voxel::createVoxel(voxel::VoxelType::Generic, 2));
 		node.setVolume(v, true);
-		const glm::vec3 euler(0.0f, 45.0f, 0.0f);
-		SceneGraphTransform transform;
-		transform.setWorldOrientation(glm::quat(euler));
-		transform.setWorldTranslation(glm::vec3(10));
-		node.setTransform(0, transform);
-		node.setPivot(glm::vec3(0.0f));
 		sceneGraph.emplace(core::move(node));
 	}
 	SceneGraph::MergeResult merged = sceneGraph.merge();
 	core::ScopedPtr<voxel::RawVolume> v(merged.volume());
 	ASSERT_NE(nullptr, v);
-	EXPECT_EQ(27, v->region().getWidthInVoxels());
-	EXPECT_TRUE(voxel::isBlocked(v->voxel(-10, -10, -10).getMaterial()));
-	EXPECT_TRUE(voxel::isBlocked(v->voxel(12, 12, 12).getMaterial()));
+	EXPECT_EQ(glm::ivec3(0, 0, -4), v->region().getLowerCorner());
+	EXPECT_EQ(glm::ivec3(11, 11, 11), v->region().getUpperCorner());
+	EXPECT_TRUE(voxel::isBlocked(v->voxel(0, 0, -4).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(v->voxel(3, 0, 0).getMaterial()));
+	EXPECT_TRUE(voxel::isBlocked(v->voxel(10, 10, 10).getMaterial()));
 }
 
 TEST_F(SceneGraphTest, testKeyframes) {
@@ -438,6 +431,55 @@ TEST_F(SceneGraphTest, testMove) {
 	}
 }
 
+TEST_F(SceneGraphTest, testIterateTypes) {
+	SceneGraph sceneGraph;
+	core::DynamicArray<int> modelIds;
+	for (int i = 0; i < 4; ++i) {
+		SceneGraphNode group(SceneGraphNodeType::Group);
+		sceneGraph.emplace(core::move(group));
+		SceneGraphNode model(SceneGraphNodeType::Model);
+		model.setVolume(new voxel::RawVolume(voxel::Region(0, 1)), true);
+		modelIds.push_back(sceneGraph.emplace(core::move(model)));
+	}
+	SceneGraphNode reference(SceneGraphNodeType::ModelReference);
+	reference.setReference(modelIds[0]);
+	const int referenceId = sceneGraph.emplace(core::move(reference));
+	// convert a model into a reference node after it was added
+	ASSERT_TRUE(sceneGraph.node(modelIds[2]).setReference(modelIds[0], true));
+
+	EXPECT_EQ(4u, sceneGraph.size(SceneGraphNodeType::Group));
+	EXPECT_EQ(3u, sceneGraph.size(SceneGraphNodeType::Model));
+	EXPECT_EQ(2u, sceneGraph.size(SceneGraphNodeType::ModelReference));
+	EXPECT_EQ(5u, sceneGraph.size(SceneGraphNodeType::AllModels));
+	EXPECT_TRUE(sceneGraph.empty(SceneGraphNodeType::Camera));
+	EXPECT_FALSE(sceneGraph.empty(SceneGraphNodeType::ModelReference));
+
+	core::DynamicArray<int> ids;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		EXPECT_EQ(SceneGraphNodeType::Model, (*iter).type());
+		ids.push_back((*iter).id());
+	}
+	ASSERT_EQ(3u, ids.size());
+	EXPECT_EQ(modelIds[0], ids[0]);
+	EXPECT_EQ(modelIds[1], ids[1]);
+	EXPECT_EQ(modelIds[3], ids[2]);
+
+	// remove the current node while iterating
+	ids.clear();
+	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
+		const int nodeId = (*iter).id();
+		ids.push_back(nodeId);
+		if (nodeId == modelIds[2]) {
+			ASSERT_TRUE(sceneGraph.removeNode(nodeId, false));
+		}
+	}
+	ASSERT_EQ(5u, ids.size());
+	EXPECT_EQ(modelIds[2], ids[2]);
+	EXPECT_EQ(modelIds[3], ids[3]);
+	EXPECT_EQ(referenceId, ids[4]);
+	EXPECT_EQ(4u, sceneGraph.size(SceneGraphNodeType::AllModels));
+}
+
 TEST_F(SceneGraphTest, testAddKeyFrame) {
 	SceneGraphNode node;
 	EXPECT_EQ(InvalidKeyFrame, node.addKeyFrame(0));
@@ -614,6 +656,105 @@ TEST_F(SceneGraphTest, testKeyFrameTransformParentRotation2) {
 	}
 }
 
+TEST_F(SceneGraphTest, testTransformsForFrame) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int parentId = 0;
+	for (int i = 0; i < 4; ++i) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		SceneGraphTransform transform0;
+		transform0.setLocalTranslation(glm::vec3(1.0f, 0.0f, 0.0f));
+		node.setTransform(0, transform0);
+		SceneGraphTransform transform1;
+		transform1.setLocalTranslation(glm::vec3(1.0f, 2.0f, 0.0f));
+		transform1.setLocalOrientation(glm::quat(glm::vec3(0.0f, glm::radians(90.0f), 0.0f)));
+		node.keyFrame(1).frameIdx = 20;
+		node.setTransform(1, transform1);
+		parentId = sceneGraph.emplace(core::move(node), parentId);
+		ASSERT_NE(InvalidNodeId, parentId);
+	}
+	sceneGraph.updateTransforms();
+
+	for (FrameIndex frameIdx : {0, 5, 20, 30}) {
+		const FrameTransforms &transforms = sceneGraph.transformsForFrame(frameIdx);
+		ASSERT_EQ(5u, transforms.size());
+		for (const auto &entry : sceneGraph.nodes()) {
+			const SceneGraphNode &node = entry->second;
+			const FrameTransform &expected = sceneGraph.transformForFrame(node, frameIdx);
+			for (int i = 0; i < 4; ++i) {
+				for (int j = 0; j < 4; ++j) {
+					EXPECT_NEAR(expected.matrix[i][j], transforms[node.id()].matrix[i][j], 0.0001f)
+						<< "frame " << frameIdx << " node " << node.id();
+				}
+			}
+		}
+	}
+	EXPECT_FLOAT_EQ(4.0f, sceneGraph.transformsForFrame(0)[parentId].translation().x);
+}
+
+TEST_F(SceneGraphTest, testTransformsForFrameCache) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int nodeId;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		nodeId = sceneGraph.emplace(core::move(node));
+	}
+	sceneGraph.updateTransforms();
+	const FrameTransforms *transforms = &sceneGraph.transformsForFrame(0);
+	EXPECT_EQ(transforms, &sceneGraph.transformsForFrame(0)) << "Expected to get the cached transforms";
+	EXPECT_FLOAT_EQ(0.0f, (*transforms)[nodeId].translation().x);
+
+	// modifying the key frames invalidates the cache
+	SceneGraphNode &node = sceneGraph.node(nodeId);
+	node.transform(0).setWorldTranslation(glm::vec3(10.0f, 0.0f, 0.0f));
+	node.transform(0).update(sceneGraph, node, 0, false);
+	EXPECT_FLOAT_EQ(10.0f, sceneGraph.transformsForFrame(0)[nodeId].translation().x);
+
+	// changing the hierarchy invalidates the cache
+	int childId;
+	{
+		SceneGraphNode child(SceneGraphNodeType::Model);
+		child.setVolume(&v, false);
+		childId = sceneGraph.emplace(core::move(child), nodeId);
+	}
+	sceneGraph.updateTransforms();
+	EXPECT_FLOAT_EQ(10.0f, sceneGraph.transformsForFrame(0)[childId].translation().x);
+	ASSERT_TRUE(sceneGraph.changeParent(childId, 0, false));
+	EXPECT_FLOAT_EQ(0.0f, sceneGraph.transformsForFrame(0)[childId].translation().x);
+}
+
+TEST_F(SceneGraphTest, testTransformsForFrameCacheKeyFrameReference) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int nodeId;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		nodeId = sceneGraph.emplace(core::move(node));
+	}
+	SceneGraphNode &node = sceneGraph.node(nodeId);
+	const KeyFrameIndex keyFrameIdx = node.addKeyFrame(10);
+	ASSERT_NE(InvalidKeyFrame, keyFrameIdx);
+	node.keyFrame(keyFrameIdx).transform().setWorldTranslation(glm::vec3(10.0f, 0.0f, 0.0f));
+	sceneGraph.updateTransforms();
+
+	// keep the reference while the transforms are evaluated and cached
+	SceneGraphKeyFrame &keyFrame = node.keyFrame(keyFrameIdx);
+	EXPECT_FLOAT_EQ(10.0f, sceneGraph.transformsForFrame(10)[nodeId].translation().x);
+	EXPECT_GT(10.0f, sceneGraph.transformsForFrame(5)[nodeId].translation().x);
+
+	keyFrame.transform().setWorldTranslation(glm::vec3(20.0f, 0.0f, 0.0f));
+	keyFrame.transform().update(sceneGraph, node, keyFrame.frameIdx, false);
+	EXPECT_FLOAT_EQ(20.0f, sceneGraph.transformsForFrame(10)[nodeId].translation().x);
+
+	keyFrame.frameIdx = 5;
+	sceneGraph.markMaxFramesDirty();
+	EXPECT_FLOAT_EQ(20.0f, sceneGraph.transformsForFrame(5)[nodeId].translation().x);
+}
+
 TEST_F(SceneGraphTest, testSceneRegion) {
 	SceneGraph sceneGraph;
 	voxel::RawVolume v(voxel::Region(-3, 3));
@@ -64,6 +64,12 @@ public:
 	 */
 	void destroyVertexArray();
 	bool update(int32_t idx, const void* data, size_t size, bool orphaning = false);
+	/**
+	 * @brief Updates a part of an already allocated buffer without touching the rest of the data
+	 * @param[in] offset The offset in bytes
+	 * @note The range must be within the size of the last @c update() call
+	 */
+	bool updateRange(int32_t idx, size_t offset, const void* data, size_t size);
 
 	/**
 	 * @return -1 on error - otherwise the index [0,n) of the created buffer (not the Id)
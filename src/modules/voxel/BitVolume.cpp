@@ -0,0 +1,255 @@
+/**
+ * @file
+ */
+
+#include "BitVolume.h"
+#include "core/collection/DynamicArray.h"
+
+namespace voxel {
+
+uint64_t BitVolume::sliceMask(int x0, int x1, int y0, int y1) {
+	const uint64_t row = ((UINT64_C(1) << (x1 - x0 + 1)) - 1u) << x0;
+	uint64_t mask = 0u;
+	for (int y = y0; y <= y1; ++y) {
+		mask |= row << (y << BrickBits);
+	}
+	return mask;
+}
+
+bool BitVolume::hasValue(int x, int y, int z) const {
+	auto iter = _bricks.find(brickPos(x, y, z));
+	if (iter == _bricks.end()) {
+		return false;
+	}
+	return (iter->value.bits[z & BrickMask] & bitMask(x, y)) != 0u;
+}
+
+void BitVolume::setValue(int x, int y, int z, bool value) {
+	const glm::ivec3 &pos = brickPos(x, y, z);
+	auto iter = _bricks.find(pos);
+	if (value) {
+		if (iter == _bricks.end()) {
+			Brick brick;
+			brick.bits[z & BrickMask] = bitMask(x, y);
+			_bricks.emplace(pos, core::move(brick));
+		} else {
+			iter->value.bits[z & BrickMask] |= bitMask(x, y);
+		}
+		if (_region.isValid()) {
+			_region.accumulate(x, y, z);
+		} else {
+			_regionDirty = true;
+		}
+		return;
+	}
+	if (iter == _bricks.end()) {
+		return;
+	}
+	iter->value.bits[z & BrickMask] &= ~bitMask(x, y);
+	if (iter->value.empty()) {
+		_bricks.remove(pos);
+	}
+	_regionDirty = true;
+}
+
+void BitVolume::setRegion(const Region &region, bool value) {
+	if (!region.isValid()) {
+		return;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const glm::ivec3 &brickMins = brickPos(mins.x, mins.y, mins.z);
+	const glm::ivec3 &brickMaxs = brickPos(maxs.x, maxs.y, maxs.z);
+	for (int bz = brickMins.z; bz <= brickMaxs.z; ++bz) {
+		const int z0 = bz == brickMins.z ? (mins.z & BrickMask) : 0;
+		const int z1 = bz == brickMaxs.z ? (maxs.z & BrickMask) : BrickMask;
+		for (int by = brickMins.y; by <= brickMaxs.y; ++by) {
+			const int y0 = by == brickMins.y ? (mins.y & BrickMask) : 0;
+			const int y1 = by == brickMaxs.y ? (maxs.y & BrickMask) : BrickMask;
+			for (int bx = brickMins.x; bx <= brickMaxs.x; ++bx) {
+				const int x0 = bx == brickMins.x ? (mins.x & BrickMask) : 0;
+				const int x1 = bx == brickMaxs.x ? (maxs.x & BrickMask) : BrickMask;
+				const uint64_t mask = sliceMask(x0, x1, y0, y1);
+				const glm::ivec3 pos(bx, by, bz);
+				auto iter = _bricks.find(pos);
+				if (value) {
+					if (iter == _bricks.end()) {
+						Brick brick;
+						for (int z = z0; z <= z1; ++z) {
+							brick.bits[z] = mask;
+						}
+						_bricks.emplace(pos, core::move(brick));
+					} else {
+						for (int z = z0; z <= z1; ++z) {
+							iter->value.bits[z] |= mask;
+						}
+					}
+				} else if (iter != _bricks.end()) {
+					for (int z = z0; z <= z1; ++z) {
+						iter->value.bits[z] &= ~mask;
+					}
+					if (iter->value.empty()) {
+						_bricks.remove(pos);
+					}
+				}
+			}
+		}
+	}
+	if (value && _region.isValid() && !_regionDirty) {
+		_region.accumulate(region);
+	} else {
+		_regionDirty = true;
+	}
+}
+
+void BitVolume::invert(const Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	BitVolume inverted;
+	inverted.setRegion(region, true);
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		auto other = inverted._bricks.find(iter->key);
+		if (other == inverted._bricks.end()) {
+			// outside of the region - keep the bits
+			inverted._bricks.put(iter->key, iter->value);
+			continue;
+		}
+		for (int z = 0; z < BrickSize; ++z) {
+			// bits inside the region are flipped, bits outside of the region are kept
+			other->value.bits[z] ^= iter->value.bits[z];
+		}
+		if (other->value.empty()) {
+			inverted._bricks.remove(iter->key);
+		}
+	}
+	_bricks = core::move(inverted._bricks);
+	_regionDirty = true;
+}
+
+void BitVolume::unite(const BitVolume &other) {
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		auto own = _bricks.find(iter->key);
+		if (own == _bricks.end()) {
+			_bricks.put(iter->key, iter->value);
+			continue;
+		}
+		for (int z = 0; z < BrickSize; ++z) {
+			own->value.bits[z] |= iter->value.bits[z];
+		}
+	}
+	if (_region.isValid() && !_regionDirty && !other.empty()) {
+		_region.accumulate(other.region());
+	} else {
+		_regionDirty = true;
+	}
+}
+
+void BitVolume::intersect(const BitVolume &other) {
+	core::DynamicArray<glm::ivec3> removed;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		auto theirs = other._bricks.find(iter->key);
+		if (theirs == other._bricks.end()) {
+			removed.push_back(iter->key);
+			continue;
+		}
+		for (int z = 0; z < BrickSize; ++z) {
+			iter->value.bits[z] &= theirs->value.bits[z];
+		}
+		if (iter->value.empty()) {
+			removed.push_back(iter->key);
+		}
+	}
+	for (const glm::ivec3 &pos : removed) {
+		_bricks.remove(pos);
+	}
+	_regionDirty = true;
+}
+
+void BitVolume::subtract(const BitVolume &other) {
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		auto own = _bricks.find(iter->key);
+		if (own == _bricks.end()) {
+			continue;
+		}
+		for (int z = 0; z < BrickSize; ++z) {
+			own->value.bits[z] &= ~iter->value.bits[z];
+		}
+		if (own->value.empty()) {
+			_bricks.remove(iter->key);
+		}
+	}
+	_regionDirty = true;
+}
+
+void BitVolume::clear() {
+	_bricks.clear();
+	_region = Region::InvalidRegion;
+	_regionDirty = false;
+}
+
+size_t BitVolume::count() const {
+	size_t n = 0u;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		for (int z = 0; z < BrickSize; ++z) {
+			for (uint64_t bits = iter->value.bits[z]; bits != 0u; bits &= bits - 1u) {
+				++n;
+			}
+		}
+	}
+	return n;
+}
+
+Region BitVolume::brickRegion(const glm::ivec3 &brickPos, const Brick &brick) {
+	uint64_t allBits = 0u;
+	int z0 = BrickSize;
+	int z1 = -1;
+	for (int z = 0; z < BrickSize; ++z) {
+		if (brick.bits[z] == 0u) {
+			continue;
+		}
+		allBits |= brick.bits[z];
+		z0 = core_min(z0, z);
+		z1 = z;
+	}
+	if (allBits == 0u) {
+		return Region::InvalidRegion;
+	}
+	int x0 = BrickSize, x1 = -1, y0 = BrickSize, y1 = -1;
+	for (int y = 0; y < BrickSize; ++y) {
+		const uint64_t row = (allBits >> (y << BrickBits)) & 0xFFu;
+		if (row == 0u) {
+			continue;
+		}
+		y0 = core_min(y0, y);
+		y1 = y;
+		x0 = core_min(x0, lowestBit(row));
+		for (int x = BrickMask; x >= 0; --x) {
+			if (row & (UINT64_C(1) << x)) {
+				x1 = core_max(x1, x);
+				break;
+			}
+		}
+	}
+	const glm::ivec3 base = brickPos * BrickSize;
+	return Region(base + glm::ivec3(x0, y0, z0), base + glm::ivec3(x1, y1, z1));
+}
+
+const Region &BitVolume::region() const {
+	if (!_regionDirty) {
+		return _region;
+	}
+	_region = Region::InvalidRegion;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const Region &r = brickRegion(iter->key, iter->value);
+		if (_region.isValid()) {
+			_region.accumulate(r);
+		} else {
+			_region = r;
+		}
+	}
+	_regionDirty = false;
+	return _region;
+}
+
+} // namespace voxel
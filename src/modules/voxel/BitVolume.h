@@ -0,0 +1,209 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/GLM.h"
+#include "core/collection/FlatHashMap.h"
+#include "voxel/Morton.h"
+#include "voxel/Region.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace voxel {
+
+/**
+ * @brief Sparse bit volume that stores one bit per voxel in bricks of 8x8x8 voxels
+ *
+ * Only bricks that have at least one bit set are stored. Membership tests are one hash lookup, the set operations
+ * work on whole 64 bit words of a brick. This is e.g. used to store the voxel selection.
+ */
+class BitVolume {
+public:
+	static constexpr int BrickBits = 3;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickMask = BrickSize - 1;
+
+private:
+	/**
+	 * @brief One word per z slice - the bit index is @c y*8+x
+	 */
+	struct Brick {
+		uint64_t bits[BrickSize]{};
+
+		bool empty() const {
+			for (int i = 0; i < BrickSize; ++i) {
+				if (bits[i] != 0u) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+	struct MortonHasher {
+		inline size_t operator()(const glm::ivec3 &pos) const {
+			return (size_t)mortonIndex64(pos.x, pos.y, pos.z);
+		}
+	};
+	core::FlatHashMap<glm::ivec3, Brick, MortonHasher> _bricks;
+	mutable Region _region = Region::InvalidRegion;
+	mutable bool _regionDirty = false;
+
+	static inline glm::ivec3 brickPos(int x, int y, int z) {
+		return {x >> BrickBits, y >> BrickBits, z >> BrickBits};
+	}
+
+	static inline uint64_t bitMask(int x, int y) {
+		return UINT64_C(1) << (((y & BrickMask) << BrickBits) + (x & BrickMask));
+	}
+
+	static CORE_FORCE_INLINE int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+		unsigned long idx;
+		_BitScanForward64(&idx, bits);
+		return (int)idx;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	/**
+	 * @return The bits of a z slice of a brick that are inside the given local x and y ranges
+	 */
+	static uint64_t sliceMask(int x0, int x1, int y0, int y1);
+
+public:
+	BitVolume() = default;
+
+	[[nodiscard]] bool hasValue(int x, int y, int z) const;
+	[[nodiscard]] inline bool hasValue(const glm::ivec3 &pos) const {
+		return hasValue(pos.x, pos.y, pos.z);
+	}
+
+	void setValue(int x, int y, int z, bool value);
+	inline void setValue(const glm::ivec3 &pos, bool value) {
+		setValue(pos.x, pos.y, pos.z, value);
+	}
+
+	/**
+	 * @brief Set or clear all bits inside the given region
+	 */
+	void setRegion(const Region &region, bool value);
+	/**
+	 * @brief Flip all bits inside the given region
+	 */
+	void invert(const Region &region);
+
+	/**
+	 * @brief Set all bits that are set in the other volume
+	 */
+	void unite(const BitVolume &other);
+	/**
+	 * @brief Only keep the bits that are also set in the other volume
+	 */
+	void intersect(const BitVolume &other);
+	/**
+	 * @brief Clear all bits that are set in the other volume
+	 */
+	void subtract(const BitVolume &other);
+
+	void clear();
+
+	[[nodiscard]] inline bool empty() const {
+		return _bricks.empty();
+	}
+
+	/**
+	 * @return The amount of set bits
+	 */
+	[[nodiscard]] size_t count() const;
+
+	/**
+	 * @return The amount of allocated bricks
+	 */
+	[[nodiscard]] inline size_t bricks() const {
+		return _bricks.size();
+	}
+
+	/**
+	 * @return The bounding region of all set bits or @c Region::InvalidRegion if nothing is set
+	 */
+	[[nodiscard]] const Region &region() const;
+
+	/**
+	 * @brief Calls the functor with the x, y and z coordinates of every set bit
+	 */
+	template<class FUNC>
+	void visit(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			const glm::ivec3 base = iter->key * BrickSize;
+			const Brick &brick = iter->value;
+			for (int z = 0; z < BrickSize; ++z) {
+				uint64_t bits = brick.bits[z];
+				while (bits != 0u) {
+					const int idx = lowestBit(bits);
+					bits &= bits - 1u;
+					func(base.x + (idx & BrickMask), base.y + (idx >> BrickBits), base.z + z);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Calls the functor with the bounding region of the set bits of every allocated brick
+	 */
+	template<class FUNC>
+	void visitBricks(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			func(brickRegion(iter->key, iter->value));
+		}
+	}
+
+	/**
+	 * @brief Calls the functor with disjoint boxes that exactly cover the set bits
+	 *
+	 * The boxes are greedily grown along x, y and z inside of each brick - they never span more than one brick.
+	 */
+	template<class FUNC>
+	void visitBoxes(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			const glm::ivec3 base = iter->key * BrickSize;
+			Brick brick = iter->value;
+			for (int z0 = 0; z0 < BrickSize; ++z0) {
+				while (brick.bits[z0] != 0u) {
+					const int idx = lowestBit(brick.bits[z0]);
+					const int x0 = idx & BrickMask;
+					const int y0 = idx >> BrickBits;
+					const uint64_t row = (brick.bits[z0] >> (y0 << BrickBits)) & 0xFFu;
+					// the row bits above x0 are shifted out - the inverted value always has a bit set
+					const int x1 = x0 + lowestBit(~(row >> x0)) - 1;
+					int y1 = y0;
+					while (y1 + 1 < BrickSize) {
+						const uint64_t rowMask = sliceMask(x0, x1, y1 + 1, y1 + 1);
+						if ((brick.bits[z0] & rowMask) != rowMask) {
+							break;
+						}
+						++y1;
+					}
+					const uint64_t mask = sliceMask(x0, x1, y0, y1);
+					int z1 = z0;
+					while (z1 + 1 < BrickSize && (brick.bits[z1 + 1] & mask) == mask) {
+						++z1;
+					}
+					for (int z = z0; z <= z1; ++z) {
+						brick.bits[z] &= ~mask;
+					}
+					func(Region(base.x + x0, base.y + y0, base.z + z0, base.x + x1, base.y + y1, base.z + z1));
+				}
+			}
+		}
+	}
+
+private:
+	static Region brickRegion(const glm::ivec3 &brickPos, const Brick &brick);
+};
+
+} // namespace voxel
@@ -57,6 +57,7 @@ Mesh &Mesh::operator=(const Mesh &other) {
 	if (&other == this) {
 		return *this;
 	}
+	_sorter.reset();
 	_vecIndices = other._vecIndices;
 	_normals = other._normals;
 	_vecVertices = other._vecVertices;
@@ -74,6 +75,7 @@ Mesh &Mesh::operator=(const Mesh &other) {
 }
 
 Mesh &Mesh::operator=(Mesh &&other) noexcept {
+	_sorter.reset();
 	_vecIndices = core::move(other._vecIndices);
 	_normals = core::move(other._normals);
 	_vecVertices = core::move(other._vecVertices);
@@ -104,10 +106,12 @@ const VertexArray &Mesh::getVertexVector() const {
 }
 
 IndexArray &Mesh::getIndexVector() {
+	_sorter.reset();
 	return _vecIndices;
 }
 
 VertexArray &Mesh::getVertexVector() {
+	_sorter.reset();
 	return _vecVertices;
 }
 
@@ -148,6 +152,7 @@ void Mesh::setOffset(const glm::ivec3 &offset) {
 }
 
 void Mesh::clear() {
+	_sorter.reset();
 	_vecVertices.clear();
 	_vecIndices.clear();
 	_offset = glm::ivec3(0);
@@ -172,6 +177,7 @@ void Mesh::addTriangle(IndexType index0, IndexType index1, IndexType index2) {
 			(int)_vecIndices.size(), (int)_vecIndices.capacity());
 	}
 
+	_sorter.reset();
 	_vecIndices.push_back(index0);
 	_vecIndices.push_back(index1);
 	_vecIndices.push_back(index2);
@@ -188,6 +194,7 @@ IndexType Mesh::addVertex(const VoxelVertex &vertex) {
 			(int)_vecVertices.size(), (int)_vecVertices.capacity());
 	}
 
+	_sorter.reset();
 	_vecVertices.push_back(vertex);
 	return (IndexType)_vecVertices.size() - 1;
 }
@@ -201,6 +208,7 @@ void Mesh::setNormal(IndexType index, const glm::vec3 &normal) {
 }
 
 void Mesh::removeUnusedVertices() {
+	_sorter.reset();
 	const size_t vertices = _vecVertices.size();
 	const size_t indices = _vecIndices.size();
 	core::DynamicArray<bool> isVertexUsed(vertices);
@@ -291,212 +299,13 @@ bool Mesh::operator<(const Mesh &rhs) const {
 	return glm::all(glm::lessThan(getOffset(), rhs.getOffset()));
 }
 
-struct Triangle {
-	const VoxelVertex *v0;
-	const VoxelVertex *v1;
-	const VoxelVertex *v2;
-	voxel::IndexType *i0;
-	voxel::IndexType *i1;
-	voxel::IndexType *i2;
-	voxel::IndexType vi0;
-	voxel::IndexType vi1;
-	voxel::IndexType vi2;
-
-	inline glm::vec3 center() const {
-		return (v0->position + v1->position + v2->position) / 3.0f;
-	}
-
-	Triangle(const VoxelVertex *_v0, const VoxelVertex *_v1, const VoxelVertex *_v2, voxel::IndexType *_i0,
-			 voxel::IndexType *_i1, voxel::IndexType *_i2)
-		: v0(_v0), v1(_v1), v2(_v2), i0(_i0), i1(_i1), i2(_i2) {
-		if (_i0 != nullptr) {
-			vi0 = *_i0;
-			vi1 = *_i1;
-			vi2 = *_i2;
-		} else {
-			vi0 = -1;
-			vi1 = -1;
-			vi2 = -1;
-		}
-	}
-
-	Triangle(const Triangle &rhs)
-		: v0(rhs.v0), v1(rhs.v1), v2(rhs.v2), i0(rhs.i0), i1(rhs.i1), i2(rhs.i2), vi0(rhs.vi0), vi1(rhs.vi1),
-		  vi2(rhs.vi2) {
-	}
-
-	Triangle(Triangle &&rhs) noexcept
-		: v0(rhs.v0), v1(rhs.v1), v2(rhs.v2), i0(rhs.i0), i1(rhs.i1), i2(rhs.i2), vi0(rhs.vi0), vi1(rhs.vi1),
-		  vi2(rhs.vi2) {
-	}
-
-	Triangle &operator=(const Triangle &rhs) {
-		if (this == &rhs) {
-			return *this;
-		}
-		v0 = rhs.v0;
-		v1 = rhs.v1;
-		v2 = rhs.v2;
-		vi0 = rhs.vi0;
-		vi1 = rhs.vi1;
-		vi2 = rhs.vi2;
-		if (rhs.v0 != nullptr) {
-			*i0 = vi0;
-			*i1 = vi1;
-			*i2 = vi2;
-		} else {
-			i0 = nullptr;
-			i1 = nullptr;
-			i2 = nullptr;
-		}
-		return *this;
-	}
-
-	Triangle &operator=(Triangle &&rhs) noexcept {
-		if (this == &rhs) {
-			return *this;
-		}
-		v0 = rhs.v0;
-		v1 = rhs.v1;
-		v2 = rhs.v2;
-		vi0 = rhs.vi0;
-		vi1 = rhs.vi1;
-		vi2 = rhs.vi2;
-		if (rhs.i0 != nullptr) {
-			*i0 = vi0;
-			*i1 = vi1;
-			*i2 = vi2;
-		} else {
-			i0 = nullptr;
-			i1 = nullptr;
-			i2 = nullptr;
-		}
-		return *this;
-	}
-};
-
-struct TriangleView {
-	TriangleView(const VertexArray &vecVertices, IndexArray &vecIndices)
-		: _vecVertices(vecVertices), _vecIndices(vecIndices) {
-	}
-	const VertexArray &_vecVertices;
-	IndexArray &_vecIndices;
-
-	int size() const {
-		return (int)_vecIndices.size() / 3;
-	}
-
-	class iterator {
-	private:
-		Triangle _tri{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
-		const VertexArray *_vecVertices;
-		IndexArray *_vecIndices;
-		int _idx;
-
-		void updateTri() {
-			if (_idx < 0 || _idx >= (int)_vecIndices->size() / 3) {
-				_tri = Triangle(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
-				return;
-			}
-			_tri.i0 = &(*_vecIndices)[(_idx * 3) + 0];
-			_tri.i1 = &(*_vecIndices)[(_idx * 3) + 1];
-			_tri.i2 = &(*_vecIndices)[(_idx * 3) + 2];
-			_tri.v0 = &(*_vecVertices)[*_tri.i0];
-			_tri.v1 = &(*_vecVertices)[*_tri.i1];
-			_tri.v2 = &(*_vecVertices)[*_tri.i2];
-			_tri.vi0 = *_tri.i0;
-			_tri.vi1 = *_tri.i1;
-			_tri.vi2 = *_tri.i2;
-		}
-
-	public:
-		iterator(const VertexArray *vecVertices, IndexArray *vecIndices, int idx)
-			: _vecVertices(vecVertices), _vecIndices(vecIndices), _idx(idx) {
-			updateTri();
-		}
-
-		iterator(iterator &&i) noexcept : _vecVertices(i._vecVertices), _vecIndices(i._vecIndices), _idx(i._idx) {
-			i._vecVertices = nullptr;
-			i._vecIndices = nullptr;
-			i._idx = -1;
-			i.updateTri();
-			updateTri();
-		}
-
-		iterator(const iterator &i) : _vecVertices(i._vecVertices), _vecIndices(i._vecIndices), _idx(i._idx) {
-			updateTri();
-		}
-
-		iterator operator=(const iterator &i) {
-			if (this == &i) {
-				return *this;
-			}
-			_idx = i._idx;
-			updateTri();
-			return *this;
-		}
-
-		iterator operator=(iterator &&i) noexcept {
-			if (this == &i) {
-				return *this;
-			}
-			_idx = i._idx;
-			i._vecVertices = nullptr;
-			i._vecIndices = nullptr;
-			i._idx = -1;
-			i.updateTri();
-			updateTri();
-			return *this;
-		}
-
-		Triangle &operator*() {
-			return _tri;
-		}
-
-		const Triangle &operator*() const {
-			return _tri;
-		}
-
-		bool operator==(const iterator &rhs) const {
-			return _idx == rhs._idx;
-		}
-
-		bool operator!=(const iterator &rhs) const {
-			return _idx != rhs._idx;
-		}
-
-		iterator &operator--() {
-			--_idx;
-			updateTri();
-			return *this;
-		}
-
-		iterator &operator++() {
-			++_idx;
-			updateTri();
-			return *this;
-		}
-	};
-
-	iterator begin() {
-		return iterator(&_vecVertices, &_vecIndices, 0);
-	}
-
-	iterator end() {
-		return iterator(&_vecVertices, &_vecIndices, size());
-	}
-};
-
 bool Mesh::sort(const glm::vec3 &cameraPos) {
 	if (glm::all(glm::epsilonEqual(cameraPos, _lastCameraPos, glm::vec3(0.5f)))) {
 		return false;
 	}
 	_lastCameraPos = cameraPos;
 	core_trace_scoped(MeshSort);
-	TriangleView triView(_vecVertices, _vecIndices);
-	core::sort(triView.begin(), triView.end(), [&cameraPos](const Triangle &lhs, const Triangle &rhs) {
-		return glm::distance(lhs.center(), cameraPos) < glm::distance(rhs.center(), cameraPos);
-	});
+	_sorter.sort(_vecVertices.data(), _vecIndices.data(), _vecIndices.size(), cameraPos);
 	return true;
 }
 
@@ -504,6 +313,7 @@ void Mesh::optimize() {
 	if (isEmpty()) {
 		return;
 	}
+	_sorter.reset();
 	core_trace_scoped(MeshOptimize);
 	meshopt_optimizeVertexCache(_vecIndices.data(), _vecIndices.data(), _vecIndices.size(), _vecVertices.size());
 	meshopt_optimizeOverdraw(_vecIndices.data(), _vecIndices.data(), _vecIndices.size(), &_vecVertices.data()->position.x, _vecVertices.size(), sizeof(VoxelVertex), 1.05f);
@@ -516,4 +326,45 @@ void Mesh::optimize() {
 	_vecIndices.resize(newSize);
 }
 
+float Mesh::simplify(Mesh &target, float ratio, float maxError) const {
+	core_assert(&target != this);
+	target.clear();
+	target._normals.clear();
+	target._offset = _offset;
+	if (isEmpty()) {
+		return 0.0f;
+	}
+	core_trace_scoped(MeshSimplify);
+	const size_t indexCount = _vecIndices.size();
+	const size_t vertexCount = _vecVertices.size();
+	const float *positions = &_vecVertices.data()->position.x;
+	const size_t targetIndexCount = (size_t)((float)indexCount * ratio) / 3 * 3;
+
+	IndexArray indices;
+	indices.resize(indexCount);
+	float relativeError = 0.0f;
+	const size_t newIndexCount =
+		meshopt_simplify(indices.data(), _vecIndices.data(), indexCount, positions, vertexCount, sizeof(VoxelVertex),
+						 targetIndexCount, maxError, 0, &relativeError);
+	indices.resize(newIndexCount);
+
+	// only keep the vertices that are still referenced
+	core::DynamicArray<unsigned int> remap;
+	remap.resize(vertexCount);
+	const size_t newVertexCount = meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), newIndexCount, vertexCount);
+	target._vecVertices.resize(newVertexCount);
+	meshopt_remapVertexBuffer(target._vecVertices.data(), _vecVertices.data(), vertexCount, sizeof(VoxelVertex),
+							  remap.data());
+	if (!_normals.empty()) {
+		target._normals.resize(newVertexCount);
+		meshopt_remapVertexBuffer(target._normals.data(), _normals.data(), vertexCount, sizeof(glm::vec3),
+								  remap.data());
+	}
+	target._vecIndices.resize(newIndexCount);
+	meshopt_remapIndexBuffer(target._vecIndices.data(), indices.data(), newIndexCount, remap.data());
+	target.calculateBounds();
+	Log::debug("simplified mesh from %i to %i indices", (int)indexCount, (int)newIndexCount);
+	return relativeError * meshopt_simplifyScale(positions, vertexCount, sizeof(VoxelVertex));
+}
+
 } // namespace voxel
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "TransparencySorter.h"
 #include "VoxelVertex.h"
 #include "core/collection/DynamicArray.h"
 
@@ -44,6 +45,7 @@ public:
 
 	// e.g. for transparency
 	// returns true if sorting was needed
+	// the triangle centers are cached - they are reset by the functions that modify the mesh
 	bool sort(const glm::vec3 &cameraPos);
 
 	const glm::ivec3& getOffset() const;
@@ -54,6 +56,13 @@ public:
 	void setNormal(IndexType index, const glm::vec3 &normal);
 
 	void optimize();
+	/**
+	 * @brief Writes a simplified version of this mesh into the given target mesh
+	 * @param[in] ratio The amount of indices that should remain - in the range [0.0-1.0]
+	 * @param[in] maxError The max deviation of the simplified surface relative to the mesh extents
+	 * @return The geometric error of the simplified mesh in mesh units
+	 */
+	float simplify(Mesh &target, float ratio, float maxError) const;
 
 	void clear();
 	bool isEmpty() const;
@@ -78,6 +87,7 @@ private:
 	size_t _compressedIndexSize = 0u;
 	glm::ivec3 _offset{0};
 	glm::vec3 _lastCameraPos{0.0f};
+	TransparencySorter _sorter;
 	bool _mayGetResized;
 };
 
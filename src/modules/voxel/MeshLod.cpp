@@ -0,0 +1,66 @@
+/**
+ * @file
+ */
+
+#include "MeshLod.h"
+#include "core/Log.h"
+#include "core/Trace.h"
+
+namespace voxel {
+
+void MeshLodChain::clear() {
+	_levels.clear();
+}
+
+void MeshLodChain::addLevel(ChunkMesh &&mesh, float error) {
+	if (!_levels.empty() && _levels.back().error > error) {
+		error = _levels.back().error;
+	}
+	_levels.emplace_back();
+	MeshLod &lod = _levels.back();
+	lod.mesh = core::move(mesh);
+	lod.error = error;
+}
+
+bool MeshLodChain::addSimplifiedLevel(float ratio, float maxError) {
+	if (_levels.empty()) {
+		return false;
+	}
+	core_trace_scoped(MeshLodSimplify);
+	ChunkMesh simplified(0, 0, true);
+	const MeshLod &last = _levels.back();
+	const float lastError = last.error;
+	float error = 0.0f;
+	size_t lastIndices = 0u;
+	size_t indices = 0u;
+	for (int i = 0; i < ChunkMesh::Meshes; ++i) {
+		const float meshError = last.mesh.mesh[i].simplify(simplified.mesh[i], ratio, maxError);
+		if (meshError > error) {
+			error = meshError;
+		}
+		lastIndices += last.mesh.mesh[i].getNoOfIndices();
+		indices += simplified.mesh[i].getNoOfIndices();
+	}
+	// a level that doesn't remove a noticeable amount of triangles is not worth the memory
+	if ((float)indices > (float)lastIndices * 0.9f) {
+		Log::debug("Could not simplify the mesh any further (%i of %i indices)", (int)indices, (int)lastIndices);
+		return false;
+	}
+	// the error of the simplification is relative to the previous level
+	addLevel(core::move(simplified), lastError + error);
+	return true;
+}
+
+int MeshLodChain::select(float distance, float maxErrorPerDistance) const {
+	const float acceptedError = distance * maxErrorPerDistance;
+	int selected = _levels.empty() ? -1 : 0;
+	for (int i = 1; i < (int)_levels.size(); ++i) {
+		if (_levels[i].error > acceptedError) {
+			break;
+		}
+		selected = i;
+	}
+	return selected;
+}
+
+} // namespace voxel
@@ -0,0 +1,77 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "voxel/ChunkMesh.h"
+
+namespace voxel {
+
+/**
+ * @brief One level of detail of a chunk mesh
+ */
+struct MeshLod {
+	ChunkMesh mesh{0, 0, true};
+	// the max geometric deviation of this level to the full detail mesh in voxels
+	float error = 0.0f;
+};
+
+/**
+ * @brief A chain of meshes with decreasing detail - level 0 is the full detail mesh.
+ *
+ * The mid levels are usually created by simplifying the triangles of the previous level, the coarse levels by
+ * extracting the surface of a downsampled volume (see voxelutil::createLodChain()).
+ */
+class MeshLodChain {
+private:
+	core::DynamicArray<MeshLod> _levels;
+
+public:
+	void clear();
+	/**
+	 * @param[in] error The geometric error of this level in voxels - this is clamped to be at least the error of
+	 * the previous level.
+	 */
+	void addLevel(ChunkMesh &&mesh, float error);
+	/**
+	 * @brief Adds a new level by simplifying the triangles of the last level
+	 * @param[in] ratio The amount of indices that should remain in relation to the last level
+	 * @param[in] maxError The max deviation relative to the mesh extents
+	 * @return @c false if there is no level yet or if the simplification didn't remove enough triangles
+	 */
+	bool addSimplifiedLevel(float ratio, float maxError = 0.05f);
+	/**
+	 * @brief Select the coarsest level whose geometric error is still acceptable for the given distance
+	 * @param[in] distance The distance of the mesh to the camera
+	 * @param[in] maxErrorPerDistance The accepted geometric error per distance unit. This is the tangent of the
+	 * accepted angular error and can be derived from the field of view and the screen height: e.g. one pixel is
+	 * @code 2 * tan(fov / 2) / screenHeight @endcode
+	 * @return The index of the level or @c -1 if the chain is empty
+	 */
+	int select(float distance, float maxErrorPerDistance) const;
+
+	int size() const;
+	bool empty() const;
+	const ChunkMesh &level(int idx) const;
+	float error(int idx) const;
+};
+
+inline int MeshLodChain::size() const {
+	return (int)_levels.size();
+}
+
+inline bool MeshLodChain::empty() const {
+	return _levels.empty();
+}
+
+inline const ChunkMesh &MeshLodChain::level(int idx) const {
+	return _levels[idx].mesh;
+}
+
+inline float MeshLodChain::error(int idx) const {
+	return _levels[idx].error;
+}
+
+} // namespace voxel
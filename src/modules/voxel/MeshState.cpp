@@ -4,11 +4,13 @@
 
 #include "MeshState.h"
 #include "app/App.h"
+#include "core/Algorithm.h"
 #include "core/Log.h"
 #include "palette/NormalPalette.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Mesh.h"
 #include "voxel/SurfaceExtractor.h"
+#include <glm/geometric.hpp>
 
 namespace voxel {
 
@@ -54,6 +56,12 @@ glm::vec3 MeshState::centerPos(int idx, int x, int y, int z) const {
 	return _volumeData[idx].centerPos(x, y, z);
 }
 
+int MeshState::selectLod(int idx, const MeshLodChain &chain, const glm::vec3 &cameraPos,
+						 float maxErrorPerDistance) const {
+	const float distance = glm::distance(centerPos(idx), cameraPos);
+	return chain.select(distance, maxErrorPerDistance);
+}
+
 const glm::mat4 &MeshState::model(int idx) const {
 	return _volumeData[idx]._model;
 }
@@ -93,6 +101,9 @@ void MeshState::clear() {
 		}
 		_meshes[i].clear();
 	}
+	for (int i = 0; i < MAX_VOLUMES; ++i) {
+		_volumeData[i]._dirtyChunks.clear();
+	}
 }
 
 void MeshState::addOrReplaceMeshes(MeshState::ExtractionCtx &result, MeshType type) {
@@ -115,11 +126,26 @@ int MeshState::pop() {
 		}
 		addOrReplaceMeshes(result, MeshType_Opaque);
 		addOrReplaceMeshes(result, MeshType_Transparency);
+		_volumeData[result.idx]._dirtyChunks.push_back(result.mins);
 		return result.idx;
 	}
 	return -1;
 }
 
+void MeshState::popDirtyChunks(int idx, core::DynamicArray<glm::ivec3> &chunks) {
+	chunks.clear();
+	if (idx < 0 || idx >= MAX_VOLUMES) {
+		return;
+	}
+	core::DynamicArray<glm::ivec3> &dirtyChunks = _volumeData[idx]._dirtyChunks;
+	for (const glm::ivec3 &pos : dirtyChunks) {
+		if (core::find(chunks.begin(), chunks.end(), pos) == chunks.end()) {
+			chunks.push_back(pos);
+		}
+	}
+	dirtyChunks.clear();
+}
+
 bool MeshState::deleteMeshes(const glm::ivec3 &pos, int idx) {
 	bool d = false;
 	for (int i = 0; i < MeshType_Max; ++i) {
@@ -133,6 +159,9 @@ bool MeshState::deleteMeshes(const glm::ivec3 &pos, int idx) {
 			d = true;
 		}
 	}
+	if (d) {
+		_volumeData[idx]._dirtyChunks.push_back(pos);
+	}
 	return d;
 }
 
@@ -148,6 +177,7 @@ bool MeshState::deleteMeshes(int idx) {
 			d = true;
 		}
 	}
+	_volumeData[idx]._dirtyChunks.clear();
 	return d;
 }
 
@@ -17,6 +17,7 @@
 #include "video/Types.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/Mesh.h"
+#include "voxel/MeshLod.h"
 
 #include "core/GLM.h"
 #include "voxel/RawVolume.h"
@@ -55,6 +56,8 @@ private:
 		glm::vec3 _pivot{0.0f};
 		glm::vec3 _mins{0.0f};
 		glm::vec3 _maxs{0.0f};
+		// mins of the chunk meshes that were replaced or deleted since the last popDirtyChunks() call
+		core::DynamicArray<glm::ivec3> _dirtyChunks;
 		/**
 		 * @brief Applies the model matrix
 		 * @note Used for sorting (for transparency)
@@ -120,6 +123,12 @@ public:
 	 * it available to others
 	 */
 	int pop();
+	/**
+	 * @brief Hands out the mins of the chunk meshes that were changed for the given volume since the last call
+	 * @note This allows the consumer to only update the changed chunks instead of the whole volume
+	 * @sa pop()
+	 */
+	void popDirtyChunks(int idx, core::DynamicArray<glm::ivec3> &chunks);
 	void count(MeshType meshType, int idx, size_t &vertCount, size_t &normalsCount, size_t &indCount) const;
 	const palette::Palette &palette(int idx) const;
 	const palette::NormalPalette &normalsPalette(int idx) const;
@@ -153,6 +162,11 @@ public:
 	 * @brief Center position of a voxel having the pivot and model matrix applied
 	 */
 	glm::vec3 centerPos(int idx, int x, int y, int z) const;
+	/**
+	 * @brief Select the level of detail for the given volume by the distance of its center to the camera
+	 * @sa MeshLodChain::select()
+	 */
+	int selectLod(int idx, const MeshLodChain &chain, const glm::vec3 &cameraPos, float maxErrorPerDistance) const;
 	const glm::vec3 &pivot(int idx) const;
 	const glm::mat4 &model(int idx) const;
 	void setModel(int idx, const glm::mat4 &model);
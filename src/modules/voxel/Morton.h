@@ -168,12 +168,32 @@ inline uint8_t mortonDecode(uint32_t m, const uint8_t *LUT) {
 	return (uint8_t)a;
 }
 
+// spread the lower 21 bits of the given value to every third bit
+inline uint64_t mortonSplitBy3(uint32_t a) {
+	uint64_t x = a & 0x1fffff;
+	x = (x | x << 32) & UINT64_C(0x1f00000000ffff);
+	x = (x | x << 16) & UINT64_C(0x1f0000ff0000ff);
+	x = (x | x << 8) & UINT64_C(0x100f00f00f00f00f);
+	x = (x | x << 4) & UINT64_C(0x10c30c30c30c30c3);
+	x = (x | x << 2) & UINT64_C(0x1249249249249249);
+	return x;
+}
+
 } // namespace priv
 
 inline uint32_t mortonIndex(uint8_t uXPos, uint8_t uYPos, uint8_t uZPos) {
 	return priv::morton256_x[uXPos] | priv::morton256_y[uYPos] | priv::morton256_z[uZPos];
 }
 
+/**
+ * @brief 64 bit morton code for 21 bits per axis. Negative coordinates are wrapped into the 21 bit range - this
+ * is fine for hashing, but the code can't get decoded into the original values in that case.
+ */
+inline uint64_t mortonIndex64(int32_t x, int32_t y, int32_t z) {
+	return priv::mortonSplitBy3((uint32_t)x) | (priv::mortonSplitBy3((uint32_t)y) << 1) |
+		   (priv::mortonSplitBy3((uint32_t)z) << 2);
+}
+
 inline bool mortonIndexToCoord(uint32_t index, uint8_t &x, uint8_t &y, uint8_t &z) {
 	x = priv::mortonDecode(index, priv::morton256_decode_x);
 	y = priv::mortonDecode(index, priv::morton256_decode_y);
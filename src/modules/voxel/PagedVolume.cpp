@@ -0,0 +1,346 @@
+/**
+ * @file
+ */
+
+#include "PagedVolume.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+
+namespace voxel {
+
+/**
+ * @note @c Voxel::operator== only compares the material - and air voxels are equal regardless of their color or
+ * normal
+ */
+static inline bool isSameVoxel(const Voxel &a, const Voxel &b) {
+	if (voxel::isAir(a.getMaterial()) && voxel::isAir(b.getMaterial())) {
+		return true;
+	}
+	return a.isSame(b) && a.getFlags() == b.getFlags();
+}
+
+PagedVolume::Brick::Brick(const Voxel &uniform) : _uniform(uniform) {
+}
+
+PagedVolume::Brick::Brick(const Brick &copy) : _uniform(copy._uniform) {
+	if (copy._data != nullptr) {
+		_data = (Voxel *)core_malloc(BrickVoxels * sizeof(Voxel));
+		core_memcpy((void *)_data, (const void *)copy._data, BrickVoxels * sizeof(Voxel));
+	}
+}
+
+PagedVolume::Brick::~Brick() {
+	core_free(_data);
+	_data = nullptr;
+}
+
+void PagedVolume::Brick::materialize() {
+	if (_data != nullptr) {
+		return;
+	}
+	_data = (Voxel *)core_malloc(BrickVoxels * sizeof(Voxel));
+	for (int i = 0; i < BrickVoxels; ++i) {
+		_data[i] = _uniform;
+	}
+}
+
+bool PagedVolume::Brick::compact() {
+	if (_data == nullptr) {
+		return false;
+	}
+	const Voxel &first = _data[0];
+	for (int i = 1; i < BrickVoxels; ++i) {
+		if (!isSameVoxel(_data[i], first)) {
+			return false;
+		}
+	}
+	_uniform = first;
+	core_free(_data);
+	_data = nullptr;
+	return true;
+}
+
+void PagedVolume::Brick::set(int idx, const Voxel &voxel) {
+	if (_data == nullptr) {
+		if (isSameVoxel(_uniform, voxel)) {
+			return;
+		}
+		materialize();
+	}
+	_data[idx] = voxel;
+}
+
+PagedVolume::PagedVolume(const Region &region) : _region(region) {
+	initialise(region);
+}
+
+PagedVolume::PagedVolume(const PagedVolume &copy)
+	: _region(copy._region), _borderVoxel(copy._borderVoxel), _bricksX(copy._bricksX), _bricksY(copy._bricksY),
+	  _bricksZ(copy._bricksZ), _bricks(copy._bricks) {
+}
+
+PagedVolume::PagedVolume(PagedVolume &&move) noexcept
+	: _region(move._region), _borderVoxel(move._borderVoxel), _bricksX(move._bricksX), _bricksY(move._bricksY),
+	  _bricksZ(move._bricksZ), _bricks(core::move(move._bricks)) {
+	move._bricksX = move._bricksY = move._bricksZ = 0;
+}
+
+PagedVolume::~PagedVolume() {
+	_bricks.release();
+}
+
+PagedVolume &PagedVolume::operator=(const PagedVolume &copy) {
+	if (&copy == this) {
+		return *this;
+	}
+	_region = copy._region;
+	_borderVoxel = copy._borderVoxel;
+	_bricksX = copy._bricksX;
+	_bricksY = copy._bricksY;
+	_bricksZ = copy._bricksZ;
+	_bricks = copy._bricks;
+	return *this;
+}
+
+PagedVolume &PagedVolume::operator=(PagedVolume &&move) noexcept {
+	_region = move._region;
+	_borderVoxel = move._borderVoxel;
+	_bricksX = move._bricksX;
+	_bricksY = move._bricksY;
+	_bricksZ = move._bricksZ;
+	_bricks = core::move(move._bricks);
+	move._bricksX = move._bricksY = move._bricksZ = 0;
+	return *this;
+}
+
+void PagedVolume::initialise(const Region &regValidRegion) {
+	_region = regValidRegion;
+	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
+	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
+	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+	_bricksX = (width() + BrickMask) >> BrickBits;
+	_bricksY = (height() + BrickMask) >> BrickBits;
+	_bricksZ = (depth() + BrickMask) >> BrickBits;
+	_bricks.release();
+	_bricks.resize((size_t)_bricksX * _bricksY * _bricksZ);
+}
+
+PagedVolume::Brick *PagedVolume::writableBrick(int idx) {
+	BrickPtr &brick = _bricks[idx];
+	if (!brick) {
+		brick = core::make_shared<Brick>(_emptyVoxel);
+	} else if ((int)*brick.refCnt() > 1) {
+		// another volume still references this brick - copy-on-write
+		brick = core::make_shared<Brick>(*brick.get());
+	}
+	return brick.get();
+}
+
+bool PagedVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	if (!_region.containsPoint(x, y, z)) {
+		return false;
+	}
+	const int lx = x - _region.getLowerX();
+	const int ly = y - _region.getLowerY();
+	const int lz = z - _region.getLowerZ();
+	const int idx = brickIndex(lx >> BrickBits, ly >> BrickBits, lz >> BrickBits);
+	const int vidx = voxelIndex(lx & BrickMask, ly & BrickMask, lz & BrickMask);
+	const BrickPtr &brick = _bricks[idx];
+	if (brick) {
+		if (isSameVoxel(brick->voxel(vidx), voxel)) {
+			return true;
+		}
+	} else if (voxel::isAir(voxel.getMaterial())) {
+		return true;
+	}
+	writableBrick(idx)->set(vidx, voxel);
+	return true;
+}
+
+void PagedVolume::clear() {
+	_bricks.fill(BrickPtr());
+}
+
+void PagedVolume::fill(const voxel::Voxel &voxel) {
+	if (voxel::isAir(voxel.getMaterial())) {
+		clear();
+		return;
+	}
+	// all bricks share the same uniform brick - it is copied on the first write
+	_bricks.fill(core::make_shared<Brick>(voxel));
+}
+
+int PagedVolume::compact() {
+	int released = 0;
+	for (BrickPtr &brick : _bricks) {
+		if (!brick || brick->isUniform()) {
+			continue;
+		}
+		if ((int)*brick.refCnt() > 1) {
+			continue;
+		}
+		if (brick->compact()) {
+			++released;
+			if (voxel::isAir(brick->uniform().getMaterial())) {
+				brick = BrickPtr();
+			}
+		}
+	}
+	return released;
+}
+
+int PagedVolume::allocatedBricks() const {
+	int cnt = 0;
+	for (const BrickPtr &brick : _bricks) {
+		if (brick && !brick->isUniform()) {
+			++cnt;
+		}
+	}
+	return cnt;
+}
+
+size_t PagedVolume::memoryUsage() const {
+	return _bricks.bytes() + (size_t)allocatedBricks() * BrickVoxels * sizeof(Voxel);
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume *volume) : _volume(const_cast<PagedVolume *>(volume)) {
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume &volume) : _volume(const_cast<PagedVolume *>(&volume)) {
+}
+
+PagedVolume::Sampler::~Sampler() {
+}
+
+void PagedVolume::Sampler::updateCurrentVoxel() {
+	if (currentPositionValid()) {
+		_currentVoxel = &_volume->voxel(_posInVolume);
+	} else {
+		_currentVoxel = nullptr;
+	}
+}
+
+bool PagedVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	_volume->setVoxel(_posInVolume, voxel);
+	// the brick might have been materialized or copied
+	updateCurrentVoxel();
+	return true;
+}
+
+bool PagedVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+	_posInVolume.x = xPos;
+	_posInVolume.y = yPos;
+	_posInVolume.z = zPos;
+
+	const voxel::Region &region = this->region();
+	_currentPositionInvalid = 0u;
+	if (!region.containsPointInX(xPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	}
+	if (!region.containsPointInY(yPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	}
+	if (!region.containsPointInZ(zPos)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	}
+
+	updateCurrentVoxel();
+	return currentPositionValid();
+}
+
+void PagedVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		movePositiveX(offset);
+		break;
+	case math::Axis::Y:
+		movePositiveY(offset);
+		break;
+	case math::Axis::Z:
+		movePositiveZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::movePositiveX(uint32_t offset) {
+	_posInVolume.x += (int)offset;
+	if (!region().containsPointInX(_posInVolume.x)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+	}
+	updateCurrentVoxel();
+}
+
+void PagedVolume::Sampler::movePositiveY(uint32_t offset) {
+	_posInVolume.y += (int)offset;
+	if (!region().containsPointInY(_posInVolume.y)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+	}
+	updateCurrentVoxel();
+}
+
+void PagedVolume::Sampler::movePositiveZ(uint32_t offset) {
+	_posInVolume.z += (int)offset;
+	if (!region().containsPointInZ(_posInVolume.z)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+	}
+	updateCurrentVoxel();
+}
+
+void PagedVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		moveNegativeX(offset);
+		break;
+	case math::Axis::Y:
+		moveNegativeY(offset);
+		break;
+	case math::Axis::Z:
+		moveNegativeZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::moveNegativeX(uint32_t offset) {
+	_posInVolume.x -= (int)offset;
+	if (!region().containsPointInX(_posInVolume.x)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDX;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+	}
+	updateCurrentVoxel();
+}
+
+void PagedVolume::Sampler::moveNegativeY(uint32_t offset) {
+	_posInVolume.y -= (int)offset;
+	if (!region().containsPointInY(_posInVolume.y)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDY;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+	}
+	updateCurrentVoxel();
+}
+
+void PagedVolume::Sampler::moveNegativeZ(uint32_t offset) {
+	_posInVolume.z -= (int)offset;
+	if (!region().containsPointInZ(_posInVolume.z)) {
+		_currentPositionInvalid |= SAMPLER_INVALIDZ;
+	} else {
+		_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+	}
+	updateCurrentVoxel();
+}
+
+} // namespace voxel
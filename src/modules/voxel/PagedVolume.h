@@ -0,0 +1,453 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/SharedPtr.h"
+#include "core/collection/DynamicArray.h"
+#include "math/Axis.h"
+#include "voxelutil/VolumeVisitor.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+/**
+ * Volume implementation which splits the region into fixed size bricks. Bricks that are completely filled with the
+ * same voxel don't allocate any voxel memory, and bricks are shared between copies of a volume until one of the
+ * copies modifies them (copy-on-write). This keeps the memory consumption proportional to the occupied space instead
+ * of the bounding box.
+ */
+class PagedVolume {
+public:
+	static constexpr int BrickBits = 5;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickMask = BrickSize - 1;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+	/**
+	 * @brief A brick is either uniform (one voxel value for all positions and no allocated memory) or holds
+	 * @c BrickVoxels voxels.
+	 */
+	class Brick {
+	private:
+		Voxel _uniform;
+		Voxel *_data = nullptr;
+
+	public:
+		Brick(const Voxel &uniform);
+		Brick(const Brick &copy);
+		~Brick();
+
+		inline bool isUniform() const {
+			return _data == nullptr;
+		}
+
+		inline const Voxel &uniform() const {
+			return _uniform;
+		}
+
+		inline const Voxel &voxel(int idx) const {
+			if (_data == nullptr) {
+				return _uniform;
+			}
+			return _data[idx];
+		}
+
+		/**
+		 * @brief Switch from the uniform representation into a brick with allocated voxel memory
+		 */
+		void materialize();
+		/**
+		 * @return @c true if all voxels are the same and the memory was released
+		 */
+		bool compact();
+		void set(int idx, const Voxel &voxel);
+	};
+	using BrickPtr = core::SharedPtr<Brick>;
+
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
+		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
+		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
+
+	public:
+		Sampler(const PagedVolume &volume);
+		Sampler(const PagedVolume *volume);
+		virtual ~Sampler();
+
+		const Voxel &voxel() const;
+		const Region &region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		virtual bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX(uint32_t offset = 1);
+		void movePositiveY(uint32_t offset = 1);
+		void movePositiveZ(uint32_t offset = 1);
+		void movePositive(math::Axis axis, uint32_t offset = 1);
+
+		void moveNegativeX(uint32_t offset = 1);
+		void moveNegativeY(uint32_t offset = 1);
+		void moveNegativeZ(uint32_t offset = 1);
+		void moveNegative(math::Axis axis, uint32_t offset = 1);
+
+		const Voxel &peekVoxel1nx1ny1nz() const;
+		const Voxel &peekVoxel1nx1ny0pz() const;
+		const Voxel &peekVoxel1nx1ny1pz() const;
+		const Voxel &peekVoxel1nx0py1nz() const;
+		const Voxel &peekVoxel1nx0py0pz() const;
+		const Voxel &peekVoxel1nx0py1pz() const;
+		const Voxel &peekVoxel1nx1py1nz() const;
+		const Voxel &peekVoxel1nx1py0pz() const;
+		const Voxel &peekVoxel1nx1py1pz() const;
+
+		const Voxel &peekVoxel0px1ny1nz() const;
+		const Voxel &peekVoxel0px1ny0pz() const;
+		const Voxel &peekVoxel0px1ny1pz() const;
+		const Voxel &peekVoxel0px0py1nz() const;
+		const Voxel &peekVoxel0px0py0pz() const;
+		const Voxel &peekVoxel0px0py1pz() const;
+		const Voxel &peekVoxel0px1py1nz() const;
+		const Voxel &peekVoxel0px1py0pz() const;
+		const Voxel &peekVoxel0px1py1pz() const;
+
+		const Voxel &peekVoxel1px1ny1nz() const;
+		const Voxel &peekVoxel1px1ny0pz() const;
+		const Voxel &peekVoxel1px1ny1pz() const;
+		const Voxel &peekVoxel1px0py1nz() const;
+		const Voxel &peekVoxel1px0py0pz() const;
+		const Voxel &peekVoxel1px0py1pz() const;
+		const Voxel &peekVoxel1px1py1nz() const;
+		const Voxel &peekVoxel1px1py0pz() const;
+		const Voxel &peekVoxel1px1py1pz() const;
+
+	protected:
+		void updateCurrentVoxel();
+
+		PagedVolume *_volume;
+
+		// The current position in the volume
+		glm::ivec3 _posInVolume{0, 0, 0};
+
+		/** Other current position information */
+		const Voxel *_currentVoxel = nullptr;
+
+		/** Whether the current position is inside the volume */
+		uint8_t _currentPositionInvalid = 0u;
+	};
+
+	/// Constructor for creating a fixed size volume.
+	PagedVolume(const Region &region);
+	/**
+	 * @note This is cheap - the bricks are shared until one of the volumes is modified
+	 */
+	PagedVolume(const PagedVolume &copy);
+	PagedVolume(PagedVolume &&move) noexcept;
+	~PagedVolume();
+
+	PagedVolume &operator=(const PagedVolume &copy);
+	PagedVolume &operator=(PagedVolume &&move) noexcept;
+
+	/**
+	 * The border value is returned whenever an attempt is made to read a voxel which
+	 * is outside the extents of the volume.
+	 * @return The value used for voxels outside of the volume
+	 */
+	inline const Voxel &borderValue() const {
+		return _borderVoxel;
+	}
+
+	/**
+	 * Sets the value used for voxels which are outside the volume
+	 */
+	void setBorderValue(const Voxel &voxel) {
+		_borderVoxel = voxel;
+	}
+
+	/**
+	 * @return A Region representing the extent of the volume.
+	 */
+	inline const Region &region() const {
+		return _region;
+	}
+
+	/**
+	 * @return The width of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the width is 64.
+	 * @sa height(), getDepth()
+	 */
+	int32_t width() const;
+	/**
+	 * @return The height of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the height is 64.
+	 * @sa width(), getDepth()
+	 */
+	int32_t height() const;
+	/**
+	 * @return The depth of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the depth is 64.
+	 * @sa width(), height()
+	 */
+	int32_t depth() const;
+
+	/**
+	 * Gets a voxel at the position given by @c x,y,z coordinates
+	 */
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+
+	/**
+	 * @param pos The 3D position of the voxel
+	 * @return The voxel value
+	 */
+	inline const Voxel &voxel(const glm::ivec3 &pos) const {
+		return voxel(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * Sets the voxel at the position given by @c x,y,z coordinates
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	/**
+	 * Sets the voxel at the position given by a 3D vector
+	 */
+	inline bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+		return setVoxel(pos.x, pos.y, pos.z, voxel);
+	}
+
+	void clear();
+	void fill(const voxel::Voxel &voxel);
+
+	/**
+	 * @brief Release the memory of all bricks that only contain one voxel value
+	 * @return The amount of bricks that were released
+	 */
+	int compact();
+
+	/**
+	 * @brief Shift the region of the volume by the given coordinates
+	 */
+	void translate(const glm::ivec3 &t) {
+		_region.shift(t.x, t.y, t.z);
+	}
+
+	/**
+	 * @return The amount of bricks the region is split into
+	 */
+	inline int brickCount() const {
+		return (int)_bricks.size();
+	}
+
+	/**
+	 * @return The amount of bricks that hold their own voxel memory
+	 */
+	int allocatedBricks() const;
+
+	/**
+	 * @brief The amount of bytes that are allocated for voxel data. Bricks that are shared between volumes are
+	 * counted for each volume.
+	 */
+	size_t memoryUsage() const;
+
+	template<class Volume>
+	void copyTo(Volume &target) const {
+		auto visitor = [&target](int x, int y, int z, const voxel::Voxel &voxel) { target.setVoxel(x, y, z, voxel); };
+		voxelutil::visitVolume(*this, visitor);
+	}
+
+	template<class Volume>
+	void copyFrom(const Volume &source) {
+		auto visitor = [this](int x, int y, int z, const voxel::Voxel &voxel) { setVoxel(x, y, z, voxel); };
+		voxelutil::visitVolume(source, visitor);
+	}
+
+private:
+	void initialise(const Region &region);
+	inline int brickIndex(int bx, int by, int bz) const {
+		return bx + by * _bricksX + bz * _bricksX * _bricksY;
+	}
+	static inline int voxelIndex(int lx, int ly, int lz) {
+		return lx + (ly << BrickBits) + (lz << (BrickBits * 2));
+	}
+	/**
+	 * @brief Makes sure the brick is not shared with any other volume before it is modified
+	 */
+	Brick *writableBrick(int idx);
+
+	Region _region;
+	Voxel _borderVoxel;
+	int _bricksX = 0;
+	int _bricksY = 0;
+	int _bricksZ = 0;
+	/**
+	 * @note A @c nullptr entry is an air brick
+	 */
+	core::DynamicArray<BrickPtr> _bricks;
+	static const constexpr voxel::Voxel _emptyVoxel{VoxelType::Air, 0, 0, 0};
+};
+
+inline int32_t PagedVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t PagedVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t PagedVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline const Voxel &PagedVolume::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return _borderVoxel;
+	}
+	const int lx = x - _region.getLowerX();
+	const int ly = y - _region.getLowerY();
+	const int lz = z - _region.getLowerZ();
+	const BrickPtr &brick = _bricks[brickIndex(lx >> BrickBits, ly >> BrickBits, lz >> BrickBits)];
+	if (!brick) {
+		return _emptyVoxel;
+	}
+	return brick->voxel(voxelIndex(lx & BrickMask, ly & BrickMask, lz & BrickMask));
+}
+
+inline const Region &PagedVolume::Sampler::region() const {
+	return _volume->region();
+}
+
+inline const glm::ivec3 &PagedVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline const Voxel &PagedVolume::Sampler::voxel() const {
+	if (this->currentPositionValid()) {
+		return *_currentVoxel;
+	}
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline bool PagedVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool PagedVolume::Sampler::setPosition(const glm::ivec3 &v3dNewPos) {
+	return setPosition(v3dNewPos.x, v3dNewPos.y, v3dNewPos.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py0pz() const {
+	return voxel();
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+} // namespace voxel
@@ -24,13 +24,13 @@ bool SparseVolume::setVoxel(const glm::ivec3 &pos, const voxel::Voxel &voxel) {
 const Voxel &SparseVolume::voxel(const glm::ivec3 &pos) const {
 	auto iter = _map.find(pos);
 	if (iter != _map.end()) {
-		return iter->second;
+		return iter->value;
 	}
 	return _emptyVoxel;
 }
 
 bool SparseVolume::hasVoxel(const glm::ivec3 &pos) const {
-	return _map.find(pos) != _map.end();
+	return _map.hasKey(pos);
 }
 
 void SparseVolume::clear() {
@@ -5,8 +5,9 @@
 #pragma once
 
 #include "core/GLM.h"
-#include "core/collection/DynamicMap.h"
+#include "core/collection/FlatHashMap.h"
 #include "math/Axis.h"
+#include "voxel/Morton.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxel {
@@ -17,7 +18,12 @@ namespace voxel {
  */
 class SparseVolume {
 private:
-	core::DynamicMap<glm::ivec3, voxel::Voxel, 1031, glm::hash<glm::ivec3>> _map;
+	struct MortonHasher {
+		inline size_t operator()(const glm::ivec3 &pos) const {
+			return (size_t)mortonIndex64(pos.x, pos.y, pos.z);
+		}
+	};
+	core::FlatHashMap<glm::ivec3, voxel::Voxel, MortonHasher> _map;
 	static const constexpr voxel::Voxel _emptyVoxel{VoxelType::Air, 0, 0, 0};
 	const voxel::Region _region;
 	const bool _isRegionValid;
@@ -170,8 +176,8 @@ public:
 	template<class Volume>
 	void copyTo(Volume &target) const {
 		for (auto iter = _map.begin(); iter != _map.end(); ++iter) {
-			const glm::ivec3 &pos = iter->first;
-			const voxel::Voxel &voxel = iter->second;
+			const glm::ivec3 &pos = iter->key;
+			const voxel::Voxel &voxel = iter->value;
 			target.setVoxel(pos.x, pos.y, pos.z, voxel);
 		}
 	}
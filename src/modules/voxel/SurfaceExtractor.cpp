@@ -3,9 +3,12 @@
  */
 
 #include "SurfaceExtractor.h"
+#include "core/collection/FlatHashMap.h"
+#include "voxel/ChunkMesh.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Region.h"
 #include "voxel/RawVolume.h"
+#include "voxel/private/BinaryGreedyMesher.h"
 #include "voxel/private/CubicSurfaceExtractor.h"
 #include "voxel/private/MarchingCubesSurfaceExtractor.h"
 
@@ -18,6 +21,13 @@ SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region
 									mergeQuads, reuseVertices, ambientOcclusion, optimize);
 }
 
+SurfaceExtractionContext buildBinaryContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
+											const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices,
+											bool ambientOcclusion, bool optimize) {
+	return SurfaceExtractionContext(volume, getPalette(), region, mesh, translate, SurfaceExtractionType::Binary,
+									mergeQuads, reuseVertices, ambientOcclusion, optimize);
+}
+
 SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 												   const palette::Palette &palette, bool optimize) {
 	return SurfaceExtractionContext(volume, palette, region, mesh, glm::ivec3(0), SurfaceExtractionType::MarchingCubes,
@@ -27,6 +37,9 @@ SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, cons
 void extractSurface(SurfaceExtractionContext &ctx) {
 	if (ctx.type == SurfaceExtractionType::MarchingCubes) {
 		voxel::extractMarchingCubesMesh(ctx.volume, ctx.palette, ctx.region, &ctx.mesh, ctx.optimize);
+	} else if (ctx.type == SurfaceExtractionType::Binary) {
+		voxel::extractBinaryGreedyMesh(ctx.volume, ctx.region, &ctx.mesh, ctx.translate, ctx.mergeQuads,
+									   ctx.reuseVertices, ctx.ambientOcclusion, ctx.optimize);
 	} else {
 		voxel::extractCubicMesh(ctx.volume, ctx.region, &ctx.mesh, ctx.translate, ctx.mergeQuads, ctx.reuseVertices,
 								ctx.ambientOcclusion, ctx.optimize);
@@ -40,7 +53,104 @@ voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type,
 	if (type == voxel::SurfaceExtractionType::MarchingCubes) {
 		return voxel::buildMarchingCubesContext(volume, region, mesh, palette, optimize);
 	}
+	if (type == voxel::SurfaceExtractionType::Binary) {
+		return voxel::buildBinaryContext(volume, region, mesh, translate, mergeQuads, reuseVertices, ambientOcclusion,
+										 optimize);
+	}
 	return voxel::buildCubicContext(volume, region, mesh, translate, mergeQuads, reuseVertices, ambientOcclusion, optimize);
 }
 
+bool isChunkedExtractionSupported(voxel::SurfaceExtractionType type, bool reuseVertices) {
+	if (!isCubicMesh(type)) {
+		return false;
+	}
+	// without vertex reuse the cubic extractor runs out of vertex slots per position and falls back to the first
+	// vertex - and this depends on the extracted region
+	return reuseVertices;
+}
+
+bool isChunkedExtractionExact(voxel::SurfaceExtractionType type, bool mergeQuads, bool reuseVertices) {
+	return !mergeQuads && isChunkedExtractionSupported(type, reuseVertices);
+}
+
+core::DynamicArray<voxel::Region> chunkRegions(const voxel::Region &region, int chunkSize) {
+	core::DynamicArray<voxel::Region> regions;
+	const glm::ivec3 &lower = region.getLowerCorner();
+	const glm::ivec3 &upper = region.getUpperCorner();
+	for (int z = lower.z; z <= upper.z; z += chunkSize) {
+		for (int y = lower.y; y <= upper.y; y += chunkSize) {
+			for (int x = lower.x; x <= upper.x; x += chunkSize) {
+				const glm::ivec3 mins(x, y, z);
+				const glm::ivec3 maxs = glm::min(mins + (chunkSize - 1), upper);
+				regions.emplace_back(mins, maxs);
+			}
+		}
+	}
+	return regions;
+}
+
+namespace {
+
+struct VoxelVertexHasher {
+	inline size_t operator()(const VoxelVertex &v) const {
+		const glm::ivec3 p(v.position);
+		return (size_t)(((uint64_t)(uint32_t)p.x * 73856093u) ^ ((uint64_t)(uint32_t)p.y * 19349663u) ^
+						((uint64_t)(uint32_t)p.z * 83492791u) ^ ((uint64_t)v.colorIndex << 32u) ^
+						((uint64_t)v.info << 40u) ^ ((uint64_t)v.normalIndex << 48u));
+	}
+};
+
+struct VoxelVertexEqual {
+	inline bool operator()(const VoxelVertex &lhs, const VoxelVertex &rhs) const {
+		return lhs.position == rhs.position && lhs.info == rhs.info && lhs.colorIndex == rhs.colorIndex &&
+			   lhs.normalIndex == rhs.normalIndex;
+	}
+};
+
+} // namespace
+
+void stitchChunkMeshes(const core::DynamicArray<voxel::ChunkMesh *> &chunks, const glm::ivec3 &offset,
+					   voxel::ChunkMesh &out, bool reuseVertices) {
+	out.clear();
+	out.setOffset(offset);
+	core::DynamicArray<IndexType> remap;
+	for (int i = 0; i < ChunkMesh::Meshes; ++i) {
+		Mesh &target = out.mesh[i];
+		core::FlatHashMap<VoxelVertex, IndexType, VoxelVertexHasher, VoxelVertexEqual> welded;
+		for (const voxel::ChunkMesh *chunk : chunks) {
+			const Mesh &src = chunk->mesh[i];
+			if (src.isEmpty()) {
+				continue;
+			}
+			const glm::vec3 delta(src.getOffset() - offset);
+			const VertexArray &vertices = src.getVertexVector();
+			const NormalArray &normals = src.getNormalVector();
+			remap.resize(vertices.size());
+			for (size_t v = 0; v < vertices.size(); ++v) {
+				VoxelVertex vertex = vertices[v];
+				vertex.position += delta;
+				if (reuseVertices) {
+					auto iter = welded.find(vertex);
+					if (iter != welded.end()) {
+						remap[v] = iter->value;
+						continue;
+					}
+				}
+				remap[v] = target.addVertex(vertex);
+				if (!normals.empty()) {
+					target.getNormalVector().push_back(normals[v]);
+				}
+				if (reuseVertices) {
+					welded.put(vertex, remap[v]);
+				}
+			}
+			const IndexArray &indices = src.getIndexVector();
+			for (size_t n = 0; n + 2 < indices.size(); n += 3) {
+				target.addTriangle(remap[indices[n]], remap[indices[n + 1]], remap[indices[n + 2]]);
+			}
+		}
+	}
+	out.compressIndices();
+}
+
 } // namespace voxel
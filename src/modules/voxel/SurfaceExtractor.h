@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "core/collection/DynamicArray.h"
 #include "math/Math.h"
+#include "voxel/Region.h"
 
 namespace palette {
 class Palette;
@@ -12,10 +14,20 @@ class Palette;
 
 namespace voxel {
 class RawVolume;
-class Region;
 struct ChunkMesh;
 
-enum class SurfaceExtractionType { Cubic, MarchingCubes, Max };
+/**
+ * @li Cubic: quad merging by shared vertices
+ * @li Binary: the same cubic mesh, but the faces are found and merged with column bitmasks
+ */
+enum class SurfaceExtractionType { Cubic, MarchingCubes, Binary, Max };
+
+/**
+ * @return @c true if the extraction type produces a mesh of quads that looks like cubes
+ */
+inline bool isCubicMesh(SurfaceExtractionType type) {
+	return type == SurfaceExtractionType::Cubic || type == SurfaceExtractionType::Binary;
+}
 
 struct SurfaceExtractionContext {
 	SurfaceExtractionContext(const RawVolume *_volume, const palette::Palette &_palette, const Region &_region,
@@ -30,15 +42,19 @@ struct SurfaceExtractionContext {
 	ChunkMesh &mesh;
 	const glm::ivec3 translate;
 	const SurfaceExtractionType type;
-	const bool mergeQuads;		 // used only for Cubic
-	const bool reuseVertices;	 // used only for Cubic
-	const bool ambientOcclusion; // used only for Cubic
+	const bool mergeQuads;		 // used only for Cubic and Binary
+	const bool reuseVertices;	 // used only for Cubic and Binary
+	const bool ambientOcclusion; // used only for Cubic and Binary
 	const bool optimize;
 };
 
 SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 										   const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
 										   bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
+SurfaceExtractionContext buildBinaryContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
+											const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
+											bool reuseVertices = true, bool ambientOcclusion = true,
+											bool optimize = false);
 SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 												   const palette::Palette &palette, bool optimize = false);
 
@@ -50,4 +66,33 @@ voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type,
 											  bool mergeQuads = true, bool reuseVertices = true,
 											  bool ambientOcclusion = true, bool optimize = false);
 
+/**
+ * @return @c true if the chunks of a region can get extracted independently and stitched together with
+ * @c stitchChunkMeshes(). If quads are merged, the merging doesn't cross the chunk borders - the stitched mesh covers
+ * the same faces with the same vertex attributes, but might have a few more quads than extracting the whole region at
+ * once.
+ * @sa isChunkedExtractionExact()
+ */
+bool isChunkedExtractionSupported(voxel::SurfaceExtractionType type, bool reuseVertices);
+
+/**
+ * @return @c true if extracting the chunks of a region independently and stitching them together with
+ * @c stitchChunkMeshes() gives the same mesh as extracting the whole region at once. This is not the case if quads
+ * are merged, because the merging doesn't cross the chunk borders - and it needs the vertices to be reused.
+ */
+bool isChunkedExtractionExact(voxel::SurfaceExtractionType type, bool mergeQuads, bool reuseVertices);
+
+/**
+ * @brief Split the given region into chunk regions of the given size - the last chunks on each axis might be smaller
+ */
+core::DynamicArray<voxel::Region> chunkRegions(const voxel::Region &region, int chunkSize);
+
+/**
+ * @brief Append the meshes of the given chunks into one mesh with the given offset.
+ * @param reuseVertices Weld the vertices that are duplicated at the chunk borders - this must match the setting the
+ * chunks were extracted with
+ */
+void stitchChunkMeshes(const core::DynamicArray<voxel::ChunkMesh *> &chunks, const glm::ivec3 &offset,
+					   voxel::ChunkMesh &out, bool reuseVertices);
+
 } // namespace voxel
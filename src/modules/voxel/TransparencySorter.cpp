@@ -0,0 +1,131 @@
+/**
+ * @file
+ */
+
+#include "TransparencySorter.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include <glm/geometric.hpp>
+
+namespace voxel {
+
+void TransparencySorter::reset() {
+	_valid = false;
+	_sorted = false;
+}
+
+void TransparencySorter::update(const VoxelVertex *vertices, const IndexType *indices, size_t indexCount) {
+	core_trace_scoped(TransparencySorterUpdate);
+	const size_t triangleCount = indexCount / 3;
+	_triangles.resize(triangleCount * 3);
+	_centers.resize(triangleCount);
+	_order.resize(triangleCount);
+	_keys.resize(triangleCount);
+	_tmpOrder.resize(triangleCount);
+	_tmpKeys.resize(triangleCount);
+	for (size_t i = 0; i < triangleCount; ++i) {
+		const IndexType i0 = indices[i * 3 + 0];
+		const IndexType i1 = indices[i * 3 + 1];
+		const IndexType i2 = indices[i * 3 + 2];
+		_triangles[i * 3 + 0] = i0;
+		_triangles[i * 3 + 1] = i1;
+		_triangles[i * 3 + 2] = i2;
+		_centers[i] = (vertices[i0].position + vertices[i1].position + vertices[i2].position) / 3.0f;
+		_order[i] = (uint32_t)i;
+	}
+	_valid = true;
+	_sorted = false;
+}
+
+bool TransparencySorter::insertionSort(size_t maxMoves) {
+	const size_t n = _order.size();
+	size_t moves = 0;
+	for (size_t i = 1; i < n; ++i) {
+		const uint32_t key = _keys[i];
+		const uint32_t tri = _order[i];
+		size_t j = i;
+		while (j > 0 && _keys[j - 1] > key) {
+			_keys[j] = _keys[j - 1];
+			_order[j] = _order[j - 1];
+			--j;
+			++moves;
+			if (moves > maxMoves) {
+				_keys[j] = key;
+				_order[j] = tri;
+				return false;
+			}
+		}
+		_keys[j] = key;
+		_order[j] = tri;
+	}
+	return true;
+}
+
+void TransparencySorter::radixSort() {
+	core_trace_scoped(TransparencySorterRadixSort);
+	const size_t n = _order.size();
+	uint32_t *keys = _keys.data();
+	uint32_t *order = _order.data();
+	uint32_t *tmpKeys = _tmpKeys.data();
+	uint32_t *tmpOrder = _tmpOrder.data();
+	for (uint32_t shift = 0u; shift < 32u; shift += 8u) {
+		uint32_t histogram[256];
+		core_memset(histogram, 0, sizeof(histogram));
+		for (size_t i = 0; i < n; ++i) {
+			++histogram[(keys[i] >> shift) & 0xFFu];
+		}
+		// all keys share the same byte - nothing to do for this pass
+		if (histogram[(keys[0] >> shift) & 0xFFu] == n) {
+			continue;
+		}
+		uint32_t offset = 0u;
+		for (int b = 0; b < 256; ++b) {
+			const uint32_t count = histogram[b];
+			histogram[b] = offset;
+			offset += count;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			const uint32_t dest = histogram[(keys[i] >> shift) & 0xFFu]++;
+			tmpKeys[dest] = keys[i];
+			tmpOrder[dest] = order[i];
+		}
+		core::exchange(keys, tmpKeys);
+		core::exchange(order, tmpOrder);
+	}
+	if (order != _order.data()) {
+		core_memcpy(_order.data(), order, n * sizeof(uint32_t));
+		core_memcpy(_keys.data(), keys, n * sizeof(uint32_t));
+	}
+}
+
+void TransparencySorter::sort(const VoxelVertex *vertices, IndexType *indices, size_t indexCount,
+							  const glm::vec3 &cameraPos) {
+	core_trace_scoped(TransparencySorterSort);
+	const size_t triangleCount = indexCount / 3;
+	if (!_valid || _order.size() != triangleCount) {
+		update(vertices, indices, indexCount);
+	}
+	if (triangleCount == 0) {
+		return;
+	}
+	for (size_t i = 0; i < triangleCount; ++i) {
+		const glm::vec3 delta = _centers[_order[i]] - cameraPos;
+		const float distanceSquared = glm::dot(delta, delta);
+		// the bit pattern of positive floats has the same order as their values
+		core_memcpy(&_keys[i], &distanceSquared, sizeof(uint32_t));
+	}
+	// the previous order is a good guess if the camera didn't move too much
+	if (!_sorted || !insertionSort(triangleCount)) {
+		radixSort();
+	}
+	_sorted = true;
+	for (size_t i = 0; i < triangleCount; ++i) {
+		const uint32_t tri = _order[i];
+		indices[i * 3 + 0] = _triangles[tri * 3 + 0];
+		indices[i * 3 + 1] = _triangles[tri * 3 + 1];
+		indices[i * 3 + 2] = _triangles[tri * 3 + 2];
+	}
+}
+
+} // namespace voxel
@@ -0,0 +1,53 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "VoxelVertex.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+/**
+ * @brief Orders the triangles of a mesh by their distance to the camera - used for rendering transparent surfaces.
+ *
+ * The triangle centers are cached and the squared distances are used as integer keys for a radix sort. For small
+ * camera movements the previous order is only fixed up by an insertion sort - the order changes only slightly between
+ * two frames.
+ *
+ * @note The cache must be reset if the vertices or indices of the mesh were modified.
+ */
+class TransparencySorter {
+private:
+	// the triangle indices in the order of the mesh before the first sort
+	core::DynamicArray<IndexType> _triangles;
+	core::DynamicArray<glm::vec3> _centers;
+	// permutation of the triangles and their sort keys
+	core::DynamicArray<uint32_t> _order;
+	core::DynamicArray<uint32_t> _keys;
+	core::DynamicArray<uint32_t> _tmpOrder;
+	core::DynamicArray<uint32_t> _tmpKeys;
+	bool _valid = false;
+	bool _sorted = false;
+
+	void update(const VoxelVertex *vertices, const IndexType *indices, size_t indexCount);
+	/**
+	 * @return @c false if the order is too far away from being sorted - the arrays are still a valid permutation then
+	 */
+	bool insertionSort(size_t maxMoves);
+	void radixSort();
+
+public:
+	/**
+	 * @brief Writes the triangle indices ordered by the distance to the given camera position (nearest first)
+	 */
+	void sort(const VoxelVertex *vertices, IndexType *indices, size_t indexCount, const glm::vec3 &cameraPos);
+	/**
+	 * @brief Invalidate the cached triangle data
+	 */
+	void reset();
+};
+
+} // namespace voxel
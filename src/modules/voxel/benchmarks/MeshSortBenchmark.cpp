@@ -0,0 +1,63 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/Mesh.h"
+
+class MeshSortBenchmark : public app::AbstractBenchmark {
+protected:
+	voxel::Mesh mesh;
+
+	// a large transparent surface like a water plane with some height variation
+	void createSurface(int size) {
+		mesh.clear();
+		voxel::VoxelVertex v;
+		for (int z = 0; z <= size; ++z) {
+			for (int x = 0; x <= size; ++x) {
+				v.position = {(float)x, (float)((x * 7 + z * 13) % 5), (float)z};
+				mesh.addVertex(v);
+			}
+		}
+		for (int z = 0; z < size; ++z) {
+			for (int x = 0; x < size; ++x) {
+				const voxel::IndexType i0 = z * (size + 1) + x;
+				const voxel::IndexType i1 = i0 + 1;
+				const voxel::IndexType i2 = i0 + size + 1;
+				const voxel::IndexType i3 = i2 + 1;
+				mesh.addTriangle(i0, i2, i1);
+				mesh.addTriangle(i1, i2, i3);
+			}
+		}
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		createSurface((int)state.range(0));
+	}
+};
+
+BENCHMARK_DEFINE_F(MeshSortBenchmark, sortCameraJump)(benchmark::State &state) {
+	const float size = (float)state.range(0);
+	int i = 0;
+	for (auto _ : state) {
+		// jump between opposite corners - the previous order is useless here
+		const float pos = (i++ & 1) ? -10.0f : size + 10.0f;
+		benchmark::DoNotOptimize(mesh.sort(glm::vec3(pos, 10.0f, pos)));
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t)mesh.getNoOfIndices() / 3);
+}
+
+BENCHMARK_DEFINE_F(MeshSortBenchmark, sortCameraMove)(benchmark::State &state) {
+	glm::vec3 cameraPos(-10.0f, 10.0f, -10.0f);
+	for (auto _ : state) {
+		// camera movement of a few frames
+		cameraPos.x += 0.6f;
+		benchmark::DoNotOptimize(mesh.sort(cameraPos));
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t)mesh.getNoOfIndices() / 3);
+}
+
+BENCHMARK_REGISTER_F(MeshSortBenchmark, sortCameraJump)->Arg(64)->Arg(256);
+BENCHMARK_REGISTER_F(MeshSortBenchmark, sortCameraMove)->Arg(64)->Arg(256);
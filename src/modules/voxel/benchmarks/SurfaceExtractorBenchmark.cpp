@@ -10,10 +10,44 @@
 class SurfaceExtractorBenchmark : public app::AbstractBenchmark {
 protected:
 	voxel::RawVolume v{voxel::Region{0, 0, 0, 143, 22, 134}};
+	voxel::RawVolume noise{voxel::Region{0, 127}};
+
+	void fillNoise() {
+		uint32_t seed = 1337u;
+		const voxel::Region &region = noise.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					seed = seed * 1664525u + 1013904223u;
+					// height field with some holes to get a mix of large and small quads
+					const int height = 64 + (x % 32) - (z % 16);
+					if (y > height || (seed >> 28u) == 0u) {
+						continue;
+					}
+					noise.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1 + (seed >> 30u)));
+				}
+			}
+		}
+	}
+
+	void extract(benchmark::State &state, voxel::SurfaceExtractionType type, bool ambientOcclusion) {
+		for (auto _ : state) {
+			voxel::ChunkMesh mesh;
+			voxel::Region region = noise.region();
+			region.shiftUpperCorner(1, 1, 1);
+			voxel::SurfaceExtractionContext ctx =
+				type == voxel::SurfaceExtractionType::Binary
+					? voxel::buildBinaryContext(&noise, region, mesh, glm::ivec3(0), true, true, ambientOcclusion)
+					: voxel::buildCubicContext(&noise, region, mesh, glm::ivec3(0), true, true, ambientOcclusion);
+			voxel::extractSurface(ctx);
+			benchmark::DoNotOptimize(mesh.mesh[0].getNoOfIndices());
+		}
+	}
 
 public:
 	void SetUp(::benchmark::State &state) override {
 		app::AbstractBenchmark::SetUp(state);
+		fillNoise();
 
 		v.setVoxel(96, 6, 62, voxel::createVoxel(voxel::VoxelType::Generic, 47));
 		v.setVoxel(97, 6, 62, voxel::createVoxel(voxel::VoxelType::Generic, 47));
@@ -105,6 +139,26 @@ BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Visit)(benchmark::State &state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Cubic)(benchmark::State &state) {
+	extract(state, voxel::SurfaceExtractionType::Cubic, false);
+}
+
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Binary)(benchmark::State &state) {
+	extract(state, voxel::SurfaceExtractionType::Binary, false);
+}
+
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, CubicAmbientOcclusion)(benchmark::State &state) {
+	extract(state, voxel::SurfaceExtractionType::Cubic, true);
+}
+
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, BinaryAmbientOcclusion)(benchmark::State &state) {
+	extract(state, voxel::SurfaceExtractionType::Binary, true);
+}
+
 BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Visit);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Cubic);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Binary);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, CubicAmbientOcclusion);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, BinaryAmbientOcclusion);
 
 BENCHMARK_MAIN();
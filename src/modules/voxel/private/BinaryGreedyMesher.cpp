@@ -0,0 +1,429 @@
+/**
+ * @file
+ */
+
+#include "BinaryGreedyMesher.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/FlatHashMap.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxel/VoxelVertex.h"
+#include <glm/vec3.hpp>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace voxel {
+
+namespace binarymesher {
+
+/**
+ * One bit of the 64 bit columns is needed for the neighbour in front of the first slice and one to not lose the
+ * last slice when shifting the column
+ */
+static constexpr int SlicesPerColumn = 62;
+
+enum FaceType {
+	FaceType_Negative,
+	FaceType_Positive,
+	FaceType_NegativeTransparent,
+	FaceType_PositiveTransparent,
+
+	FaceType_Max
+};
+
+/**
+ * @brief The face normal axis and the two axes of the slices - the rows are along @c u, the bits of a row are
+ * along @c v
+ */
+struct AxisSetup {
+	int axis;
+	int u;
+	int v;
+};
+static constexpr AxisSetup Axes[3] = {{0, 1, 2}, {1, 2, 0}, {2, 1, 0}};
+
+/**
+ * @brief The quad corners as (u, v) offsets in the same vertex order that is used by @c extractCubicMesh()
+ */
+static constexpr uint8_t CornersA[4][2] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+static constexpr uint8_t CornersB[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+static inline const uint8_t (*corners(int axis, bool positive))[2] {
+	if (axis == 2) {
+		return positive ? CornersA : CornersB;
+	}
+	return positive ? CornersB : CornersA;
+}
+
+/**
+ * @brief The face key contains everything that must be equal for two faces to get merged
+ *
+ * @li bits 0-7: color
+ * @li bits 8-15: normal
+ * @li bits 16-23: flags
+ * @li bits 24-31: material
+ * @li bits 32-39: ambient occlusion of the four corners (2 bits each)
+ */
+static constexpr uint64_t KeyMaskAmbientOcclusion = UINT64_C(0xFFFFFFFFFF);
+static constexpr uint64_t KeyMaskNoAmbientOcclusion = UINT64_C(0xFFFFFFFF);
+
+static CORE_FORCE_INLINE int lowestBit(uint64_t bits) {
+	core_assert(bits != 0u);
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward64(&idx, bits);
+	return (int)idx;
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+static CORE_FORCE_INLINE bool isOpaque(VoxelType material) {
+	return !isAir(material) && !isTransparent(material);
+}
+
+/**
+ * @brief See @c vertexAmbientOcclusion() of the cubic surface extractor
+ */
+static CORE_FORCE_INLINE uint8_t vertexAmbientOcclusion(bool side1, bool side2, bool corner) {
+	if (side1 && side2) {
+		return 0;
+	}
+	return 3 - (side1 + side2 + corner);
+}
+
+struct VertexKey {
+	glm::ivec3 pos;
+	uint64_t attributes;
+
+	inline bool operator==(const VertexKey &other) const {
+		return pos == other.pos && attributes == other.attributes;
+	}
+};
+
+struct VertexKeyHasher {
+	inline size_t operator()(const VertexKey &key) const {
+		return (size_t)(((uint64_t)(uint32_t)key.pos.x * UINT64_C(73856093)) ^
+						((uint64_t)(uint32_t)key.pos.y * UINT64_C(19349663)) ^
+						((uint64_t)(uint32_t)key.pos.z * UINT64_C(83492791)) ^ key.attributes);
+	}
+};
+
+struct Context {
+	const RawVolume *volume;
+	glm::ivec3 lower;
+	glm::ivec3 size;
+	glm::ivec3 translate;
+	bool reuseVertices;
+	ChunkMesh *result;
+	core::FlatHashMap<VertexKey, IndexType, VertexKeyHasher> vertices[ChunkMesh::Meshes];
+
+	// position relative to the lower corner of the region
+	inline const Voxel &voxel(const glm::ivec3 &pos) const {
+		return volume->voxel(lower.x + pos.x, lower.y + pos.y, lower.z + pos.z);
+	}
+
+	inline bool opaque(const glm::ivec3 &pos) const {
+		return isOpaque(voxel(pos).getMaterial());
+	}
+};
+
+static uint64_t faceKey(const Context &ctx, const AxisSetup &setup, FaceType faceType, int slice, int u, int v) {
+	const bool positive = faceType == FaceType_Positive || faceType == FaceType_PositiveTransparent;
+	glm::ivec3 front;
+	front[setup.axis] = slice;
+	front[setup.u] = u;
+	front[setup.v] = v;
+	glm::ivec3 solid = front;
+	if (positive) {
+		solid[setup.axis] -= 1;
+	} else {
+		front[setup.axis] -= 1;
+	}
+	const Voxel &voxel = ctx.voxel(solid);
+	uint64_t key = (uint64_t)voxel.getColor() | ((uint64_t)voxel.getNormal() << 8u) |
+				   ((uint64_t)voxel.getFlags() << 16u) | ((uint64_t)voxel.getMaterial() << 24u);
+	const uint8_t(*quadCorners)[2] = corners(setup.axis, positive);
+	for (int i = 0; i < 4; ++i) {
+		glm::ivec3 side1 = front;
+		side1[setup.u] += quadCorners[i][0] ? 1 : -1;
+		glm::ivec3 side2 = front;
+		side2[setup.v] += quadCorners[i][1] ? 1 : -1;
+		glm::ivec3 corner = side1;
+		corner[setup.v] = side2[setup.v];
+		const uint8_t ao = vertexAmbientOcclusion(ctx.opaque(side1), ctx.opaque(side2), ctx.opaque(corner));
+		key |= (uint64_t)ao << (32u + 2u * i);
+	}
+	return key;
+}
+
+static IndexType addVertex(Context &ctx, int meshIdx, const glm::ivec3 &pos, uint64_t key, int corner) {
+	const uint8_t ambientOcclusion = (uint8_t)((key >> (32u + 2u * corner)) & 3u);
+	Mesh &mesh = ctx.result->mesh[meshIdx];
+	const VertexKey vertexKey{pos, (key & KeyMaskNoAmbientOcclusion) | ((uint64_t)ambientOcclusion << 32u)};
+	if (ctx.reuseVertices) {
+		IndexType idx;
+		if (ctx.vertices[meshIdx].get(vertexKey, idx)) {
+			return idx;
+		}
+	}
+	VoxelVertex vertex;
+	vertex.position = pos + ctx.translate;
+	vertex.colorIndex = (uint8_t)(key & 0xFFu);
+	vertex.normalIndex = (uint8_t)((key >> 8u) & 0xFFu);
+	vertex.ambientOcclusion = ambientOcclusion;
+	vertex.flags = (uint8_t)((key >> 16u) & 0xFFu);
+	vertex.padding = 0u;
+	vertex.padding2 = 0u;
+	const IndexType idx = mesh.addVertex(vertex);
+	if (ctx.reuseVertices) {
+		ctx.vertices[meshIdx].put(vertexKey, idx);
+	}
+	return idx;
+}
+
+/**
+ * @brief See @c isQuadFlipped() of the cubic surface extractor
+ */
+static CORE_FORCE_INLINE bool isQuadFlipped(const VoxelVertex &v00, const VoxelVertex &v01, const VoxelVertex &v10,
+											const VoxelVertex &v11) {
+	return v00.ambientOcclusion + v11.ambientOcclusion > v01.ambientOcclusion + v10.ambientOcclusion;
+}
+
+/**
+ * @param[in] u0,v0 The first face of the rectangle
+ * @param[in] u1,v1 One after the last face of the rectangle
+ */
+static void addQuad(Context &ctx, const AxisSetup &setup, FaceType faceType, int slice, int u0, int v0, int u1, int v1,
+					const uint64_t *keys) {
+	const bool positive = faceType == FaceType_Positive || faceType == FaceType_PositiveTransparent;
+	const int meshIdx = (faceType == FaceType_Negative || faceType == FaceType_Positive) ? 0 : 1;
+	const int extV = ctx.size[setup.v];
+	const uint8_t(*quadCorners)[2] = corners(setup.axis, positive);
+	IndexType indices[4];
+	for (int i = 0; i < 4; ++i) {
+		const bool du = quadCorners[i][0] != 0;
+		const bool dv = quadCorners[i][1] != 0;
+		// the vertex attributes are taken from the face in this corner
+		const int faceU = du ? u1 - 1 : u0;
+		const int faceV = dv ? v1 - 1 : v0;
+		glm::ivec3 pos;
+		pos[setup.axis] = slice;
+		pos[setup.u] = du ? u1 : u0;
+		pos[setup.v] = dv ? v1 : v0;
+		indices[i] = addVertex(ctx, meshIdx, pos, keys[faceU * extV + faceV], i);
+	}
+
+	Mesh &mesh = ctx.result->mesh[meshIdx];
+	const IndexType i0 = indices[0];
+	const IndexType i1 = indices[1];
+	const IndexType i2 = indices[2];
+	const IndexType i3 = indices[3];
+	const VoxelVertex &v00 = mesh.getVertex(i3);
+	const VoxelVertex &v01 = mesh.getVertex(i0);
+	const VoxelVertex &v10 = mesh.getVertex(i2);
+	const VoxelVertex &v11 = mesh.getVertex(i1);
+	if (isQuadFlipped(v00, v01, v10, v11)) {
+		mesh.addTriangle(i1, i2, i3);
+		mesh.addTriangle(i1, i3, i0);
+	} else {
+		mesh.addTriangle(i0, i1, i2);
+		mesh.addTriangle(i0, i2, i3);
+	}
+}
+
+static CORE_FORCE_INLINE bool isBitSet(const uint64_t *row, int v) {
+	return (row[v >> 6] >> (v & 63)) & 1u;
+}
+
+static CORE_FORCE_INLINE uint64_t rangeMask(int word, int v0, int v1) {
+	const int start = core_max(v0 - word * 64, 0);
+	const int end = core_min(v1 - word * 64, 64);
+	const uint64_t upper = end >= 64 ? ~UINT64_C(0) : ((UINT64_C(1) << end) - 1u);
+	return upper & ~((UINT64_C(1) << start) - 1u);
+}
+
+static bool isRangeSet(const uint64_t *row, int v0, int v1) {
+	for (int w = v0 >> 6; w <= (v1 - 1) >> 6; ++w) {
+		const uint64_t mask = rangeMask(w, v0, v1);
+		if ((row[w] & mask) != mask) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void clearRange(uint64_t *row, int v0, int v1) {
+	for (int w = v0 >> 6; w <= (v1 - 1) >> 6; ++w) {
+		row[w] &= ~rangeMask(w, v0, v1);
+	}
+}
+
+/**
+ * @brief Greedy merge of the faces of one slice
+ * @param[in,out] rows One bit per face - the bits are cleared while the quads are generated
+ */
+static void meshifySlice(Context &ctx, const AxisSetup &setup, FaceType faceType, int slice, uint64_t *rows,
+						 uint64_t *keys, bool merge, uint64_t compareMask) {
+	core_trace_scoped(MeshifySlice);
+	const int extU = ctx.size[setup.u];
+	const int extV = ctx.size[setup.v];
+	const int wordsV = (extV + 63) / 64;
+
+	for (int u = 0; u < extU; ++u) {
+		const uint64_t *row = rows + u * wordsV;
+		for (int w = 0; w < wordsV; ++w) {
+			uint64_t bits = row[w];
+			while (bits != 0u) {
+				const int v = w * 64 + lowestBit(bits);
+				bits &= bits - 1u;
+				keys[u * extV + v] = faceKey(ctx, setup, faceType, slice, u, v);
+			}
+		}
+	}
+
+	for (int u0 = 0; u0 < extU; ++u0) {
+		uint64_t *row = rows + u0 * wordsV;
+		for (int w = 0; w < wordsV; ++w) {
+			while (row[w] != 0u) {
+				const int v0 = w * 64 + lowestBit(row[w]);
+				int v1 = v0 + 1;
+				int u1 = u0 + 1;
+				if (merge) {
+					const uint64_t key = keys[u0 * extV + v0] & compareMask;
+					while (v1 < extV && isBitSet(row, v1) && (keys[u0 * extV + v1] & compareMask) == key) {
+						++v1;
+					}
+					for (; u1 < extU; ++u1) {
+						const uint64_t *nextRow = rows + u1 * wordsV;
+						if (!isRangeSet(nextRow, v0, v1)) {
+							break;
+						}
+						const uint64_t *nextKeys = keys + u1 * extV;
+						int v = v0;
+						while (v < v1 && (nextKeys[v] & compareMask) == key) {
+							++v;
+						}
+						if (v != v1) {
+							break;
+						}
+					}
+				}
+				for (int u = u0; u < u1; ++u) {
+					clearRange(rows + u * wordsV, v0, v1);
+				}
+				addQuad(ctx, setup, faceType, slice, u0, v0, u1, v1, keys);
+			}
+		}
+	}
+}
+
+static void extractAxis(Context &ctx, const AxisSetup &setup, bool merge, uint64_t compareMask) {
+	core_trace_scoped(ExtractAxis);
+	const int extA = ctx.size[setup.axis];
+	const int extU = ctx.size[setup.u];
+	const int extV = ctx.size[setup.v];
+	const int wordsV = (extV + 63) / 64;
+	const size_t sliceWords = (size_t)extU * wordsV;
+
+	// one bit per face - [faceType][slice][u][v]
+	core::DynamicArray<uint64_t> rows;
+	rows.resize(FaceType_Max * SlicesPerColumn * sliceWords);
+	core::DynamicArray<uint64_t> keys;
+	keys.resize((size_t)extU * extV);
+
+	for (int a0 = 0; a0 < extA; a0 += SlicesPerColumn) {
+		const int slices = core_min(SlicesPerColumn, extA - a0);
+		// bit 0 is the voxel in front of the first slice
+		const uint64_t slicesMask = ((UINT64_C(1) << slices) - 1u) << 1u;
+		rows.fill(0u);
+		{
+			core_trace_scoped(BuildColumns);
+			glm::ivec3 pos;
+			for (int u = 0; u < extU; ++u) {
+				pos[setup.u] = u;
+				for (int v = 0; v < extV; ++v) {
+					pos[setup.v] = v;
+					uint64_t opaque = 0u;
+					uint64_t transparent = 0u;
+					for (int i = 0; i <= slices; ++i) {
+						pos[setup.axis] = a0 - 1 + i;
+						const VoxelType material = ctx.voxel(pos).getMaterial();
+						if (isAir(material)) {
+							continue;
+						}
+						if (isTransparent(material)) {
+							transparent |= UINT64_C(1) << i;
+						} else {
+							opaque |= UINT64_C(1) << i;
+						}
+					}
+					if ((opaque | transparent) == 0u) {
+						continue;
+					}
+					const uint64_t faces[FaceType_Max] = {
+						opaque & ~(opaque << 1u) & slicesMask, (opaque << 1u) & ~opaque & slicesMask,
+						transparent & ~(transparent << 1u) & slicesMask,
+						(transparent << 1u) & ~transparent & slicesMask};
+					const size_t wordOffset = (size_t)u * wordsV + (v >> 6);
+					const uint64_t bit = UINT64_C(1) << (v & 63);
+					for (int faceType = 0; faceType < FaceType_Max; ++faceType) {
+						uint64_t bits = faces[faceType];
+						while (bits != 0u) {
+							const int slice = lowestBit(bits) - 1;
+							bits &= bits - 1u;
+							rows[(faceType * SlicesPerColumn + slice) * sliceWords + wordOffset] |= bit;
+						}
+					}
+				}
+			}
+		}
+		for (int faceType = 0; faceType < FaceType_Max; ++faceType) {
+			for (int slice = 0; slice < slices; ++slice) {
+				uint64_t *sliceRows = &rows[(faceType * SlicesPerColumn + slice) * sliceWords];
+				meshifySlice(ctx, setup, (FaceType)faceType, a0 + slice, sliceRows, keys.data(), merge, compareMask);
+			}
+		}
+	}
+}
+
+} // namespace binarymesher
+
+void extractBinaryGreedyMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+							 const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion,
+							 bool optimize) {
+	core_trace_scoped(ExtractBinaryGreedyMesh);
+
+	result->clear();
+	result->setOffset(region.getLowerCorner());
+
+	binarymesher::Context ctx;
+	ctx.volume = volData;
+	ctx.lower = region.getLowerCorner();
+	ctx.size = region.getDimensionsInVoxels();
+	ctx.translate = translate;
+	ctx.reuseVertices = reuseVertices;
+	ctx.result = result;
+
+	// the cubic extractor merges the quads by shared vertices - without reusing them nothing is merged
+	const bool merge = mergeQuads && reuseVertices;
+	const uint64_t compareMask =
+		ambientOcclusion ? binarymesher::KeyMaskAmbientOcclusion : binarymesher::KeyMaskNoAmbientOcclusion;
+	for (const binarymesher::AxisSetup &setup : binarymesher::Axes) {
+		binarymesher::extractAxis(ctx, setup, merge, compareMask);
+	}
+
+	if (optimize) {
+		result->optimize();
+	}
+	result->removeUnusedVertices();
+	result->compressIndices();
+}
+
+} // namespace voxel
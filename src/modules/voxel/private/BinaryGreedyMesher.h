@@ -0,0 +1,33 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <glm/fwd.hpp>
+
+namespace voxel {
+
+class RawVolume;
+class Region;
+struct ChunkMesh;
+
+/**
+ * @brief Cubic surface extraction based on column bitmasks
+ *
+ * The visible faces are found by shifting and masking 64 bit columns of solid (and transparent) voxel bits along
+ * each axis. The faces are then transposed into per slice row masks and merged greedily into rectangles by walking
+ * the set bits. The rules for visible faces, the vertex order, the ambient occlusion values and the quad orientation
+ * match the ones of @c extractCubicMesh() - but the quad merging doesn't need the quadratic list merging.
+ *
+ * @note Two faces are merged if they share the color, the normal, the flags and - with @c ambientOcclusion enabled -
+ * the ambient occlusion values of all four corners. Without @c reuseVertices no quads are merged - this is the same
+ * as for @c extractCubicMesh() because the quads there are merged by shared vertices.
+ *
+ * @sa extractCubicMesh()
+ */
+void extractBinaryGreedyMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+							 const glm::ivec3 &translate, bool mergeQuads = true, bool reuseVertices = true,
+							 bool ambientOcclusion = true, bool optimize = false);
+
+} // namespace voxel
@@ -0,0 +1,138 @@
+/**
+ * @file
+ */
+
+#include "voxel/BitVolume.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+class BitVolumeTest : public app::AbstractTest {};
+
+TEST_F(BitVolumeTest, testSetValue) {
+	BitVolume v;
+	EXPECT_TRUE(v.empty());
+	EXPECT_FALSE(v.region().isValid());
+	v.setValue(0, 0, 0, true);
+	v.setValue(-1, 9, 17, true);
+	EXPECT_TRUE(v.hasValue(0, 0, 0));
+	EXPECT_TRUE(v.hasValue(-1, 9, 17));
+	EXPECT_FALSE(v.hasValue(1, 0, 0));
+	EXPECT_FALSE(v.hasValue(-1, 8, 17));
+	EXPECT_EQ(2u, v.count());
+	EXPECT_EQ(2u, v.bricks());
+	EXPECT_EQ(Region(-1, 0, 0, 0, 9, 17), v.region());
+	v.setValue(-1, 9, 17, false);
+	EXPECT_FALSE(v.hasValue(-1, 9, 17));
+	EXPECT_EQ(1u, v.bricks());
+	EXPECT_EQ(Region(0, 0), v.region());
+	v.setValue(0, 0, 0, false);
+	EXPECT_TRUE(v.empty());
+	EXPECT_FALSE(v.region().isValid());
+}
+
+TEST_F(BitVolumeTest, testSetRegion) {
+	BitVolume v;
+	const Region region(-5, 3, 2, 12, 17, 9);
+	v.setRegion(region, true);
+	EXPECT_EQ((size_t)region.voxels(), v.count());
+	EXPECT_EQ(region, v.region());
+	for (int z = -8; z <= 20; ++z) {
+		for (int y = -8; y <= 20; ++y) {
+			for (int x = -8; x <= 20; ++x) {
+				ASSERT_EQ(region.containsPoint(x, y, z), v.hasValue(x, y, z)) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	const Region inner(0, 4, 4, 2, 6, 6);
+	v.setRegion(inner, false);
+	EXPECT_EQ((size_t)(region.voxels() - inner.voxels()), v.count());
+	EXPECT_FALSE(v.hasValue(1, 5, 5));
+	EXPECT_TRUE(v.hasValue(3, 5, 5));
+	v.setRegion(region, false);
+	EXPECT_TRUE(v.empty());
+}
+
+TEST_F(BitVolumeTest, testInvert) {
+	BitVolume v;
+	v.setRegion(Region(0, 3), true);
+	v.setValue(100, 100, 100, true);
+	v.invert(Region(0, 7));
+	EXPECT_EQ((size_t)(8 * 8 * 8 - 4 * 4 * 4 + 1), v.count());
+	EXPECT_FALSE(v.hasValue(0, 0, 0));
+	EXPECT_TRUE(v.hasValue(4, 0, 0));
+	EXPECT_TRUE(v.hasValue(100, 100, 100));
+	EXPECT_EQ(Region(0, 100), v.region());
+}
+
+TEST_F(BitVolumeTest, testSetOperations) {
+	BitVolume a;
+	a.setRegion(Region(0, 9), true);
+	BitVolume b;
+	b.setRegion(Region(5, 14), true);
+
+	BitVolume united = a;
+	united.unite(b);
+	EXPECT_EQ((size_t)(2 * 1000 - 125), united.count());
+	EXPECT_EQ(Region(0, 14), united.region());
+
+	BitVolume intersected = a;
+	intersected.intersect(b);
+	EXPECT_EQ(125u, intersected.count());
+	EXPECT_EQ(Region(5, 9), intersected.region());
+
+	BitVolume subtracted = a;
+	subtracted.subtract(b);
+	EXPECT_EQ((size_t)(1000 - 125), subtracted.count());
+	EXPECT_EQ(Region(0, 9), subtracted.region());
+	EXPECT_FALSE(subtracted.hasValue(5, 5, 5));
+	EXPECT_TRUE(subtracted.hasValue(4, 9, 9));
+}
+
+TEST_F(BitVolumeTest, testVisit) {
+	BitVolume v;
+	const Region region(-3, 4);
+	v.setRegion(region, true);
+	int n = 0;
+	v.visit([&](int x, int y, int z) {
+		EXPECT_TRUE(region.containsPoint(x, y, z));
+		++n;
+	});
+	EXPECT_EQ(region.voxels(), n);
+	Region bricks = Region::InvalidRegion;
+	v.visitBricks([&](const Region &r) {
+		if (bricks.isValid()) {
+			bricks.accumulate(r);
+		} else {
+			bricks = r;
+		}
+	});
+	EXPECT_EQ(region, bricks);
+}
+
+TEST_F(BitVolumeTest, testVisitBoxes) {
+	BitVolume v;
+	const Region region(-5, 12);
+	v.setRegion(region, true);
+	v.setRegion(Region(-1, 3), false);
+	v.setValue(0, 0, 0, true);
+	v.setValue(20, 1, -7, true);
+	BitVolume covered;
+	size_t voxels = 0u;
+	v.visitBoxes([&](const Region &r) {
+		for (int z = r.getLowerZ(); z <= r.getUpperZ(); ++z) {
+			for (int y = r.getLowerY(); y <= r.getUpperY(); ++y) {
+				for (int x = r.getLowerX(); x <= r.getUpperX(); ++x) {
+					EXPECT_TRUE(v.hasValue(x, y, z));
+					EXPECT_FALSE(covered.hasValue(x, y, z)) << "boxes overlap at " << x << ":" << y << ":" << z;
+					covered.setValue(x, y, z, true);
+				}
+			}
+		}
+		voxels += (size_t)r.voxels();
+	});
+	EXPECT_EQ(v.count(), voxels);
+}
+
+} // namespace voxel
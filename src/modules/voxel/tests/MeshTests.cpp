@@ -5,12 +5,32 @@
 #include "app/tests/AbstractTest.h"
 #include "voxel/Mesh.h"
 #include "voxel/VoxelVertex.h"
+#include <glm/geometric.hpp>
 
 namespace voxel {
 
-class MeshTest : public app::AbstractTest {};
+class MeshTest : public app::AbstractTest {
+protected:
+	static float distanceSquared(const Mesh &mesh, int triangle, const glm::vec3 &cameraPos) {
+		const IndexArray &indices = mesh.getIndexVector();
+		const glm::vec3 center = (mesh.getVertex(indices[triangle * 3 + 0]).position +
+								  mesh.getVertex(indices[triangle * 3 + 1]).position +
+								  mesh.getVertex(indices[triangle * 3 + 2]).position) /
+								 3.0f;
+		const glm::vec3 delta = center - cameraPos;
+		return glm::dot(delta, delta);
+	}
 
-TEST_F(MeshTest, DISABLED_testSort) {
+	void validateOrder(const Mesh &mesh, const glm::vec3 &cameraPos) {
+		const int triangles = (int)mesh.getNoOfIndices() / 3;
+		for (int i = 1; i < triangles; ++i) {
+			ASSERT_LE(distanceSquared(mesh, i - 1, cameraPos), distanceSquared(mesh, i, cameraPos))
+				<< "Triangle " << i << " is not sorted";
+		}
+	}
+};
+
+TEST_F(MeshTest, testSort) {
 	Mesh mesh;
 	voxel::VoxelVertex v;
 	v.info = 3;
@@ -44,7 +64,46 @@ TEST_F(MeshTest, DISABLED_testSort) {
 	mesh.addTriangle(0, 3, 6);
 	mesh.addTriangle(0, 6, 4);
 
-	EXPECT_TRUE(mesh.sort(glm::vec3(100.0f, 100.0f, 100.0f)));
+	const glm::vec3 cameraPos(100.0f, 100.0f, 100.0f);
+	EXPECT_TRUE(mesh.sort(cameraPos));
+	EXPECT_EQ(36u, mesh.getNoOfIndices());
+	validateOrder(mesh, cameraPos);
+	EXPECT_FALSE(mesh.sort(cameraPos + 0.1f)) << "Small camera movements should not trigger a new sort";
+}
+
+TEST_F(MeshTest, testSortCameraMovement) {
+	Mesh mesh;
+	voxel::VoxelVertex v;
+	const int size = 32;
+	for (int z = 0; z <= size; ++z) {
+		for (int x = 0; x <= size; ++x) {
+			v.position = {(float)x, 0.0f, (float)z};
+			mesh.addVertex(v);
+		}
+	}
+	for (int z = 0; z < size; ++z) {
+		for (int x = 0; x < size; ++x) {
+			const IndexType i0 = z * (size + 1) + x;
+			const IndexType i1 = i0 + 1;
+			const IndexType i2 = i0 + size + 1;
+			const IndexType i3 = i2 + 1;
+			mesh.addTriangle(i0, i2, i1);
+			mesh.addTriangle(i1, i2, i3);
+		}
+	}
+	glm::vec3 cameraPos(-10.0f, 5.0f, -10.0f);
+	ASSERT_TRUE(mesh.sort(cameraPos));
+	validateOrder(mesh, cameraPos);
+	// small steps are fixed up from the previous order, the large jump needs a full sort
+	for (int i = 0; i < 10; ++i) {
+		cameraPos += glm::vec3(1.0f, 0.0f, 0.5f);
+		ASSERT_TRUE(mesh.sort(cameraPos));
+		validateOrder(mesh, cameraPos);
+	}
+	cameraPos = glm::vec3(50.0f, 5.0f, 50.0f);
+	ASSERT_TRUE(mesh.sort(cameraPos));
+	validateOrder(mesh, cameraPos);
+	EXPECT_EQ((size_t)size * size * 6, mesh.getNoOfIndices());
 }
 
 } // namespace voxel
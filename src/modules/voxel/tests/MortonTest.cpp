@@ -33,4 +33,11 @@ TEST_F(MortonTest, testLookup256) {
 	}
 }
 
+TEST_F(MortonTest, testIndex64) {
+	EXPECT_EQ((uint64_t)voxel::mortonIndex(5, 6, 7), voxel::mortonIndex64(5, 6, 7));
+	EXPECT_EQ((uint64_t)voxel::mortonIndex(255, 0, 128), voxel::mortonIndex64(255, 0, 128));
+	EXPECT_EQ(UINT64_C(0x1) << 60, voxel::mortonIndex64(1 << 20, 0, 0));
+	EXPECT_NE(voxel::mortonIndex64(-1, 0, 0), voxel::mortonIndex64(1, 0, 0));
+}
+
 } // namespace voxel
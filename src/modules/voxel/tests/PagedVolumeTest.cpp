@@ -0,0 +1,109 @@
+/**
+ * @file
+ */
+
+#include "voxel/PagedVolume.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxelutil/VolumeVisitor.h"
+
+namespace voxel {
+
+class PagedVolumeTest : public app::AbstractTest {};
+
+TEST_F(PagedVolumeTest, testSetVoxels) {
+	voxel::PagedVolume v(voxel::Region(0, 63));
+	ASSERT_EQ(8, v.brickCount());
+	ASSERT_EQ(0, v.allocatedBricks());
+	ASSERT_TRUE(v.setVoxel(0, 0, 0, voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_EQ(1, v.allocatedBricks());
+	ASSERT_TRUE(v.setVoxel(63, 63, 63, voxel::createVoxel(VoxelType::Generic, 2)));
+	ASSERT_EQ(2, v.allocatedBricks());
+	ASSERT_FALSE(v.setVoxel(64, 64, 64, voxel::createVoxel(VoxelType::Generic, 3)));
+	ASSERT_EQ(2, v.allocatedBricks());
+	EXPECT_EQ(1, v.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(2, v.voxel(63, 63, 63).getColor());
+	EXPECT_TRUE(voxel::isAir(v.voxel(1, 0, 0).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(v.voxel(64, 0, 0).getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testAirDoesNotAllocate) {
+	voxel::PagedVolume v(voxel::Region(0, 127));
+	ASSERT_TRUE(v.setVoxel(5, 5, 5, voxel::Voxel()));
+	ASSERT_EQ(0, v.allocatedBricks());
+	ASSERT_TRUE(v.setVoxel(5, 5, 5, voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_EQ(1, v.allocatedBricks());
+	ASSERT_TRUE(v.setVoxel(5, 5, 5, voxel::Voxel()));
+	ASSERT_EQ(1, v.compact());
+	ASSERT_EQ(0, v.allocatedBricks());
+}
+
+TEST_F(PagedVolumeTest, testUniformFill) {
+	voxel::PagedVolume v(voxel::Region(0, 95));
+	v.fill(voxel::createVoxel(VoxelType::Generic, 7));
+	ASSERT_EQ(0, v.allocatedBricks());
+	EXPECT_EQ(7, v.voxel(90, 10, 50).getColor());
+	ASSERT_TRUE(v.setVoxel(90, 10, 50, voxel::createVoxel(VoxelType::Generic, 8)));
+	ASSERT_EQ(1, v.allocatedBricks());
+	EXPECT_EQ(8, v.voxel(90, 10, 50).getColor());
+	EXPECT_EQ(7, v.voxel(91, 10, 50).getColor());
+}
+
+TEST_F(PagedVolumeTest, testCopyOnWrite) {
+	voxel::PagedVolume v(voxel::Region(0, 63));
+	ASSERT_TRUE(v.setVoxel(1, 1, 1, voxel::createVoxel(VoxelType::Generic, 1)));
+	voxel::PagedVolume copy(v);
+	ASSERT_TRUE(copy.setVoxel(1, 1, 1, voxel::createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(1, v.voxel(1, 1, 1).getColor());
+	EXPECT_EQ(2, copy.voxel(1, 1, 1).getColor());
+	ASSERT_TRUE(v.setVoxel(2, 2, 2, voxel::createVoxel(VoxelType::Generic, 3)));
+	EXPECT_TRUE(voxel::isAir(copy.voxel(2, 2, 2).getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testNegativeRegion) {
+	const voxel::Region region(glm::ivec3(-40, -5, -70), glm::ivec3(10, 3, -1));
+	voxel::PagedVolume v(region);
+	ASSERT_TRUE(v.setVoxel(region.getLowerCorner(), voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_TRUE(v.setVoxel(region.getUpperCorner(), voxel::createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(1, v.voxel(region.getLowerCorner()).getColor());
+	EXPECT_EQ(2, v.voxel(region.getUpperCorner()).getColor());
+	EXPECT_EQ(2, voxelutil::visitVolume(v, [](int, int, int, const voxel::Voxel &) {}));
+}
+
+TEST_F(PagedVolumeTest, testCopyFromRawVolume) {
+	const voxel::Region region(0, 40);
+	voxel::RawVolume rv(region);
+	for (int i = 0; i <= 40; ++i) {
+		rv.setVoxel(i, i, i, voxel::createVoxel(VoxelType::Generic, i));
+	}
+	voxel::PagedVolume v(region);
+	v.copyFrom(rv);
+	voxel::RawVolume target(region);
+	v.copyTo(target);
+	for (int i = 0; i <= 40; ++i) {
+		EXPECT_EQ(i, v.voxel(i, i, i).getColor());
+		EXPECT_EQ(i, target.voxel(i, i, i).getColor());
+	}
+	EXPECT_EQ(41, voxelutil::visitVolume(v, [](int, int, int, const voxel::Voxel &) {}));
+}
+
+TEST_F(PagedVolumeTest, testSampler) {
+	voxel::PagedVolume v(voxel::Region(0, 63));
+	v.setVoxel(31, 0, 0, voxel::createVoxel(VoxelType::Generic, 1));
+	v.setVoxel(32, 0, 0, voxel::createVoxel(VoxelType::Generic, 2));
+	PagedVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(31, 0, 0));
+	EXPECT_EQ(1, sampler.voxel().getColor());
+	EXPECT_EQ(2, sampler.peekVoxel1px0py0pz().getColor());
+	sampler.movePositiveX();
+	EXPECT_EQ(2, sampler.voxel().getColor());
+	EXPECT_EQ(1, sampler.peekVoxel1nx0py0pz().getColor());
+	ASSERT_TRUE(sampler.setVoxel(voxel::createVoxel(VoxelType::Generic, 3)));
+	EXPECT_EQ(3, sampler.voxel().getColor());
+	sampler.moveNegativeY();
+	EXPECT_FALSE(sampler.currentPositionValid());
+}
+
+} // namespace voxel
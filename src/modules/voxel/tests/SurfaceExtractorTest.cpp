@@ -4,12 +4,266 @@
 
 #include "voxel/SurfaceExtractor.h"
 #include "app/tests/AbstractTest.h"
+#include "core/Algorithm.h"
+#include "core/StringUtil.h"
+#include "core/collection/DynamicArray.h"
+#include "palette/Palette.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/RawVolume.h"
+#include <glm/geometric.hpp>
 
 namespace voxel {
 
-class SurfaceExtractorTest : public app::AbstractTest {};
+class SurfaceExtractorTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Splits the quads of the meshes into unit faces (axis, direction, position, color and the vertex info of
+	 * the four corners) to compare the surfaces of different extractors independent of how the quads were merged
+	 *
+	 * @param vertexInfo Quads are only merged if their corners have the same vertex info if ambient occlusion is
+	 * enabled - every unit face of a merged quad gets the vertex info of the quad corners then
+	 */
+	void collectUnitFaces(const voxel::ChunkMesh &mesh, bool vertexInfo, core::DynamicArray<core::String> &faces) {
+		for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+			const voxel::IndexArray &indices = mesh.mesh[m].getIndexVector();
+			const voxel::VertexArray &vertices = mesh.mesh[m].getVertexVector();
+			ASSERT_EQ(0u, indices.size() % 6u);
+			for (size_t i = 0; i < indices.size(); i += 6) {
+				glm::vec3 mins(vertices[indices[i]].position);
+				glm::vec3 maxs(mins);
+				for (size_t j = i; j < i + 6; ++j) {
+					mins = glm::min(mins, vertices[indices[j]].position);
+					maxs = glm::max(maxs, vertices[indices[j]].position);
+				}
+				const glm::vec3 &p0 = vertices[indices[i]].position;
+				const glm::vec3 &p1 = vertices[indices[i + 1]].position;
+				const glm::vec3 &p2 = vertices[indices[i + 2]].position;
+				const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				int axis = 0;
+				while (axis < 3 && mins[axis] != maxs[axis]) {
+					++axis;
+				}
+				ASSERT_LT(axis, 3);
+				const int u = (axis + 1) % 3;
+				const int v = (axis + 2) % 3;
+				// the vertex info of the quad corners - indexed by min/max of the u and v axis
+				int info[2][2] = {{-1, -1}, {-1, -1}};
+				for (size_t j = i; vertexInfo && j < i + 6; ++j) {
+					const voxel::VoxelVertex &vertex = vertices[indices[j]];
+					const int cu = vertex.position[u] == maxs[u] ? 1 : 0;
+					const int cv = vertex.position[v] == maxs[v] ? 1 : 0;
+					info[cu][cv] = vertex.info;
+				}
+				const int color = vertices[indices[i]].colorIndex;
+				const int positive = normal[axis] > 0.0f ? 1 : 0;
+				const glm::ivec3 imins(mins);
+				const glm::ivec3 imaxs(glm::max(maxs, mins + 1.0f));
+				for (int x = imins.x; x < imaxs.x; ++x) {
+					for (int y = imins.y; y < imaxs.y; ++y) {
+						for (int z = imins.z; z < imaxs.z; ++z) {
+							faces.push_back(core::string::format("%i:%i:%i:%3i:%6i:%6i:%6i:%3i:%3i:%3i:%3i", m, axis,
+																 positive, color, x, y, z, info[0][0], info[0][1],
+																 info[1][0], info[1][1]));
+						}
+					}
+				}
+			}
+		}
+		core::sort(faces.begin(), faces.end(), core::Less<core::String>());
+	}
+
+	/**
+	 * @brief Collect the quads with their corner vertices (position, ambient occlusion, color and normal) - the
+	 * corners are sorted to be independent of the triangulation
+	 */
+	void collectQuads(const voxel::ChunkMesh &mesh, core::DynamicArray<core::String> &quads) {
+		for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+			const voxel::IndexArray &indices = mesh.mesh[m].getIndexVector();
+			const voxel::VertexArray &vertices = mesh.mesh[m].getVertexVector();
+			const glm::ivec3 &offset = mesh.mesh[m].getOffset();
+			ASSERT_EQ(0u, indices.size() % 6u);
+			for (size_t i = 0; i < indices.size(); i += 6) {
+				core::DynamicArray<core::String> corners;
+				for (size_t j = i; j < i + 6; ++j) {
+					const voxel::VoxelVertex &vertex = vertices[indices[j]];
+					const glm::ivec3 p = glm::ivec3(vertex.position) + offset;
+					const core::String &corner =
+						core::string::format("%6i:%6i:%6i:%3i:%3i:%3i", p.x, p.y, p.z, (int)vertex.info,
+											 (int)vertex.colorIndex, (int)vertex.normalIndex);
+					if (core::find(corners.begin(), corners.end(), corner) == corners.end()) {
+						corners.push_back(corner);
+					}
+				}
+				ASSERT_EQ(4u, corners.size());
+				core::sort(corners.begin(), corners.end(), core::Less<core::String>());
+				quads.push_back(core::string::format("%i %s %s %s %s", m, corners[0].c_str(), corners[1].c_str(),
+													 corners[2].c_str(), corners[3].c_str()));
+			}
+		}
+		core::sort(quads.begin(), quads.end(), core::Less<core::String>());
+	}
+
+	void fillNoise(voxel::RawVolume &v) {
+		const voxel::Region &region = v.region();
+		uint32_t seed = 1337u;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					seed = seed * 1664525u + 1013904223u;
+					const uint32_t rnd = seed >> 24u;
+					if (rnd < 96u) {
+						continue;
+					}
+					if (rnd < 112u) {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Transparent, rnd & 1u));
+					} else {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (rnd & 3u) + 2u));
+					}
+				}
+			}
+		}
+	}
+
+	void compareWithCubic(const voxel::RawVolume &v, const voxel::Region &region, bool ambientOcclusion) {
+		// without merging the quads both extractors must produce the same quads with the same vertices
+		{
+			voxel::ChunkMesh cubicMesh;
+			voxel::SurfaceExtractionContext cubicCtx =
+				voxel::buildCubicContext(&v, region, cubicMesh, glm::ivec3(0), false, true, ambientOcclusion);
+			voxel::extractSurface(cubicCtx);
+
+			voxel::ChunkMesh binaryMesh;
+			voxel::SurfaceExtractionContext binaryCtx =
+				voxel::buildBinaryContext(&v, region, binaryMesh, glm::ivec3(0), false, true, ambientOcclusion);
+			voxel::extractSurface(binaryCtx);
+
+			core::DynamicArray<core::String> cubicQuads;
+			collectQuads(cubicMesh, cubicQuads);
+			core::DynamicArray<core::String> binaryQuads;
+			collectQuads(binaryMesh, binaryQuads);
+			ASSERT_FALSE(cubicQuads.empty());
+			ASSERT_EQ(cubicQuads.size(), binaryQuads.size());
+			for (size_t i = 0; i < cubicQuads.size(); ++i) {
+				ASSERT_EQ(cubicQuads[i], binaryQuads[i]) << "Quad " << i << " differs";
+			}
+		}
+
+		// the merged quads are laid out differently - but they must cover the same unit faces with the same vertex
+		// info at the corners. The greedy merging and the pairwise merging of the cubic extractor produce about the
+		// same amount of quads.
+		voxel::ChunkMesh cubicMesh;
+		voxel::SurfaceExtractionContext cubicCtx =
+			voxel::buildCubicContext(&v, region, cubicMesh, glm::ivec3(0), true, true, ambientOcclusion);
+		voxel::extractSurface(cubicCtx);
+
+		voxel::ChunkMesh binaryMesh;
+		voxel::SurfaceExtractionContext binaryCtx =
+			voxel::buildBinaryContext(&v, region, binaryMesh, glm::ivec3(0), true, true, ambientOcclusion);
+		voxel::extractSurface(binaryCtx);
+
+		core::DynamicArray<core::String> cubicFaces;
+		collectUnitFaces(cubicMesh, ambientOcclusion, cubicFaces);
+		core::DynamicArray<core::String> binaryFaces;
+		collectUnitFaces(binaryMesh, ambientOcclusion, binaryFaces);
+		ASSERT_FALSE(cubicFaces.empty());
+		ASSERT_EQ(cubicFaces.size(), binaryFaces.size());
+		for (size_t i = 0; i < cubicFaces.size(); ++i) {
+			ASSERT_EQ(cubicFaces[i], binaryFaces[i]) << "Unit face " << i << " differs";
+		}
+
+		for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+			const size_t cubicQuads = cubicMesh.mesh[m].getNoOfIndices() / 6u;
+			const size_t binaryQuads = binaryMesh.mesh[m].getNoOfIndices() / 6u;
+			EXPECT_LE(binaryQuads, cubicQuads + cubicQuads / 100u) << "cubic: " << cubicQuads << " quads";
+		}
+	}
+
+	/**
+	 * @brief Collect the triangles with absolute vertex positions - the vertices of each triangle are rotated to
+	 * start with the smallest one to keep the winding order
+	 */
+	void collectTriangles(const voxel::Mesh &mesh, core::DynamicArray<core::String> &tris) {
+		const voxel::IndexArray &indices = mesh.getIndexVector();
+		const voxel::VertexArray &vertices = mesh.getVertexVector();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			core::String v[3];
+			for (int j = 0; j < 3; ++j) {
+				const voxel::VoxelVertex &vertex = vertices[indices[i + j]];
+				const glm::ivec3 p = glm::ivec3(vertex.position) + mesh.getOffset();
+				v[j] = core::string::format("%6i:%6i:%6i:%3i:%3i:%3i", p.x, p.y, p.z, (int)vertex.info,
+											(int)vertex.colorIndex, (int)vertex.normalIndex);
+			}
+			int start = 0;
+			for (int j = 1; j < 3; ++j) {
+				if (v[j] < v[start]) {
+					start = j;
+				}
+			}
+			tris.push_back(v[start] + " " + v[(start + 1) % 3] + " " + v[(start + 2) % 3]);
+		}
+		core::sort(tris.begin(), tris.end(), core::Less<core::String>());
+	}
+
+	void compareChunked(voxel::SurfaceExtractionType type, bool mergeQuads, bool reuseVertices) {
+		ASSERT_TRUE(voxel::isChunkedExtractionSupported(type, reuseVertices));
+		ASSERT_EQ(!mergeQuads, voxel::isChunkedExtractionExact(type, mergeQuads, reuseVertices));
+		voxel::RawVolume v(voxel::Region(-3, 20));
+		fillNoise(v);
+		voxel::Region region = v.region();
+		region.shiftUpperCorner(1, 1, 1);
+		const palette::Palette &palette = voxel::getPalette();
+
+		voxel::ChunkMesh serialMesh;
+		voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &v, region, palette, serialMesh,
+																   glm::ivec3(0), mergeQuads, reuseVertices, true);
+		voxel::extractSurface(ctx);
+
+		core::DynamicArray<voxel::ChunkMesh *> chunks;
+		for (const voxel::Region &chunkRegion : voxel::chunkRegions(region, 7)) {
+			voxel::ChunkMesh *chunk = new voxel::ChunkMesh();
+			voxel::SurfaceExtractionContext chunkCtx = voxel::createContext(
+				type, &v, chunkRegion, palette, *chunk, glm::ivec3(0), mergeQuads, reuseVertices, true);
+			voxel::extractSurface(chunkCtx);
+			chunks.push_back(chunk);
+		}
+		voxel::ChunkMesh stitchedMesh;
+		voxel::stitchChunkMeshes(chunks, region.getLowerCorner(), stitchedMesh, reuseVertices);
+		for (voxel::ChunkMesh *chunk : chunks) {
+			delete chunk;
+		}
+
+		if (mergeQuads) {
+			// the quads are not merged across the chunk borders - but the faces and their vertex info are the same
+			core::DynamicArray<core::String> serialFaces;
+			collectUnitFaces(serialMesh, true, serialFaces);
+			core::DynamicArray<core::String> stitchedFaces;
+			collectUnitFaces(stitchedMesh, true, stitchedFaces);
+			ASSERT_FALSE(serialFaces.empty());
+			ASSERT_EQ(serialFaces.size(), stitchedFaces.size());
+			for (size_t i = 0; i < serialFaces.size(); ++i) {
+				ASSERT_EQ(serialFaces[i], stitchedFaces[i]) << "Unit face " << i << " differs";
+			}
+			for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+				EXPECT_GE(stitchedMesh.mesh[m].getNoOfIndices(), serialMesh.mesh[m].getNoOfIndices());
+			}
+			return;
+		}
+
+		for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+			EXPECT_EQ(serialMesh.mesh[m].getNoOfVertices(), stitchedMesh.mesh[m].getNoOfVertices());
+			core::DynamicArray<core::String> serialTris;
+			collectTriangles(serialMesh.mesh[m], serialTris);
+			core::DynamicArray<core::String> stitchedTris;
+			collectTriangles(stitchedMesh.mesh[m], stitchedTris);
+			ASSERT_FALSE(serialTris.empty());
+			ASSERT_EQ(serialTris.size(), stitchedTris.size());
+			for (size_t i = 0; i < serialTris.size(); ++i) {
+				ASSERT_EQ(serialTris[i], stitchedTris[i]) << "Triangle " << i << " differs in mesh " << m;
+			}
+		}
+	}
+};
 
 // https://github.com/vengi-voxel/vengi/issues/389
 // 63 vertices mesh object. When you import this one into Blender, then when manually merged (Mesh > Merge > By Distance
@@ -133,4 +387,72 @@ TEST_F(SurfaceExtractorTest, testMeshExtractionIssue445) {
 	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
 }
 
+TEST_F(SurfaceExtractorTest, testBinaryMeshExtractionIssue445) {
+	glm::ivec3 mins(-1, -1, -1);
+	glm::ivec3 maxs(1, -1, 1);
+	voxel::Region region(mins, maxs);
+	voxel::RawVolume v(region);
+	for (int x = mins.x; x <= maxs.x; ++x) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int z = mins.z; z <= maxs.z; ++z) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+
+	voxel::ChunkMesh mesh;
+
+	region.shiftUpperCorner(1, 1, 1);
+	SurfaceExtractionContext ctx = voxel::buildBinaryContext(&v, region, mesh, glm::ivec3(0), true, true, true);
+	voxel::extractSurface(ctx);
+	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
+	EXPECT_EQ(36, (int)mesh.mesh[0].getNoOfIndices());
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMatchesCubicAmbientOcclusion) {
+	voxel::RawVolume v(voxel::Region(-3, 20));
+	fillNoise(v);
+	compareWithCubic(v, v.region(), true);
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMatchesCubicNoAmbientOcclusion) {
+	voxel::RawVolume v(voxel::Region(0, 20));
+	fillNoise(v);
+	compareWithCubic(v, v.region(), false);
+}
+
+// more than 64 slices per axis
+TEST_F(SurfaceExtractorTest, testBinaryMatchesCubicLargeRegion) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(0), glm::ivec3(129, 4, 70)));
+	fillNoise(v);
+	voxel::Region region = v.region();
+	region.shiftUpperCorner(1, 1, 1);
+	compareWithCubic(v, region, true);
+}
+
+TEST_F(SurfaceExtractorTest, testChunkedCubicReuseVertices) {
+	compareChunked(voxel::SurfaceExtractionType::Cubic, false, true);
+}
+
+TEST_F(SurfaceExtractorTest, testChunkedBinaryReuseVertices) {
+	compareChunked(voxel::SurfaceExtractionType::Binary, false, true);
+}
+
+TEST_F(SurfaceExtractorTest, testChunkedCubicMergeQuads) {
+	compareChunked(voxel::SurfaceExtractionType::Cubic, true, true);
+}
+
+TEST_F(SurfaceExtractorTest, testChunkedBinaryMergeQuads) {
+	compareChunked(voxel::SurfaceExtractionType::Binary, true, true);
+}
+
+TEST_F(SurfaceExtractorTest, testChunkedExactness) {
+	EXPECT_TRUE(voxel::isChunkedExtractionSupported(voxel::SurfaceExtractionType::Cubic, true));
+	EXPECT_FALSE(voxel::isChunkedExtractionSupported(voxel::SurfaceExtractionType::Cubic, false));
+	EXPECT_FALSE(voxel::isChunkedExtractionSupported(voxel::SurfaceExtractionType::MarchingCubes, true));
+	EXPECT_FALSE(voxel::isChunkedExtractionExact(voxel::SurfaceExtractionType::Cubic, true, true));
+	EXPECT_FALSE(voxel::isChunkedExtractionExact(voxel::SurfaceExtractionType::Cubic, false, false));
+	EXPECT_FALSE(voxel::isChunkedExtractionExact(voxel::SurfaceExtractionType::MarchingCubes, false, false));
+}
+
 } // namespace voxel
@@ -26,7 +26,7 @@ bool FormatConfig::init() {
 	core::Var::get(cfg::VoxformatMergequads, "true", core::CV_NOPERSIST, _("Merge similar quads to optimize the mesh"),
 				   core::Var::boolValidator);
 	core::Var::get(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic),
-				   core::CV_SHADER, _("0 = cubes, 1 = marching cubes"),
+				   core::CV_SHADER, _("0 = cubes, 1 = marching cubes, 2 = cubes (binary greedy meshing)"),
 				   core::Var::minMaxValidator<(int)voxel::SurfaceExtractionType::Cubic,
 											  (int)voxel::SurfaceExtractionType::Max - 1>);
 	core::Var::get(cfg::VoxformatReusevertices, "true", core::CV_NOPERSIST,
@@ -70,7 +70,8 @@ bool FormatConfig::init() {
 	core::Var::get(cfg::VoxformatFillHollow, "true", core::CV_NOPERSIST,
 				   _("Fill the hollows when voxelizing a mesh format"), core::Var::boolValidator);
 	core::Var::get(cfg::VoxformatVoxelizeMode, MeshFormat::VoxelizeMode::HighQuality, core::CV_NOPERSIST,
-				   _("0 = high quality, 1 = faster and less memory"), core::Var::minMaxValidator<0, 1>);
+				   _("0 = high quality, 1 = faster and less memory, 2 = tiled and parallel"),
+				   core::Var::minMaxValidator<0, 2>);
 	core::Var::get(cfg::VoxformatQBTPaletteMode, "true", core::CV_NOPERSIST,
 				   _("Use palette mode in qubicle qbt export"), core::Var::boolValidator);
 	core::Var::get(cfg::VoxformatQBTMergeCompounds, "false", core::CV_NOPERSIST, _("Merge compounds on load"),
@@ -101,6 +102,13 @@ bool FormatConfig::init() {
 				   core::Var::boolValidator);
 	core::Var::get(cfg::VoxFormatGLTF_KHR_materials_specular, "false", core::CV_NOPERSIST,
 				   _("Apply KHR_materials_specular when saving into the gltf format"), core::Var::boolValidator);
+	core::Var::get(cfg::VoxFormatGLTF_MSFT_lod, "0", core::CV_NOPERSIST,
+				   _("The amount of simplified MSFT_lod levels to save into the gltf format"),
+				   core::Var::minMaxValidator<0, 4>);
+	core::Var::get(cfg::VoxFormatGLTF_KHR_mesh_quantization, "false", core::CV_NOPERSIST,
+				   _("Apply KHR_mesh_quantization when saving into the gltf format"), core::Var::boolValidator);
+	core::Var::get(cfg::VoxFormatGLTF_EXT_meshopt_compression, "false", core::CV_NOPERSIST,
+				   _("Apply EXT_meshopt_compression when saving into the gltf format"), core::Var::boolValidator);
 	core::Var::get(cfg::VoxFormatWithMaterials, "true", core::CV_NOPERSIST,
 				   _("Try to export material properties if the formats support it"), core::Var::boolValidator);
 	core::Var::get(cfg::VoxformatImageVolumeMaxDepth, "1", core::CV_NOPERSIST,
@@ -113,6 +121,8 @@ bool FormatConfig::init() {
 				   core::Var::minMaxValidator<PNGFormat::ImportType::Plane, PNGFormat::ImportType::Volume>);
 	static_assert(PNGFormat::ImportType::Plane == 0, "Plane must be 0");
 	static_assert(PNGFormat::ImportType::Volume == 2, "Volume must be 2");
+	core::Var::get(cfg::VoxformatMCRRegion, "", core::CV_NOPERSIST,
+				   _("Only load the given minecraft region part: 'miny maxy' or 'minx miny minz maxx maxy maxz'"));
 
 	core::Var::get(cfg::PalformatRGB6Bit, "false", core::CV_NOPERSIST,
 				   _("Use 6 bit color values for the palette (0-63) - used e.g. in C&C pal files"),
@@ -0,0 +1,520 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ConfigVar.h"
+#include "core/ScopedPtr.h"
+#include "core/Var.h"
+#include "core/collection/Buffer.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/FileStream.h"
+#include "io/MemoryArchive.h"
+#include "io/MemoryReadStream.h"
+#include "io/ZipReadStream.h"
+#include "io/ZipWriteStream.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/FormatConfig.h"
+#include "voxelformat/private/minecraft/MCRFormat.h"
+#include "voxelformat/private/minecraft/MinecraftPaletteMap.h"
+#include "voxelformat/private/minecraft/NamedBinaryTag.h"
+#include "voxelutil/VolumeCropper.h"
+#include "voxelutil/VolumeMerger.h"
+#include <glm/common.hpp>
+
+/**
+ * @brief The chunk conversion of the MCRFormat before the nbt data was streamed: the whole tag tree is built and the
+ * sections are converted one by one and merged afterwards.
+ *
+ * @note Only the sections of the newer versions (data version >= 2844) are supported - that's what the benchmark
+ * regions contain
+ */
+namespace legacy {
+
+static constexpr int MaxSize = 16;
+
+using SectionVolumes = core::DynamicArray<voxel::RawVolume *>;
+
+struct SectionPalette {
+	core::Buffer<uint8_t> pal;
+	uint32_t numBits = 0u;
+	palette::Palette mcpal;
+};
+
+static voxel::RawVolume *error(SectionVolumes &volumes) {
+	for (voxel::RawVolume *v : volumes) {
+		delete v;
+	}
+	return nullptr;
+}
+
+static voxel::RawVolume *finalize(SectionVolumes &volumes, int xPos, int zPos) {
+	if (volumes.empty()) {
+		return nullptr;
+	}
+	voxel::RawVolume *merged = voxelutil::merge(volumes);
+	for (voxel::RawVolume *v : volumes) {
+		delete v;
+	}
+	merged->translate(glm::ivec3(xPos * MaxSize, 0, zPos * MaxSize));
+	voxel::RawVolume *cropped = voxelutil::cropVolume(merged);
+	delete merged;
+	return cropped;
+}
+
+static bool parsePaletteList(const voxelformat::priv::NamedBinaryTag &palette, SectionPalette &sectionPal) {
+	if (palette.type() != voxelformat::priv::TagType::LIST) {
+		return false;
+	}
+	const voxelformat::priv::NBTList &paletteList = *palette.list();
+	const size_t paletteCount = paletteList.size();
+	if (paletteCount > 512u) {
+		return false;
+	}
+	sectionPal.pal.resize(paletteCount);
+	sectionPal.numBits = (uint32_t)glm::max(glm::ceil(glm::log2((float)paletteCount)), 4.0f);
+
+	int paletteEntry = 0;
+	for (const voxelformat::priv::NamedBinaryTag &block : paletteList) {
+		if (block.type() != voxelformat::priv::TagType::COMPOUND) {
+			return false;
+		}
+		for (const auto &entry : *block.compound()) {
+			if (entry->key != "Name") {
+				continue;
+			}
+			const core::String *value = entry->value.string();
+			if (value == nullptr) {
+				continue;
+			}
+			sectionPal.pal[paletteEntry] = voxelformat::findPaletteIndex(*value);
+		}
+		++paletteEntry;
+	}
+	return true;
+}
+
+static bool parseBlockStates(const palette::Palette &palette, const voxelformat::priv::NamedBinaryTag &data,
+							 SectionVolumes &volumes, int sectionY, const SectionPalette &secPal) {
+	if (data.type() != voxelformat::priv::TagType::LONG_ARRAY || data.longArray()->empty()) {
+		return true;
+	}
+	const voxel::Region region(0, MaxSize - 1);
+	voxel::RawVolume *v = new voxel::RawVolume(region);
+	bool hasBlocks = false;
+
+	const core::DynamicArray<int64_t> &blockStates = *data.longArray();
+	constexpr int blockCount = MaxSize * MaxSize * MaxSize;
+	uint8_t blocks[blockCount];
+	int bsCnt = 0;
+	size_t bitCnt = 0;
+	const size_t bitSize = secPal.numBits;
+	const uint32_t bitMask = (1 << bitSize) - 1;
+	for (int i = 0; i < blockCount; i++) {
+		const uint64_t blockState = blockStates[bsCnt];
+		const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
+		if (blockIndex < secPal.pal.size()) {
+			blocks[i] = secPal.pal[blockIndex];
+			hasBlocks = true;
+		} else {
+			blocks[i] = 0;
+		}
+		bitCnt += bitSize;
+		if (bitCnt + bitSize > 64) {
+			bsCnt++;
+			bitCnt = 0;
+		}
+	}
+
+	glm::ivec3 sPos;
+	for (sPos.y = 0; sPos.y < MaxSize; ++sPos.y) {
+		for (sPos.z = 0; sPos.z < MaxSize; ++sPos.z) {
+			for (sPos.x = 0; sPos.x < MaxSize; ++sPos.x) {
+				const uint16_t i = sPos.y * MaxSize * MaxSize + sPos.z * MaxSize + sPos.x;
+				const uint8_t color = blocks[i];
+				if (color) {
+					const uint8_t palColIdx = palette.getClosestMatch(secPal.mcpal.color(color));
+					v->setVoxel(sPos, voxel::createVoxel(palette, palColIdx));
+				}
+			}
+		}
+	}
+
+	if (hasBlocks) {
+		v->translate(glm::ivec3(0, sectionY * MaxSize, 0));
+		volumes.push_back(v);
+	} else {
+		delete v;
+	}
+	return true;
+}
+
+static voxel::RawVolume *parseSections(const voxelformat::priv::NamedBinaryTag &root, const palette::Palette &pal) {
+	const voxelformat::priv::NamedBinaryTag &sections = root.get("sections");
+	if (!sections.valid() || sections.type() != voxelformat::priv::TagType::LIST) {
+		return nullptr;
+	}
+	const int32_t xPos = root.get("xPos").int32();
+	const int32_t zPos = root.get("zPos").int32();
+	SectionVolumes volumes;
+	for (const voxelformat::priv::NamedBinaryTag &section : *sections.list()) {
+		const voxelformat::priv::NamedBinaryTag &blockStates = section.get("block_states");
+		if (!blockStates.valid()) {
+			return error(volumes);
+		}
+		const int8_t sectionY = section.get("Y").int8();
+		const voxelformat::priv::NamedBinaryTag &palette = blockStates.get("palette");
+		if (!palette.valid()) {
+			return error(volumes);
+		}
+		SectionPalette secPal;
+		secPal.mcpal.minecraft();
+		if (!parsePaletteList(palette, secPal)) {
+			return error(volumes);
+		}
+		if (!parseBlockStates(pal, blockStates.get("data"), volumes, sectionY, secPal)) {
+			return error(volumes);
+		}
+	}
+	return finalize(volumes, xPos, zPos);
+}
+
+/**
+ * @param stream The uncompressed nbt data of one chunk
+ */
+static voxel::RawVolume *loadChunk(io::ReadStream &stream, const palette::Palette &palette) {
+	voxelformat::priv::NamedBinaryTagContext ctx;
+	ctx.stream = &stream;
+	const voxelformat::priv::NamedBinaryTag &root = voxelformat::priv::NamedBinaryTag::parse(ctx);
+	if (!root.valid() || root.get("DataVersion").int32() < 2844) {
+		return nullptr;
+	}
+	return parseSections(root, palette);
+}
+
+/**
+ * @brief Reads, decompresses and converts the chunks of the region file one after another
+ */
+static bool loadRegion(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
+					   const palette::Palette &palette) {
+	uint32_t offsets[voxelformat::MCRFormat::SECTOR_INTS];
+	for (int i = 0; i < voxelformat::MCRFormat::SECTOR_INTS; ++i) {
+		uint8_t raw[4];
+		if (stream.read(raw, sizeof(raw)) != (int)sizeof(raw)) {
+			return false;
+		}
+		if (raw[3] == 0u) {
+			offsets[i] = 0u;
+			continue;
+		}
+		offsets[i] = ((raw[0] << 16) + (raw[1] << 8) + raw[2]) * voxelformat::MCRFormat::SECTOR_BYTES;
+	}
+	for (int i = 0; i < voxelformat::MCRFormat::SECTOR_INTS; ++i) {
+		if (offsets[i] < 2u * voxelformat::MCRFormat::SECTOR_BYTES || stream.seek(offsets[i]) == -1) {
+			continue;
+		}
+		uint32_t nbtSize;
+		uint8_t version;
+		if (stream.readUInt32BE(nbtSize) != 0 || nbtSize == 0 || stream.readUInt8(version) != 0) {
+			continue;
+		}
+		io::ZipReadStream zipStream(stream, (int)nbtSize - 1);
+		voxel::RawVolume *volume = loadChunk(zipStream, palette);
+		if (volume == nullptr) {
+			return false;
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
+	}
+	return true;
+}
+
+} // namespace legacy
+
+/**
+ * @brief Exposes the chunk parsing of the streaming loader
+ */
+class BenchMCRFormat : public voxelformat::MCRFormat {
+public:
+	using MCRFormat::createVolume;
+	using MCRFormat::loadGroupsPalette;
+	using MCRFormat::MinecraftChunk;
+	using MCRFormat::parseChunk;
+};
+
+/**
+ * @brief Compares the streaming nbt reader of the MCRFormat with building the whole nbt tree and converting the
+ * sections like the loader did before - for a synthetic region and a real region file from the test data. Also
+ * measures the parallel region loading with and without a region filter.
+ *
+ * The benchmarks take the region as argument: @c 0 is the synthetic region, @c 1 is @c r.0.-2.mca
+ */
+class MCRBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int SectorBytes = voxelformat::MCRFormat::SECTOR_BYTES;
+	static constexpr int Regions = 2;
+
+	struct Region {
+		core::String filename;
+		// the compressed nbt data of each chunk
+		core::DynamicArray<core::Buffer<uint8_t>> chunks;
+	};
+
+	io::MemoryArchivePtr _archive;
+	Region _regions[Regions];
+
+	/**
+	 * @brief Builds a chunk with 24 sections that looks like the chunks of a current minecraft version - including
+	 * light and height map data that isn't needed for the voxels
+	 */
+	static voxelformat::priv::NamedBinaryTag createChunk(int x, int z) {
+		using namespace voxelformat::priv;
+		static const char *Blocks[]{"minecraft:stone", "minecraft:dirt", "minecraft:grass_block", "minecraft:sand",
+									"minecraft:gravel", "minecraft:oak_log", "minecraft:oak_leaves",
+									"minecraft:water"};
+		NBTList sections;
+		for (int y = -4; y < 20; ++y) {
+			NBTList palette;
+			for (const char *block : Blocks) {
+				NBTCompound entry;
+				entry.put("Name", NamedBinaryTag(core::String(block)));
+				NBTCompound properties;
+				properties.put("snowy", NamedBinaryTag(core::String("false")));
+				entry.put("Properties", NamedBinaryTag(core::move(properties)));
+				palette.emplace_back(core::move(entry));
+			}
+			// 4 bits per block
+			core::DynamicArray<int64_t> data;
+			data.resize(256);
+			for (int i = 0; i < 256; ++i) {
+				data[i] = (int64_t)(0x0123456701234567ull + (uint64_t)(i + y + x * z));
+			}
+			NBTCompound blockStates;
+			blockStates.put("palette", NamedBinaryTag(core::move(palette)));
+			blockStates.put("data", NamedBinaryTag(core::move(data)));
+
+			core::DynamicArray<int8_t> light;
+			light.resize(2048);
+			NBTCompound section;
+			section.put("Y", NamedBinaryTag((int8_t)y));
+			section.put("block_states", NamedBinaryTag(core::move(blockStates)));
+			section.put("BlockLight", NamedBinaryTag(core::DynamicArray<int8_t>(light)));
+			section.put("SkyLight", NamedBinaryTag(core::move(light)));
+			sections.emplace_back(core::move(section));
+		}
+		NBTCompound heightmaps;
+		for (const char *name : {"MOTION_BLOCKING", "OCEAN_FLOOR", "WORLD_SURFACE"}) {
+			core::DynamicArray<int64_t> heights;
+			heights.resize(37);
+			heightmaps.put(name, NamedBinaryTag(core::move(heights)));
+		}
+		NBTCompound root;
+		root.put("DataVersion", NamedBinaryTag((int32_t)3465));
+		root.put("xPos", NamedBinaryTag((int32_t)x));
+		root.put("zPos", NamedBinaryTag((int32_t)z));
+		root.put("Status", NamedBinaryTag(core::String("minecraft:full")));
+		root.put("Heightmaps", NamedBinaryTag(core::move(heightmaps)));
+		root.put("sections", NamedBinaryTag(core::move(sections)));
+		return NamedBinaryTag(core::move(root));
+	}
+
+	static void createRegion(io::BufferedReadWriteStream &region) {
+		constexpr int chunks = voxelformat::MCRFormat::SECTOR_INTS;
+		core::DynamicArray<core::Buffer<uint8_t>> compressed;
+		compressed.resize(chunks);
+		for (int i = 0; i < chunks; ++i) {
+			io::BufferedReadWriteStream chunk;
+			{
+				io::ZipWriteStream zipStream(chunk);
+				voxelformat::priv::NamedBinaryTag::write(createChunk(i % 32, i / 32), "", zipStream);
+			}
+			compressed[i].append(chunk.getBuffer(), chunk.size());
+		}
+
+		// location table - the chunk data starts after the two header sectors
+		uint32_t sector = 2;
+		for (const core::Buffer<uint8_t> &chunk : compressed) {
+			const uint32_t sectorCount = (uint32_t)((chunk.size() + 5 + SectorBytes - 1) / SectorBytes);
+			region.writeUInt8((uint8_t)(sector >> 16));
+			region.writeUInt8((uint8_t)(sector >> 8));
+			region.writeUInt8((uint8_t)sector);
+			region.writeUInt8((uint8_t)sectorCount);
+			sector += sectorCount;
+		}
+		// timestamps
+		for (int i = 0; i < chunks; ++i) {
+			region.writeUInt32BE(0u);
+		}
+		for (const core::Buffer<uint8_t> &chunk : compressed) {
+			region.writeUInt32BE((uint32_t)chunk.size() + 1);
+			region.writeUInt8(2); // deflate
+			region.write(chunk.data(), chunk.size());
+			while (region.size() % SectorBytes) {
+				region.writeUInt8(0);
+			}
+		}
+	}
+
+	/**
+	 * @brief Adds the region file to the archive and extracts the compressed nbt data of its chunks
+	 */
+	void addRegion(Region &region, const core::String &filename, const uint8_t *data, size_t size) {
+		region.filename = filename;
+		_archive->add(filename, data, size);
+		if (size < 2u * SectorBytes) {
+			return;
+		}
+		for (int i = 0; i < voxelformat::MCRFormat::SECTOR_INTS; ++i) {
+			const uint8_t *location = data + i * 4;
+			const size_t offset = (size_t)((location[0] << 16) + (location[1] << 8) + location[2]) * SectorBytes;
+			if (location[3] == 0u || offset < 2u * SectorBytes || offset + 5 > size) {
+				continue;
+			}
+			const uint8_t *chunk = data + offset;
+			const size_t nbtSize = (size_t)((chunk[0] << 24) + (chunk[1] << 16) + (chunk[2] << 8) + chunk[3]);
+			if (nbtSize <= 1u || offset + 4 + nbtSize > size) {
+				continue;
+			}
+			core::Buffer<uint8_t> compressed;
+			compressed.append(chunk + 5, nbtSize - 1);
+			region.chunks.emplace_back(core::move(compressed));
+		}
+	}
+
+	const Region *region(benchmark::State &state) {
+		const Region &region = _regions[state.range(0)];
+		if (region.chunks.empty()) {
+			state.SkipWithError("Could not load the region file");
+			return nullptr;
+		}
+		return &region;
+	}
+
+	void load(benchmark::State &state, const char *filter) {
+		const Region *r = region(state);
+		if (r == nullptr) {
+			return;
+		}
+		core::Var::getSafe(cfg::VoxformatMCRRegion)->setVal(filter);
+		voxelformat::LoadContext ctx;
+		for (auto _ : state) {
+			BenchMCRFormat format;
+			scenegraph::SceneGraph sceneGraph;
+			palette::Palette palette;
+			benchmark::DoNotOptimize(format.loadGroupsPalette(r->filename, _archive, sceneGraph, palette, ctx));
+		}
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)r->chunks.size());
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		voxelformat::FormatConfig::init();
+		if (_archive) {
+			return;
+		}
+		_archive = io::openMemoryArchive();
+		io::BufferedReadWriteStream synthetic;
+		createRegion(synthetic);
+		addRegion(_regions[0], "r.0.0.mca", synthetic.getBuffer(), synthetic.size());
+
+		const io::FilePtr &file = _benchmarkApp->filesystem()->open("r.0.-2.mca");
+		if (!file->exists()) {
+			return;
+		}
+		io::FileStream stream(file);
+		core::Buffer<uint8_t> data;
+		data.resize(stream.size());
+		if (stream.read(data.data(), data.size()) == (int)data.size()) {
+			addRegion(_regions[1], "r.0.-2.mca", data.data(), data.size());
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(MCRBenchmark, ParseTree)(benchmark::State &state) {
+	const Region *r = region(state);
+	if (r == nullptr) {
+		return;
+	}
+	palette::Palette palette;
+	palette.minecraft();
+	for (auto _ : state) {
+		for (const core::Buffer<uint8_t> &chunk : r->chunks) {
+			io::MemoryReadStream memStream(chunk.data(), chunk.size());
+			io::ZipReadStream zipStream(memStream, (int)memStream.size());
+			voxel::RawVolume *volume = legacy::loadChunk(zipStream, palette);
+			benchmark::DoNotOptimize(volume);
+			delete volume;
+		}
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)r->chunks.size());
+}
+
+BENCHMARK_DEFINE_F(MCRBenchmark, ParseChunk)(benchmark::State &state) {
+	const Region *r = region(state);
+	if (r == nullptr) {
+		return;
+	}
+	palette::Palette palette;
+	palette.minecraft();
+	for (auto _ : state) {
+		// the loader maps the minecraft palette once per region
+		palette::Palette mcpal;
+		mcpal.minecraft();
+		voxel::Voxel voxels[palette::PaletteMaxColors];
+		for (int i = 0; i < palette::PaletteMaxColors; ++i) {
+			voxels[i] = voxel::createVoxel(palette, palette.getClosestMatch(mcpal.color(i)));
+		}
+		for (const core::Buffer<uint8_t> &chunk : r->chunks) {
+			io::MemoryReadStream memStream(chunk.data(), chunk.size());
+			io::ZipReadStream zipStream(memStream, (int)memStream.size());
+			BenchMCRFormat::MinecraftChunk mcChunk;
+			bool error = false;
+			voxel::RawVolume *volume = nullptr;
+			if (BenchMCRFormat::parseChunk(zipStream, mcChunk)) {
+				volume = BenchMCRFormat::createVolume(mcChunk, voxel::Region::InvalidRegion, voxels, error);
+			}
+			benchmark::DoNotOptimize(volume);
+			delete volume;
+		}
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)r->chunks.size());
+}
+
+BENCHMARK_DEFINE_F(MCRBenchmark, LoadLegacy)(benchmark::State &state) {
+	const Region *r = region(state);
+	if (r == nullptr) {
+		return;
+	}
+	palette::Palette palette;
+	palette.minecraft();
+	for (auto _ : state) {
+		core::ScopedPtr<io::SeekableReadStream> stream(_archive->readStream(r->filename));
+		scenegraph::SceneGraph sceneGraph;
+		benchmark::DoNotOptimize(legacy::loadRegion(*stream, sceneGraph, palette));
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)r->chunks.size());
+}
+
+BENCHMARK_DEFINE_F(MCRBenchmark, Load)(benchmark::State &state) {
+	load(state, "");
+}
+
+BENCHMARK_DEFINE_F(MCRBenchmark, LoadYRange)(benchmark::State &state) {
+	load(state, "0 63");
+}
+
+BENCHMARK_DEFINE_F(MCRBenchmark, LoadBounds)(benchmark::State &state) {
+	load(state, "0 0 0 127 63 127");
+}
+
+BENCHMARK_REGISTER_F(MCRBenchmark, ParseTree)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MCRBenchmark, ParseChunk)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MCRBenchmark, LoadLegacy)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MCRBenchmark, Load)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MCRBenchmark, LoadYRange)->Arg(0)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MCRBenchmark, LoadBounds)->Arg(0)->Unit(benchmark::kMillisecond);
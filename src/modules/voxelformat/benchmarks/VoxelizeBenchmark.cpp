@@ -0,0 +1,97 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ConfigVar.h"
+#include "core/Var.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxelformat/FormatConfig.h"
+#include "voxelformat/private/mesh/MeshFormat.h"
+#include <glm/ext/scalar_constants.hpp>
+
+namespace {
+
+class BenchmarkMesh : public voxelformat::MeshFormat {
+public:
+	bool saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &, const Meshes &, const core::String &,
+					const io::ArchivePtr &, const glm::vec3 &, bool, bool, bool) override {
+		return false;
+	}
+
+	int voxelize(scenegraph::SceneGraph &sceneGraph, const TriCollection &tris) {
+		return voxelizeNode("benchmark", sceneGraph, tris);
+	}
+};
+
+} // namespace
+
+class VoxelizeBenchmark : public app::AbstractBenchmark {
+protected:
+	voxelformat::MeshFormat::TriCollection _tris;
+
+	/**
+	 * @brief A finely tessellated uv sphere with a color gradient - large mesh imports usually have a lot of
+	 * triangles that are much smaller than a voxel
+	 */
+	void createSphere(float radius, int slices, int stacks) {
+		auto vertex = [&](int slice, int stack) {
+			const float theta = (float)stack / (float)stacks * glm::pi<float>();
+			const float phi = (float)slice / (float)slices * glm::two_pi<float>();
+			return glm::vec3(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi)) *
+				   radius;
+		};
+		auto color = [&](int stack) {
+			const uint8_t v = (uint8_t)(255 * stack / stacks);
+			return core::RGBA(v, 255 - v, 128, 255);
+		};
+		for (int stack = 0; stack < stacks; ++stack) {
+			for (int slice = 0; slice < slices; ++slice) {
+				voxelformat::TexturedTri tri;
+				tri.vertices[0] = vertex(slice, stack);
+				tri.vertices[1] = vertex(slice + 1, stack);
+				tri.vertices[2] = vertex(slice + 1, stack + 1);
+				tri.color[0] = tri.color[1] = color(stack);
+				tri.color[2] = color(stack + 1);
+				_tris.push_back(tri);
+				tri.vertices[1] = vertex(slice + 1, stack + 1);
+				tri.vertices[2] = vertex(slice, stack + 1);
+				tri.color[1] = tri.color[2] = color(stack + 1);
+				_tris.push_back(tri);
+			}
+		}
+	}
+
+	void voxelize(benchmark::State &state, int mode) {
+		core::Var::getSafe(cfg::VoxformatVoxelizeMode)->setVal(mode);
+		BenchmarkMesh mesh;
+		for (auto _ : state) {
+			scenegraph::SceneGraph sceneGraph;
+			benchmark::DoNotOptimize(mesh.voxelize(sceneGraph, _tris));
+		}
+		state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)_tris.size());
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		voxelformat::FormatConfig::init();
+		core::Var::getSafe(cfg::VoxformatFillHollow)->setVal(false);
+		if (_tris.empty()) {
+			createSphere(32.0f, 128, 64);
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(VoxelizeBenchmark, HighQuality)(benchmark::State &state) {
+	voxelize(state, voxelformat::MeshFormat::VoxelizeMode::HighQuality);
+}
+
+BENCHMARK_DEFINE_F(VoxelizeBenchmark, Tiled)(benchmark::State &state) {
+	voxelize(state, voxelformat::MeshFormat::VoxelizeMode::Tiled);
+}
+
+BENCHMARK_REGISTER_F(VoxelizeBenchmark, HighQuality)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VoxelizeBenchmark, Tiled)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1040,6 +1040,9 @@ struct Buffer {
   std::string
       uri;  // considered as required here but not in the spec (need to clarify)
             // uri is not decoded(e.g. whitespace may be represented as %20)
+  // byteLength of a buffer without data - e.g. the fallback buffer of the
+  // EXT_meshopt_compression extension
+  size_t fallbackByteLength{0};
   Value extras;
   ExtensionMap extensions;
 
@@ -2009,7 +2012,8 @@ bool Asset::operator==(const Asset &other) const {
 bool Buffer::operator==(const Buffer &other) const {
   return this->data == other.data && this->extensions == other.extensions &&
          this->extras == other.extras && this->name == other.name &&
-         this->uri == other.uri;
+         this->uri == other.uri &&
+         this->fallbackByteLength == other.fallbackByteLength;
 }
 bool BufferView::operator==(const BufferView &other) const {
   return this->buffer == other.buffer && this->byteLength == other.byteLength &&
@@ -4541,6 +4545,22 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
   buffer->uri.clear();
   ParseStringProperty(&buffer->uri, err, o, "uri", false, "Buffer");
 
+  // the fallback buffer of EXT_meshopt_compression doesn't need any data
+  if (buffer->uri.empty()) {
+    detail::json_const_iterator extIt;
+    detail::json_const_iterator meshoptIt;
+    if (detail::FindMember(o, "extensions", extIt) &&
+        detail::FindMember(detail::GetValue(extIt), "EXT_meshopt_compression",
+                           meshoptIt)) {
+      buffer->data.clear();
+      buffer->fallbackByteLength = byteLength;
+      ParseStringProperty(&buffer->name, err, o, "name", false);
+      ParseExtrasAndExtensions(buffer, err, o,
+                               store_original_json_for_extras_and_extensions);
+      return true;
+    }
+  }
+
   // having an empty uri for a non embedded image should not be valid
   if (!is_binary && buffer->uri.empty()) {
     if (err) {
@@ -7481,8 +7501,21 @@ static void SerializeGltfAsset(const Asset &asset, detail::json &o) {
   SerializeExtrasAndExtensions(asset, o);
 }
 
+static void SerializeGltfBufferFallback(const Buffer &buffer,
+                                        detail::json &o) {
+  SerializeNumberProperty("byteLength", buffer.fallbackByteLength, o);
+
+  if (buffer.name.size()) SerializeStringProperty("name", buffer.name, o);
+
+  SerializeExtrasAndExtensions(buffer, o);
+}
+
 static void SerializeGltfBufferBin(const Buffer &buffer, detail::json &o,
                                    std::vector<unsigned char> &binBuffer) {
+  if (buffer.data.empty() && buffer.fallbackByteLength > 0) {
+    SerializeGltfBufferFallback(buffer, o);
+    return;
+  }
   SerializeNumberProperty("byteLength", buffer.data.size(), o);
   binBuffer = buffer.data;
 
@@ -7492,6 +7525,10 @@ static void SerializeGltfBufferBin(const Buffer &buffer, detail::json &o,
 }
 
 static void SerializeGltfBuffer(const Buffer &buffer, detail::json &o) {
+  if (buffer.data.empty() && buffer.fallbackByteLength > 0) {
+    SerializeGltfBufferFallback(buffer, o);
+    return;
+  }
   SerializeNumberProperty("byteLength", buffer.data.size(), o);
   SerializeGltfBufferData(buffer.data, o);
 
@@ -7503,6 +7540,10 @@ static void SerializeGltfBuffer(const Buffer &buffer, detail::json &o) {
 static bool SerializeGltfBuffer(const Buffer &buffer, detail::json &o,
                                 const std::string &binFilename,
                                 const std::string &binUri) {
+  if (buffer.data.empty() && buffer.fallbackByteLength > 0) {
+    SerializeGltfBufferFallback(buffer, o);
+    return true;
+  }
   if (!SerializeGltfBufferData(buffer.data, binFilename)) return false;
   SerializeNumberProperty("byteLength", buffer.data.size(), o);
   SerializeStringProperty("uri", binUri, o);
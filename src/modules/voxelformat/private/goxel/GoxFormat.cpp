@@ -3,11 +3,14 @@
  */
 
 #include "GoxFormat.h"
+#include "app/Async.h"
 #include "core/Common.h"
 #include "core/FourCC.h"
+#include "core/Hash.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
+#include "core/collection/Map.h"
 #include "image/Image.h"
 #include "io/MemoryReadStream.h"
 #include "io/Stream.h"
@@ -188,6 +191,12 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 	voxel::RawVolume *modelVolume = new voxel::RawVolume(voxel::Region(0, 0, 0, 1, 1, 1));
 	uint32_t blockCount;
 
+	if (!decodeBlocks(state)) {
+		Log::error("Could not load gox file: Failed to decode the blocks");
+		delete modelVolume;
+		return false;
+	}
+
 	palette::PaletteLookup palLookup(palette);
 	if ((stream.readUInt32(blockCount)) != 0) {
 		Log::error("Could not load gox file: Failed to read blockCount");
@@ -202,7 +211,7 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 			delete modelVolume;
 			return false;
 		}
-		if (index > state.images.size()) {
+		if (index >= state.images.size()) {
 			Log::error("Index out of bounds: %u", index);
 			delete modelVolume;
 			return false;
@@ -352,21 +361,41 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 }
 
 bool GoxFormat::loadChunk_BL16(State &state, const GoxChunk &c, io::SeekableReadStream &stream) {
-	uint8_t *png = (uint8_t *)core_malloc(c.length);
-	wrapBool(loadChunk_ReadData(stream, (char *)png, c.length))
-	image::ImagePtr img = image::createEmptyImage("gox-voxeldata");
-	bool success = img->load(png, c.length);
-	core_free(png);
-	if (!success) {
-		Log::error("Failed to load png chunk");
-		return false;
+	core::Buffer<uint8_t> png;
+	png.resize(c.length);
+	wrapBool(loadChunk_ReadData(stream, (char *)png.data(), c.length))
+	Log::debug("Found BL16 with index %i", (int)(state.images.size() + state.pngs.size()));
+	state.pngs.push_back(core::move(png));
+	return true;
+}
+
+bool GoxFormat::decodeBlocks(State &state) {
+	if (state.pngs.empty()) {
+		return true;
 	}
-	if (img->width() != 64 || img->height() != 64 || img->depth() != 4) {
-		Log::error("Invalid image dimensions: %i:%i", img->width(), img->height());
-		return false;
+	const size_t offset = state.images.size();
+	state.images.resize(offset + state.pngs.size());
+	app::for_parallel(0, (int)state.pngs.size(), 8, [&state, offset](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			const core::Buffer<uint8_t> &png = state.pngs[i];
+			image::ImagePtr img = image::createEmptyImage("gox-voxeldata");
+			if (!img->load(png.data(), (int)png.size())) {
+				Log::error("Failed to load png chunk");
+				continue;
+			}
+			if (img->width() != 64 || img->height() != 64 || img->depth() != 4) {
+				Log::error("Invalid image dimensions: %i:%i", img->width(), img->height());
+				continue;
+			}
+			state.images[offset + i] = img;
+		}
+	});
+	state.pngs.clear();
+	for (size_t i = offset; i < state.images.size(); ++i) {
+		if (!state.images[i]) {
+			return false;
+		}
 	}
-	Log::debug("Found BL16 with index %i", (int)state.images.size());
-	state.images.push_back(img);
 	return true;
 }
 
@@ -555,6 +584,7 @@ size_t GoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 		}
 		loadChunk_ValidateCRC(*stream);
 	}
+	wrapBool(decodeBlocks(state))
 
 	RGBAMap colors;
 	for (image::ImagePtr &img : state.images) {
@@ -746,7 +776,7 @@ bool GoxFormat::saveChunk_MATE(io::SeekableWriteStream &stream, const scenegraph
 }
 
 bool GoxFormat::saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-							   int numBlocks) {
+							   const core::DynamicArray<int> &blockIndices) {
 	int blockUid = 0;
 	int layerId = 0;
 	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
@@ -777,14 +807,18 @@ bool GoxFormat::saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph
 					if (isEmptyBlock(sceneGraph.resolveVolume(node), glm::ivec3(BlockSize), x, y, z)) {
 						continue;
 					}
-					Log::debug("Saved LAYR chunk %i at %i:%i:%i", blockUid, x, y, z);
-					wrapBool(stream.writeUInt32(blockUid++))
+					if (blockUid >= (int)blockIndices.size()) {
+						Log::error("Invalid amount of blocks");
+						return false;
+					}
+					const int blockIndex = blockIndices[blockUid++];
+					Log::debug("Saved LAYR chunk %i at %i:%i:%i", blockIndex, x, y, z);
+					wrapBool(stream.writeUInt32(blockIndex))
 					wrapBool(stream.writeInt32(x))
 					wrapBool(stream.writeInt32(z))
 					wrapBool(stream.writeInt32(y))
 					wrapBool(stream.writeUInt32(0))
 					--layerBlocks;
-					--numBlocks;
 				}
 			}
 		}
@@ -806,65 +840,157 @@ bool GoxFormat::saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph
 
 		++layerId;
 	}
-	if (numBlocks != 0) {
+	if (blockUid != (int)blockIndices.size()) {
 		Log::error("Invalid amount of blocks");
 		return false;
 	}
 	return true;
 }
 
-bool GoxFormat::saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int &blocks) {
-	blocks = 0;
-	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
+namespace {
+
+struct GoxBlock {
+	// 16^3 colors with x running fastest, then z and then y - only set until the png was created
+	uint32_t *rgba = nullptr;
+	uint8_t *png = nullptr;
+	int pngSize = 0;
+	uint32_t hash = 0u;
+	// index of the previous block with the same hash or -1
+	int next = -1;
+};
+
+using GoxBlockLookup = core::Map<uint32_t, int, 1031>;
+
+} // namespace
+
+bool GoxFormat::saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+							   core::DynamicArray<int> &blockIndices) {
+	const size_t rgbaSize = (size_t)BlockSize * BlockSize * BlockSize * sizeof(uint32_t);
+	// the blocks that were already written into the stream - they are referenced by their index in the LAYR chunks
+	core::DynamicArray<GoxBlock> written;
+	GoxBlockLookup writtenLookup;
+	bool success = true;
+
+	blockIndices.clear();
+	for (auto iter = sceneGraph.beginAllModels(); success && iter != sceneGraph.end(); ++iter) {
 		const scenegraph::SceneGraphNode &node = *iter;
 		const voxel::Region &region = sceneGraph.resolveRegion(node);
 		glm::ivec3 mins, maxs;
 		calcMinsMaxs(region, glm::ivec3(BlockSize), mins, maxs);
 
+		// collect the colors of the non empty blocks and merge the identical ones
+		core::DynamicArray<GoxBlock> blocks;
+		GoxBlockLookup blockLookup;
+		core::DynamicArray<int> nodeBlocks;
+		const palette::Palette &palette = node.palette();
 		voxel::RawVolume *mirrored = voxelutil::mirrorAxis(sceneGraph.resolveVolume(node), math::Axis::X);
+		uint32_t *rgba = (uint32_t *)core_malloc(rgbaSize);
 		for (int by = mins.y; by <= maxs.y; by += BlockSize) {
 			for (int bz = mins.z; bz <= maxs.z; bz += BlockSize) {
 				for (int bx = mins.x; bx <= maxs.x; bx += BlockSize) {
 					if (isEmptyBlock(mirrored, glm::ivec3(BlockSize), bx, by, bz)) {
 						continue;
 					}
-					GoxScopedChunkWriter scoped(stream, FourCC('B', 'L', '1', '6'));
 					const voxel::Region blockRegion(bx, by, bz, bx + BlockSize - 1, by + BlockSize - 1,
 													bz + BlockSize - 1);
-					const size_t size = (size_t)BlockSize * BlockSize * BlockSize * 4;
-					uint32_t *data = (uint32_t *)core_malloc(size);
 					int offset = 0;
-					const palette::Palette &palette = node.palette();
 					voxelutil::visitVolume(
 						*mirrored, blockRegion,
 						[&](int, int, int, const voxel::Voxel &voxel) {
 							if (voxel::isAir(voxel.getMaterial())) {
-								data[offset++] = 0;
+								rgba[offset++] = 0;
 							} else {
-								data[offset++] = palette.color(voxel.getColor());
+								rgba[offset++] = palette.color(voxel.getColor());
 							}
 						},
 						voxelutil::VisitAll(), voxelutil::VisitorOrder::YZX);
 
-					int pngSize = 0;
-					uint8_t *png = image::createPng(data, 64, 64, 4, &pngSize);
-					core_free(data);
-
-					if (stream.write(png, pngSize) == -1) {
-						Log::error("Could not write png into gox stream");
-						core_free(png);
-						delete mirrored;
-						return false;
+					const uint32_t hash = core::hash(rgba, (int)rgbaSize);
+					int head = -1;
+					blockLookup.get(hash, head);
+					int blockIdx = head;
+					while (blockIdx != -1 && core_memcmp(blocks[blockIdx].rgba, rgba, rgbaSize) != 0) {
+						blockIdx = blocks[blockIdx].next;
 					}
-					core_free(png);
-					Log::debug("Saved BL16 chunk %i with a pngsize of %i", blocks, pngSize);
-					++blocks;
+					if (blockIdx == -1) {
+						GoxBlock block;
+						block.rgba = rgba;
+						block.hash = hash;
+						block.next = head;
+						blockIdx = (int)blocks.size();
+						blocks.push_back(block);
+						blockLookup.put(hash, blockIdx);
+						rgba = (uint32_t *)core_malloc(rgbaSize);
+					}
+					nodeBlocks.push_back(blockIdx);
 				}
 			}
 		}
+		core_free(rgba);
 		delete mirrored;
+
+		app::for_parallel(0, (int)blocks.size(), 4, [&blocks](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				GoxBlock &block = blocks[i];
+				block.png = image::createPng(block.rgba, 64, 64, 4, &block.pngSize);
+				core_free(block.rgba);
+				block.rgba = nullptr;
+			}
+		});
+
+		// write the blocks that are not identical to a block of a previous node
+		core::DynamicArray<int> blockIndex;
+		blockIndex.resize(blocks.size());
+		for (size_t i = 0; i < blocks.size(); ++i) {
+			GoxBlock &block = blocks[i];
+			if (!success) {
+				core_free(block.png);
+				continue;
+			}
+			if (block.png == nullptr) {
+				Log::error("Could not create png for gox block");
+				success = false;
+				continue;
+			}
+			int head = -1;
+			writtenLookup.get(block.hash, head);
+			int writtenIdx = head;
+			while (writtenIdx != -1) {
+				const GoxBlock &other = written[writtenIdx];
+				if (other.pngSize == block.pngSize && core_memcmp(other.png, block.png, block.pngSize) == 0) {
+					break;
+				}
+				writtenIdx = other.next;
+			}
+			if (writtenIdx != -1) {
+				core_free(block.png);
+				blockIndex[i] = writtenIdx;
+				continue;
+			}
+			{
+				GoxScopedChunkWriter scoped(stream, FourCC('B', 'L', '1', '6'));
+				if (stream.write(block.png, block.pngSize) == -1) {
+					Log::error("Could not write png into gox stream");
+					core_free(block.png);
+					success = false;
+					continue;
+				}
+			}
+			blockIndex[i] = (int)written.size();
+			Log::debug("Saved BL16 chunk %i with a pngsize of %i", blockIndex[i], block.pngSize);
+			block.next = head;
+			written.push_back(block);
+			writtenLookup.put(block.hash, blockIndex[i]);
+		}
+		for (int blockIdx : nodeBlocks) {
+			blockIndices.push_back(blockIndex[blockIdx]);
+		}
 	}
-	return true;
+	for (GoxBlock &block : written) {
+		core_free(block.png);
+	}
+	Log::debug("Saved %i unique blocks for %i blocks", (int)written.size(), (int)blockIndices.size());
+	return success;
 }
 
 bool GoxFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
@@ -878,10 +1004,10 @@ bool GoxFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 	wrapSave(stream->writeUInt32(2))
 
 	wrapBool(saveChunk_PREV(sceneGraph, *stream, ctx))
-	int blocks = 0;
-	wrapBool(saveChunk_BL16(*stream, sceneGraph, blocks))
+	core::DynamicArray<int> blockIndices;
+	wrapBool(saveChunk_BL16(*stream, sceneGraph, blockIndices))
 	wrapBool(saveChunk_MATE(*stream, sceneGraph))
-	wrapBool(saveChunk_LAYR(*stream, sceneGraph, blocks))
+	wrapBool(saveChunk_LAYR(*stream, sceneGraph, blockIndices))
 	wrapBool(saveChunk_CAMR(*stream, sceneGraph))
 	wrapBool(saveChunk_LIGH(*stream))
 
@@ -7,6 +7,7 @@
 #include "core/collection/StringMap.h"
 #include "palette/Palette.h"
 #include "voxelformat/Format.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "io/Stream.h"
 
@@ -41,7 +42,8 @@ namespace voxelformat {
  *
  *  PREV: a png image for preview.
  *
- *  BL16: a 16^3 block saved as a 64x64 png image.
+ *  BL16: a 16^3 block saved as a 64x64 png image. Identical blocks are only
+ *        saved once and referenced by their index in the LAYR chunks.
  *
  *  LAYR: a layer:
  *      4 bytes: number of blocks.
@@ -84,6 +86,8 @@ private:
 	struct State {
 		int32_t version = 0;
 		core::DynamicArray<image::ImagePtr> images;
+		// the png data of the BL16 chunks that were not yet decoded into @c images
+		core::DynamicArray<core::Buffer<uint8_t>> pngs;
 		core::StringMap<palette::Material> materials;
 	};
 
@@ -94,6 +98,8 @@ private:
 	bool loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 						scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette);
 	bool loadChunk_BL16(State &state, const GoxChunk &c, io::SeekableReadStream &stream);
+	// Decode the png data of all the BL16 chunks that were read so far in parallel.
+	bool decodeBlocks(State &state);
 	bool loadChunk_MATE(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 						scenegraph::SceneGraph &sceneGraph);
 	bool loadChunk_CAMR(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
@@ -120,12 +126,14 @@ private:
 	// Write all the lights - not used.
 	bool saveChunk_LIGH(io::SeekableWriteStream &stream);
 
-	// Write all the blocks chunks.
-	bool saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int &blocks);
+	// Write all the unique blocks chunks - blockIndices contains the BL16 index for every non empty block.
+	bool saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+						core::DynamicArray<int> &blockIndices);
 	// Write all the materials.
 	bool saveChunk_MATE(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph);
 	// Write all the layers.
-	bool saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int numBlocks);
+	bool saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+						const core::DynamicArray<int> &blockIndices);
 	bool loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
 						scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 						const LoadContext &ctx) override;
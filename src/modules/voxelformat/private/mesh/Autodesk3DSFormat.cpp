@@ -9,6 +9,7 @@
 #include "image/Image.h"
 #include "io/Stream.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxelformat/private/mesh/MeshTextureCache.h"
 #include "voxelformat/private/mesh/TexturedTri.h"
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
@@ -364,11 +365,6 @@ bool Autodesk3DSFormat::readMaterialTexture(const io::ArchivePtr &archive, io::S
 		case priv::CHUNK_ID_TEXTURE_MAP_NAME: {
 			wrapBool(stream->readString(64, texture.name, true))
 			Log::debug("texture name: %s", texture.name.c_str());
-			texture.name = lookupTexture("", texture.name);
-			texture.texture = image::loadImage(texture.name);
-			if (!texture.texture || !texture.texture->isLoaded()) {
-				Log::warn("Failed to load texture %s", texture.name.c_str());
-			}
 			break;
 		}
 		case priv::CHUNK_ID_TEXTURE_MAP_TILING: {
@@ -660,6 +656,25 @@ bool Autodesk3DSFormat::voxelizeGroups(const core::String &filename, const io::A
 		}
 	}
 
+	// the textures of all materials are decoded in parallel
+	MeshTextureCache textureCache(filename);
+	for (const Node3ds &node : nodes) {
+		for (const auto &entry : node.materials) {
+			if (!entry->second.diffuse.name.empty()) {
+				textureCache.addFile(entry->second.diffuse.name);
+			}
+		}
+	}
+	textureCache.load();
+	for (Node3ds &node : nodes) {
+		for (auto entry : node.materials) {
+			MaterialTexture3ds &texture = entry->value.diffuse;
+			if (!texture.name.empty()) {
+				texture.texture = textureCache.get(texture.name);
+			}
+		}
+	}
+
 	// 3dsmax is using z-up axis - so let's correct this
 	const glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 
@@ -16,6 +16,7 @@
 #include "voxel/Mesh.h"
 #include "voxel/VoxelVertex.h"
 #include "palette/Palette.h"
+#include "voxelformat/private/mesh/MeshTextureCache.h"
 
 #define ufbx_assert core_assert
 #include "voxelformat/external/ufbx.h"
@@ -497,7 +498,9 @@ bool FBXFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 	Log::debug("right: %i, up: %i, front: %i", ufbxscene->settings.axes.right, ufbxscene->settings.axes.up,
 			   ufbxscene->settings.axes.front);
 
-	core::StringMap<image::ImagePtr> textures;
+	// material name to texture name
+	core::StringMap<core::String> materialTextures;
+	MeshTextureCache textureCache(filename);
 	for (size_t i = 0; i < ufbxscene->meshes.count; ++i) {
 		const ufbx_mesh *mesh = ufbxscene->meshes[i];
 		for (size_t pi = 0; pi < mesh->material_parts.count; pi++) {
@@ -519,23 +522,28 @@ bool FBXFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 				texture = material->pbr.base_color.texture;
 			}
 
-			if (textures.hasKey(texname)) {
-				Log::debug("Texture for material '%s' is already loaded", texname.c_str());
+			if (materialTextures.hasKey(texname)) {
+				Log::debug("Texture for material '%s' is already known", texname.c_str());
 				continue;
 			}
 
 			const core::String &relativeFilename =
 				priv::_ufbx_to_string(texture ? texture->relative_filename : material->name);
-			const core::String &name = lookupTexture(filename, relativeFilename);
-			image::ImagePtr tex = image::loadImage(name);
-			if (tex->isLoaded()) {
-				Log::debug("Use image %s", name.c_str());
-				textures.put(texname, tex);
-			} else {
-				Log::debug("Failed to load image %s", relativeFilename.c_str());
-				textures.put(texname, image::ImagePtr());
-			}
+			materialTextures.put(texname, relativeFilename);
+			textureCache.addFile(relativeFilename);
+		}
+	}
+	textureCache.load();
+
+	core::StringMap<image::ImagePtr> textures;
+	for (const auto &entry : materialTextures) {
+		image::ImagePtr tex = textureCache.get(entry->second);
+		if (tex) {
+			Log::debug("Use image %s", entry->second.c_str());
+		} else {
+			Log::debug("Failed to load image %s", entry->second.c_str());
 		}
+		textures.put(entry->first, tex);
 	}
 
 	const ufbx_node *root = ufbxscene->root_node;
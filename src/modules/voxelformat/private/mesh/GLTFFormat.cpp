@@ -20,12 +20,15 @@
 #include "io/MemoryReadStream.h"
 #include "io/StdStreamBuf.h"
 #include "io/Stream.h"
+#include "meshoptimizer.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "scenegraph/SceneGraphTransform.h"
 #include "voxel/Mesh.h"
+#include "voxel/MeshLod.h"
 #include "voxel/VoxelVertex.h"
+#include "voxelformat/private/mesh/MeshTextureCache.h"
 #include "voxelutil/VoxelUtil.h"
 
 #include <glm/ext/matrix_transform.hpp>
@@ -34,6 +37,7 @@
 #include <limits.h>
 
 #define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_EXTERNAL_IMAGE
 // #define TINYGLTF_NO_FS // TODO: VOXELFORMAT: use our own file abstraction
 #define JSON_HAS_CPP_11
 #include "voxelformat/external/tiny_gltf.h"
@@ -52,6 +56,115 @@ static int addBuffer(tinygltf::Model &gltfModel, io::BufferedReadWriteStream &st
 	return (int)(gltfModel.buffers.size() - 1);
 }
 
+static tinygltf::Value meshoptCompression(int buffer, size_t byteOffset, size_t byteLength, size_t byteStride,
+										  size_t count, const char *mode) {
+	tinygltf::Value::Object ext;
+	ext["buffer"] = tinygltf::Value(buffer);
+	ext["byteOffset"] = tinygltf::Value((int)byteOffset);
+	ext["byteLength"] = tinygltf::Value((int)byteLength);
+	ext["byteStride"] = tinygltf::Value((int)byteStride);
+	ext["count"] = tinygltf::Value((int)count);
+	ext["mode"] = tinygltf::Value(std::string(mode));
+	return tinygltf::Value(ext);
+}
+
+/**
+ * @brief Decodes the EXT_meshopt_compression buffer views into new buffers - the accessors can afterwards be read
+ * like any other uncompressed accessor
+ */
+static bool decodeMeshoptCompression(tinygltf::Model &gltfModel) {
+	for (tinygltf::BufferView &gltfBufferView : gltfModel.bufferViews) {
+		auto extIter = gltfBufferView.extensions.find("EXT_meshopt_compression");
+		if (extIter == gltfBufferView.extensions.end()) {
+			continue;
+		}
+		const tinygltf::Value &ext = extIter->second;
+		const int buffer = ext.Get("buffer").GetNumberAsInt();
+		const size_t byteOffset = ext.Has("byteOffset") ? (size_t)ext.Get("byteOffset").GetNumberAsInt() : 0u;
+		const size_t byteLength = (size_t)ext.Get("byteLength").GetNumberAsInt();
+		const size_t byteStride = (size_t)ext.Get("byteStride").GetNumberAsInt();
+		const size_t count = (size_t)ext.Get("count").GetNumberAsInt();
+		const std::string &mode = ext.Get("mode").Get<std::string>();
+		const std::string filter = ext.Has("filter") ? ext.Get("filter").Get<std::string>() : "NONE";
+		if (buffer < 0 || buffer >= (int)gltfModel.buffers.size()) {
+			Log::error("Invalid buffer %i for EXT_meshopt_compression", buffer);
+			return false;
+		}
+		const tinygltf::Buffer &gltfCompressedBuffer = gltfModel.buffers[buffer];
+		if (byteOffset + byteLength > gltfCompressedBuffer.data.size()) {
+			Log::error("Invalid buffer range for EXT_meshopt_compression");
+			return false;
+		}
+		const uint8_t *compressed = gltfCompressedBuffer.data.data() + byteOffset;
+
+		tinygltf::Buffer gltfBuffer;
+		gltfBuffer.data.resize(count * byteStride);
+		int ret = -1;
+		if (mode == "ATTRIBUTES") {
+			ret = meshopt_decodeVertexBuffer(gltfBuffer.data.data(), count, byteStride, compressed, byteLength);
+		} else if (mode == "TRIANGLES") {
+			ret = meshopt_decodeIndexBuffer(gltfBuffer.data.data(), count, byteStride, compressed, byteLength);
+		} else if (mode == "INDICES") {
+			ret = meshopt_decodeIndexSequence(gltfBuffer.data.data(), count, byteStride, compressed, byteLength);
+		} else {
+			Log::error("Unknown EXT_meshopt_compression mode %s", mode.c_str());
+			return false;
+		}
+		if (ret != 0) {
+			Log::error("Failed to decode EXT_meshopt_compression buffer view (%i)", ret);
+			return false;
+		}
+		if (filter == "OCTAHEDRAL") {
+			meshopt_decodeFilterOct(gltfBuffer.data.data(), count, byteStride);
+		} else if (filter == "QUATERNION") {
+			meshopt_decodeFilterQuat(gltfBuffer.data.data(), count, byteStride);
+		} else if (filter == "EXPONENTIAL") {
+			meshopt_decodeFilterExp(gltfBuffer.data.data(), count, byteStride);
+		}
+		gltfBufferView.buffer = (int)gltfModel.buffers.size();
+		gltfBufferView.byteOffset = 0;
+		gltfBufferView.byteLength = gltfBuffer.data.size();
+		gltfModel.buffers.emplace_back(core::move(gltfBuffer));
+	}
+	return true;
+}
+
+/**
+ * @brief Converts the component of an accessor to float - normalized integers (e.g. from KHR_mesh_quantization)
+ * are mapped to [0,1] or [-1,1]
+ */
+static float toFloat(int componentType, bool normalized, const uint8_t *buf) {
+	switch (componentType) {
+	case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+		float v;
+		core_memcpy(&v, buf, sizeof(v));
+		return v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_BYTE: {
+		const float v = (float)*(const int8_t *)buf;
+		return normalized ? glm::max(v / 127.0f, -1.0f) : v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+		const float v = (float)*buf;
+		return normalized ? v / 255.0f : v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_SHORT: {
+		int16_t v;
+		core_memcpy(&v, buf, sizeof(v));
+		return normalized ? glm::max((float)v / 32767.0f, -1.0f) : (float)v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+		uint16_t v;
+		core_memcpy(&v, buf, sizeof(v));
+		return normalized ? (float)v / 65535.0f : (float)v;
+	}
+	default:
+		break;
+	}
+	Log::warn("Unsupported component type %i", componentType);
+	return 0.0f;
+}
+
 static image::TextureWrap convertTextureWrap(int wrap) {
 	if (wrap == TINYGLTF_TEXTURE_WRAP_REPEAT) {
 		return image::TextureWrap::Repeat;
@@ -171,6 +284,69 @@ static bool validateCamera(const tinygltf::Camera &camera) {
 	return false;
 }
 
+/**
+ * @return The name that is used as key for the decoded image in the textures map
+ */
+static core::String imageName(const tinygltf::Model &gltfModel, int imageIndex) {
+	const tinygltf::Image &gltfImage = gltfModel.images[imageIndex];
+	if (!gltfImage.uri.empty()) {
+		return gltfImage.uri.c_str();
+	}
+	if (!gltfImage.name.empty()) {
+		return gltfImage.name.c_str();
+	}
+	return core::string::format("image%i", imageIndex);
+}
+
+/**
+ * @brief Decode all images of the model in parallel
+ * @note The images are loaded as is by tinygltf - external images are not loaded at all
+ */
+static void loadTextures(const core::String &filename, const tinygltf::Model &gltfModel,
+						 core::StringMap<image::ImagePtr> &textures) {
+	MeshTextureCache textureCache(filename);
+	core::DynamicArray<core::String> keys;
+	keys.resize(gltfModel.images.size());
+	for (int i = 0; i < (int)gltfModel.images.size(); ++i) {
+		const tinygltf::Image &gltfImage = gltfModel.images[i];
+		if (!gltfImage.uri.empty()) {
+			keys[i] = gltfImage.uri.c_str();
+			textureCache.addFile(keys[i]);
+			continue;
+		}
+		// embedded images are registered by their index - the names don't have to be unique
+		const core::String &key = core::string::format("#%i", i);
+		if (gltfImage.bufferView >= 0 && gltfImage.bufferView < (int)gltfModel.bufferViews.size()) {
+			const tinygltf::BufferView &gltfImgBufferView = gltfModel.bufferViews[gltfImage.bufferView];
+			if (gltfImgBufferView.buffer >= 0 && gltfImgBufferView.buffer < (int)gltfModel.buffers.size()) {
+				const tinygltf::Buffer &gltfImgBuffer = gltfModel.buffers[gltfImgBufferView.buffer];
+				const uint8_t *buf = gltfImgBuffer.data.data() + gltfImgBufferView.byteOffset;
+				textureCache.addData(key, buf, gltfImgBufferView.byteLength);
+				keys[i] = key;
+			} else {
+				Log::warn("Invalid buffer index for image: %i", gltfImgBufferView.buffer);
+			}
+		} else if (!gltfImage.image.empty()) {
+			// data uri
+			textureCache.addData(key, gltfImage.image.data(), gltfImage.image.size());
+			keys[i] = key;
+		} else {
+			Log::warn("Invalid buffer view index for image: %i", gltfImage.bufferView);
+		}
+	}
+	textureCache.load();
+
+	for (int i = 0; i < (int)gltfModel.images.size(); ++i) {
+		if (keys[i].empty()) {
+			continue;
+		}
+		const image::ImagePtr &tex = textureCache.get(keys[i]);
+		if (tex) {
+			textures.put(imageName(gltfModel, i), tex);
+		}
+	}
+}
+
 } // namespace _priv
 
 void GLTFFormat::createPointMesh(tinygltf::Model &gltfModel, const scenegraph::SceneGraphNode &node) const {
@@ -342,6 +518,10 @@ bool GLTFFormat::savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOf
 										   const palette::Palette &palette, bool withColor, bool withTexCoords,
 										   bool colorAsFloat, bool exportNormals, bool applyTransform,
 										   int texcoordIndex, const MaterialMap &paletteMaterialIndices) {
+	if (_quantization || _meshoptCompression) {
+		return savePackedPrimitive(idx, pivotOffset, gltfModel, gltfMesh, mesh, palette, withColor, withTexCoords,
+								   colorAsFloat, exportNormals, applyTransform, texcoordIndex, paletteMaterialIndices);
+	}
 
 	const size_t expectedSize =
 		mesh->getNoOfIndices() * sizeof(voxel::IndexType) + mesh->getNoOfVertices() * 10 * sizeof(float);
@@ -478,12 +658,281 @@ bool GLTFFormat::savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOf
 	return true;
 }
 
-static void addExtension(tinygltf::Model &gltfModel, const core::String &extension) {
+static void addExtension(tinygltf::Model &gltfModel, const core::String &extension, bool required = false) {
 	std::string ext = extension.c_str();
 	if (core::find(gltfModel.extensionsUsed.begin(), gltfModel.extensionsUsed.end(), ext) ==
 		gltfModel.extensionsUsed.end()) {
 		gltfModel.extensionsUsed.push_back(ext);
 	}
+	if (required && core::find(gltfModel.extensionsRequired.begin(), gltfModel.extensionsRequired.end(), ext) ==
+						gltfModel.extensionsRequired.end()) {
+		gltfModel.extensionsRequired.push_back(ext);
+	}
+}
+
+bool GLTFFormat::savePackedPrimitive(uint8_t idx, const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel,
+									 tinygltf::Mesh &gltfMesh, const voxel::Mesh *mesh,
+									 const palette::Palette &palette, bool withColor, bool withTexCoords,
+									 bool colorAsFloat, bool exportNormals, bool applyTransform, int texcoordIndex,
+									 const MaterialMap &paletteMaterialIndices) {
+	const voxel::VertexArray &vertices = mesh->getVertexVector();
+	const voxel::NormalArray &normals = mesh->getNormalVector();
+	const voxel::IndexArray &indices = mesh->getIndexVector();
+	const size_t nv = vertices.size();
+	const size_t ni = indices.size();
+
+	core::DynamicArray<uint32_t> primitiveIndices;
+	primitiveIndices.reserve(ni);
+	for (size_t i = 0; i + 2 < ni; i += 3) {
+		if (vertices[indices[i]].colorIndex != idx) {
+			continue;
+		}
+		primitiveIndices.push_back(indices[i + 0]);
+		primitiveIndices.push_back(indices[i + 1]);
+		primitiveIndices.push_back(indices[i + 2]);
+	}
+	if (primitiveIndices.empty()) {
+		return false;
+	}
+	const size_t indexCount = primitiveIndices.size();
+
+	// only keep the vertices that are used by this primitive - in the order of their first use
+	meshopt_optimizeVertexCache(primitiveIndices.data(), primitiveIndices.data(), indexCount, nv);
+	core::DynamicArray<uint32_t> remap(nv);
+	const size_t vertexCount =
+		meshopt_optimizeVertexFetchRemap(remap.data(), primitiveIndices.data(), indexCount, nv);
+	meshopt_remapIndexBuffer(primitiveIndices.data(), primitiveIndices.data(), indexCount, remap.data());
+
+	core::DynamicArray<uint32_t> vertexIndices(vertexCount);
+	core::DynamicArray<glm::vec3> positions(vertexCount);
+	glm::vec3 minVertex{FLT_MAX};
+	glm::vec3 maxVertex{-FLT_MAX};
+	bool integerPositions = true;
+	for (size_t i = 0; i < nv; ++i) {
+		if (remap[i] == ~0u) {
+			continue;
+		}
+		glm::vec3 pos = vertices[i].position;
+		if (applyTransform) {
+			pos += pivotOffset;
+		}
+		vertexIndices[remap[i]] = (uint32_t)i;
+		positions[remap[i]] = pos;
+		minVertex = glm::min(minVertex, pos);
+		maxVertex = glm::max(maxVertex, pos);
+		if (glm::any(glm::notEqual(glm::round(pos), pos))) {
+			integerPositions = false;
+		}
+	}
+
+	// voxel positions are usually integers - they can be stored as shorts without losing any precision
+	const bool quantizePositions = _quantization && integerPositions &&
+								   glm::all(glm::greaterThanEqual(minVertex, glm::vec3(INT16_MIN))) &&
+								   glm::all(glm::lessThanEqual(maxVertex, glm::vec3(INT16_MAX)));
+	const bool quantizeNormals = _quantization && exportNormals;
+	// all attributes are padded to 4 bytes
+	const size_t positionSize = quantizePositions ? 4 * sizeof(int16_t) : 3 * sizeof(float);
+	const size_t normalSize = exportNormals ? (quantizeNormals ? 4 * sizeof(int8_t) : 3 * sizeof(float)) : 0u;
+	size_t colorSize = 0u;
+	if (withTexCoords) {
+		colorSize = 2 * sizeof(float);
+	} else if (withColor) {
+		colorSize = colorAsFloat ? 4 * sizeof(float) : 4 * sizeof(uint8_t);
+	}
+	const size_t vertexSize = positionSize + normalSize + colorSize;
+
+	io::BufferedReadWriteStream vertexStream((int64_t)(vertexCount * vertexSize));
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const glm::vec3 &pos = positions[i];
+		const voxel::VoxelVertex &vertex = vertices[vertexIndices[i]];
+		for (int coordIndex = 0; coordIndex < glm::vec3::length(); coordIndex++) {
+			if (quantizePositions) {
+				vertexStream.writeInt16((int16_t)pos[coordIndex]);
+			} else {
+				vertexStream.writeFloat(pos[coordIndex]);
+			}
+		}
+		if (quantizePositions) {
+			vertexStream.writeInt16(0);
+		}
+		if (exportNormals) {
+			const glm::vec3 &normal = normals[vertexIndices[i]];
+			for (int coordIndex = 0; coordIndex < glm::vec3::length(); coordIndex++) {
+				if (quantizeNormals) {
+					vertexStream.writeInt8((int8_t)meshopt_quantizeSnorm(normal[coordIndex], 8));
+				} else {
+					vertexStream.writeFloat(normal[coordIndex]);
+				}
+			}
+			if (quantizeNormals) {
+				vertexStream.writeInt8(0);
+			}
+		}
+		if (withTexCoords) {
+			const glm::vec2 &uv = paletteUV(vertex.colorIndex);
+			vertexStream.writeFloat(uv.x);
+			vertexStream.writeFloat(uv.y);
+		} else if (withColor) {
+			const core::RGBA paletteColor = palette.color(vertex.colorIndex);
+			if (colorAsFloat) {
+				const glm::vec4 &color = core::Color::fromRGBA(paletteColor);
+				for (int colorIdx = 0; colorIdx < glm::vec4::length(); colorIdx++) {
+					vertexStream.writeFloat(color[colorIdx]);
+				}
+			} else {
+				vertexStream.writeUInt8(paletteColor.r);
+				vertexStream.writeUInt8(paletteColor.g);
+				vertexStream.writeUInt8(paletteColor.b);
+				vertexStream.writeUInt8(paletteColor.a);
+			}
+		}
+	}
+
+	const bool shortIndices = vertexCount <= (size_t)UINT16_MAX + 1;
+	const size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+	io::BufferedReadWriteStream indexStream((int64_t)(indexCount * indexSize));
+	uint32_t maxIndex = 0u;
+	for (size_t i = 0; i < indexCount; ++i) {
+		const uint32_t index = primitiveIndices[i];
+		if (shortIndices) {
+			indexStream.writeUInt16((uint16_t)index);
+		} else {
+			indexStream.writeUInt32(index);
+		}
+		maxIndex = core_max(maxIndex, index);
+	}
+
+	const int vertexBufferViewIdx = (int)gltfModel.bufferViews.size();
+	const int indexBufferViewIdx = vertexBufferViewIdx + 1;
+
+	tinygltf::BufferView gltfVerticesBufferView;
+	gltfVerticesBufferView.byteOffset = 0;
+	gltfVerticesBufferView.byteLength = vertexStream.size();
+	gltfVerticesBufferView.byteStride = vertexSize;
+	gltfVerticesBufferView.target = TINYGLTF_TARGET_ARRAY_BUFFER;
+
+	// the vertex size is a multiple of 4 - so the indices are aligned
+	tinygltf::BufferView gltfIndicesBufferView;
+	gltfIndicesBufferView.byteOffset = vertexStream.size();
+	gltfIndicesBufferView.byteLength = indexStream.size();
+	gltfIndicesBufferView.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+
+	if (_meshoptCompression) {
+		const int compressedBufferIdx = (int)gltfModel.buffers.size();
+		tinygltf::Buffer gltfCompressedBuffer;
+		gltfCompressedBuffer.data.resize(meshopt_encodeVertexBufferBound(vertexCount, vertexSize));
+		const size_t vertexBytes = meshopt_encodeVertexBuffer(gltfCompressedBuffer.data.data(),
+															  gltfCompressedBuffer.data.size(),
+															  vertexStream.getBuffer(), vertexCount, vertexSize);
+		const size_t indexOffset = (vertexBytes + 3u) & ~3u;
+		gltfCompressedBuffer.data.resize(indexOffset + meshopt_encodeIndexBufferBound(indexCount, vertexCount));
+		const size_t indexBytes =
+			meshopt_encodeIndexBuffer(gltfCompressedBuffer.data.data() + indexOffset,
+									  gltfCompressedBuffer.data.size() - indexOffset, primitiveIndices.data(), indexCount);
+		gltfCompressedBuffer.data.resize(indexOffset + indexBytes);
+		if (vertexBytes == 0u || indexBytes == 0u) {
+			Log::error("Failed to compress the mesh data");
+			return false;
+		}
+
+		// the views point into a buffer without any data - only the compressed data is stored
+		tinygltf::Buffer gltfFallbackBuffer;
+		gltfFallbackBuffer.fallbackByteLength = vertexStream.size() + indexStream.size();
+		tinygltf::Value::Object fallback;
+		fallback["fallback"] = tinygltf::Value(true);
+		gltfFallbackBuffer.extensions["EXT_meshopt_compression"] = tinygltf::Value(fallback);
+
+		gltfVerticesBufferView.buffer = compressedBufferIdx + 1;
+		gltfVerticesBufferView.extensions["EXT_meshopt_compression"] = _priv::meshoptCompression(
+			compressedBufferIdx, 0u, vertexBytes, vertexSize, vertexCount, "ATTRIBUTES");
+		gltfIndicesBufferView.buffer = compressedBufferIdx + 1;
+		gltfIndicesBufferView.extensions["EXT_meshopt_compression"] = _priv::meshoptCompression(
+			compressedBufferIdx, indexOffset, indexBytes, indexSize, indexCount, "TRIANGLES");
+
+		gltfModel.buffers.emplace_back(core::move(gltfCompressedBuffer));
+		gltfModel.buffers.emplace_back(core::move(gltfFallbackBuffer));
+		addExtension(gltfModel, "EXT_meshopt_compression", true);
+	} else {
+		tinygltf::Buffer gltfBuffer;
+		gltfBuffer.data.insert(gltfBuffer.data.end(), vertexStream.getBuffer(),
+							   vertexStream.getBuffer() + vertexStream.size());
+		gltfBuffer.data.insert(gltfBuffer.data.end(), indexStream.getBuffer(),
+							   indexStream.getBuffer() + indexStream.size());
+		gltfVerticesBufferView.buffer = (int)gltfModel.buffers.size();
+		gltfIndicesBufferView.buffer = (int)gltfModel.buffers.size();
+		gltfModel.buffers.emplace_back(core::move(gltfBuffer));
+	}
+	gltfModel.bufferViews.emplace_back(core::move(gltfVerticesBufferView));
+	gltfModel.bufferViews.emplace_back(core::move(gltfIndicesBufferView));
+
+	tinygltf::Primitive gltfMeshPrimitive;
+	{
+		tinygltf::Accessor gltfIndicesAccessor;
+		gltfIndicesAccessor.bufferView = indexBufferViewIdx;
+		gltfIndicesAccessor.componentType =
+			shortIndices ? TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT : TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+		gltfIndicesAccessor.count = indexCount;
+		gltfIndicesAccessor.type = TINYGLTF_TYPE_SCALAR;
+		gltfIndicesAccessor.maxValues.push_back(maxIndex);
+		gltfIndicesAccessor.minValues.push_back(0);
+		gltfMeshPrimitive.indices = (int)gltfModel.accessors.size();
+		gltfModel.accessors.emplace_back(core::move(gltfIndicesAccessor));
+	}
+	{
+		tinygltf::Accessor gltfVerticesAccessor;
+		gltfVerticesAccessor.bufferView = vertexBufferViewIdx;
+		gltfVerticesAccessor.componentType =
+			quantizePositions ? TINYGLTF_COMPONENT_TYPE_SHORT : TINYGLTF_COMPONENT_TYPE_FLOAT;
+		gltfVerticesAccessor.count = vertexCount;
+		gltfVerticesAccessor.type = TINYGLTF_TYPE_VEC3;
+		gltfVerticesAccessor.maxValues = {maxVertex[0], maxVertex[1], maxVertex[2]};
+		gltfVerticesAccessor.minValues = {minVertex[0], minVertex[1], minVertex[2]};
+		gltfMeshPrimitive.attributes["POSITION"] = (int)gltfModel.accessors.size();
+		gltfModel.accessors.emplace_back(core::move(gltfVerticesAccessor));
+	}
+	if (exportNormals) {
+		tinygltf::Accessor gltfNormalAccessor;
+		gltfNormalAccessor.bufferView = vertexBufferViewIdx;
+		gltfNormalAccessor.byteOffset = positionSize;
+		gltfNormalAccessor.componentType =
+			quantizeNormals ? TINYGLTF_COMPONENT_TYPE_BYTE : TINYGLTF_COMPONENT_TYPE_FLOAT;
+		gltfNormalAccessor.normalized = quantizeNormals;
+		gltfNormalAccessor.count = vertexCount;
+		gltfNormalAccessor.type = TINYGLTF_TYPE_VEC3;
+		gltfMeshPrimitive.attributes["NORMAL"] = (int)gltfModel.accessors.size();
+		gltfModel.accessors.emplace_back(core::move(gltfNormalAccessor));
+	}
+	if (withTexCoords || withColor) {
+		tinygltf::Accessor gltfColorAccessor;
+		gltfColorAccessor.bufferView = vertexBufferViewIdx;
+		gltfColorAccessor.byteOffset = positionSize + normalSize;
+		gltfColorAccessor.count = vertexCount;
+		if (withTexCoords) {
+			gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+			gltfColorAccessor.type = TINYGLTF_TYPE_VEC2;
+			const core::String &texcoordsKey = core::String::format("TEXCOORD_%i", texcoordIndex);
+			gltfMeshPrimitive.attributes[texcoordsKey.c_str()] = (int)gltfModel.accessors.size();
+		} else {
+			gltfColorAccessor.componentType =
+				colorAsFloat ? TINYGLTF_COMPONENT_TYPE_FLOAT : TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+			gltfColorAccessor.normalized = !colorAsFloat;
+			gltfColorAccessor.type = TINYGLTF_TYPE_VEC4;
+			gltfMeshPrimitive.attributes["COLOR_0"] = (int)gltfModel.accessors.size();
+		}
+		gltfModel.accessors.emplace_back(core::move(gltfColorAccessor));
+	}
+	if (quantizePositions || quantizeNormals) {
+		addExtension(gltfModel, "KHR_mesh_quantization", true);
+	}
+
+	auto paletteMaterialIter = paletteMaterialIndices.find(palette.hash());
+	core_assert(paletteMaterialIter != paletteMaterialIndices.end());
+	const int material = paletteMaterialIter->value[idx];
+	core_assert(material >= 0);
+	gltfMeshPrimitive.material = material;
+	gltfMeshPrimitive.mode = TINYGLTF_MODE_TRIANGLES;
+	gltfMesh.primitives.emplace_back(core::move(gltfMeshPrimitive));
+	return true;
 }
 
 void GLTFFormat::save_KHR_materials_emissive_strength(const palette::Material &material,
@@ -706,6 +1155,66 @@ void GLTFFormat::generateMaterials(bool withTexCoords, tinygltf::Model &gltfMode
 	}
 }
 
+void GLTFFormat::saveLodNodes(int gltfNodeIdx, int meshIdx, const voxel::MeshLodChain &lodChain,
+							  const char *objectName, const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel,
+							  const palette::Palette &palette, bool withColor, bool withTexCoords, bool colorAsFloat,
+							  bool applyTransform, int texcoordIndex, const MaterialMap &paletteMaterialIndices) {
+	std::vector<int> ids;
+	for (int lod = 1; lod < lodChain.size(); ++lod) {
+		const voxel::Mesh *mesh = &lodChain.level(lod).mesh[meshIdx];
+		if (mesh->isEmpty()) {
+			continue;
+		}
+		const bool exportNormals = !mesh->getNormalVector().empty();
+		tinygltf::Mesh gltfMesh;
+		gltfMesh.name = core::string::format("%s_lod%i", objectName, lod).c_str();
+		for (int j = 0; j < palette.colorCount(); ++j) {
+			if (palette.color(j).a == 0) {
+				continue;
+			}
+			savePrimitivesPerMaterial(j, pivotOffset, gltfModel, gltfMesh, mesh, palette, withColor, withTexCoords,
+									  colorAsFloat, exportNormals, applyTransform, texcoordIndex,
+									  paletteMaterialIndices);
+		}
+		if (gltfMesh.primitives.empty()) {
+			continue;
+		}
+		// the lod nodes are not part of the scene - they replace the original node and need the same transform
+		const tinygltf::Node &originalNode = gltfModel.nodes[gltfNodeIdx];
+		tinygltf::Node gltfLodNode;
+		gltfLodNode.name = gltfMesh.name;
+		gltfLodNode.mesh = (int)gltfModel.meshes.size();
+		gltfLodNode.matrix = originalNode.matrix;
+		gltfLodNode.translation = originalNode.translation;
+		gltfLodNode.rotation = originalNode.rotation;
+		gltfLodNode.scale = originalNode.scale;
+		ids.push_back((int)gltfModel.nodes.size());
+		gltfModel.meshes.emplace_back(core::move(gltfMesh));
+		gltfModel.nodes.emplace_back(core::move(gltfLodNode));
+	}
+	if (ids.empty()) {
+		return;
+	}
+
+	// each simplified level halves the triangle count - switch when the screen coverage halves, too
+	tinygltf::Value::Array screenCoverage;
+	float coverage = 0.5f;
+	for (size_t i = 0; i <= ids.size(); ++i) {
+		screenCoverage.emplace_back(coverage);
+		coverage *= 0.5f;
+	}
+	tinygltf::Node &gltfNode = gltfModel.nodes[gltfNodeIdx];
+	// keep the extras that were already set for the node
+	tinygltf::Value::Object extras;
+	if (gltfNode.extras.IsObject()) {
+		extras = gltfNode.extras.Get<tinygltf::Value::Object>();
+	}
+	extras["MSFT_screencoverage"] = tinygltf::Value(screenCoverage);
+	gltfNode.lods = core::move(ids);
+	gltfNode.extras = tinygltf::Value(core::move(extras));
+	addExtension(gltfModel, "MSFT_lod");
+}
+
 bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const scenegraph::SceneGraph &sceneGraph,
 							const Meshes &meshes, const core::String &filename, const io::ArchivePtr &archive,
 							const glm::vec3 &scale, bool quad, bool withColor, bool withTexCoords) {
@@ -741,6 +1250,9 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	stack.emplace_back(0, -1);
 
 	const bool exportAnimations = sceneGraph.hasAnimations();
+	const int lodLevels = core::Var::get(cfg::VoxFormatGLTF_MSFT_lod)->intVal();
+	_quantization = core::Var::get(cfg::VoxFormatGLTF_KHR_mesh_quantization)->boolVal();
+	_meshoptCompression = core::Var::get(cfg::VoxFormatGLTF_EXT_meshopt_compression)->boolVal();
 
 	MaterialMap paletteMaterialIndices((int)sceneGraph.size());
 	core::Map<int, int> nodeMapping((int)sceneGraph.nodeSize());
@@ -770,6 +1282,17 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 			}
 		}
 
+		voxel::MeshLodChain lodChain;
+		if (lodLevels > 0) {
+			lodChain.addLevel(voxel::ChunkMesh(*meshExt.mesh), 0.0f);
+			for (int lod = 0; lod < lodLevels; ++lod) {
+				if (!lodChain.addSimplifiedLevel(0.5f)) {
+					break;
+				}
+			}
+			Log::debug("Created %i lod levels for %s", lodChain.size() - 1, meshExt.name.c_str());
+		}
+
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
 			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
 			if (mesh->isEmpty()) {
@@ -810,6 +1333,12 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 			saveGltfNode(nodeMapping, gltfModel, gltfScene, node, stack, sceneGraph, scale,
 							exportAnimations);
 			gltfModel.meshes.emplace_back(core::move(gltfMesh));
+			if (lodChain.size() > 1) {
+				const int gltfNodeIdx = (int)gltfModel.nodes.size() - 1;
+				saveLodNodes(gltfNodeIdx, i, lodChain, objectName, pivotOffset, gltfModel, palette, withColor,
+							 withTexCoords, colorAsFloat, meshExt.applyTransform, texcoordIndex,
+							 paletteMaterialIndices);
+			}
 		}
 	}
 
@@ -1121,65 +1650,14 @@ void GLTFFormat::loadTexture(const core::String &filename, core::StringMap<image
 		const tinygltf::Image &gltfImage = gltfModel.images[gltfTexture.source];
 		Log::debug("Image '%s': components: %i, width: %i, height: %i, bits: %i", gltfImage.uri.c_str(),
 				   gltfImage.component, gltfImage.width, gltfImage.height, gltfImage.bits);
-		if (gltfImage.uri.empty()) {
-			if (gltfImage.bufferView >= 0 && gltfImage.bufferView < (int)gltfModel.bufferViews.size()) {
-				const tinygltf::BufferView &gltfImgBufferView = gltfModel.bufferViews[gltfImage.bufferView];
-				if (gltfImgBufferView.buffer >= 0 && gltfImgBufferView.buffer < (int)gltfModel.buffers.size()) {
-					const tinygltf::Buffer &gltfImgBuffer = gltfModel.buffers[gltfImgBufferView.buffer];
-					const size_t offset = gltfImgBufferView.byteOffset;
-					const uint8_t *buf = gltfImgBuffer.data.data() + offset;
-					core::String name = gltfImage.name.c_str();
-					if (name.empty()) {
-						name = core::string::format("image%i", gltfTexture.source);
-					}
-					image::ImagePtr tex = image::createEmptyImage(name.c_str());
-					if (!tex->load(buf, (int)gltfImgBufferView.byteLength)) {
-						Log::warn("Failed to load embedded image %s", name.c_str());
-					} else {
-						Log::debug("Loaded embedded image %s", name.c_str());
-						materialData.diffuseTexture = name.c_str();
-						// image::writeImage(tex, materialData.diffuseTexture + ".png");
-						textures.emplace(materialData.diffuseTexture, core::move(tex));
-					}
-				} else {
-					Log::warn("Invalid buffer index for image: %i", gltfImgBufferView.buffer);
-				}
-			} else if (!gltfImage.image.empty()) {
-				if (gltfImage.component == 4) {
-					core::String name = gltfImage.name.c_str();
-					if (name.empty()) {
-						name = core::string::format("image%i", gltfTexture.source);
-					}
-					image::ImagePtr tex = image::createEmptyImage(name);
-					core_assert(gltfImage.image.size() ==
-								(size_t)(gltfImage.width * gltfImage.height * gltfImage.component));
-					tex->loadRGBA(gltfImage.image.data(), gltfImage.width, gltfImage.height);
-					Log::debug("Use image %s", name.c_str());
-					materialData.diffuseTexture = name.c_str();
-					textures.emplace(materialData.diffuseTexture, core::move(tex));
-					texCoordIndex = gltfTextureInfo.texCoord;
-				} else {
-					Log::warn("Failed to load image with %i components", gltfImage.component);
-				}
-			} else {
-				Log::warn("Invalid buffer view index for image: %i", gltfImage.bufferView);
-			}
+		// the images were already decoded in _priv::loadTextures()
+		const core::String &name = _priv::imageName(gltfModel, gltfTexture.source);
+		if (textures.hasKey(name)) {
+			Log::debug("Use image %s", name.c_str());
+			materialData.diffuseTexture = name;
+			texCoordIndex = gltfTextureInfo.texCoord;
 		} else {
-			core::String name = gltfImage.uri.c_str();
-			if (!textures.hasKey(name)) {
-				name = lookupTexture(filename, name);
-				image::ImagePtr tex = image::loadImage(name);
-				if (tex->isLoaded()) {
-					Log::debug("Use image %s", name.c_str());
-					materialData.diffuseTexture = gltfImage.uri.c_str();
-					textures.emplace(materialData.diffuseTexture, core::move(tex));
-					texCoordIndex = gltfTextureInfo.texCoord;
-				} else {
-					Log::warn("Failed to load %s", name.c_str());
-				}
-			} else {
-				materialData.diffuseTexture = name;
-			}
+			Log::warn("Failed to load image %s", name.c_str());
 		}
 	} else {
 		Log::debug("Invalid image index given %i", gltfTexture.source);
@@ -1359,18 +1837,17 @@ bool GLTFFormat::loadAttributes(const core::String &filename, core::StringMap<im
 				   (int)stride);
 		const uint8_t *buf = gltfAttributeBuffer.data.data() + offset;
 		if (attrType == "POSITION") {
-			if (gltfAttributeAccessor->componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
-				Log::debug("Skip non float type for %s", attrType.c_str());
-				continue;
-			}
 			foundPosition = true;
 			core_assert(gltfAttributeAccessor->type == TINYGLTF_TYPE_VEC3);
+			// the component type is not always float - see KHR_mesh_quantization
+			const int componentType = gltfAttributeAccessor->componentType;
+			const bool normalized = gltfAttributeAccessor->normalized;
+			const size_t componentSize = (size_t)tinygltf::GetComponentSizeInBytes(componentType);
 			for (size_t i = 0; i < gltfAttributeAccessor->count; i++) {
-				io::MemoryReadStream posStream(buf, stride);
 				glm::vec3 pos;
-				posStream.readFloat(pos.x);
-				posStream.readFloat(pos.y);
-				posStream.readFloat(pos.z);
+				pos.x = _priv::toFloat(componentType, normalized, buf);
+				pos.y = _priv::toFloat(componentType, normalized, buf + componentSize);
+				pos.z = _priv::toFloat(componentType, normalized, buf + 2 * componentSize);
 				vertices[verticesOffset + i].pos = pos;
 				vertices[verticesOffset + i].texture = gltfMaterial.diffuseTexture;
 				vertices[verticesOffset + i].color = gltfMaterial.baseColor;
@@ -1741,6 +2218,8 @@ bool GLTFFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 
 	const core::String filePath = core::string::extractDir(filename);
 	tinygltf::TinyGLTF gltfLoader;
+	// the images are decoded in parallel by _priv::loadTextures()
+	gltfLoader.SetImagesAsIs(true);
 	tinygltf::Model gltfModel;
 	if (magic == FourCC('g', 'l', 'T', 'F')) {
 		Log::debug("Detected binary gltf stream");
@@ -1761,8 +2240,12 @@ bool GLTFFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 	if (!state) {
 		return false;
 	}
+	if (!_priv::decodeMeshoptCompression(gltfModel)) {
+		return false;
+	}
 
 	core::StringMap<image::ImagePtr> textures;
+	_priv::loadTextures(filename, gltfModel, textures);
 
 	Log::debug("Materials: %i", (int)gltfModel.materials.size());
 	Log::debug("Animations: %i", (int)gltfModel.animations.size());
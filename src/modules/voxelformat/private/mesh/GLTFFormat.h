@@ -25,6 +25,9 @@ struct TextureInfo;
 namespace scenegraph {
 class SceneGraphTransform;
 }
+namespace voxel {
+class MeshLodChain;
+}
 namespace voxelformat {
 
 /**
@@ -71,6 +74,14 @@ private:
 	void load_KHR_materials_specular(palette::Material &material, const tinygltf::Material &gltfMaterial) const;
 
 	// exporting
+	/**
+	 * https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Khronos/KHR_mesh_quantization
+	 */
+	bool _quantization = false;
+	/**
+	 * https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+	 */
+	bool _meshoptCompression = false;
 	struct Bounds {
 		uint32_t maxIndex = 0u;
 		uint32_t minIndex = 0u;
@@ -97,6 +108,18 @@ private:
 								   tinygltf::Mesh &gltfMesh, const voxel::Mesh *mesh, const palette::Palette &palette,
 								   bool withColor, bool withTexCoords, bool colorAsFloat, bool exportNormals,
 								   bool applyTransform, int texcoordIndex, const MaterialMap &paletteMaterialIndices);
+	/**
+	 * @brief Writes only the vertices that are referenced by the triangles of the given material with 16 bit
+	 * indices if possible - and applies the quantization and compression extensions if enabled
+	 */
+	bool savePackedPrimitive(uint8_t idx, const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel,
+							 tinygltf::Mesh &gltfMesh, const voxel::Mesh *mesh, const palette::Palette &palette,
+							 bool withColor, bool withTexCoords, bool colorAsFloat, bool exportNormals,
+							 bool applyTransform, int texcoordIndex, const MaterialMap &paletteMaterialIndices);
+	void saveLodNodes(int gltfNodeIdx, int meshIdx, const voxel::MeshLodChain &lodChain, const char *objectName,
+					  const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel, const palette::Palette &palette,
+					  bool withColor, bool withTexCoords, bool colorAsFloat, bool applyTransform, int texcoordIndex,
+					  const MaterialMap &paletteMaterialIndices);
 
 	void saveAnimation(int targetNode, tinygltf::Model &m, const scenegraph::SceneGraphNode &node,
 					   tinygltf::Animation &gltfAnimation);
@@ -14,7 +14,6 @@
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Map.h"
-#include "core/concurrent/Lock.h"
 #include "io/Archive.h"
 #include "io/FormatDescription.h"
 #include "palette/NormalPalette.h"
@@ -35,7 +34,6 @@
 namespace voxelformat {
 
 #define AlphaThreshold 0
-#define MaxTriangleColorContributions 4
 
 MeshFormat::MeshFormat() {
 	_flattenFactor = core::Var::getSafe(cfg::VoxformatRGBFlattenFactor)->intVal();
@@ -224,6 +222,138 @@ void MeshFormat::transformTrisAxisAligned(const voxel::Region &region, const Tri
 	}
 }
 
+/**
+ * @brief Samples the triangle color at the point of the triangle that is closest to the given position
+ */
+static core::RGBA sampleTriColor(const voxelformat::TexturedTri &tri, const glm::vec3 &pos) {
+	glm::vec3 b = glm::max(tri.calculateBarycentric(pos), glm::vec3(0.0f));
+	const float sum = b.x + b.y + b.z;
+	if (sum <= glm::epsilon<float>()) {
+		b = glm::vec3(1.0f / 3.0f);
+	} else {
+		b /= sum;
+	}
+	if (tri.texture) {
+		return tri.colorAt(b.x * tri.uv[0] + b.y * tri.uv[1] + b.z * tri.uv[2]);
+	}
+	const glm::vec4 &color = b.x * core::Color::fromRGBA(tri.color[0]) + b.y * core::Color::fromRGBA(tri.color[1]) +
+							 b.z * core::Color::fromRGBA(tri.color[2]);
+	return core::Color::getRGBA(color);
+}
+
+MeshFormat::PosSamples MeshFormat::voxelizeTile(const voxel::Region &tileRegion, const TriCollection &tris,
+												const core::DynamicArray<uint32_t> &bin,
+												const palette::NormalPalette &normalPalette) {
+	constexpr int TileSize = VoxelizeTileSize;
+	// local accumulators for the tile - no shared state with other tiles
+	core::DynamicArray<PosSampling> slots;
+	slots.resize(TileSize * TileSize * TileSize);
+	const glm::ivec3 &tileMins = tileRegion.getLowerCorner();
+	const glm::ivec3 &tileMaxs = tileRegion.getUpperCorner();
+	const glm::vec3 voxelHalf(0.5f);
+	int filled = 0;
+
+	for (uint32_t triIdx : bin) {
+		if (stopExecution()) {
+			break;
+		}
+		const voxelformat::TexturedTri &tri = tris[triIdx];
+		const uint32_t area = (uint32_t)(glm::min(tri.area(), 1.0f) * 1000.0f);
+		const uint8_t normalIdx = normalPalette.getClosestMatch(tri.normal());
+		const glm::ivec3 mins = glm::max(glm::ivec3(glm::floor(tri.mins())), tileMins);
+		const glm::ivec3 maxs = glm::min(glm::ivec3(glm::floor(tri.maxs())), tileMaxs);
+		for (int z = mins.z; z <= maxs.z; ++z) {
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				for (int x = mins.x; x <= maxs.x; ++x) {
+					const glm::vec3 center((float)x + 0.5f, (float)y + 0.5f, (float)z + 0.5f);
+					if (!glm::intersectTriangleAABB(center, voxelHalf, tri.vertices[0], tri.vertices[1],
+													tri.vertices[2])) {
+						continue;
+					}
+					const core::RGBA rgba = sampleTriColor(tri, center);
+					if (rgba.a <= AlphaThreshold) {
+						continue;
+					}
+					const int idx = ((z - tileMins.z) * TileSize + (y - tileMins.y)) * TileSize + (x - tileMins.x);
+					PosSampling &sampling = slots[idx];
+					if (sampling.entries.empty()) {
+						++filled;
+					}
+					sampling.add(area, rgba, normalIdx);
+				}
+			}
+		}
+	}
+
+	PosSamples samples;
+	samples.reserve(filled);
+	for (int z = tileMins.z; z <= tileMaxs.z; ++z) {
+		for (int y = tileMins.y; y <= tileMaxs.y; ++y) {
+			for (int x = tileMins.x; x <= tileMaxs.x; ++x) {
+				const int idx = ((z - tileMins.z) * TileSize + (y - tileMins.y)) * TileSize + (x - tileMins.x);
+				if (!slots[idx].entries.empty()) {
+					samples.push_back({glm::ivec3(x, y, z), slots[idx]});
+				}
+			}
+		}
+	}
+	return samples;
+}
+
+void MeshFormat::transformTrisTiled(const voxel::Region &region, const TriCollection &tris,
+									core::DynamicArray<PosSamples> &tiles,
+									const palette::NormalPalette &normalPalette) {
+	const glm::ivec3 &lower = region.getLowerCorner();
+	const glm::ivec3 &upper = region.getUpperCorner();
+	const glm::ivec3 tileCount = (region.getDimensionsInVoxels() + VoxelizeTileSize - 1) / VoxelizeTileSize;
+	const int tileAmount = tileCount.x * tileCount.y * tileCount.z;
+	Log::debug("bin %i triangles into %i tiles", (int)tris.size(), tileAmount);
+
+	core::DynamicArray<core::DynamicArray<uint32_t>> bins;
+	bins.resize(tileAmount);
+	for (size_t i = 0; i < tris.size(); ++i) {
+		const voxelformat::TexturedTri &tri = tris[i];
+		const glm::ivec3 mins = glm::clamp(glm::ivec3(glm::floor(tri.mins())), lower, upper) - lower;
+		const glm::ivec3 maxs = glm::clamp(glm::ivec3(glm::floor(tri.maxs())), lower, upper) - lower;
+		const glm::ivec3 tileMins = mins / VoxelizeTileSize;
+		const glm::ivec3 tileMaxs = maxs / VoxelizeTileSize;
+		for (int z = tileMins.z; z <= tileMaxs.z; ++z) {
+			for (int y = tileMins.y; y <= tileMaxs.y; ++y) {
+				for (int x = tileMins.x; x <= tileMaxs.x; ++x) {
+					bins[(z * tileCount.y + y) * tileCount.x + x].push_back((uint32_t)i);
+				}
+			}
+		}
+	}
+
+	core::DynamicArray<PosSamples> results;
+	results.resize(tileAmount);
+	core::TaskGroup group(app::App::getInstance()->threadPool());
+	for (int z = 0; z < tileCount.z; ++z) {
+		for (int y = 0; y < tileCount.y; ++y) {
+			for (int x = 0; x < tileCount.x; ++x) {
+				const core::DynamicArray<uint32_t> &bin = bins[(z * tileCount.y + y) * tileCount.x + x];
+				if (bin.empty()) {
+					continue;
+				}
+				const glm::ivec3 tileMins = lower + glm::ivec3(x, y, z) * VoxelizeTileSize;
+				const glm::ivec3 tileMaxs = glm::min(tileMins + (VoxelizeTileSize - 1), upper);
+				const voxel::Region tileRegion(tileMins, tileMaxs);
+				PosSamples *result = &results[(z * tileCount.y + y) * tileCount.x + x];
+				group.run([tileRegion, &tris, &bin, &normalPalette, result]() {
+					*result = voxelizeTile(tileRegion, tris, bin, normalPalette);
+				});
+			}
+		}
+	}
+	group.wait();
+	for (PosSamples &samples : results) {
+		if (!samples.empty()) {
+			tiles.emplace_back(core::move(samples));
+		}
+	}
+}
+
 bool MeshFormat::isVoxelMesh(const TriCollection &tris) {
 	for (const voxelformat::TexturedTri &tri : tris) {
 		if (!tri.flat()) {
@@ -373,20 +503,27 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 			const voxel::Voxel voxel = voxel::createVoxel(palette, FillColorIndex);
 			voxelutil::fillHollow(wrapper, voxel);
 		}
+	} else if (voxelizeMode == VoxelizeMode::Tiled) {
+		core::DynamicArray<PosSamples> tiles;
+		transformTrisTiled(region, tris, tiles, normalPalette);
+		if (tiles.empty()) {
+			Log::warn("Empty volume - no voxels were found");
+			return InvalidNodeId;
+		}
+		voxelizeTris(node, tiles, fillHollow);
 	} else {
 		Log::debug("Subdivide %i triangles", (int)tris.size());
-		core::DynamicArray<std::future<TriCollection>> futures;
-		futures.reserve(tris.size());
-		for (const voxelformat::TexturedTri &tri : tris) {
-			futures.emplace_back(app::async([tri]() {
-				TriCollection subdivided;
-				subdivideTri(tri, subdivided);
-				return subdivided;
-			}));
-		}
+		constexpr int grain = 64;
+		core::DynamicArray<TriCollection> chunks;
+		chunks.resize(((int)tris.size() + grain - 1) / grain);
+		app::for_parallel(0, (int)tris.size(), grain, [&tris, &chunks](int start, int end) {
+			TriCollection &sub = chunks[start / grain];
+			for (int i = start; i < end; ++i) {
+				subdivideTri(tris[i], sub);
+			}
+		});
 		TriCollection subdivided;
-		for (std::future<TriCollection> &future : futures) {
-			const TriCollection &sub = future.get();
+		for (const TriCollection &sub : chunks) {
 			subdivided.append(sub);
 		}
 
@@ -428,41 +565,40 @@ bool MeshFormat::calculateAABB(const TriCollection &tris, glm::vec3 &mins, glm::
 	return true;
 }
 
-void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const {
+template<class FUNC>
+void MeshFormat::voxelizeSamples(scenegraph::SceneGraphNode &node, FUNC &&visitSamples, bool fillHollow) const {
 	voxel::RawVolumeWrapper wrapper(node.volume());
 	palette::Palette palette;
 	const bool shouldCreatePalette = core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal();
 	if (shouldCreatePalette) {
 		RGBAMap colors;
 		Log::debug("create palette");
-		for (const auto &entry : posMap) {
-			if (stopExecution()) {
-				return;
-			}
-			const PosSampling &pos = entry->second;
+		visitSamples([&](const glm::ivec3 &, const PosSampling &pos) {
 			const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
 			if (rgba.a <= AlphaThreshold) {
-				continue;
+				return;
 			}
 			colors.put(rgba, true);
+		});
+		if (stopExecution()) {
+			return;
 		}
 		createPalette(colors, palette);
 	} else {
 		palette = voxel::getPalette();
 	}
 
-	Log::debug("create voxels for %i positions", (int)posMap.size());
-	for (const auto &entry : posMap) {
-		if (stopExecution()) {
-			return;
-		}
-		const PosSampling &pos = entry->second;
+	palette::PaletteLookup palLookup(palette);
+	visitSamples([&](const glm::ivec3 &p, const PosSampling &pos) {
 		const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
 		if (rgba.a <= AlphaThreshold) {
-			continue;
+			return;
 		}
-		const voxel::Voxel voxel = voxel::createVoxel(palette, palette.getClosestMatch(rgba), pos.getNormal());
-		wrapper.setVoxel(entry->first, voxel);
+		const voxel::Voxel voxel = voxel::createVoxel(palette, palLookup.findClosestIndex(rgba), pos.getNormal());
+		wrapper.setVoxel(p, voxel);
+	});
+	if (stopExecution()) {
+		return;
 	}
 	if (palette.colorCount() == 1) {
 		core::RGBA c = palette.color(0);
@@ -482,6 +618,33 @@ void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &po
 	}
 }
 
+void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const {
+	Log::debug("create voxels for %i positions", (int)posMap.size());
+	voxelizeSamples(
+		node,
+		[&posMap](auto &&func) {
+			for (const auto &entry : posMap) {
+				func(entry->first, entry->second);
+			}
+		},
+		fillHollow);
+}
+
+void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const core::DynamicArray<PosSamples> &tiles,
+							  bool fillHollow) const {
+	Log::debug("create voxels for %i tiles", (int)tiles.size());
+	voxelizeSamples(
+		node,
+		[&tiles](auto &&func) {
+			for (const PosSamples &samples : tiles) {
+				for (const PosSample &sample : samples) {
+					func(sample.pos, sample.sampling);
+				}
+			}
+		},
+		fillHollow);
+}
+
 MeshFormat::MeshExt::MeshExt(voxel::ChunkMesh *_mesh, const scenegraph::SceneGraphNode &node, bool _applyTransform)
 	: mesh(_mesh), name(node.name()), applyTransform(_applyTransform), size(node.region().getDimensionsInVoxels()),
 	  pivot(node.pivot()), nodeId(node.id()) {
@@ -616,22 +779,67 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 
 	const voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
 
-	const size_t models = sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels);
-	Meshes meshes;
+	// large volumes are split into chunks that are extracted in parallel - but only if the stitched result is the
+	// same as extracting the whole volume at once
+	const bool chunked = voxel::isChunkedExtractionExact(type, mergeQuads, reuseVertices);
+	struct NodeExtraction {
+		const scenegraph::SceneGraphNode *node;
+		voxel::Region region;
+		core::DynamicArray<voxel::ChunkMesh *> chunks;
+	};
+	core::DynamicArray<NodeExtraction> extractions;
 	core::Map<int, int> meshIdxNodeMap;
-	core_trace_mutex(core::Lock, lock, "MeshFormat");
+	extractions.reserve(sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels));
+	core::TaskGroup group(app::App::getInstance()->threadPool());
 	// TODO: VOXELFORMAT: this could get optimized by re-using the same mesh for multiple nodes (in case of reference nodes)
 	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
 		const scenegraph::SceneGraphNode &node = *iter;
-		app::async([&, volume = sceneGraph.resolveVolume(node), region = sceneGraph.resolveRegion(node)]() {
+		const voxel::RawVolume *volume = sceneGraph.resolveVolume(node);
+		voxel::Region regionExt = sceneGraph.resolveRegion(node);
+		// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
+		regionExt.shiftUpperCorner(1, 1, 1);
+		core::DynamicArray<voxel::Region> regions;
+		if (chunked && glm::any(glm::greaterThan(regionExt.getDimensionsInVoxels(), glm::ivec3(ExtractChunkSize)))) {
+			regions = voxel::chunkRegions(regionExt, ExtractChunkSize);
+		} else {
+			regions.push_back(regionExt);
+		}
+		extractions.emplace_back(NodeExtraction{&node, regionExt, {}});
+		NodeExtraction &extraction = extractions.back();
+		const palette::Palette *palette = &node.palette();
+		for (const voxel::Region &region : regions) {
 			voxel::ChunkMesh *mesh = new voxel::ChunkMesh();
-			voxel::Region regionExt = region;
-			// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
-			regionExt.shiftUpperCorner(1, 1, 1);
-			voxel::SurfaceExtractionContext ctx =
-				voxel::createContext(type, volume, regionExt, node.palette(), *mesh, {0, 0, 0}, mergeQuads,
-									 reuseVertices, ambientOcclusion);
-			voxel::extractSurface(ctx);
+			extraction.chunks.push_back(mesh);
+			group.run([&, volume, palette, region, mesh]() {
+				voxel::SurfaceExtractionContext ctx =
+					voxel::createContext(type, volume, region, *palette, *mesh, {0, 0, 0}, mergeQuads,
+										 reuseVertices, ambientOcclusion);
+				voxel::extractSurface(ctx);
+			});
+		}
+	}
+	group.wait();
+
+	Meshes meshes;
+	meshes.reserve(extractions.size());
+	for (NodeExtraction &extraction : extractions) {
+		voxel::ChunkMesh *mesh;
+		if (extraction.chunks.size() == 1) {
+			mesh = extraction.chunks[0];
+		} else {
+			mesh = new voxel::ChunkMesh();
+		}
+		meshes.emplace_back(mesh, *extraction.node, applyTransform);
+		const NodeExtraction *nodeExtraction = &extraction;
+		group.run([&, nodeExtraction, mesh]() {
+			if (nodeExtraction->chunks.size() > 1) {
+				Log::debug("Stitch %i chunks", (int)nodeExtraction->chunks.size());
+				voxel::stitchChunkMeshes(nodeExtraction->chunks, nodeExtraction->region.getLowerCorner(), *mesh,
+										 reuseVertices);
+				for (voxel::ChunkMesh *chunk : nodeExtraction->chunks) {
+					delete chunk;
+				}
+			}
 			if (withNormals) {
 				Log::debug("Calculate normals");
 				mesh->calculateNormals();
@@ -639,21 +847,10 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 			if (optimizeMesh) {
 				mesh->optimize();
 			}
-
-			core::ScopedLock scoped(lock);
-			meshes.emplace_back(mesh, node, applyTransform);
 		});
 	}
-	for (;;) {
-		lock.lock();
-		const size_t size = meshes.size();
-		lock.unlock();
-		if (size < models) {
-			app::App::getInstance()->wait(10);
-		} else {
-			break;
-		}
-	}
+	group.wait();
+
 	Meshes nonEmptyMeshes;
 	nonEmptyMeshes.reserve(meshes.size());
 
@@ -672,7 +869,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 	} else {
 		Log::debug("Save meshes");
 		state = saveMeshes(meshIdxNodeMap, sceneGraph, nonEmptyMeshes, filename, archive, {1.0f, 1.0f, 1.0f},
-						   type == voxel::SurfaceExtractionType::Cubic ? quads : false, withColor, withTexCoords);
+						   voxel::isCubicMesh(type) ? quads : false, withColor, withTexCoords);
 	}
 	for (MeshExt &meshext : meshes) {
 		delete meshext.mesh;
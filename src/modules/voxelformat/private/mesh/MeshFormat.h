@@ -7,6 +7,7 @@
 #include "TexturedTri.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Map.h"
+#include "core/collection/Vector.h"
 #include "io/Archive.h"
 #include "palette/NormalPalette.h"
 #include "voxel/ChunkMesh.h"
@@ -24,6 +25,11 @@ namespace voxelformat {
 class MeshFormat : public Format {
 public:
 	static constexpr const uint8_t FillColorIndex = 2;
+	/**
+	 * @brief Volumes that are larger than this are split into chunks that are extracted in parallel on saving
+	 * @sa voxel::isChunkedExtractionExact()
+	 */
+	static constexpr const int ExtractChunkSize = 64;
 	using TriCollection = core::DynamicArray<voxelformat::TexturedTri, 512>;
 
 	/**
@@ -100,6 +106,8 @@ protected:
 	 * during voxelization
 	 */
 	struct PosSamplingEntry {
+		PosSamplingEntry() : area(0), normal(0) {
+		}
 		inline PosSamplingEntry(uint32_t _area, core::RGBA _color, uint8_t _normal) : area(_area), normal(_normal), color(_color) {
 		}
 		uint32_t area : 24;
@@ -107,15 +115,29 @@ protected:
 		core::RGBA color;
 	};
 
+	static constexpr int MaxTriangleColorContributions = 4;
+
 	/**
 	 * @brief Weighted color entry for a position for averaging the voxel color value over all positions that were found
 	 * during voxelization
 	 */
 	struct PosSampling {
-		core::DynamicArray<PosSamplingEntry> entries;
+		core::Vector<PosSamplingEntry, MaxTriangleColorContributions> entries;
+		PosSampling() = default;
 		inline PosSampling(uint32_t area, core::RGBA color, uint8_t normal) {
 			entries.emplace_back(area, color, normal);
 		}
+		/**
+		 * @brief Adds another color contribution - the first color is kept and further contributions are only added
+		 * if they differ from it
+		 */
+		inline void add(uint32_t area, core::RGBA color, uint8_t normal) {
+			if (entries.empty()) {
+				entries.emplace_back(area, color, normal);
+			} else if (entries.size() < MaxTriangleColorContributions && entries[0].color != color) {
+				entries.emplace_back(area, color, normal);
+			}
+		}
 		core::RGBA getColor(uint8_t flattenFactor, bool weightedAverage) const;
 		uint8_t getNormal() const;
 	};
@@ -125,6 +147,20 @@ protected:
 	 */
 	typedef core::Map<glm::ivec3, PosSampling, 64, glm::hash<glm::ivec3>> PosMap;
 
+	/**
+	 * @brief Edge length of the tiles that are voxelized in parallel by @c transformTrisTiled()
+	 */
+	static constexpr int VoxelizeTileSize = 16;
+
+	struct PosSample {
+		glm::ivec3 pos{0};
+		PosSampling sampling;
+	};
+	/**
+	 * @brief The samples of one tile - every position is only included once
+	 */
+	using PosSamples = core::DynamicArray<PosSample>;
+
 	/**
 	 * @brief Convert the given input triangles into a list of positions to place the voxels at
 	 *
@@ -146,6 +182,20 @@ protected:
 	 */
 	static void transformTrisAxisAligned(const voxel::Region &region, const TriCollection &tris, PosMap &posMap,
 										 const palette::NormalPalette &normalPalette);
+	/**
+	 * @brief Convert the given input triangles into a list of positions to place the voxels at without subdividing
+	 * them.
+	 *
+	 * The triangles are binned into tiles of @c VoxelizeTileSize voxels that are processed in parallel. Each voxel
+	 * that overlaps a triangle (separating axis test) gets a color sample at the closest point of the triangle. The
+	 * tiles don't share any state - the result for every tile is stored in its own @c PosSamples instance.
+	 *
+	 * @param[in] tris The triangles to voxelize
+	 * @param[out] tiles The samples for each non-empty tile
+	 * @sa voxelizeTris()
+	 */
+	static void transformTrisTiled(const voxel::Region &region, const TriCollection &tris,
+								   core::DynamicArray<PosSamples> &tiles, const palette::NormalPalette &normalPalette);
 	/**
 	 * @brief Convert the given @c PosMap into a volume
 	 *
@@ -155,6 +205,18 @@ protected:
 	 * @param[out] node The node to create the volume in
 	 */
 	void voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const;
+	/**
+	 * @brief Convert the given tile samples into a volume
+	 * @note The tiles can get calculated by @c transformTrisTiled()
+	 */
+	void voxelizeTris(scenegraph::SceneGraphNode &node, const core::DynamicArray<PosSamples> &tiles,
+					  bool fillHollow) const;
+
+private:
+	static PosSamples voxelizeTile(const voxel::Region &tileRegion, const TriCollection &tris,
+								   const core::DynamicArray<uint32_t> &bin, const palette::NormalPalette &normalPalette);
+	template<class FUNC>
+	void voxelizeSamples(scenegraph::SceneGraphNode &node, FUNC &&visitSamples, bool fillHollow) const;
 
 public:
 	static core::String lookupTexture(const core::String &meshFilename, const core::String &in);
@@ -165,7 +227,7 @@ public:
 	bool saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 					const io::ArchivePtr &archive, const SaveContext &ctx) override;
 
-	enum VoxelizeMode { HighQuality = 0, Fast = 1 };
+	enum VoxelizeMode { HighQuality = 0, Fast = 1, Tiled = 2 };
 };
 
 } // namespace voxelformat
@@ -0,0 +1,163 @@
+/**
+ * @file
+ */
+
+#include "MeshTextureCache.h"
+#include "app/Async.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/TimeProvider.h"
+#include "core/collection/Map.h"
+#include "io/File.h"
+#include "io/Filesystem.h"
+#include "voxelformat/private/mesh/MeshFormat.h"
+
+namespace voxelformat {
+
+MeshTextureCache::MeshTextureCache(const core::String &meshFilename) : _meshFilename(meshFilename) {
+}
+
+MeshTextureCache::~MeshTextureCache() {
+	for (Entry &entry : _entries) {
+		core_free(entry.data);
+	}
+}
+
+void MeshTextureCache::addFile(const core::String &name) {
+	if (_names.hasKey(name)) {
+		return;
+	}
+	const core::String &path = MeshFormat::lookupTexture(_meshFilename, name);
+	int idx;
+	if (!_paths.get(path, idx)) {
+		Entry entry;
+		entry.name = path;
+		entry.file = true;
+		idx = (int)_entries.size();
+		_entries.emplace_back(core::move(entry));
+		_paths.put(path, idx);
+	}
+	_names.put(name, idx);
+}
+
+void MeshTextureCache::addData(const core::String &name, const uint8_t *data, size_t size) {
+	if (_names.hasKey(name)) {
+		return;
+	}
+	Entry entry;
+	entry.name = name;
+	if (data != nullptr && size > 0) {
+		entry.data = (uint8_t *)core_malloc(size);
+		core_memcpy(entry.data, data, size);
+		entry.size = (int)size;
+	}
+	_names.put(name, (int)_entries.size());
+	_entries.emplace_back(core::move(entry));
+}
+
+bool MeshTextureCache::readFile(Entry &entry) const {
+	const io::FilePtr &file = io::filesystem()->open(entry.name);
+	if (!file || !file->validHandle()) {
+		return false;
+	}
+	const long size = file->length();
+	if (size <= 0) {
+		return false;
+	}
+	entry.data = (uint8_t *)core_malloc(size);
+	entry.size = (int)size;
+	if (file->read(entry.data, entry.size) != entry.size) {
+		core_free(entry.data);
+		entry.data = nullptr;
+		entry.size = 0;
+		return false;
+	}
+	return true;
+}
+
+void MeshTextureCache::load() {
+	const uint64_t start = core::TimeProvider::highResTime();
+	// the entries that must get decoded and the entries that have the same image data as one of them
+	core::DynamicArray<int> decode;
+	core::DynamicArray<int> shared;
+	core::DynamicArray<int> sharedWith;
+	core::Map<uint32_t, int, 64> contents;
+	for (int i = 0; i < (int)_entries.size(); ++i) {
+		Entry &entry = _entries[i];
+		if (entry.loaded) {
+			continue;
+		}
+		entry.loaded = true;
+		if (entry.file && !readFile(entry)) {
+			Log::warn("Failed to read texture %s", entry.name.c_str());
+			continue;
+		}
+		if (entry.data == nullptr) {
+			continue;
+		}
+		const uint32_t hash = core::hash(entry.data, entry.size);
+		int other;
+		if (contents.get(hash, other) && _entries[other].size == entry.size &&
+			core_memcmp(_entries[other].data, entry.data, entry.size) == 0) {
+			Log::debug("Texture %s is the same as %s", entry.name.c_str(), _entries[other].name.c_str());
+			shared.push_back(i);
+			sharedWith.push_back(other);
+			continue;
+		}
+		contents.put(hash, i);
+		decode.push_back(i);
+	}
+
+	app::for_parallel(0, (int)decode.size(), 1, [this, &decode](int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			Entry &entry = _entries[decode[i]];
+			image::ImagePtr image = image::createEmptyImage(entry.name);
+			if (image->load(entry.data, entry.size)) {
+				entry.image = image;
+			}
+		}
+	});
+
+	for (size_t i = 0; i < shared.size(); ++i) {
+		_entries[shared[i]].image = _entries[sharedWith[i]].image;
+	}
+	int decoded = 0;
+	for (int idx : decode) {
+		Entry &entry = _entries[idx];
+		if (entry.image) {
+			_memory += (size_t)entry.image->width() * entry.image->height() * entry.image->depth();
+			++decoded;
+		} else {
+			Log::warn("Failed to load texture %s", entry.name.c_str());
+		}
+	}
+	for (Entry &entry : _entries) {
+		core_free(entry.data);
+		entry.data = nullptr;
+	}
+
+	const uint64_t end = core::TimeProvider::highResTime();
+	const double millis = (double)(end - start) / (double)core::TimeProvider::highResTimeResolution() * 1000.0;
+	_decodeMillis += millis;
+	if (!decode.empty()) {
+		Log::debug("Decoded %i textures (%i shared) in %.2f ms - %i KB in total", decoded, (int)shared.size(), millis,
+				   (int)(_memory / 1024));
+	}
+}
+
+image::ImagePtr MeshTextureCache::get(const core::String &name) {
+	int idx;
+	if (!_names.get(name, idx)) {
+		addFile(name);
+		load();
+		if (!_names.get(name, idx)) {
+			return image::ImagePtr();
+		}
+	} else if (!_entries[idx].loaded) {
+		load();
+	}
+	return _entries[idx].image;
+}
+
+} // namespace voxelformat
@@ -0,0 +1,90 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/NonCopyable.h"
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/StringMap.h"
+#include "image/Image.h"
+
+namespace voxelformat {
+
+/**
+ * @brief The textures of a mesh import
+ *
+ * The textures are registered by the name they are referenced with in the mesh file. The path of a texture file is
+ * only looked up once and all names that resolve to the same path or to the same image data share one decoded image.
+ * Calling @c load() decodes all registered textures in parallel.
+ *
+ * @ingroup Formats
+ */
+class MeshTextureCache : public core::NonCopyable {
+private:
+	struct Entry {
+		// the resolved path or the name of an embedded texture
+		core::String name;
+		// the encoded image data - only valid until the texture was decoded
+		uint8_t *data = nullptr;
+		int size = 0;
+		bool file = false;
+		bool loaded = false;
+		image::ImagePtr image;
+	};
+	core::String _meshFilename;
+	core::DynamicArray<Entry> _entries;
+	core::StringMap<int> _names;
+	core::StringMap<int> _paths;
+	size_t _memory = 0u;
+	double _decodeMillis = 0.0;
+
+	bool readFile(Entry &entry) const;
+
+public:
+	/**
+	 * @param meshFilename The mesh file is used to resolve relative texture paths
+	 * @sa MeshFormat::lookupTexture()
+	 */
+	MeshTextureCache(const core::String &meshFilename);
+	~MeshTextureCache();
+
+	/**
+	 * @brief Register a texture file that is referenced by the given name in the mesh file
+	 */
+	void addFile(const core::String &name);
+	/**
+	 * @brief Register an embedded texture with its encoded image data
+	 * @note The data is copied
+	 */
+	void addData(const core::String &name, const uint8_t *data, size_t size);
+	/**
+	 * @brief Read and decode all registered textures that were not yet loaded
+	 */
+	void load();
+	/**
+	 * @return The decoded image or an empty @c image::ImagePtr if the texture could not get loaded. Texture files that
+	 * were not registered before are loaded on demand.
+	 */
+	image::ImagePtr get(const core::String &name);
+
+	/**
+	 * @return The amount of bytes of the decoded images
+	 */
+	size_t memory() const;
+	/**
+	 * @return The milliseconds that were spent on reading and decoding the textures
+	 */
+	double decodeMillis() const;
+};
+
+inline size_t MeshTextureCache::memory() const {
+	return _memory;
+}
+
+inline double MeshTextureCache::decodeMillis() const {
+	return _decodeMillis;
+}
+
+} // namespace voxelformat
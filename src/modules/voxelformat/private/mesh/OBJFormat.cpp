@@ -19,6 +19,7 @@
 #include "voxel/Mesh.h"
 #include "voxel/VoxelVertex.h"
 #include "palette/Palette.h"
+#include "voxelformat/private/mesh/MeshTextureCache.h"
 
 #define TINYOBJLOADER_USE_MAPBOX_EARCUT
 #define TINYOBJLOADER_DONOT_INCLUDE_MAPBOX_EARCUT
@@ -277,11 +278,11 @@ bool OBJFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 		return false;
 	}
 
-	core::StringMap<image::ImagePtr> textures;
+	MeshTextureCache textureCache(filename);
 	Log::debug("%i materials", (int)materials.size());
 
 	for (tinyobj::material_t &material : materials) {
-		core::String name = material.diffuse_texname.c_str();
+		const core::String name = material.diffuse_texname.c_str();
 		Log::debug("material: '%s'", material.name.c_str());
 		Log::debug("- emissive_texname '%s'", material.emissive_texname.c_str());
 		Log::debug("- ambient_texname '%s'", material.ambient_texname.c_str());
@@ -296,17 +297,20 @@ bool OBJFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 		if (name.empty()) {
 			continue;
 		}
+		textureCache.addFile(name);
+	}
+	textureCache.load();
 
-		if (textures.hasKey(name)) {
-			Log::debug("texture for material '%s' is already loaded", name.c_str());
+	core::StringMap<image::ImagePtr> textures;
+	for (const tinyobj::material_t &material : materials) {
+		const core::String name = material.diffuse_texname.c_str();
+		if (name.empty() || textures.hasKey(name)) {
 			continue;
 		}
-
-		name = lookupTexture(filename, name);
-		image::ImagePtr tex = image::loadImage(name);
-		if (tex->isLoaded()) {
+		image::ImagePtr tex = textureCache.get(name);
+		if (tex) {
 			Log::debug("Use image %s", name.c_str());
-			textures.put(material.diffuse_texname.c_str(), tex);
+			textures.put(name, tex);
 		} else {
 			Log::warn("Failed to load image %s from %s", name.c_str(), material.name.c_str());
 		}
@@ -3,23 +3,27 @@
  */
 
 #include "MCRFormat.h"
+#include "app/Async.h"
 #include "core/Color.h"
 #include "core/Common.h"
+#include "core/ConfigVar.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
+#include "core/Var.h"
 #include "core/collection/DynamicArray.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "scenegraph/SceneGraph.h"
 #include "palette/Palette.h"
-#include "voxelutil/VolumeCropper.h"
-#include "voxelutil/VolumeMerger.h"
 #include "MinecraftPaletteMap.h"
 #include "NamedBinaryTag.h"
+#include "NamedBinaryTagReader.h"
 
 #include <glm/common.hpp>
+#include <limits>
 
 namespace voxelformat {
 
@@ -33,6 +37,28 @@ namespace voxelformat {
 		}                                                                                                              \
 	} while (0)
 
+voxel::Region MCRFormat::parseRegion(const core::String &str) {
+	if (str.empty()) {
+		return voxel::Region::InvalidRegion;
+	}
+	// sscanf would silently ignore any trailing values
+	core::DynamicArray<core::String> tokens;
+	core::string::splitString(str, tokens);
+	glm::ivec3 mins;
+	glm::ivec3 maxs;
+	if (tokens.size() == 6u &&
+		SDL_sscanf(str.c_str(), "%i %i %i %i %i %i", &mins.x, &mins.y, &mins.z, &maxs.x, &maxs.y, &maxs.z) == 6) {
+		return voxel::Region(mins, maxs);
+	}
+	// only a y range is given
+	constexpr int unbounded = (std::numeric_limits<int>::max)() / 2;
+	if (tokens.size() == 2u && SDL_sscanf(str.c_str(), "%i %i", &mins.y, &maxs.y) == 2) {
+		return voxel::Region(-unbounded, mins.y, -unbounded, unbounded, maxs.y, unbounded);
+	}
+	Log::warn("Invalid region given for %s: '%s'", cfg::VoxformatMCRRegion, str.c_str());
+	return voxel::Region::InvalidRegion;
+}
+
 bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 								  scenegraph::SceneGraph &sceneGraph, palette::Palette &palette, const LoadContext &ctx) {
 	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
@@ -50,11 +76,17 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	int chunkX = 0;
 	int chunkZ = 0;
 	char type = 'a';
-	if (SDL_sscanf(name.c_str(), "r.%i.%i.mc%c", &chunkX, &chunkZ, &type) != 3) {
+	const bool validRegionPos = SDL_sscanf(name.c_str(), "r.%i.%i.mc%c", &chunkX, &chunkZ, &type) == 3;
+	if (!validRegionPos) {
 		Log::warn("Failed to parse the region chunk boundaries from filename %s (%i.%i.%c)", name.c_str(), chunkX,
 				  chunkZ, type);
 	}
 
+	const voxel::Region region = parseRegion(core::Var::getSafe(cfg::VoxformatMCRRegion)->strVal());
+	if (region.isValid()) {
+		Log::debug("Only load the voxels in %s", region.toString().c_str());
+	}
+
 	palette.minecraft();
 	switch (type) {
 	case 'r':	// Region file format
@@ -86,7 +118,8 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 			return false;
 		}
 
-		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette);
+		const bool success =
+			loadMinecraftRegion(sceneGraph, *stream, palette, region, chunkX, chunkZ, validRegionPos);
 		return success;
 	}
 	}
@@ -95,7 +128,11 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 }
 
 bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-									const palette::Palette &palette) {
+									const palette::Palette &palette, const voxel::Region &region, int regionX,
+									int regionZ, bool validRegionPos) {
+	// read the compressed chunks sequentially - the decompression and the conversion is done in parallel
+	core::DynamicArray<MinecraftChunkData> chunks;
+	chunks.reserve(SECTOR_INTS);
 	for (int i = 0; i < SECTOR_INTS; ++i) {
 		if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
 			continue;
@@ -103,426 +140,470 @@ bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::Seek
 		if (_offsets[i].offset + 6 >= (uint32_t)stream.size()) {
 			return false;
 		}
+		if (region.isValid() && validRegionPos) {
+			// the chunks are stored in x major order in the sector table
+			const int chunkX = regionX * 32 + i % 32;
+			const int chunkZ = regionZ * 32 + i / 32;
+			const voxel::Region chunkRegion(chunkX * MAX_SIZE, region.getLowerY(), chunkZ * MAX_SIZE,
+											chunkX * MAX_SIZE + MAX_SIZE - 1, region.getUpperY(),
+											chunkZ * MAX_SIZE + MAX_SIZE - 1);
+			if (!voxel::intersects(region, chunkRegion)) {
+				continue;
+			}
+		}
 		if (stream.seek(_offsets[i].offset) == -1) {
 			continue;
 		}
-		if (!readCompressedNBT(sceneGraph, stream, i, palette)) {
-			Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
+		uint32_t nbtSize;
+		wrap(stream.readUInt32BE(nbtSize));
+		if (nbtSize == 0) {
+			Log::debug("Empty nbt chunk found");
+			continue;
+		}
+		if (nbtSize > 0x1FFFFFF) {
+			Log::error("Size of nbt data exceeds the max allowed value: %u", nbtSize);
 			return false;
 		}
-	}
-
-	return true;
-}
+		uint8_t version;
+		wrap(stream.readUInt8(version));
+		if (version != VERSION_GZIP && version != VERSION_DEFLATE) {
+			Log::error("Unsupported version found: %u", version);
+			return false;
+		}
+		// the version is included in the length
+		--nbtSize;
 
-bool MCRFormat::readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-								  const palette::Palette &palette) {
-	uint32_t nbtSize;
-	wrap(stream.readUInt32BE(nbtSize));
-	if (nbtSize == 0) {
-		Log::debug("Empty nbt chunk found");
-		return true;
+		MinecraftChunkData chunkData;
+		chunkData.sector = i;
+		chunkData.data.resize(nbtSize);
+		if (stream.read(chunkData.data.data(), nbtSize) != (int)nbtSize) {
+			Log::error("Failed to read the nbt data of sector %i", i);
+			return false;
+		}
+		chunks.emplace_back(core::move(chunkData));
 	}
 
-	if (nbtSize > 0x1FFFFFF) {
-		Log::error("Size of nbt data exceeds the max allowed value: %u", nbtSize);
-		return false;
+	// the section palettes are minecraft palettes - map them once to the target palette
+	palette::Palette mcpal;
+	mcpal.minecraft();
+	voxel::Voxel voxels[palette::PaletteMaxColors];
+	for (int i = 0; i < palette::PaletteMaxColors; ++i) {
+		const uint8_t palColIdx = palette.getClosestMatch(mcpal.color(i));
+		voxels[i] = voxel::createVoxel(palette, palColIdx);
 	}
 
-	uint8_t version;
-	wrap(stream.readUInt8(version));
-	if (version != VERSION_GZIP && version != VERSION_DEFLATE) {
-		Log::error("Unsupported version found: %u", version);
-		return false;
-	}
+	app::for_parallel(0, (int)chunks.size(), 1, [&chunks, &region, &voxels](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			MinecraftChunkData &chunkData = chunks[i];
+			io::MemoryReadStream memStream(chunkData.data.data(), chunkData.data.size());
+			io::ZipReadStream zipStream(memStream, (int)memStream.size());
+			MinecraftChunk chunk;
+			if (!parseChunk(zipStream, chunk)) {
+				Log::error("Could not parse nbt structure");
+				chunkData.failed = true;
+				continue;
+			}
+			chunkData.volume = createVolume(chunk, region, voxels, chunkData.failed);
+			chunkData.data.release();
+		}
+	});
 
-	// the version is included in the length
-	--nbtSize;
-
-	io::ZipReadStream zipStream(stream, (int)nbtSize);
-	priv::NamedBinaryTagContext ctx;
-	ctx.stream = &zipStream;
-	const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
-	if (!root.valid()) {
-		Log::error("Could not parse nbt structure");
-		return false;
+	bool success = true;
+	for (MinecraftChunkData &chunkData : chunks) {
+		if (chunkData.failed) {
+			Log::error("Failed to load minecraft chunk section %i for offset %u", chunkData.sector,
+					   (int)_offsets[chunkData.sector].offset);
+			success = false;
+		}
 	}
-
-	voxel::RawVolume *volume;
-	// https://minecraft.wiki/w/Data_version
-	const int32_t dataVersion = root.get("DataVersion").int32();
-	Log::debug("Found data version %i", dataVersion);
-	if (dataVersion >= 2844) {
-		volume = parseSections(dataVersion, root, sector, palette);
-		if (volume == nullptr) {
-			return false;
+	for (MinecraftChunkData &chunkData : chunks) {
+		if (chunkData.volume == nullptr) {
+			continue;
 		}
-	} else {
-		volume = parseLevelCompound(dataVersion, root, sector, palette);
-		if (volume == nullptr) {
-			return false;
+		if (!success) {
+			delete chunkData.volume;
+			continue;
 		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(chunkData.volume, true);
+		node.setPalette(palette);
+		sceneGraph.emplace(core::move(node));
 	}
-	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-	node.setVolume(volume, true);
-	node.setPalette(palette);
-	sceneGraph.emplace(core::move(node));
-	return true;
+	return success;
 }
 
-int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos) {
-	const uint32_t i = pos.y * MAX_SIZE * MAX_SIZE + pos.z * MAX_SIZE + pos.x;
-	if (i >= data.byteArray()->size()) {
-		Log::error("Byte array index out of bounds: %u/%i", i, (int)data.byteArray()->size());
-		return -1;
+bool MCRFormat::parseBlockData(priv::NamedBinaryTagReader &reader, priv::TagType type, MinecraftBlockData &data) {
+	data.type = type;
+	if (type == priv::TagType::BYTE_ARRAY) {
+		return reader.readByteArray(data.bytes);
 	}
-	const int val = (int)(uint8_t)(*data.byteArray())[i];
-	if (val < 0) {
-		Log::error("Invalid value: %i", val);
-		return -1;
+	if (type == priv::TagType::LONG_ARRAY) {
+		return reader.readLongArray(data.longs);
 	}
-	return val;
+	return reader.skip(type);
 }
 
-voxel::RawVolume *MCRFormat::error(SectionVolumes &volumes) {
-	for (voxel::RawVolume *v : volumes) {
-		delete v;
+bool MCRFormat::parsePaletteList(priv::NamedBinaryTagReader &reader, MinecraftSection &section) {
+	priv::TagType contentType;
+	uint32_t paletteCount;
+	if (!reader.readListHeader(contentType, paletteCount)) {
+		return false;
 	}
-	return nullptr;
-}
-
-voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPos) {
-	if (volumes.empty()) {
-		Log::error("No volumes found at %i:%i", xPos, zPos);
-		return nullptr;
+	if (paletteCount > 512u) {
+		Log::error("Palette overflow");
+		return false;
 	}
-	// TODO: VOXELFORMAT: only merge connected y chunks - don't fill empty chunks - just a waste of memory
-	voxel::RawVolume *merged = voxelutil::merge(volumes);
-	for (voxel::RawVolume *v : volumes) {
-		delete v;
+	if (paletteCount > 0u && contentType != priv::TagType::COMPOUND) {
+		Log::error("Invalid block type %i", (int)contentType);
+		return false;
 	}
-	merged->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
-	voxel::RawVolume *cropped = voxelutil::cropVolume(merged);
-	delete merged;
-	return cropped;
-}
-
-bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
-								 SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal) {
-	Log::debug("Parse block states");
-	const bool hasData = data.type() == priv::TagType::LONG_ARRAY && !data.longArray()->empty();
-
-	const glm::ivec3 mins(0, 0, 0);
-	const glm::ivec3 maxs(MAX_SIZE - 1, MAX_SIZE - 1, MAX_SIZE - 1);
-	const voxel::Region region(mins, maxs);
-	voxel::RawVolume *v = new voxel::RawVolume(region);
-	bool hasBlocks = false;
-
-	if (secPal.pal.empty()) {
-		if (data.type() != priv::TagType::BYTE_ARRAY) {
-			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
-			delete v;
-			return false;
-		}
-		glm::ivec3 sPos;
-		for (sPos.y = 0; sPos.y < MAX_SIZE; ++sPos.y) {
-			for (sPos.z = 0; sPos.z < MAX_SIZE; ++sPos.z) {
-				for (sPos.x = 0; sPos.x < MAX_SIZE; ++sPos.x) {
-					const int color = getVoxel(dataVersion, data, sPos);
-					if (color < 0) {
-						Log::error("Failed to load voxel at position %i:%i:%i (dataversion: %i)", sPos.x, sPos.y,
-								   sPos.z, dataVersion);
-						delete v;
-						return false;
-					}
-					if (color) {
-						const uint8_t palColIdx = palette.getClosestMatch(secPal.mcpal.color(color));
-						const voxel::Voxel voxel = voxel::createVoxel(palette, palColIdx);
-						v->setVoxel(sPos, voxel);
-						hasBlocks = true;
-					}
+	section.hasPalette = true;
+	section.pal.resize(paletteCount);
+	section.numBits = (uint32_t)glm::max(glm::ceil(glm::log2((float)paletteCount)), 4.0f);
+
+	core::String name;
+	core::String value;
+	for (uint32_t paletteEntry = 0; paletteEntry < paletteCount; ++paletteEntry) {
+		section.pal[paletteEntry] = 0;
+		priv::TagType type;
+		while (reader.nextTag(type, name)) {
+			if (type == priv::TagType::STRING && name == "Name") {
+				if (!reader.readString(value)) {
+					return false;
 				}
+				section.pal[paletteEntry] = findPaletteIndex(value);
+			} else if (!reader.skip(type)) {
+				return false;
 			}
 		}
-	} else if (hasData) {
-		if (data.type() != priv::TagType::LONG_ARRAY) {
-			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
-			delete v;
+		if (reader.error()) {
 			return false;
 		}
+	}
+	return true;
+}
 
-		const core::DynamicArray<int64_t> &blockStates = *data.longArray();
-
-		constexpr int blockCount = MAX_SIZE * MAX_SIZE * MAX_SIZE;
-		uint8_t blocks[blockCount];
-		int bsCnt = 0;
-		size_t bitCnt = 0;
-		if (dataVersion < 2529) {
-			const size_t bitSize = (data.longArray()->size()) * 64 / blockCount;
-			const uint32_t bitMask = (1 << bitSize) - 1;
-			for (int i = 0; i < blockCount; i++) {
-				if (bitCnt + bitSize <= 64) {
-					const uint64_t blockState = blockStates[bsCnt];
-					const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
-					if (blockIndex < secPal.pal.size()) {
-						blocks[i] = secPal.pal[blockIndex];
-						hasBlocks = true;
-					} else {
-						blocks[i] = 0;
-					}
-					bitCnt += bitSize;
-					if (bitCnt == 64) {
-						bitCnt = 0;
-						bsCnt++;
-					}
-				} else {
-					const uint64_t blockState1 = blockStates[bsCnt++];
-					const uint64_t blockState2 = blockStates[bsCnt];
-					uint32_t blockIndex = (blockState1 >> bitCnt) & bitMask;
-					bitCnt += bitSize;
-					bitCnt -= 64;
-					blockIndex += (blockState2 << (bitSize - bitCnt)) & bitMask;
-					if (blockIndex < secPal.pal.size()) {
-						blocks[i] = secPal.pal[blockIndex];
-						hasBlocks = true;
-					} else {
-						blocks[i] = 0;
-					}
-				}
-			}
+bool MCRFormat::parseBlockStatesCompound(priv::NamedBinaryTagReader &reader, MinecraftSection &section) {
+	section.hasBlockStates = true;
+	priv::TagType type;
+	core::String name;
+	while (reader.nextTag(type, name)) {
+		bool success;
+		if (name == "palette" && type == priv::TagType::LIST) {
+			success = parsePaletteList(reader, section);
+		} else if (name == "data") {
+			success = parseBlockData(reader, type, section.blockStates);
 		} else {
-			const size_t bitSize = secPal.numBits;
-			const uint32_t bitMask = (1 << bitSize) - 1;
-			for (int i = 0; i < blockCount; i++) {
-				const uint64_t blockState = blockStates[bsCnt];
-				const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
-				if (blockIndex < secPal.pal.size()) {
-					blocks[i] = secPal.pal[blockIndex];
-					hasBlocks = true;
-				} else {
-					blocks[i] = 0;
-				}
-				bitCnt += bitSize;
-				if (bitCnt + bitSize > 64) {
-					bsCnt++;
-					bitCnt = 0;
-				}
-			}
+			success = reader.skip(type);
 		}
-
-		glm::ivec3 sPos;
-		for (sPos.y = 0; sPos.y < MAX_SIZE; ++sPos.y) {
-			for (sPos.z = 0; sPos.z < MAX_SIZE; ++sPos.z) {
-				for (sPos.x = 0; sPos.x < MAX_SIZE; ++sPos.x) {
-					const uint16_t i = sPos.y * MAX_SIZE * MAX_SIZE + sPos.z * MAX_SIZE + sPos.x;
-					const uint8_t color = blocks[i];
-					if (color) {
-						const uint8_t palColIdx = palette.getClosestMatch(secPal.mcpal.color(color));
-						const voxel::Voxel voxel = voxel::createVoxel(palette, palColIdx);
-						v->setVoxel(sPos, voxel);
-					}
-				}
-			}
+		if (!success) {
+			return false;
 		}
 	}
+	return !reader.error();
+}
 
-	if (hasBlocks) {
-		glm::ivec3 translate;
-		translate.x = 0;
-		translate.y = sectionY * MAX_SIZE;
-		translate.z = 0;
-
-		v->translate(translate);
-		volumes.push_back(v);
-	} else {
-		delete v;
+bool MCRFormat::parseSection(priv::NamedBinaryTagReader &reader, MinecraftSection &section) {
+	priv::TagType type;
+	core::String name;
+	while (reader.nextTag(type, name)) {
+		bool success;
+		if (name == "Y") {
+			int64_t y = 0;
+			success = reader.readInt(type, y);
+			section.y = (int8_t)y;
+		} else if (name == "block_states" && type == priv::TagType::COMPOUND) {
+			success = parseBlockStatesCompound(reader, section);
+		} else if (name == "Palette" && type == priv::TagType::LIST) {
+			success = parsePaletteList(reader, section);
+		} else if (name == "Blocks") {
+			success = parseBlockData(reader, type, section.blocks);
+		} else if (name == "BlockStates") {
+			success = parseBlockData(reader, type, section.blockStates);
+		} else {
+			success = reader.skip(type);
+		}
+		if (!success) {
+			return false;
+		}
 	}
-	return true;
+	return !reader.error();
 }
 
-voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-										   const palette::Palette &pal) {
-	const priv::NamedBinaryTag &sections = root.get("sections");
-	if (!sections.valid()) {
-		Log::error("Could not find 'sections' tag");
-		return nullptr;
+bool MCRFormat::parseSectionList(priv::NamedBinaryTagReader &reader, priv::TagType type,
+								 core::DynamicArray<MinecraftSection> &sections) {
+	if (type != priv::TagType::LIST) {
+		Log::error("Unexpected tag type found for sections tag: %i", (int)type);
+		return false;
 	}
-	if (sections.type() != priv::TagType::LIST) {
-		Log::error("Unexpected tag type found for 'sections' tag: %i", (int)sections.type());
-		return nullptr;
+	priv::TagType contentType;
+	uint32_t length;
+	if (!reader.readListHeader(contentType, length)) {
+		return false;
 	}
-
-	const int32_t xPos = root.get("xPos").int32();
-	const int32_t zPos = root.get("zPos").int32();
-
-	Log::debug("xpos: %i, zpos: %i", xPos, zPos);
-
-	const priv::NBTList &sectionsList = *sections.list();
-	Log::debug("Found %i sections", (int)sectionsList.size());
-	if (sectionsList.empty()) {
-		Log::warn("Empty region - no sections found - version: %i", dataVersion);
-		return nullptr;
+	if (contentType != priv::TagType::COMPOUND) {
+		for (uint32_t i = 0; i < length; ++i) {
+			if (!reader.skip(contentType)) {
+				return false;
+			}
+		}
+		return true;
 	}
-	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &blockStates = section.get("block_states");
-		if (!blockStates.valid()) {
-			Log::error("Could not find 'block_states'");
-			return error(volumes);
+	sections.resize(length);
+	for (uint32_t i = 0; i < length; ++i) {
+		if (!parseSection(reader, sections[i])) {
+			return false;
 		}
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
-		if (!ylvl.valid()) {
-			Log::debug("Could not find Y int in section compound");
+	}
+	return true;
+}
+
+bool MCRFormat::parseLevelCompound(priv::NamedBinaryTagReader &reader, MinecraftChunk &chunk) {
+	chunk.hasLevel = true;
+	priv::TagType type;
+	core::String name;
+	while (reader.nextTag(type, name)) {
+		bool success;
+		int64_t val = 0;
+		if (name == "xPos") {
+			success = reader.readInt(type, val);
+			chunk.levelPos.x = (int32_t)val;
+		} else if (name == "zPos") {
+			success = reader.readInt(type, val);
+			chunk.levelPos.y = (int32_t)val;
+		} else if (name == "Sections") {
+			chunk.hasLevelSections = true;
+			success = parseSectionList(reader, type, chunk.levelSections);
+		} else {
+			success = reader.skip(type);
 		}
-		const int8_t sectionY = ylvl.int8();
-		if (sectionY == -1) {
-			Log::debug("Skip empty section compound");
+		if (!success) {
+			return false;
 		}
-		Log::debug("Y level for section compound: %i", (int)sectionY);
+	}
+	return !reader.error();
+}
 
-		const priv::NamedBinaryTag &palette = blockStates.get("palette");
-		if (!palette.valid()) {
-			Log::error("Could not find 'palette'");
-			return error(volumes);
-		}
-		MinecraftSectionPalette secPal;
-		secPal.mcpal.minecraft();
-		if (!parsePaletteList(dataVersion, palette, secPal)) {
-			Log::error("Could not parse palette chunk");
-			return error(volumes);
+bool MCRFormat::parseChunk(io::ReadStream &stream, MinecraftChunk &chunk) {
+	priv::NamedBinaryTagReader reader(stream);
+	if (!reader.readRoot()) {
+		return false;
+	}
+	priv::TagType type;
+	core::String name;
+	while (reader.nextTag(type, name)) {
+		bool success;
+		int64_t val = 0;
+		if (name == "DataVersion") {
+			success = reader.readInt(type, val);
+			chunk.dataVersion = (int32_t)val;
+		} else if (name == "xPos") {
+			success = reader.readInt(type, val);
+			chunk.pos.x = (int32_t)val;
+		} else if (name == "zPos") {
+			success = reader.readInt(type, val);
+			chunk.pos.y = (int32_t)val;
+		} else if (name == "sections") {
+			chunk.hasSections = true;
+			success = parseSectionList(reader, type, chunk.sections);
+		} else if (name == "Level" && type == priv::TagType::COMPOUND) {
+			success = parseLevelCompound(reader, chunk);
+		} else {
+			success = reader.skip(type);
 		}
-		const priv::NamedBinaryTag &data = blockStates.get("data");
-		if (!parseBlockStates(dataVersion, pal, data, volumes, sectionY, secPal)) {
-			Log::error("Failed to parse 'data' tag");
-			return error(volumes);
+		if (!success) {
+			return false;
 		}
 	}
-	return finalize(volumes, xPos, zPos);
+	return !reader.error();
 }
 
-voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-												const palette::Palette &pal) {
-	const priv::NamedBinaryTag &levels = root.get("Level");
-	if (!levels.valid()) {
-		Log::error("Could not find 'Level' tag");
-		return nullptr;
+bool MCRFormat::unpackBlocks(int dataVersion, const MinecraftSection &section, const MinecraftBlockData &data,
+							 uint8_t *blocks) {
+	constexpr int blockCount = MAX_SIZE * MAX_SIZE * MAX_SIZE;
+	if (section.pal.empty()) {
+		if (data.type != priv::TagType::BYTE_ARRAY) {
+			Log::error("Unknown block data type: %i for version %i", (int)data.type, dataVersion);
+			return false;
+		}
+		if ((int)data.bytes.size() < blockCount) {
+			Log::error("Byte array index out of bounds: %i/%i", blockCount, (int)data.bytes.size());
+			return false;
+		}
+		core_memcpy(blocks, data.bytes.data(), blockCount);
+		return true;
 	}
-	if (levels.type() != priv::TagType::COMPOUND) {
-		Log::error("Invalid type for 'Level' tag: %i", (int)levels.type());
-		return nullptr;
+
+	core_memset(blocks, 0, blockCount);
+	if (data.type != priv::TagType::LONG_ARRAY || data.longs.empty()) {
+		return true;
 	}
-	const int32_t xPos = levels.get("xPos").int32();
-	const int32_t zPos = levels.get("zPos").int32();
 
-	if (dataVersion >= 1976) {
-		const core::String *tagStatus = root.get("Status").string();
-		if (tagStatus == nullptr) {
-			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "full") {
-			Log::debug("Status for level node is not full but %s (version: %i)", tagStatus->c_str(), dataVersion);
+	const core::DynamicArray<int64_t> &blockStates = data.longs;
+	const size_t blockStateCount = blockStates.size();
+	const size_t palSize = section.pal.size();
+	size_t bsCnt = 0;
+	size_t bitCnt = 0;
+	if (dataVersion < 2529) {
+		// the indices might span two longs
+		const size_t bitSize = blockStateCount * 64 / blockCount;
+		const uint32_t bitMask = (1 << bitSize) - 1;
+		for (int i = 0; i < blockCount && bsCnt < blockStateCount; i++) {
+			uint64_t blockIndex;
+			if (bitCnt + bitSize <= 64) {
+				const uint64_t blockState = blockStates[bsCnt];
+				blockIndex = (blockState >> bitCnt) & bitMask;
+				bitCnt += bitSize;
+				if (bitCnt == 64) {
+					bitCnt = 0;
+					bsCnt++;
+				}
+			} else {
+				const uint64_t blockState1 = blockStates[bsCnt++];
+				if (bsCnt >= blockStateCount) {
+					break;
+				}
+				const uint64_t blockState2 = blockStates[bsCnt];
+				blockIndex = (blockState1 >> bitCnt) & bitMask;
+				bitCnt += bitSize;
+				bitCnt -= 64;
+				blockIndex += (blockState2 << (bitSize - bitCnt)) & bitMask;
+			}
+			if (blockIndex < palSize) {
+				blocks[i] = section.pal[blockIndex];
+			}
 		}
-	} else if (dataVersion >= 1628) {
-		const core::String *tagStatus = levels.get("Status").string();
-		if (tagStatus == nullptr) {
-			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "postprocessed") {
-			Log::debug("Status for level node is not postprocessed but %s (version: %i)", tagStatus->c_str(),
-					   dataVersion);
+	} else {
+		const size_t bitSize = section.numBits;
+		const uint32_t bitMask = (1 << bitSize) - 1;
+		for (int i = 0; i < blockCount && bsCnt < blockStateCount; i++) {
+			const uint64_t blockState = blockStates[bsCnt];
+			const uint64_t blockIndex = (blockState >> bitCnt) & bitMask;
+			if (blockIndex < palSize) {
+				blocks[i] = section.pal[blockIndex];
+			}
+			bitCnt += bitSize;
+			if (bitCnt + bitSize > 64) {
+				bsCnt++;
+				bitCnt = 0;
+			}
 		}
 	}
+	return true;
+}
 
-	const priv::NamedBinaryTag &sections = levels.get("Sections");
-	if (!sections.valid()) {
-		Log::error("Could not find 'Sections' tag");
+voxel::RawVolume *MCRFormat::createVolume(const MinecraftChunk &chunk, const voxel::Region &region,
+										  const voxel::Voxel *voxels, bool &error) {
+	const int dataVersion = chunk.dataVersion;
+	Log::debug("Found data version %i", dataVersion);
+	// https://minecraft.wiki/w/Data_version
+	const bool newVersion = dataVersion >= 2844;
+	if (newVersion && !chunk.hasSections) {
+		Log::error("Could not find 'sections' tag");
+		error = true;
 		return nullptr;
 	}
-	if (sections.type() != priv::TagType::LIST) {
-		Log::error("Invalid type for 'Sections' tag: %i", (int)sections.type());
+	if (!newVersion && !chunk.hasLevel) {
+		Log::error("Could not find 'Level' tag");
+		error = true;
 		return nullptr;
 	}
-	const priv::NBTList &sectionsList = *sections.list();
-	Log::debug("Found %i sections", (int)sectionsList.size());
-	if (sectionsList.empty()) {
-		Log::warn("Empty region - no sections found - version: %i", dataVersion);
+	if (!newVersion && !chunk.hasLevelSections) {
+		Log::error("Could not find 'Sections' tag");
+		error = true;
 		return nullptr;
 	}
-	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
-		if (!ylvl.valid()) {
-			Log::debug("Could not find Y int in section compound");
-		}
-		const int8_t sectionY = ylvl.int8();
-		if (sectionY == -1) {
-			Log::debug("Skip empty section compound");
-		}
-		Log::debug("Y level for section compound: %i", (int)sectionY);
-
-		MinecraftSectionPalette secPal;
-		secPal.mcpal.minecraft();
-
-		const priv::NamedBinaryTag &palette = section.get("Palette");
-		if (palette.valid()) {
-			if (!parsePaletteList(dataVersion, palette, secPal)) {
-				Log::error("Failed to parse 'Palette' tag");
-				return error(volumes);
+	const glm::ivec2 &chunkPos = newVersion ? chunk.pos : chunk.levelPos;
+	const core::DynamicArray<MinecraftSection> &sections = newVersion ? chunk.sections : chunk.levelSections;
+	Log::debug("xpos: %i, zpos: %i, sections: %i", chunkPos.x, chunkPos.y, (int)sections.size());
+
+	const glm::ivec3 chunkOffset(chunkPos.x * MAX_SIZE, 0, chunkPos.y * MAX_SIZE);
+	constexpr int blockCount = MAX_SIZE * MAX_SIZE * MAX_SIZE;
+	core::Buffer<uint8_t> blocks;
+	core::DynamicArray<int> sectionYs;
+	glm::ivec3 mins((std::numeric_limits<int>::max)() / 2);
+	glm::ivec3 maxs((std::numeric_limits<int>::min)() / 2);
+
+	for (const MinecraftSection &section : sections) {
+		const MinecraftBlockData *data;
+		if (newVersion) {
+			if (!section.hasBlockStates) {
+				Log::error("Could not find 'block_states'");
+				error = true;
+				return nullptr;
 			}
+			if (!section.hasPalette) {
+				Log::error("Could not find 'palette'");
+				error = true;
+				return nullptr;
+			}
+			data = &section.blockStates;
 		} else {
-			Log::debug("Could not find a Palette compound in section %i", dataVersion);
+			// TODO:"Data"(byte_array)
+			data = dataVersion <= 1343 ? &section.blocks : &section.blockStates;
+			if (data->type == priv::TagType::END) {
+				Log::debug("Could not find block data in section %i", section.y);
+				continue;
+			}
 		}
-
-		// TODO:"Data"(byte_array)
-		// const priv::NamedBinaryTag &data = section.get("Data");
-		const core::String &tagId = dataVersion <= 1343 ? "Blocks" : "BlockStates";
-		const priv::NamedBinaryTag &blockStates = section.get(tagId);
-		if (!blockStates.valid()) {
-			Log::debug("Could not find '%s'", tagId.c_str());
+		const int sectionY = section.y * MAX_SIZE;
+		if (region.isValid() && (sectionY > region.getUpperY() || sectionY + MAX_SIZE - 1 < region.getLowerY())) {
 			continue;
 		}
-		if (!parseBlockStates(dataVersion, pal, blockStates, volumes, sectionY, secPal)) {
-			Log::error("Failed to parse '%s' tag", tagId.c_str());
-			return error(volumes);
+
+		const size_t offset = blocks.size();
+		blocks.resize(offset + blockCount);
+		uint8_t *sectionBlocks = blocks.data() + offset;
+		if (!unpackBlocks(dataVersion, section, *data, sectionBlocks)) {
+			error = true;
+			return nullptr;
 		}
-	}
-	return finalize(volumes, xPos, zPos);
-}
+		sectionYs.push_back(sectionY);
 
-bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette,
-								 MinecraftSectionPalette &sectionPal) {
-	if (palette.type() != priv::TagType::LIST) {
-		Log::error("Invalid type for palette: %i", (int)palette.type());
-		return false;
-	}
-	const priv::NBTList &paletteList = *palette.list();
-	const size_t paletteCount = paletteList.size();
-	if (paletteCount > 512u) {
-		Log::error("Palette overflow");
-		return false;
+		int i = 0;
+		glm::ivec3 pos;
+		for (pos.y = sectionY; pos.y < sectionY + MAX_SIZE; ++pos.y) {
+			for (pos.z = chunkOffset.z; pos.z < chunkOffset.z + MAX_SIZE; ++pos.z) {
+				for (pos.x = chunkOffset.x; pos.x < chunkOffset.x + MAX_SIZE; ++pos.x, ++i) {
+					if (sectionBlocks[i] == 0u) {
+						continue;
+					}
+					if (region.isValid() && !region.containsPoint(pos)) {
+						sectionBlocks[i] = 0u;
+						continue;
+					}
+					mins = glm::min(mins, pos);
+					maxs = glm::max(maxs, pos);
+				}
+			}
+		}
 	}
-	sectionPal.pal.resize(paletteCount);
-	sectionPal.numBits = (uint32_t)glm::max(glm::ceil(glm::log2((float)paletteCount)), 4.0f);
 
-	int paletteEntry = 0;
-	for (const priv::NamedBinaryTag &block : paletteList) {
-		if (block.type() != priv::TagType::COMPOUND) {
-			Log::error("Invalid block type %i", (int)block.type());
-			return false;
-		}
+	const voxel::Region volumeRegion(mins, maxs);
+	if (!volumeRegion.isValid()) {
+		Log::debug("No voxels found at %i:%i", chunkPos.x, chunkPos.y);
+		return nullptr;
+	}
 
-		for (const auto &entry : *block.compound()) {
-			if (entry->key != "Name") {
-				continue;
-			}
-			const priv::NamedBinaryTag &nbt = entry->value;
-			const core::String *value = nbt.string();
-			if (value == nullptr) {
-				continue;
+	// the volume only covers the voxels that are set - no merging and cropping of the sections needed
+	voxel::RawVolume *volume = new voxel::RawVolume(volumeRegion);
+	for (size_t s = 0; s < sectionYs.size(); ++s) {
+		const uint8_t *sectionBlocks = blocks.data() + s * blockCount;
+		const int sectionY = sectionYs[s];
+		int i = 0;
+		glm::ivec3 pos;
+		for (pos.y = sectionY; pos.y < sectionY + MAX_SIZE; ++pos.y) {
+			for (pos.z = chunkOffset.z; pos.z < chunkOffset.z + MAX_SIZE; ++pos.z) {
+				for (pos.x = chunkOffset.x; pos.x < chunkOffset.x + MAX_SIZE; ++pos.x, ++i) {
+					const uint8_t color = sectionBlocks[i];
+					if (color) {
+						volume->setVoxel(pos, voxels[color]);
+					}
+				}
 			}
-			sectionPal.pal[paletteEntry] = findPaletteIndex(*value);
 		}
-		++paletteEntry;
 	}
-	return true;
+	return volume;
 }
 
 #undef wrap
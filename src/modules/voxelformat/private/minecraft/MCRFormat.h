@@ -9,6 +9,9 @@
 #include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "palette/Palette.h"
+#include "NamedBinaryTag.h"
+#include "voxel/Region.h"
+#include <glm/vec2.hpp>
 
 namespace io {
 class ZipReadStream;
@@ -17,9 +20,7 @@ class ZipReadStream;
 namespace voxelformat {
 
 namespace priv {
-class NamedBinaryTag;
-using NBTCompound = core::DynamicMap<core::String, NamedBinaryTag, 11, core::StringHash>;
-using NBTList = core::DynamicArray<NamedBinaryTag>;
+class NamedBinaryTagReader;
 } // namespace priv
 
 /**
@@ -85,42 +86,94 @@ private:
 		uint8_t sectorCount;
 	} _offsets[SECTOR_INTS];
 
-	struct MinecraftSectionPalette {
-		core::Buffer<uint8_t> pal;
-		uint32_t numBits = 0u;
-		palette::Palette mcpal;
+	/**
+	 * @brief The compressed nbt data of one chunk in the region file
+	 */
+	struct MinecraftChunkData {
+		int sector = 0;
+		core::Buffer<uint8_t> data;
+		voxel::RawVolume *volume = nullptr;
+		bool failed = false;
 	};
 
-	using SectionVolumes = core::DynamicArray<voxel::RawVolume *>;
-
-	voxel::RawVolume *error(SectionVolumes &volumes);
-	voxel::RawVolume *finalize(SectionVolumes &volumes, int xPos, int zPos);
-
-	static int getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos);
-
-	// shared across versions
-	bool parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette, MinecraftSectionPalette &sectionPal);
-	bool parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
-						  SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal);
-
-	// new version (>= 2844)
-	voxel::RawVolume *parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-									const palette::Palette &palette);
-
-	// old version (< 2844)
-	voxel::RawVolume *parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-										 const palette::Palette &palette);
-
-	bool readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-						   const palette::Palette &palette);
 	bool loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-							 const palette::Palette &palette);
+							 const palette::Palette &palette, const voxel::Region &region, int regionX, int regionZ,
+							 bool validRegionPos);
 
 	bool saveSections(const scenegraph::SceneGraph &sceneGraph, priv::NBTList &sections, int sector);
 	bool saveCompressedNBT(const scenegraph::SceneGraph &sceneGraph, io::SeekableWriteStream &stream, int sector);
 	bool saveMinecraftRegion(const scenegraph::SceneGraph &sceneGraph, io::SeekableWriteStream &stream);
 
 protected:
+	/**
+	 * @brief The raw block data of a section - either a byte array with minecraft palette indices or a long array with
+	 * bit packed indices into the section palette
+	 */
+	struct MinecraftBlockData {
+		priv::TagType type = priv::TagType::END;
+		core::DynamicArray<int8_t> bytes;
+		core::DynamicArray<int64_t> longs;
+	};
+
+	/**
+	 * @brief The parts of a section compound that are needed to build the volume. All other tags are skipped while
+	 * streaming the nbt data.
+	 */
+	struct MinecraftSection {
+		int y = 0;
+		bool hasBlockStates = false;
+		bool hasPalette = false;
+		// maps the section palette entries to the minecraft palette indices
+		core::Buffer<uint8_t> pal;
+		uint32_t numBits = 0u;
+		// "Blocks" (old versions)
+		MinecraftBlockData blocks;
+		// "BlockStates" (old versions) or "data" in the "block_states" compound (>= 2844)
+		MinecraftBlockData blockStates;
+	};
+
+	struct MinecraftChunk {
+		int32_t dataVersion = 0;
+		// new version (>= 2844) - the sections are part of the root compound
+		bool hasSections = false;
+		glm::ivec2 pos{0};
+		core::DynamicArray<MinecraftSection> sections;
+		// old version (< 2844) - the sections are part of the "Level" compound
+		bool hasLevel = false;
+		bool hasLevelSections = false;
+		glm::ivec2 levelPos{0};
+		core::DynamicArray<MinecraftSection> levelSections;
+	};
+
+	static bool parseBlockData(priv::NamedBinaryTagReader &reader, priv::TagType type, MinecraftBlockData &data);
+	static bool parsePaletteList(priv::NamedBinaryTagReader &reader, MinecraftSection &section);
+	static bool parseBlockStatesCompound(priv::NamedBinaryTagReader &reader, MinecraftSection &section);
+	static bool parseSection(priv::NamedBinaryTagReader &reader, MinecraftSection &section);
+	static bool parseSectionList(priv::NamedBinaryTagReader &reader, priv::TagType type,
+								 core::DynamicArray<MinecraftSection> &sections);
+	static bool parseLevelCompound(priv::NamedBinaryTagReader &reader, MinecraftChunk &chunk);
+	/**
+	 * @brief Streams the nbt data of a chunk without building the whole tag tree
+	 */
+	static bool parseChunk(io::ReadStream &stream, MinecraftChunk &chunk);
+
+	/**
+	 * @brief Unpacks the block data of a section into minecraft palette indices
+	 * @param[out] blocks 16x16x16 minecraft palette indices in yzx order
+	 * @return @c false on error
+	 */
+	static bool unpackBlocks(int dataVersion, const MinecraftSection &section, const MinecraftBlockData &data,
+							 uint8_t *blocks);
+	/**
+	 * @brief Converts the parsed chunk into a volume that only contains the voxels inside the given region
+	 * @param[out] error set to @c true if the chunk data is invalid
+	 * @return @c nullptr if there are no voxels in the chunk or on error
+	 */
+	static voxel::RawVolume *createVolume(const MinecraftChunk &chunk, const voxel::Region &region,
+										  const voxel::Voxel *voxels, bool &error);
+
+	static voxel::Region parseRegion(const core::String &str);
+
 	bool loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 						   const LoadContext &ctx) override;
@@ -0,0 +1,265 @@
+/**
+ * @file
+ */
+
+#include "NamedBinaryTagReader.h"
+#include "core/Log.h"
+#include <SDL_endian.h>
+
+namespace voxelformat {
+
+namespace priv {
+
+// upper limit for array payloads - protects against huge allocations for corrupted data
+static constexpr uint32_t MaxArrayBytes = 64u * 1024u * 1024u;
+
+// payload size of the fixed size tags - or 0 for tags with a variable size
+static int64_t primitiveSize(TagType type) {
+	switch (type) {
+	case TagType::BYTE:
+		return 1;
+	case TagType::SHORT:
+		return 2;
+	case TagType::INT:
+	case TagType::FLOAT:
+		return 4;
+	case TagType::LONG:
+	case TagType::DOUBLE:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+bool NamedBinaryTagReader::fail() {
+	_error = true;
+	return false;
+}
+
+bool NamedBinaryTagReader::skipBytes(int64_t bytes) {
+	uint8_t buf[4096];
+	while (bytes > 0) {
+		const int64_t n = bytes < (int64_t)sizeof(buf) ? bytes : (int64_t)sizeof(buf);
+		if (_stream.read(buf, (size_t)n) != (int)n) {
+			return fail();
+		}
+		bytes -= n;
+	}
+	return true;
+}
+
+bool NamedBinaryTagReader::readRoot() {
+	uint8_t type;
+	if (_stream.readUInt8(type) != 0 || (TagType)type != TagType::COMPOUND) {
+		return fail();
+	}
+	uint16_t length;
+	if (_stream.readUInt16BE(length) != 0) {
+		return fail();
+	}
+	return skipBytes(length);
+}
+
+bool NamedBinaryTagReader::nextTag(TagType &type, core::String &name) {
+	if (_error) {
+		return false;
+	}
+	uint8_t raw;
+	if (_stream.readUInt8(raw) != 0) {
+		return fail();
+	}
+	type = (TagType)raw;
+	if (type == TagType::END) {
+		return false;
+	}
+	if (type >= TagType::MAX) {
+		Log::debug("Invalid nbt tag type %i", (int)raw);
+		return fail();
+	}
+	return readString(name);
+}
+
+bool NamedBinaryTagReader::readListHeader(TagType &contentType, uint32_t &length) {
+	uint8_t raw;
+	if (_stream.readUInt8(raw) != 0 || raw >= (uint8_t)TagType::MAX) {
+		return fail();
+	}
+	contentType = (TagType)raw;
+	if (_stream.readUInt32BE(length) != 0) {
+		return fail();
+	}
+	if (contentType == TagType::END && length > 0u) {
+		// lists of end tags don't have any payload
+		length = 0u;
+	}
+	return true;
+}
+
+bool NamedBinaryTagReader::readInt(TagType type, int64_t &val) {
+	switch (type) {
+	case TagType::BYTE: {
+		int8_t v;
+		if (_stream.readInt8(v) != 0) {
+			return fail();
+		}
+		val = v;
+		return true;
+	}
+	case TagType::SHORT: {
+		int16_t v;
+		if (_stream.readInt16BE(v) != 0) {
+			return fail();
+		}
+		val = v;
+		return true;
+	}
+	case TagType::INT: {
+		int32_t v;
+		if (_stream.readInt32BE(v) != 0) {
+			return fail();
+		}
+		val = v;
+		return true;
+	}
+	case TagType::LONG:
+		if (_stream.readInt64BE(val) != 0) {
+			return fail();
+		}
+		return true;
+	default:
+		// not an integral tag - consume the payload to stay in sync with the stream
+		skip(type);
+		return false;
+	}
+}
+
+bool NamedBinaryTagReader::readString(core::String &str) {
+	uint16_t length;
+	if (_stream.readUInt16BE(length) != 0) {
+		return fail();
+	}
+	char buf[256];
+	if (length < sizeof(buf)) {
+		if (_stream.read(buf, length) != (int)length) {
+			return fail();
+		}
+		str = core::String(buf, length);
+		return true;
+	}
+	core::String s(length, ' ');
+	if (_stream.read(s.c_str(), length) != (int)length) {
+		return fail();
+	}
+	str = core::move(s);
+	return true;
+}
+
+bool NamedBinaryTagReader::readByteArray(core::DynamicArray<int8_t> &array) {
+	uint32_t length;
+	if (_stream.readUInt32BE(length) != 0 || length > MaxArrayBytes) {
+		return fail();
+	}
+	array.resize(length);
+	if (length > 0u && _stream.read(array.data(), length) != (int)length) {
+		return fail();
+	}
+	return true;
+}
+
+bool NamedBinaryTagReader::readLongArray(core::DynamicArray<int64_t> &array) {
+	uint32_t length;
+	if (_stream.readUInt32BE(length) != 0 || length > MaxArrayBytes / sizeof(int64_t)) {
+		return fail();
+	}
+	array.resize(length);
+	if (length == 0u) {
+		return true;
+	}
+	const int bytes = (int)(length * sizeof(int64_t));
+	if (_stream.read(array.data(), bytes) != bytes) {
+		return fail();
+	}
+	// one bulk read and an in-place swap instead of one stream call per element
+	int64_t *values = array.data();
+	for (uint32_t i = 0; i < length; ++i) {
+		values[i] = (int64_t)SDL_SwapBE64((uint64_t)values[i]);
+	}
+	return true;
+}
+
+bool NamedBinaryTagReader::skip(TagType type) {
+	return skip(type, 0);
+}
+
+bool NamedBinaryTagReader::skip(TagType type, int level) {
+	if (level > MaxDepth) {
+		Log::debug("Max nbt depth exceeded");
+		return fail();
+	}
+	const int64_t size = primitiveSize(type);
+	if (size > 0) {
+		return skipBytes(size);
+	}
+	switch (type) {
+	case TagType::END:
+		return true;
+	case TagType::STRING: {
+		uint16_t length;
+		if (_stream.readUInt16BE(length) != 0) {
+			return fail();
+		}
+		return skipBytes(length);
+	}
+	case TagType::BYTE_ARRAY:
+	case TagType::INT_ARRAY:
+	case TagType::LONG_ARRAY: {
+		uint32_t length;
+		if (_stream.readUInt32BE(length) != 0) {
+			return fail();
+		}
+		const int64_t elementSize = type == TagType::BYTE_ARRAY ? 1 : (type == TagType::INT_ARRAY ? 4 : 8);
+		return skipBytes((int64_t)length * elementSize);
+	}
+	case TagType::LIST: {
+		TagType contentType;
+		uint32_t length;
+		if (!readListHeader(contentType, length)) {
+			return false;
+		}
+		const int64_t elementSize = primitiveSize(contentType);
+		if (elementSize > 0) {
+			return skipBytes((int64_t)length * elementSize);
+		}
+		for (uint32_t i = 0; i < length; ++i) {
+			if (!skip(contentType, level + 1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case TagType::COMPOUND: {
+		for (;;) {
+			uint8_t subType;
+			if (_stream.readUInt8(subType) != 0 || subType >= (uint8_t)TagType::MAX) {
+				return fail();
+			}
+			if ((TagType)subType == TagType::END) {
+				return true;
+			}
+			// the names of skipped tags are not needed
+			uint16_t length;
+			if (_stream.readUInt16BE(length) != 0 || !skipBytes(length)) {
+				return fail();
+			}
+			if (!skip((TagType)subType, level + 1)) {
+				return false;
+			}
+		}
+	}
+	default:
+		return fail();
+	}
+}
+
+} // namespace priv
+} // namespace voxelformat
@@ -0,0 +1,99 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "NamedBinaryTag.h"
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "io/Stream.h"
+#include <stdint.h>
+
+namespace voxelformat {
+
+namespace priv {
+
+/**
+ * @brief Pull parser for the named binary tag format
+ *
+ * Other than @c NamedBinaryTag::parse() this doesn't build a tree of the whole structure. The caller walks the
+ * compounds with @c nextTag() and either reads the tags it is interested in or calls @c skip() for the others. This
+ * allows to only decode the palettes and block states of a minecraft chunk without allocating the light, heightmap or
+ * entity data.
+ *
+ * @code
+ * NamedBinaryTagReader reader(stream);
+ * if (!reader.readRoot()) {
+ *   return false;
+ * }
+ * TagType type;
+ * core::String name;
+ * while (reader.nextTag(type, name)) {
+ *   if (name == "DataVersion") {
+ *     reader.readInt(type, dataVersion);
+ *   } else {
+ *     reader.skip(type);
+ *   }
+ * }
+ * if (reader.error()) {
+ *   return false;
+ * }
+ * @endcode
+ *
+ * @note https://minecraft.wiki/w/NBT_format
+ */
+class NamedBinaryTagReader {
+private:
+	io::ReadStream &_stream;
+	bool _error = false;
+
+	bool fail();
+	bool skipBytes(int64_t bytes);
+	bool skip(TagType type, int level);
+
+public:
+	static constexpr int MaxDepth = 512;
+
+	explicit NamedBinaryTagReader(io::ReadStream &stream) : _stream(stream) {
+	}
+
+	/**
+	 * @brief Reads the type and the name of the root compound
+	 */
+	bool readRoot();
+
+	/**
+	 * @brief Reads the header of the next tag in the current compound
+	 * @return @c false if the end of the compound was reached or an error occurred - check @c error() to distinguish
+	 * both cases. If @c true is returned, the caller must either read the payload or call @c skip() with the
+	 * returned type
+	 */
+	bool nextTag(TagType &type, core::String &name);
+
+	/**
+	 * @brief Reads the element type and the amount of elements of a list tag. The elements must be consumed by the
+	 * caller.
+	 */
+	bool readListHeader(TagType &contentType, uint32_t &length);
+
+	/**
+	 * @brief Reads any integral tag payload (byte, short, int, long)
+	 */
+	bool readInt(TagType type, int64_t &val);
+	bool readString(core::String &str);
+	bool readByteArray(core::DynamicArray<int8_t> &array);
+	bool readLongArray(core::DynamicArray<int64_t> &array);
+
+	/**
+	 * @brief Skips the payload of a tag of the given type - including nested compounds and lists
+	 */
+	bool skip(TagType type);
+
+	inline bool error() const {
+		return _error;
+	}
+};
+
+} // namespace priv
+} // namespace voxelformat
@@ -10,6 +10,7 @@
 #include "core/ScopedPtr.h"
 #include "core/Var.h"
 #include "core/collection/Array.h"
+#include "core/collection/DynamicArray.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "palette/NormalPalette.h"
@@ -36,6 +37,133 @@
 
 namespace voxelformat {
 
+/**
+ * The current version of the format - since version 5 the voxels are stored in bricks
+ */
+static constexpr uint32_t VENGIVersion = 5u;
+/**
+ * The edge length of the bricks the volume is split into for the voxel data since version 5
+ */
+static constexpr int VENGIBrickSize = 32;
+
+enum VENGIBrickType : uint8_t { VENGIBrickEmpty, VENGIBrickRLE };
+
+/**
+ * @brief A run of voxels in a brick in x, y, z order - the length is stored minus one
+ */
+struct VENGIRun {
+	uint16_t length;
+	uint8_t air;
+	uint8_t color;
+	uint8_t normal;
+};
+
+static void appendRun(core::DynamicArray<uint8_t> &buffer, const VENGIRun &run) {
+	const uint8_t data[] = {(uint8_t)(run.length & 0xFF), (uint8_t)(run.length >> 8), run.air, run.color,
+							run.normal};
+	buffer.append(data, lengthof(data));
+}
+
+/**
+ * @brief Run length encoding of the voxels of the given brick region
+ * @return @c false if the brick is empty
+ */
+static bool encodeBrick(const voxel::RawVolume &volume, const voxel::Region &brickRegion, int replaceIndex,
+						int replacement, core::DynamicArray<uint8_t> &buffer) {
+	VENGIRun run{0, 1, 0, 0};
+	int runLength = 0;
+	bool empty = true;
+	voxel::RawVolume::Sampler sampler(volume);
+	for (int z = brickRegion.getLowerZ(); z <= brickRegion.getUpperZ(); ++z) {
+		for (int y = brickRegion.getLowerY(); y <= brickRegion.getUpperY(); ++y) {
+			sampler.setPosition(brickRegion.getLowerX(), y, z);
+			for (int x = brickRegion.getLowerX(); x <= brickRegion.getUpperX(); ++x, sampler.movePositiveX()) {
+				const voxel::Voxel &voxel = sampler.voxel();
+				const uint8_t air = isAir(voxel.getMaterial()) ? 1u : 0u;
+				uint8_t color = 0u;
+				uint8_t normal = 0u;
+				if (!air) {
+					empty = false;
+					color = voxel.getColor() == replaceIndex ? (uint8_t)replacement : voxel.getColor();
+					normal = voxel.getNormal();
+				}
+				if (runLength > 0) {
+					if (run.air == air && run.color == color && run.normal == normal) {
+						++runLength;
+						continue;
+					}
+					run.length = (uint16_t)(runLength - 1);
+					appendRun(buffer, run);
+				}
+				run.air = air;
+				run.color = color;
+				run.normal = normal;
+				runLength = 1;
+			}
+		}
+	}
+	if (empty) {
+		buffer.clear();
+		return false;
+	}
+	run.length = (uint16_t)(runLength - 1);
+	appendRun(buffer, run);
+	return true;
+}
+
+static bool decodeBrick(voxel::RawVolume &volume, const voxel::Region &brickRegion, const palette::Palette &palette,
+						const uint8_t *buffer, size_t size) {
+	voxel::RawVolume::Sampler sampler(volume);
+	glm::ivec3 pos = brickRegion.getLowerCorner();
+	sampler.setPosition(pos);
+	const size_t runSize = 5u;
+	for (size_t i = 0; i + runSize <= size; i += runSize) {
+		const int length = (int)(buffer[i] | (buffer[i + 1] << 8)) + 1;
+		const bool air = buffer[i + 2] != 0u;
+		const voxel::Voxel voxel = air ? voxel::Voxel() : voxel::createVoxel(palette, buffer[i + 3], buffer[i + 4]);
+		for (int n = 0; n < length; ++n) {
+			if (pos.z > brickRegion.getUpperZ()) {
+				Log::error("Run exceeds the brick region");
+				return false;
+			}
+			if (!air) {
+				sampler.setVoxel(voxel);
+			}
+			if (pos.x < brickRegion.getUpperX()) {
+				++pos.x;
+				sampler.movePositiveX();
+				continue;
+			}
+			pos.x = brickRegion.getLowerX();
+			if (pos.y < brickRegion.getUpperY()) {
+				++pos.y;
+			} else {
+				pos.y = brickRegion.getLowerY();
+				++pos.z;
+			}
+			sampler.setPosition(pos);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Splits the given region into the bricks in z, y, x order
+ */
+static void brickRegions(const voxel::Region &region, core::DynamicArray<voxel::Region> &bricks) {
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	for (int z = mins.z; z <= maxs.z; z += VENGIBrickSize) {
+		for (int y = mins.y; y <= maxs.y; y += VENGIBrickSize) {
+			for (int x = mins.x; x <= maxs.x; x += VENGIBrickSize) {
+				const glm::ivec3 brickMins(x, y, z);
+				const glm::ivec3 brickMaxs = glm::min(brickMins + (VENGIBrickSize - 1), maxs);
+				bricks.emplace_back(brickMins, brickMaxs);
+			}
+		}
+	}
+}
+
 static scenegraph::SceneGraphNodeType toNodeType(const core::String &type) {
 	for (int i = 0; i < lengthof(scenegraph::SceneGraphNodeTypeStr); ++i) {
 		if (type == scenegraph::SceneGraphNodeTypeStr[i]) {
@@ -100,19 +228,30 @@ bool VENGIFormat::saveNodeData(const scenegraph::SceneGraph &sceneGraph, const s
 		replacement = node.palette().findReplacement(replaceIndex);
 		Log::debug("Looking for a similar color in the palette: %d", replacement);
 	}
-	auto visitor = [&stream, replacement, replaceIndex](int, int, int, const voxel::Voxel &voxel) {
-		const bool air = isAir(voxel.getMaterial());
-		stream.writeBool(air);
-		if (!air) {
-			if (voxel.getColor() == replaceIndex) {
-				stream.writeUInt8(replacement);
-			} else {
-				stream.writeUInt8(voxel.getColor());
-			}
-			stream.writeUInt8(voxel.getNormal());
+	core::DynamicArray<voxel::Region> bricks;
+	brickRegions(region, bricks);
+	wrapBool(stream.writeUInt32(VENGIBrickSize))
+	wrapBool(stream.writeUInt32((uint32_t)bricks.size()))
+
+	// encode all bricks first to be able to write the size table - this allows readers to skip bricks
+	core::DynamicArray<core::DynamicArray<uint8_t>> buffers;
+	buffers.resize(bricks.size());
+	for (size_t i = 0; i < bricks.size(); ++i) {
+		encodeBrick(*v, bricks[i], replaceIndex, replacement, buffers[i]);
+	}
+	for (size_t i = 0; i < bricks.size(); ++i) {
+		wrapBool(stream.writeUInt8(buffers[i].empty() ? VENGIBrickEmpty : VENGIBrickRLE))
+		wrapBool(stream.writeUInt32((uint32_t)buffers[i].size()))
+	}
+	for (const core::DynamicArray<uint8_t> &buffer : buffers) {
+		if (buffer.empty()) {
+			continue;
 		}
-	};
-	voxelutil::visitVolume(*v, visitor, voxelutil::VisitAll(), voxelutil::VisitorOrder::XYZ);
+		if (stream.write(buffer.data(), buffer.size()) == -1) {
+			Log::error("Failed to write the brick data");
+			return false;
+		}
+	}
 	return true;
 }
 
@@ -242,6 +381,10 @@ bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::S
 	node.setVolume(v, true);
 	const palette::Palette &palette = node.palette();
 
+	if (version >= 5u) {
+		return loadNodeDataBricks(*v, palette, stream);
+	}
+
 	auto visitor = [&stream, v, version, &palette](int x, int y, int z, const voxel::Voxel &voxel) {
 		const bool air = stream.readBool();
 		if (air) {
@@ -259,6 +402,50 @@ bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::S
 	return true;
 }
 
+bool VENGIFormat::loadNodeDataBricks(voxel::RawVolume &volume, const palette::Palette &palette,
+									 io::ReadStream &stream) {
+	uint32_t brickSize;
+	wrap(stream.readUInt32(brickSize))
+	if (brickSize != VENGIBrickSize) {
+		Log::error("Unsupported brick size %u", brickSize);
+		return false;
+	}
+	uint32_t brickCount;
+	wrap(stream.readUInt32(brickCount))
+	core::DynamicArray<voxel::Region> bricks;
+	brickRegions(volume.region(), bricks);
+	if (brickCount != bricks.size()) {
+		Log::error("Unexpected brick count %u (expected %i)", brickCount, (int)bricks.size());
+		return false;
+	}
+	core::DynamicArray<uint8_t> types;
+	types.resize(brickCount);
+	core::DynamicArray<uint32_t> sizes;
+	sizes.resize(brickCount);
+	for (uint32_t i = 0; i < brickCount; ++i) {
+		wrap(stream.readUInt8(types[i]))
+		wrap(stream.readUInt32(sizes[i]))
+	}
+	core::DynamicArray<uint8_t> buffer;
+	for (uint32_t i = 0; i < brickCount; ++i) {
+		if (sizes[i] == 0u) {
+			continue;
+		}
+		if (types[i] != VENGIBrickRLE) {
+			Log::warn("Skip unknown brick type %u", types[i]);
+			wrap(stream.skipDelta(sizes[i]))
+			continue;
+		}
+		buffer.resize(sizes[i]);
+		if (stream.read(buffer.data(), buffer.size()) != (int)buffer.size()) {
+			Log::error("Failed to read the data of brick %u", i);
+			return false;
+		}
+		wrapBool(decodeBrick(volume, bricks[i], palette, buffer.data(), buffer.size()))
+	}
+	return true;
+}
+
 bool VENGIFormat::loadNodePaletteNormals(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node,
 										uint32_t version, io::ReadStream &stream) {
 	palette::NormalPalette normalPalette;
@@ -492,7 +679,7 @@ bool VENGIFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const cor
 	Log::debug("Save scenegraph as vengi");
 	wrapBool(stream->writeUInt32(FourCC('V', 'E', 'N', 'G')))
 	io::ZipWriteStream zipStream(*stream, stream->size());
-	wrapBool(zipStream.writeUInt32(4))
+	wrapBool(zipStream.writeUInt32(VENGIVersion))
 	if (!saveNode(sceneGraph, zipStream, sceneGraph.root())) {
 		return false;
 	}
@@ -515,7 +702,7 @@ bool VENGIFormat::loadGroups(const core::String &filename, const io::ArchivePtr
 	io::ZipReadStream zipStream(*stream, stream->size());
 	uint32_t version;
 	wrap(zipStream.readUInt32(version))
-	if (version > 4) {
+	if (version > VENGIVersion) {
 		Log::error("Unsupported version %u", version);
 		return false;
 	}
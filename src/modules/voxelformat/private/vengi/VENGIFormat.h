@@ -16,6 +16,9 @@ namespace voxelformat {
  *
  * It's a RIFF header based format. It stores one palette per model node.
  *
+ * Since version 5 the voxels of a model node are split into bricks. The bricks are run length encoded and prefixed
+ * by a table with the type and size of each brick - empty bricks don't have any data.
+ *
  * @ingroup Formats
  */
 class VENGIFormat : public Format {
@@ -41,6 +44,7 @@ private:
 							io::ReadStream &stream);
 	bool loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 					  io::ReadStream &stream);
+	bool loadNodeDataBricks(voxel::RawVolume &volume, const palette::Palette &palette, io::ReadStream &stream);
 	bool loadAnimation(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 					   io::ReadStream &stream);
 	bool loadNodeKeyFrame(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
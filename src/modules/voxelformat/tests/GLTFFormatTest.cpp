@@ -4,9 +4,16 @@
 
 #include "voxelformat/private/mesh/GLTFFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/ConfigVar.h"
+#include "core/ScopedPtr.h"
+#include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "util/VarUtil.h"
+#include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
+#include "voxelformat/VolumeFormat.h"
+#include <glm/geometric.hpp>
 
 namespace voxelformat {
 
@@ -18,6 +25,42 @@ TEST_F(GLTFFormatTest, testExportMesh) {
 	helper_saveSceneGraph(sceneGraph, "exportrgb.gltf");
 }
 
+TEST_F(GLTFFormatTest, testExportMeshLod) {
+	util::ScopedVarChange scoped(cfg::VoxFormatGLTF_MSFT_lod, "2");
+	scenegraph::SceneGraph sceneGraph;
+	const voxel::Region region(0, 15);
+	voxel::RawVolume *volume = new voxel::RawVolume(region);
+	const glm::vec3 center(region.getCenter());
+	for (int z = 0; z <= 15; ++z) {
+		for (int y = 0; y <= 15; ++y) {
+			for (int x = 0; x <= 15; ++x) {
+				if (glm::distance(glm::vec3(x, y, z), center) <= 7.0f) {
+					volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+				}
+			}
+		}
+	}
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(volume, true);
+	sceneGraph.emplace(core::move(node));
+	ASSERT_TRUE(helper_saveSceneGraph(sceneGraph, "exportlod.gltf"));
+
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream("exportlod.gltf"));
+	ASSERT_TRUE(stream);
+	core::String json;
+	ASSERT_TRUE(stream->readString((int)stream->size(), json));
+	EXPECT_TRUE(json.contains("MSFT_lod"));
+	EXPECT_TRUE(json.contains("MSFT_screencoverage"));
+
+	// the lod nodes are not part of the scene
+	scenegraph::SceneGraph sceneGraphLoad;
+	io::FileDescription fileDesc;
+	fileDesc.set("exportlod.gltf");
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraphLoad, testLoadCtx));
+	EXPECT_EQ(1u, sceneGraphLoad.size(scenegraph::SceneGraphNodeType::AllModels));
+}
+
 TEST_F(GLTFFormatTest, testImportAnimation) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "glTF/BoxAnimated.glb", 2);
@@ -54,6 +97,21 @@ TEST_F(GLTFFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("bv-smallvolumesavetest.gltf", &f, 0, 10, flags);
 }
 
+TEST_F(GLTFFormatTest, testSaveLoadVoxelQuantized) {
+	util::ScopedVarChange scoped(cfg::VoxFormatGLTF_KHR_mesh_quantization, "true");
+	GLTFFormat f;
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	testSaveLoadVoxel("bv-smallvolumesavetest-quantized.gltf", &f, 0, 10, flags);
+}
+
+TEST_F(GLTFFormatTest, testSaveLoadVoxelMeshoptCompression) {
+	util::ScopedVarChange scoped1(cfg::VoxFormatGLTF_KHR_mesh_quantization, "true");
+	util::ScopedVarChange scoped2(cfg::VoxFormatGLTF_EXT_meshopt_compression, "true");
+	GLTFFormat f;
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	testSaveLoadVoxel("bv-smallvolumesavetest-meshopt.glb", &f, 0, 10, flags);
+}
+
 TEST_F(GLTFFormatTest, testVoxelizeLantern) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "glTF/lantern/Lantern.gltf", 3u);
@@ -4,6 +4,12 @@
 
 #include "voxelformat/private/goxel/GoxFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/FourCC.h"
+#include "core/ScopedPtr.h"
+#include "io/Stream.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/VolumeVisitor.h"
 
 namespace voxelformat {
 
@@ -18,6 +24,59 @@ TEST_F(GoxFormatTest, testSaveSmallVoxel) {
 	testSaveLoadVoxel("goxel-smallvolumesavetest.gox", &f, -16, 15, voxel::ValidateFlags::None);
 }
 
+TEST_F(GoxFormatTest, testSaveIdenticalBlocks) {
+	// three 16^3 blocks - the first two are identical
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 47, 15, 15));
+	volume.fill(voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	volume.setVoxel(40, 3, 5, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	palette::Palette pal;
+	pal.nippon();
+
+	scenegraph::SceneGraph sceneGraph;
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(&volume, false);
+	node.setPalette(pal);
+	sceneGraph.emplace(core::move(node));
+
+	GoxFormat f;
+	io::ArchivePtr archive = helper_archive();
+	ASSERT_TRUE(f.save(sceneGraph, "identicalblocks.gox", archive, testSaveCtx));
+
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream("identicalblocks.gox"));
+	ASSERT_TRUE(stream);
+	uint32_t magic;
+	ASSERT_EQ(0, stream->readUInt32(magic));
+	ASSERT_EQ(FourCC('G', 'O', 'X', ' '), magic);
+	uint32_t version;
+	ASSERT_EQ(0, stream->readUInt32(version));
+	int bl16Chunks = 0;
+	uint32_t type;
+	uint32_t length;
+	while (stream->readUInt32(type) == 0 && stream->readUInt32(length) == 0) {
+		if (type == FourCC('B', 'L', '1', '6')) {
+			++bl16Chunks;
+		}
+		ASSERT_NE(-1, stream->skip(length + 4));
+	}
+	EXPECT_EQ(2, bl16Chunks) << "Identical blocks should only be saved once";
+
+	scenegraph::SceneGraph sceneGraphLoad;
+	ASSERT_TRUE(f.load("identicalblocks.gox", archive, sceneGraphLoad, testLoadCtx));
+	const scenegraph::SceneGraphNode *loaded = sceneGraphLoad.firstModelNode();
+	ASSERT_NE(nullptr, loaded);
+	const palette::Palette &loadedPal = loaded->palette();
+	int voxels = 0;
+	int voxelsColor2 = 0;
+	voxelutil::visitVolume(*loaded->volume(), [&](int, int, int, const voxel::Voxel &voxel) {
+		++voxels;
+		if (loadedPal.color(voxel.getColor()) == pal.color(2)) {
+			++voxelsColor2;
+		}
+	});
+	EXPECT_EQ(48 * 16 * 16, voxels);
+	EXPECT_EQ(1, voxelsColor2);
+}
+
 TEST_F(GoxFormatTest, testLoadRGB) {
 	testRGB("rgb.gox");
 }
@@ -2,14 +2,38 @@
  * @file
  */
 
+#include "voxelformat/private/minecraft/MCRFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/ConfigVar.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "util/VarUtil.h"
 #include "voxel/RawVolume.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxelformat {
 
-class MCRFormatTest : public AbstractFormatTest {};
+class MCRFormatTest : public AbstractFormatTest {
+protected:
+	class TestMCRFormat : public MCRFormat {
+	public:
+		using MCRFormat::parseRegion;
+	};
+};
+
+TEST_F(MCRFormatTest, testParseRegion) {
+	EXPECT_EQ(voxel::Region(0, -64, -576, 15, -60, -561), TestMCRFormat::parseRegion("0 -64 -576 15 -60 -561"));
+	const voxel::Region yRange = TestMCRFormat::parseRegion("-50 0");
+	ASSERT_TRUE(yRange.isValid());
+	EXPECT_EQ(-50, yRange.getLowerY());
+	EXPECT_EQ(0, yRange.getUpperY());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("0").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("-50 0 10").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("0 -64 -576 15").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("0 -64 -576 15 -60").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("0 -64 -576 15 -60 -561 1").isValid());
+	EXPECT_FALSE(TestMCRFormat::parseRegion("a b").isValid());
+}
 
 TEST_F(MCRFormatTest, testLoad117) {
 	scenegraph::SceneGraph sceneGraph;
@@ -26,6 +50,33 @@ TEST_F(MCRFormatTest, testLoad117) {
 	EXPECT_EQ(32512, cnt);
 }
 
+TEST_F(MCRFormatTest, testLoad117Region) {
+	util::ScopedVarChange scoped(cfg::VoxformatMCRRegion, "-50 0");
+	scenegraph::SceneGraph sceneGraph;
+	testLoad(sceneGraph, "r.0.-2.mca", 128);
+	const scenegraph::SceneGraphNode &node = *sceneGraph.begin(scenegraph::SceneGraphNodeType::Model);
+	ASSERT_EQ(node.type(), scenegraph::SceneGraphNodeType::Model);
+	const voxel::RawVolume *v = node.volume();
+	EXPECT_GE(v->region().getLowerY(), -50);
+	EXPECT_LE(v->region().getUpperY(), 0);
+	const int cnt = voxelutil::visitVolume(*v, [&](int, int, int, const voxel::Voxel &) {}, voxelutil::VisitAll());
+	EXPECT_EQ(v->voxel(0, -45, -576), voxel::Voxel(voxel::VoxelType::Generic, 8));
+	EXPECT_EQ(v->voxel(0, -45, -566), voxel::Voxel(voxel::VoxelType::Generic, 2));
+	EXPECT_EQ(51 * 16 * 16, cnt);
+}
+
+TEST_F(MCRFormatTest, testLoad117Bounds) {
+	util::ScopedVarChange scoped(cfg::VoxformatMCRRegion, "0 -64 -576 15 -60 -561");
+	scenegraph::SceneGraph sceneGraph;
+	testLoad(sceneGraph, "r.0.-2.mca", 1);
+	const scenegraph::SceneGraphNode &node = *sceneGraph.begin(scenegraph::SceneGraphNodeType::Model);
+	ASSERT_EQ(node.type(), scenegraph::SceneGraphNodeType::Model);
+	const voxel::RawVolume *v = node.volume();
+	EXPECT_EQ(v->voxel(0, -62, -576), voxel::Voxel(voxel::VoxelType::Generic, 118));
+	EXPECT_EQ(v->voxel(0, -64, -576), voxel::Voxel(voxel::VoxelType::Generic, 7));
+	EXPECT_EQ(voxel::Region(0, -64, -576, 15, -60, -561), v->region());
+}
+
 TEST_F(MCRFormatTest, testLoad110) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "minecraft_110.mca", 1024);
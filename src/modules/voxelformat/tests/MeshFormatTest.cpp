@@ -4,20 +4,27 @@
 
 #include "voxelformat/private/mesh/MeshFormat.h"
 #include "core/Color.h"
+#include "core/ConfigVar.h"
+#include "core/ScopedPtr.h"
 #include "core/tests/TestColorHelper.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "util/VarUtil.h"
 #include "video/ShapeBuilder.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
 #include "voxelformat/VolumeFormat.h"
 #include "voxelformat/tests/AbstractFormatTest.h"
 
 namespace voxelformat {
 
-class MeshFormatTest : public AbstractFormatTest {};
+class MeshFormatTest : public AbstractFormatTest {
+protected:
+	void testVoxelizeColor();
+};
 
 TEST_F(MeshFormatTest, testSubdivide) {
 	MeshFormat::TriCollection tinyTris;
@@ -114,7 +121,7 @@ TEST_F(MeshFormatTest, testAreAllTrisAxisAligned) {
 	EXPECT_FALSE(MeshFormat::isVoxelMesh(tris));
 }
 
-TEST_F(MeshFormatTest, testVoxelizeColor) {
+void MeshFormatTest::testVoxelizeColor() {
 	class TestMesh : public MeshFormat {
 	public:
 		bool saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &, const Meshes &,
@@ -164,11 +171,70 @@ TEST_F(MeshFormatTest, testVoxelizeColor) {
 	ASSERT_NE(nullptr, node);
 	voxel::getPalette() = node->palette();
 	const voxel::RawVolume *v = node->volume();
+	// the corners that are close to the differently colored vertices are blended a little bit
+	const float cornerTolerance = 0.06f;
 	EXPECT_COLOR_NEAR(nipponRed, node->palette().color(v->voxel(0, 0, 0).getColor()), 0.01f);
 	EXPECT_COLOR_NEAR(nipponRed, node->palette().color(v->voxel(size * 2 - 1, 0, size * 2 - 1).getColor()), 0.01f);
-	EXPECT_COLOR_NEAR(nipponBlue, node->palette().color(v->voxel(0, 0, size * 2 - 1).getColor()), 0.06f);
-	EXPECT_COLOR_NEAR(nipponRed, node->palette().color(v->voxel(size * 2 - 1, 0, 0).getColor()), 0.06f);
+	EXPECT_COLOR_NEAR(nipponBlue, node->palette().color(v->voxel(0, 0, size * 2 - 1).getColor()), cornerTolerance);
+	EXPECT_COLOR_NEAR(nipponRed, node->palette().color(v->voxel(size * 2 - 1, 0, 0).getColor()), cornerTolerance);
 	EXPECT_COLOR_NEAR(nipponGreen, node->palette().color(v->voxel(size - 1, size - 1, size - 1).getColor()), 0.01f);
 }
 
+TEST_F(MeshFormatTest, testVoxelizeColor) {
+	testVoxelizeColor();
+}
+
+TEST_F(MeshFormatTest, testVoxelizeColorTiled) {
+	util::ScopedVarChange scoped(cfg::VoxformatVoxelizeMode, MeshFormat::VoxelizeMode::Tiled);
+	testVoxelizeColor();
+}
+
+// large volumes are only extracted in chunks if the result is the same as extracting the whole volume at once
+TEST_F(MeshFormatTest, testSaveChunked) {
+	ASSERT_TRUE(core::Var::getSafe(cfg::VoxformatReusevertices)->boolVal());
+	const voxel::SurfaceExtractionType type =
+		(voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
+	const bool ambientOcclusion = core::Var::getSafe(cfg::VoxformatAmbientocclusion)->boolVal();
+
+	// a bar of voxels that is longer than two chunks - with some gaps and colors that prevent the quad merging
+	const int length = MeshFormat::ExtractChunkSize * 2 + 22;
+	const voxel::Region region(0, 0, 0, length - 1, 2, 2);
+	voxel::RawVolume *volume = new voxel::RawVolume(region);
+	volume->fill(voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	for (int x = 5; x < length; x += 7) {
+		volume->setVoxel(x, 1, 2, voxel::Voxel());
+		volume->setVoxel(x + 1, 2, 0, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	}
+	scenegraph::SceneGraph sceneGraph;
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(volume, true);
+	const int nodeId = sceneGraph.emplace(core::move(node));
+	ASSERT_NE(InvalidNodeId, nodeId);
+	const palette::Palette &palette = sceneGraph.node(nodeId).palette();
+
+	for (bool mergeQuads : {false, true}) {
+		SCOPED_TRACE(mergeQuads ? "merged quads" : "unmerged quads");
+		util::ScopedVarChange scoped(cfg::VoxformatMergequads, mergeQuads ? "true" : "false");
+		EXPECT_EQ(!mergeQuads, voxel::isChunkedExtractionExact(type, mergeQuads, true));
+
+		voxel::Region regionExt = region;
+		regionExt.shiftUpperCorner(1, 1, 1);
+		voxel::ChunkMesh serial;
+		voxel::SurfaceExtractionContext ctx = voxel::createContext(type, volume, regionExt, palette, serial,
+																   {0, 0, 0}, mergeQuads, true, ambientOcclusion);
+		voxel::extractSurface(ctx);
+		const size_t serialTriangles = (serial.mesh[0].getNoOfIndices() + serial.mesh[1].getNoOfIndices()) / 3u;
+		ASSERT_GT(serialTriangles, 0u);
+
+		io::ArchivePtr archive = helper_archive();
+		ASSERT_TRUE(voxelformat::saveFormat(sceneGraph, "chunked.stl", nullptr, archive, testSaveCtx));
+		core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream("chunked.stl"));
+		ASSERT_TRUE(stream);
+		ASSERT_NE(-1, stream->seek(80));
+		uint32_t triangles = 0;
+		ASSERT_EQ(0, stream->readUInt32(triangles));
+		EXPECT_EQ(serialTriangles, triangles);
+	}
+}
+
 } // namespace voxelformat
@@ -0,0 +1,36 @@
+/**
+ * @file
+ */
+
+#include "voxelformat/private/mesh/MeshTextureCache.h"
+#include "app/tests/AbstractTest.h"
+#include "io/File.h"
+#include "io/Filesystem.h"
+
+namespace voxelformat {
+
+class MeshTextureCacheTest : public app::AbstractTest {};
+
+TEST_F(MeshTextureCacheTest, testSharedImages) {
+	const io::FilePtr &file = io::filesystem()->open("palette-nippon.png");
+	ASSERT_TRUE(file->validHandle());
+	uint8_t *buffer = nullptr;
+	const int length = file->read((void **)&buffer);
+	ASSERT_GT(length, 0);
+
+	MeshTextureCache cache("");
+	cache.addFile("palette-nippon.png");
+	cache.addFile("palette-nippon.png");
+	cache.addData("embedded", buffer, length);
+	delete[] buffer;
+	cache.load();
+
+	const image::ImagePtr &image = cache.get("palette-nippon.png");
+	ASSERT_TRUE(image);
+	EXPECT_TRUE(image->isLoaded());
+	EXPECT_EQ(image.get(), cache.get("embedded").get()) << "The same image data should only be decoded once";
+	EXPECT_EQ((size_t)image->width() * image->height() * image->depth(), cache.memory());
+	EXPECT_FALSE(cache.get("does-not-exist.png"));
+}
+
+} // namespace voxelformat
@@ -19,4 +19,13 @@ TEST_F(VENGIFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("testSaveLoadVoxel.vengi", &f);
 }
 
+TEST_F(VENGIFormatTest, testSaveLoadVoxelBricks) {
+	VENGIFormat f;
+	testSaveLoadVoxel("testSaveLoadVoxelBricks.vengi", &f, -20, 50);
+}
+
+TEST_F(VENGIFormatTest, testLoadVersion3) {
+	testLoad("bat_anim.vengi", 5);
+}
+
 } // namespace voxelformat
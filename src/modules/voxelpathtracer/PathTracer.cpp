@@ -266,6 +266,7 @@ static void addPaletteTexture(yocto::scene_data &scene, const palette::Palette &
 bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
 	_state.scene = {};
 	_state.lights = {};
+	_state.voxelTracer.clear();
 
 	voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::Var::getSafe(cfg::VoxelMeshMode)->intVal();
 	// TODO: support references
@@ -279,10 +280,19 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 			continue;
 		}
 
+		const palette::Palette &palette = node.palette();
+		if (_state.voxels) {
+			_state.voxelTracer.addNode(sceneGraph, node, (int)_state.scene.materials.size());
+			// the voxel color indices are not limited to the color count of the palette
+			for (int i = 0; i < palette::PaletteMaxColors; ++i) {
+				setupMaterial(_state.scene, palette, i);
+			}
+			continue;
+		}
+
 		voxel::ChunkMesh mesh(65536, 65536, true);
 		voxel::Region region = v->region();
 
-		const palette::Palette &palette = node.palette();
 		voxel::SurfaceExtractionContext ctx =
 			voxel::createContext(type, v, region, palette, mesh, region.getLowerCorner());
 
@@ -315,7 +325,12 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 	}
 
 	if (_state.scene.cameras.size() <= 1) {
-		yocto::add_camera(_state.scene);
+		if (_state.voxels) {
+			// there are no shapes to compute the scene bounds from
+			_state.voxelTracer.addCamera(_state.scene);
+		} else {
+			yocto::add_camera(_state.scene);
+		}
 	}
 	yocto::add_sky(_state.scene);
 
@@ -325,15 +340,27 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
 	Log::debug("Create scene");
 	createScene(sceneGraph, camera);
-	_state.bvh = yocto::make_trace_bvh(_state.scene, _state.params);
-	_state.lights = yocto::make_trace_lights(_state.scene, _state.params);
+	if (_state.voxels) {
+		_state.bvh = {};
+	} else {
+		_state.bvh = yocto::make_trace_bvh(_state.scene, _state.params);
+		_state.lights = yocto::make_trace_lights(_state.scene, _state.params);
+	}
 	_state.state = yocto::make_trace_state(_state.scene, _state.params);
-	yocto::trace_start(_state.context, _state.state, _state.scene, _state.bvh, _state.lights, _state.params);
+	traceStart();
 	_state.started = true;
 	Log::debug("Started pathtracer");
 	return true;
 }
 
+void PathTracer::traceStart() {
+	if (_state.voxels) {
+		_state.voxelTracer.start(_state.context, _state.state, _state.scene, _state.params);
+	} else {
+		yocto::trace_start(_state.context, _state.state, _state.scene, _state.bvh, _state.lights, _state.params);
+	}
+}
+
 bool PathTracer::restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
 	if (!started()) {
 		return false;
@@ -369,7 +396,7 @@ bool PathTracer::update(int *currentSample) {
 			*currentSample = _state.state.samples;
 		}
 		Log::debug("PathTracer sample: %i", _state.state.samples);
-		yocto::trace_start(_state.context, _state.state, _state.scene, _state.bvh, _state.lights, _state.params);
+		traceStart();
 	}
 	return false;
 }
@@ -6,6 +6,7 @@
 
 #include "core/SharedPtr.h"
 #include "core/GLM.h"
+#include "voxelpathtracer/VoxelTracer.h"
 #include <yocto_scene.h>
 #include <yocto_trace.h>
 
@@ -41,6 +42,12 @@ struct PathTracerState {
 	yocto::trace_params params;
 	yocto::trace_lights lights;
 	yocto::trace_state state;
+	VoxelTracer voxelTracer;
+	/**
+	 * @brief Intersect the voxels directly instead of extracting meshes and building a triangle bvh
+	 * @sa VoxelTracer
+	 */
+	bool voxels = false;
 	bool started = false;
 
 	PathTracerState() : context(yocto::make_trace_context({})) {
@@ -57,6 +64,7 @@ private:
 	bool createScene(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 					 const voxel::Mesh &mesh, bool opaque);
 	bool createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera);
+	void traceStart();
 
 public:
 	~PathTracer();
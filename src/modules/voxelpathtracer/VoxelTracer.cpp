@@ -0,0 +1,534 @@
+/**
+ * @file
+ */
+
+#include "VoxelTracer.h"
+#include "app/Async.h"
+#include "core/Log.h"
+#include "core/Trace.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
+#include <future>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <yocto_sampling.h>
+#include <yocto_shading.h>
+
+namespace voxelpathtracer {
+
+namespace priv {
+
+// world space offset to move the origin of the next ray away from the hit face
+static constexpr float RayOffset = 1e-3f;
+
+static inline yocto::vec3f toVec3f(const glm::vec3 &in) {
+	return yocto::vec3f{in.x, in.y, in.z};
+}
+
+static inline glm::vec3 toVec3(const yocto::vec3f &in) {
+	return glm::vec3(in.x, in.y, in.z);
+}
+
+// the following functions mirror the (static) bsdf dispatch functions of yocto_trace.cpp
+
+static yocto::vec3f evalEmission(const yocto::material_point &material, const yocto::vec3f &normal,
+								 const yocto::vec3f &outgoing) {
+	return yocto::dot(normal, outgoing) >= 0 ? material.emission : yocto::vec3f{0, 0, 0};
+}
+
+static yocto::vec3f evalBsdfcos(const yocto::material_point &material, const yocto::vec3f &normal,
+								const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	using yocto::material_type;
+	if (material.roughness == 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case material_type::matte:
+		return yocto::eval_matte(material.color, normal, outgoing, incoming);
+	case material_type::glossy:
+		return yocto::eval_glossy(material.color, material.ior, material.roughness, normal, outgoing, incoming);
+	case material_type::reflective:
+		return yocto::eval_reflective(material.color, material.roughness, normal, outgoing, incoming);
+	case material_type::transparent:
+		return yocto::eval_transparent(material.color, material.ior, material.roughness, normal, outgoing,
+									   incoming);
+	case material_type::refractive:
+	case material_type::subsurface:
+		return yocto::eval_refractive(material.color, material.ior, material.roughness, normal, outgoing, incoming);
+	case material_type::gltfpbr:
+		return yocto::eval_gltfpbr(material.color, material.ior, material.roughness, material.metallic, normal,
+								   outgoing, incoming);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+static yocto::vec3f evalDelta(const yocto::material_point &material, const yocto::vec3f &normal,
+							  const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	using yocto::material_type;
+	if (material.roughness != 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case material_type::reflective:
+		return yocto::eval_reflective(material.color, normal, outgoing, incoming);
+	case material_type::transparent:
+		return yocto::eval_transparent(material.color, material.ior, normal, outgoing, incoming);
+	case material_type::refractive:
+		return yocto::eval_refractive(material.color, material.ior, normal, outgoing, incoming);
+	case material_type::volumetric:
+		return yocto::eval_passthrough(material.color, normal, outgoing, incoming);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+static yocto::vec3f sampleBsdfcos(const yocto::material_point &material, const yocto::vec3f &normal,
+								  const yocto::vec3f &outgoing, float rnl, const yocto::vec2f &rn) {
+	using yocto::material_type;
+	if (material.roughness == 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case material_type::matte:
+		return yocto::sample_matte(material.color, normal, outgoing, rn);
+	case material_type::glossy:
+		return yocto::sample_glossy(material.color, material.ior, material.roughness, normal, outgoing, rnl, rn);
+	case material_type::reflective:
+		return yocto::sample_reflective(material.color, material.roughness, normal, outgoing, rn);
+	case material_type::transparent:
+		return yocto::sample_transparent(material.color, material.ior, material.roughness, normal, outgoing, rnl,
+										 rn);
+	case material_type::refractive:
+	case material_type::subsurface:
+		return yocto::sample_refractive(material.color, material.ior, material.roughness, normal, outgoing, rnl,
+										rn);
+	case material_type::gltfpbr:
+		return yocto::sample_gltfpbr(material.color, material.ior, material.roughness, material.metallic, normal,
+									 outgoing, rnl, rn);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+static yocto::vec3f sampleDelta(const yocto::material_point &material, const yocto::vec3f &normal,
+								const yocto::vec3f &outgoing, float rnl) {
+	using yocto::material_type;
+	if (material.roughness != 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case material_type::reflective:
+		return yocto::sample_reflective(material.color, normal, outgoing);
+	case material_type::transparent:
+		return yocto::sample_transparent(material.color, material.ior, normal, outgoing, rnl);
+	case material_type::refractive:
+		return yocto::sample_refractive(material.color, material.ior, normal, outgoing, rnl);
+	case material_type::volumetric:
+		return yocto::sample_passthrough(material.color, normal, outgoing);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+static float sampleBsdfcosPdf(const yocto::material_point &material, const yocto::vec3f &normal,
+							  const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	using yocto::material_type;
+	if (material.roughness == 0) {
+		return 0;
+	}
+	switch (material.type) {
+	case material_type::matte:
+		return yocto::sample_matte_pdf(material.color, normal, outgoing, incoming);
+	case material_type::glossy:
+		return yocto::sample_glossy_pdf(material.color, material.ior, material.roughness, normal, outgoing,
+										incoming);
+	case material_type::reflective:
+		return yocto::sample_reflective_pdf(material.color, material.roughness, normal, outgoing, incoming);
+	case material_type::transparent:
+		return yocto::sample_tranparent_pdf(material.color, material.ior, material.roughness, normal, outgoing,
+											incoming);
+	case material_type::refractive:
+	case material_type::subsurface:
+		return yocto::sample_refractive_pdf(material.color, material.ior, material.roughness, normal, outgoing,
+											incoming);
+	case material_type::gltfpbr:
+		return yocto::sample_gltfpbr_pdf(material.color, material.ior, material.roughness, material.metallic,
+										 normal, outgoing, incoming);
+	default:
+		return 0;
+	}
+}
+
+static float sampleDeltaPdf(const yocto::material_point &material, const yocto::vec3f &normal,
+							const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	using yocto::material_type;
+	if (material.roughness != 0) {
+		return 0;
+	}
+	switch (material.type) {
+	case material_type::reflective:
+		return yocto::sample_reflective_pdf(material.color, normal, outgoing, incoming);
+	case material_type::transparent:
+		return yocto::sample_tranparent_pdf(material.color, material.ior, normal, outgoing, incoming);
+	case material_type::refractive:
+		return yocto::sample_refractive_pdf(material.color, material.ior, normal, outgoing, incoming);
+	case material_type::volumetric:
+		return yocto::sample_passthrough_pdf(material.color, normal, outgoing, incoming);
+	default:
+		return 0;
+	}
+}
+
+// see sample_camera() in yocto_trace.cpp
+static yocto::ray3f sampleCamera(const yocto::camera_data &camera, const yocto::vec2i &ij,
+								 const yocto::vec2i &imageSize, const yocto::vec2f &puv, const yocto::vec2f &luv,
+								 bool tent) {
+	yocto::vec2f fuv = puv;
+	if (tent) {
+		const float width = 2.0f;
+		const float offset = 0.5f;
+		fuv.x = width * (puv.x < 0.5f ? yocto::sqrt(2 * puv.x) - 1 : 1 - yocto::sqrt(2 - 2 * puv.x)) + offset;
+		fuv.y = width * (puv.y < 0.5f ? yocto::sqrt(2 * puv.y) - 1 : 1 - yocto::sqrt(2 - 2 * puv.y)) + offset;
+	}
+	const yocto::vec2f uv{(ij.x + fuv.x) / imageSize.x, (ij.y + fuv.y) / imageSize.y};
+	return yocto::eval_camera(camera, uv, yocto::sample_disk(luv));
+}
+
+} // namespace priv
+
+VoxelTracer::~VoxelTracer() {
+	clear();
+}
+
+void VoxelTracer::clear() {
+	for (Node &node : _nodes) {
+		delete node.pyramid;
+		delete node.volume;
+	}
+	_nodes.clear();
+	_bounds = yocto::invalidb3f;
+}
+
+bool VoxelTracer::addNode(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+						  int materialOffset) {
+	core_trace_scoped(VoxelTracerAddNode);
+	const voxel::RawVolume *v = node.volume();
+	if (v == nullptr) {
+		return false;
+	}
+	Node tracerNode;
+	tracerNode.region = v->region();
+	tracerNode.materialOffset = materialOffset;
+
+	// same transform as the mesh vertices of the triangle backend get
+	const scenegraph::KeyFrameIndex keyFrameIdx = 0;
+	const scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
+	const glm::vec3 size(sceneGraph.resolveRegion(node).getDimensionsInVoxels());
+	const glm::vec3 pivot = node.pivot() * size;
+	tracerNode.worldMatrix = glm::translate(transform.worldMatrix(), -pivot);
+	tracerNode.invWorldMatrix = glm::inverse(tracerNode.worldMatrix);
+	tracerNode.normalMatrix = glm::transpose(glm::inverse(glm::mat3(tracerNode.worldMatrix)));
+
+	const glm::vec3 mins(tracerNode.region.getLowerCorner());
+	const glm::vec3 maxs(tracerNode.region.getUpperCorner() + 1);
+	for (int i = 0; i < 8; ++i) {
+		const glm::vec3 corner((i & 1) ? maxs.x : mins.x, (i & 2) ? maxs.y : mins.y, (i & 4) ? maxs.z : mins.z);
+		yocto::expand(_bounds, priv::toVec3f(glm::vec3(tracerNode.worldMatrix * glm::vec4(corner, 1.0f))));
+	}
+
+	tracerNode.volume = new voxel::RawVolume(*v);
+	tracerNode.pyramid = new voxelutil::OccupancyPyramid(tracerNode.volume);
+	_nodes.push_back(tracerNode);
+	return true;
+}
+
+void VoxelTracer::addCamera(yocto::scene_data &scene) const {
+	scene.camera_names.emplace_back("camera");
+	yocto::camera_data &camera = scene.cameras.emplace_back();
+	camera.orthographic = false;
+	camera.film = 0.036f;
+	camera.aspect = 16.0f / 9.0f;
+	camera.aperture = 0.0f;
+	camera.lens = 0.050f;
+	yocto::bbox3f bbox = _bounds;
+	if (_nodes.empty()) {
+		bbox = yocto::bbox3f{{-1, -1, -1}, {1, 1, 1}};
+	}
+	const yocto::vec3f center = (bbox.max + bbox.min) / 2;
+	const float bboxRadius = yocto::length(bbox.max - bbox.min) / 2;
+	const yocto::vec3f cameraDir{0, 0, 1};
+	// the factor 2 is the correction for the tracer camera implementation - see yocto::add_camera()
+	const float cameraDist = 2.0f * bboxRadius * camera.lens / (camera.film / camera.aspect);
+	const yocto::vec3f from = cameraDir * cameraDist + center;
+	camera.frame = yocto::lookat_frame(from, center, yocto::vec3f{0, 1, 0});
+	camera.focus = yocto::length(from - center);
+}
+
+void VoxelTracer::setHit(const Node &node, const glm::vec3 &origin, const glm::vec3 &dir, float distance,
+						 const glm::ivec3 &normal, uint8_t color, Intersection &intersection) const {
+	intersection.hit = true;
+	intersection.distance = distance;
+	intersection.position =
+		priv::toVec3f(glm::vec3(node.worldMatrix * glm::vec4(origin + dir * distance, 1.0f)));
+	intersection.normal = priv::toVec3f(glm::normalize(node.normalMatrix * glm::vec3(normal)));
+	intersection.material = node.materialOffset + color;
+}
+
+bool VoxelTracer::intersectInside(const Node &node, const glm::ivec3 &startVoxel, const glm::vec3 &origin,
+								  const glm::vec3 &dir, float maxDistance, Intersection &intersection) const {
+	// walk the voxels with the same color until the ray leaves them - the exit face is the hit
+	const uint8_t color = node.volume->voxel(startVoxel).getColor();
+	constexpr float inf = (std::numeric_limits<float>::max)();
+	glm::ivec3 pos = startVoxel;
+	glm::ivec3 step;
+	glm::vec3 tNext;
+	glm::vec3 tDelta;
+	for (int a = 0; a < 3; ++a) {
+		step[a] = dir[a] > 0.0f ? 1 : -1;
+		if (dir[a] == 0.0f) {
+			tNext[a] = tDelta[a] = inf;
+		} else {
+			const float boundary = (float)(step[a] > 0 ? pos[a] + 1 : pos[a]);
+			tNext[a] = (boundary - origin[a]) / dir[a];
+			tDelta[a] = glm::abs(1.0f / dir[a]);
+		}
+	}
+	for (;;) {
+		const int axis = tNext.x <= tNext.y ? (tNext.x <= tNext.z ? 0 : 2) : (tNext.y <= tNext.z ? 1 : 2);
+		const float t = tNext[axis];
+		if (t == inf || t > maxDistance) {
+			return false;
+		}
+		pos[axis] += step[axis];
+		tNext[axis] += tDelta[axis];
+		bool leave = !node.region.containsPoint(pos);
+		if (!leave) {
+			const voxel::Voxel &next = node.volume->voxel(pos);
+			leave = voxel::isAir(next.getMaterial()) || next.getColor() != color;
+		}
+		if (leave) {
+			glm::ivec3 normal(0);
+			normal[axis] = step[axis];
+			setHit(node, origin, dir, t, normal, color, intersection);
+			return true;
+		}
+	}
+}
+
+bool VoxelTracer::intersect(const Node &node, const glm::vec3 &origin, const glm::vec3 &dir, float maxDistance,
+							Intersection &intersection) const {
+	const glm::ivec3 startVoxel(glm::floor(origin));
+	if (node.region.containsPoint(startVoxel) && !voxel::isAir(node.volume->voxel(startVoxel).getMaterial())) {
+		return intersectInside(node, startVoxel, origin, dir, maxDistance, intersection);
+	}
+
+	// clip the ray against the node bounds to limit the length of the traversal
+	const glm::vec3 mins(node.region.getLowerCorner());
+	const glm::vec3 maxs(node.region.getUpperCorner() + 1);
+	float tEnter = 0.0f;
+	float tExit = maxDistance;
+	for (int a = 0; a < 3; ++a) {
+		if (dir[a] == 0.0f) {
+			if (origin[a] < mins[a] || origin[a] >= maxs[a]) {
+				return false;
+			}
+			continue;
+		}
+		float t1 = (mins[a] - origin[a]) / dir[a];
+		float t2 = (maxs[a] - origin[a]) / dir[a];
+		if (t1 > t2) {
+			core::exchange(t1, t2);
+		}
+		tEnter = glm::max(tEnter, t1);
+		tExit = glm::min(tExit, t2);
+	}
+	if (tEnter > tExit) {
+		return false;
+	}
+
+	const voxelutil::PickResult result = node.pyramid->pick(origin, dir * tExit);
+	if (!result.didHit || result.hitFace == voxel::FaceNames::Max) {
+		return false;
+	}
+	const int face = (int)result.hitFace;
+	const int axis = face % 3;
+	const bool positive = face < 3;
+	const float plane = (float)(positive ? result.hitVoxel[axis] + 1 : result.hitVoxel[axis]);
+	const float t = (plane - origin[axis]) / dir[axis];
+	if (t > maxDistance) {
+		return false;
+	}
+	glm::ivec3 normal(0);
+	normal[axis] = positive ? 1 : -1;
+	setHit(node, origin, dir, t, normal, node.volume->voxel(result.hitVoxel).getColor(), intersection);
+	return true;
+}
+
+VoxelTracer::Intersection VoxelTracer::intersect(const yocto::ray3f &ray) const {
+	Intersection intersection;
+	float maxDistance = ray.tmax;
+	for (const Node &node : _nodes) {
+		const glm::vec3 origin(node.invWorldMatrix * glm::vec4(priv::toVec3(ray.o), 1.0f));
+		// not normalized - the distances along the ray stay in world space
+		const glm::vec3 dir(glm::mat3(node.invWorldMatrix) * priv::toVec3(ray.d));
+		Intersection nodeIntersection;
+		if (intersect(node, origin, dir, maxDistance, nodeIntersection)) {
+			maxDistance = nodeIntersection.distance;
+			intersection = nodeIntersection;
+		}
+	}
+	return intersection;
+}
+
+void VoxelTracer::traceSample(yocto::trace_state &state, const yocto::scene_data &scene, int i, int j, int sample,
+							  const yocto::trace_params &params) const {
+	const yocto::camera_data &camera = scene.cameras[params.camera];
+	const int idx = state.width * j + i;
+	yocto::rng_state &rng = state.rngs[idx];
+	const yocto::ray3f cameraRay =
+		priv::sampleCamera(camera, {i, j}, {state.width, state.height}, yocto::rand2f(rng), yocto::rand2f(rng),
+						   params.tentfilter);
+
+	// the naive path sampler of yocto_trace.cpp
+	yocto::vec3f radiance{0, 0, 0};
+	yocto::vec3f weight{1, 1, 1};
+	yocto::ray3f ray = cameraRay;
+	bool hit = false;
+	yocto::vec3f hitAlbedo{0, 0, 0};
+	yocto::vec3f hitNormal{0, 0, 0};
+	int opbounce = 0;
+	for (int bounce = 0; bounce < params.bounces; ++bounce) {
+		const Intersection intersection = intersect(ray);
+		if (!intersection.hit) {
+			if (bounce > 0 || !params.envhidden) {
+				radiance += weight * yocto::eval_environment(scene, ray.d);
+			}
+			break;
+		}
+
+		const yocto::vec3f outgoing = -ray.d;
+		const yocto::material_point material =
+			yocto::eval_material(scene, scene.materials[intersection.material], {0, 0});
+		yocto::vec3f normal = intersection.normal;
+		if (material.type != yocto::material_type::refractive && yocto::dot(normal, outgoing) < 0) {
+			normal = -normal;
+		}
+
+		// handle opacity
+		if (material.opacity < 1 && yocto::rand1f(rng) >= material.opacity) {
+			if (opbounce++ > 128) {
+				break;
+			}
+			ray = {intersection.position + ray.d * 1e-2f, ray.d};
+			bounce -= 1;
+			continue;
+		}
+
+		if (bounce == 0) {
+			hit = true;
+			hitAlbedo = material.color;
+			hitNormal = normal;
+		}
+
+		radiance += weight * priv::evalEmission(material, normal, outgoing);
+
+		yocto::vec3f incoming{0, 0, 0};
+		if (material.roughness != 0) {
+			incoming = priv::sampleBsdfcos(material, normal, outgoing, yocto::rand1f(rng), yocto::rand2f(rng));
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= priv::evalBsdfcos(material, normal, outgoing, incoming) /
+					  priv::sampleBsdfcosPdf(material, normal, outgoing, incoming);
+		} else {
+			incoming = priv::sampleDelta(material, normal, outgoing, yocto::rand1f(rng));
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= priv::evalDelta(material, normal, outgoing, incoming) /
+					  priv::sampleDeltaPdf(material, normal, outgoing, incoming);
+		}
+
+		if (weight == yocto::vec3f{0, 0, 0} || !yocto::isfinite(weight)) {
+			break;
+		}
+
+		// russian roulette
+		if (bounce > 3) {
+			const float rrProb = yocto::min(0.99f, yocto::max(weight));
+			if (yocto::rand1f(rng) >= rrProb) {
+				break;
+			}
+			weight *= 1 / rrProb;
+		}
+
+		// there is no ray epsilon for the voxel traversal - move the origin to the side of the face the ray
+		// continues on
+		const float side = yocto::dot(incoming, intersection.normal) >= 0 ? priv::RayOffset : -priv::RayOffset;
+		ray = {intersection.position + intersection.normal * side, incoming};
+	}
+
+	if (!yocto::isfinite(radiance)) {
+		radiance = {0, 0, 0};
+	}
+	if (yocto::max(radiance) > params.clamp) {
+		radiance = radiance * (params.clamp / yocto::max(radiance));
+	}
+	const float w = 1.0f / (float)(sample + 1);
+	if (hit) {
+		state.image[idx] = yocto::lerp(state.image[idx], {radiance.x, radiance.y, radiance.z, 1}, w);
+		state.albedo[idx] = yocto::lerp(state.albedo[idx], hitAlbedo, w);
+		state.normal[idx] = yocto::lerp(state.normal[idx], hitNormal, w);
+		state.hits[idx] += 1;
+	} else if (!params.envhidden && !scene.environments.empty()) {
+		state.image[idx] = yocto::lerp(state.image[idx], {radiance.x, radiance.y, radiance.z, 1}, w);
+		state.albedo[idx] = yocto::lerp(state.albedo[idx], {1, 1, 1}, w);
+		state.normal[idx] = yocto::lerp(state.normal[idx], -cameraRay.d, w);
+		state.hits[idx] += 1;
+	} else {
+		state.image[idx] = yocto::lerp(state.image[idx], {0, 0, 0, 0}, w);
+		state.albedo[idx] = yocto::lerp(state.albedo[idx], {0, 0, 0}, w);
+		state.normal[idx] = yocto::lerp(state.normal[idx], -cameraRay.d, w);
+	}
+}
+
+void VoxelTracer::start(yocto::trace_context &context, yocto::trace_state &state, const yocto::scene_data &scene,
+						const yocto::trace_params &params) const {
+	if (state.samples >= params.samples) {
+		return;
+	}
+	context.stop = false;
+	context.done = false;
+	context.worker = std::async(std::launch::async, [&]() {
+		if (context.stop) {
+			return;
+		}
+		app::for_parallel(0, state.height, 1, [&](int start, int end) {
+			for (int j = start; j < end; ++j) {
+				for (int i = 0; i < state.width; ++i) {
+					for (int sample = state.samples; sample < state.samples + params.batch; ++sample) {
+						if (context.stop) {
+							return;
+						}
+						traceSample(state, scene, i, j, sample, params);
+					}
+				}
+			}
+		});
+		state.samples += params.batch;
+		if (context.stop) {
+			return;
+		}
+		if (params.denoise && !state.denoised.empty()) {
+			yocto::denoise_image(state.denoised, state.width, state.height, state.image, state.albedo,
+								 state.normal);
+		}
+		context.done = true;
+	});
+}
+
+} // namespace voxelpathtracer
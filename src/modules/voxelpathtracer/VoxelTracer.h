@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include "voxelutil/OccupancyPyramid.h"
+#include <glm/mat4x4.hpp>
+#include <yocto_scene.h>
+#include <yocto_trace.h>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace scenegraph {
+class SceneGraph;
+class SceneGraphNode;
+} // namespace scenegraph
+
+namespace voxelpathtracer {
+
+/**
+ * @brief Path tracer backend that intersects the voxels of the model nodes directly
+ *
+ * Other than the triangle backend of the @c PathTracer no surface is extracted. Each node volume is copied when it's
+ * added and gets a @c voxelutil::OccupancyPyramid - modifications of the scene graph need a new scene. The rays are
+ * transformed into the local space of the nodes and traversed with the hierarchical DDA of the pyramid. The
+ * materials are the yocto @c material_data entries of the scene - the palette color index of the hit voxel selects
+ * the material.
+ *
+ * Rays that start inside of a solid voxel (refraction, transparency) walk the voxels until the material changes and
+ * hit the exit face of the last voxel.
+ *
+ * @note Only the path sampler without light sampling is implemented - the scene is lit by the environment.
+ */
+class VoxelTracer {
+public:
+	struct Intersection {
+		bool hit = false;
+		float distance = 0.0f;
+		/** world space position on the voxel face */
+		yocto::vec3f position{0, 0, 0};
+		/** world space normal of the hit face - pointing away from the hit voxel */
+		yocto::vec3f normal{0, 0, 0};
+		/** index into the scene materials */
+		int material = -1;
+	};
+
+private:
+	struct Node {
+		/**
+		 * @brief Copy of the node volume - the render threads must not read the scene graph volume while it's
+		 * modified
+		 */
+		voxel::RawVolume *volume = nullptr;
+		voxelutil::OccupancyPyramid *pyramid = nullptr;
+		voxel::Region region;
+		/** local voxel space to world space */
+		glm::mat4 worldMatrix{1.0f};
+		glm::mat4 invWorldMatrix{1.0f};
+		glm::mat3 normalMatrix{1.0f};
+		/** offset of the node palette in the scene materials */
+		int materialOffset = 0;
+	};
+	core::DynamicArray<Node> _nodes;
+	yocto::bbox3f _bounds = yocto::invalidb3f;
+
+	bool intersect(const Node &node, const glm::vec3 &origin, const glm::vec3 &dir, float maxDistance,
+				   Intersection &intersection) const;
+	bool intersectInside(const Node &node, const glm::ivec3 &startVoxel, const glm::vec3 &origin,
+						 const glm::vec3 &dir, float maxDistance, Intersection &intersection) const;
+	void setHit(const Node &node, const glm::vec3 &origin, const glm::vec3 &dir, float distance,
+				const glm::ivec3 &normal, uint8_t color, Intersection &intersection) const;
+
+public:
+	~VoxelTracer();
+
+	void clear();
+	/**
+	 * @param materialOffset The index of the first palette material of the node in the scene materials. There must be
+	 * @c palette::PaletteMaxColors materials for the node - the color index of a voxel isn't limited by the color count
+	 * of the palette.
+	 */
+	bool addNode(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+				 int materialOffset);
+
+	/**
+	 * @brief Add a camera that looks at all added nodes - like @c yocto::add_camera() does for the shapes
+	 */
+	void addCamera(yocto::scene_data &scene) const;
+
+	Intersection intersect(const yocto::ray3f &ray) const;
+
+	/**
+	 * @brief Render one sample for one pixel and accumulate it into the state
+	 * @note This mirrors @c yocto::trace_sample() and can get called for different pixels from different threads
+	 */
+	void traceSample(yocto::trace_state &state, const yocto::scene_data &scene, int i, int j, int sample,
+					 const yocto::trace_params &params) const;
+
+	/**
+	 * @brief Start rendering the next batch of samples asynchronously - the rows of the image are distributed over
+	 * the app thread pool
+	 * @sa yocto::trace_start()
+	 */
+	void start(yocto::trace_context &context, yocto::trace_state &state, const yocto::scene_data &scene,
+			   const yocto::trace_params &params) const;
+
+	inline const yocto::bbox3f &bounds() const {
+		return _bounds;
+	}
+
+	inline bool empty() const {
+		return _nodes.empty();
+	}
+};
+
+} // namespace voxelpathtracer
@@ -0,0 +1,176 @@
+/**
+ * @file
+ */
+
+#include "voxelpathtracer/VoxelTracer.h"
+#include "app/tests/AbstractTest.h"
+#include "image/Image.h"
+#include "io/FilesystemArchive.h"
+#include "io/FormatDescription.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/FormatConfig.h"
+#include "voxelformat/VolumeFormat.h"
+#include "voxelpathtracer/PathTracer.h"
+
+namespace voxelpathtracer {
+
+class VoxelTracerTest : public app::AbstractTest {
+private:
+	using Super = app::AbstractTest;
+
+protected:
+	/**
+	 * @brief Adds a model node with a solid cube of 4x4x4 voxels of the given color
+	 */
+	void addCube(scenegraph::SceneGraph &sceneGraph, const glm::vec3 &translation, uint8_t color = 1) {
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 3));
+		for (int z = 0; z < 4; ++z) {
+			for (int y = 0; y < 4; ++y) {
+				for (int x = 0; x < 4; ++x) {
+					volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+				}
+			}
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		scenegraph::KeyFrameIndex keyFrameIdx = 0;
+		scenegraph::SceneGraphTransform transform;
+		transform.setWorldTranslation(translation);
+		node.setTransform(keyFrameIdx, transform);
+		sceneGraph.emplace(core::move(node));
+		sceneGraph.updateTransforms();
+	}
+
+public:
+	bool onInitApp() override {
+		if (!Super::onInitApp()) {
+			return false;
+		}
+		voxelformat::FormatConfig::init();
+		voxel::getPalette().nippon();
+		return true;
+	}
+};
+
+TEST_F(VoxelTracerTest, testIntersect) {
+	scenegraph::SceneGraph sceneGraph;
+	addCube(sceneGraph, glm::vec3(0.0f), 3);
+	VoxelTracer tracer;
+	ASSERT_TRUE(tracer.addNode(sceneGraph, *sceneGraph.beginModel(), 10));
+
+	const VoxelTracer::Intersection hit = tracer.intersect(yocto::ray3f{{2.5f, 2.5f, 10.0f}, {0, 0, -1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_FLOAT_EQ(6.0f, hit.distance);
+	EXPECT_FLOAT_EQ(4.0f, hit.position.z);
+	EXPECT_FLOAT_EQ(1.0f, hit.normal.z);
+	EXPECT_EQ(13, hit.material);
+
+	EXPECT_FALSE(tracer.intersect(yocto::ray3f{{2.5f, 2.5f, 10.0f}, {0, 0, 1}}).hit);
+	EXPECT_FALSE(tracer.intersect(yocto::ray3f{{5.5f, 2.5f, 10.0f}, {0, 0, -1}}).hit);
+}
+
+TEST_F(VoxelTracerTest, testIntersectInside) {
+	scenegraph::SceneGraph sceneGraph;
+	addCube(sceneGraph, glm::vec3(0.0f));
+	VoxelTracer tracer;
+	ASSERT_TRUE(tracer.addNode(sceneGraph, *sceneGraph.beginModel(), 0));
+
+	// a refracted ray leaves the solid voxels through the exit face
+	const VoxelTracer::Intersection hit = tracer.intersect(yocto::ray3f{{2.5f, 2.5f, 3.9f}, {0, 0, -1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_NEAR(3.9f, hit.distance, 0.0001f);
+	EXPECT_FLOAT_EQ(0.0f, hit.position.z);
+	EXPECT_FLOAT_EQ(-1.0f, hit.normal.z);
+}
+
+TEST_F(VoxelTracerTest, testIntersectTranslatedNodes) {
+	scenegraph::SceneGraph sceneGraph;
+	addCube(sceneGraph, glm::vec3(0.0f, 0.0f, -20.0f), 1);
+	addCube(sceneGraph, glm::vec3(0.0f, 0.0f, 0.0f), 2);
+	VoxelTracer tracer;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		ASSERT_TRUE(tracer.addNode(sceneGraph, *iter, 0));
+	}
+	EXPECT_FLOAT_EQ(-20.0f, tracer.bounds().min.z);
+	EXPECT_FLOAT_EQ(4.0f, tracer.bounds().max.z);
+
+	// the nearest node is hit
+	VoxelTracer::Intersection hit = tracer.intersect(yocto::ray3f{{2.5f, 2.5f, 10.0f}, {0, 0, -1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_EQ(2, hit.material);
+	EXPECT_FLOAT_EQ(6.0f, hit.distance);
+
+	hit = tracer.intersect(yocto::ray3f{{2.5f, 2.5f, -30.0f}, {0, 0, 1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_EQ(1, hit.material);
+	EXPECT_FLOAT_EQ(-20.0f, hit.position.z);
+	EXPECT_FLOAT_EQ(-1.0f, hit.normal.z);
+}
+
+TEST_F(VoxelTracerTest, testColorOutsideOfPalette) {
+	scenegraph::SceneGraph sceneGraph;
+	addCube(sceneGraph, glm::vec3(0.0f, 0.0f, -20.0f), 200);
+	addCube(sceneGraph, glm::vec3(0.0f, 0.0f, 0.0f), 255);
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		palette::Palette palette;
+		palette.setSize(3);
+		(*iter).setPalette(palette);
+	}
+
+	PathTracer pathTracer;
+	pathTracer.state().voxels = true;
+	pathTracer.state().params.resolution = 16;
+	pathTracer.state().params.samples = 1;
+	ASSERT_TRUE(pathTracer.start(sceneGraph));
+	const int materials = (int)pathTracer.state().scene.materials.size();
+	EXPECT_EQ(2 * palette::PaletteMaxColors, materials);
+	VoxelTracer::Intersection hit =
+		pathTracer.state().voxelTracer.intersect(yocto::ray3f{{2.5f, 2.5f, 10.0f}, {0, 0, -1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_EQ(palette::PaletteMaxColors + 255, hit.material);
+	hit = pathTracer.state().voxelTracer.intersect(yocto::ray3f{{2.5f, 2.5f, -30.0f}, {0, 0, 1}});
+	ASSERT_TRUE(hit.hit);
+	EXPECT_EQ(200, hit.material);
+	while (!pathTracer.update()) {
+		_testApp->wait(10);
+	}
+}
+
+TEST_F(VoxelTracerTest, testHMec) {
+	const io::ArchivePtr &archive = io::openFilesystemArchive(_testApp->filesystem());
+	io::FileDescription fileDesc;
+	fileDesc.set("hmec.vxl");
+	scenegraph::SceneGraph sceneGraph;
+	voxelformat::LoadContext testLoadCtx;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, testLoadCtx))
+		<< "Could not load " << fileDesc.name.c_str();
+
+	PathTracer pathTracer;
+	pathTracer.state().voxels = true;
+	pathTracer.state().params.resolution = 128;
+	pathTracer.state().params.samples = 4;
+	ASSERT_TRUE(pathTracer.start(sceneGraph));
+	EXPECT_TRUE(pathTracer.state().scene.shapes.empty());
+	while (!pathTracer.update()) {
+		_testApp->wait(10);
+	}
+	EXPECT_EQ(4, pathTracer.state().state.samples);
+	int hits = 0;
+	for (int h : pathTracer.state().state.hits) {
+		if (h > 0) {
+			++hits;
+		}
+	}
+	EXPECT_GT(hits, 0);
+	const image::ImagePtr &img = pathTracer.image();
+	ASSERT_TRUE(img);
+	ASSERT_TRUE(img->isLoaded());
+	ASSERT_EQ(128, img->width());
+	ASSERT_TRUE(pathTracer.stop());
+}
+
+} // namespace voxelpathtracer
@@ -0,0 +1,123 @@
+/**
+ * @file
+ */
+
+#include "ChunkBufferLayout.h"
+#include "core/Assert.h"
+
+namespace voxelrender {
+
+void RangeAllocator::reset(uint32_t capacity) {
+	_free.clear();
+	_end = 0u;
+	_capacity = capacity;
+}
+
+bool RangeAllocator::allocate(uint32_t count, uint32_t &offset) {
+	if (count == 0u) {
+		offset = 0u;
+		return true;
+	}
+	for (size_t i = 0; i < _free.size(); ++i) {
+		Range &range = _free[i];
+		if (range.count < count) {
+			continue;
+		}
+		offset = range.offset;
+		range.offset += count;
+		range.count -= count;
+		if (range.count == 0u) {
+			_free.erase(i);
+		}
+		return true;
+	}
+	if (_capacity - _end < count) {
+		return false;
+	}
+	offset = _end;
+	_end += count;
+	return true;
+}
+
+void RangeAllocator::release(uint32_t offset, uint32_t count) {
+	if (count == 0u) {
+		return;
+	}
+	core_assert(offset + count <= _end);
+	size_t pos = 0;
+	while (pos < _free.size() && _free[pos].offset < offset) {
+		++pos;
+	}
+	Range range{offset, count};
+	// merge with the following range
+	if (pos < _free.size() && range.offset + range.count == _free[pos].offset) {
+		range.count += _free[pos].count;
+		_free.erase(pos);
+	}
+	// merge with the previous range
+	if (pos > 0 && _free[pos - 1].offset + _free[pos - 1].count == range.offset) {
+		--pos;
+		range.offset = _free[pos].offset;
+		range.count += _free[pos].count;
+		_free.erase(pos);
+	}
+	if (range.offset + range.count == _end) {
+		// the range is at the end - no need to keep it as hole
+		_end = range.offset;
+		return;
+	}
+	_free.insert(_free.begin() + pos, range);
+}
+
+uint32_t RangeAllocator::fragmented() const {
+	uint32_t cnt = 0u;
+	for (const Range &range : _free) {
+		cnt += range.count;
+	}
+	return cnt;
+}
+
+void ChunkBufferLayout::reset(uint32_t vertexCapacity, uint32_t indexCapacity) {
+	_chunks.clear();
+	_vertices.reset(vertexCapacity);
+	_indices.reset(indexCapacity);
+}
+
+bool ChunkBufferLayout::release(const glm::ivec3 &pos, ChunkRange &old) {
+	auto iter = _chunks.find(pos);
+	if (iter == _chunks.end()) {
+		old = ChunkRange();
+		return false;
+	}
+	old = iter->value;
+	_chunks.erase(iter);
+	_vertices.release(old.vertexOffset, old.vertexCount);
+	_indices.release(old.indexOffset, old.indexCount);
+	return true;
+}
+
+bool ChunkBufferLayout::allocate(const glm::ivec3 &pos, uint32_t vertexCount, uint32_t indexCount,
+								 ChunkRange &range, ChunkRange &old) {
+	release(pos, old);
+	range = ChunkRange();
+	if (vertexCount == 0u || indexCount == 0u) {
+		return true;
+	}
+	if (!_vertices.allocate(vertexCount, range.vertexOffset)) {
+		return false;
+	}
+	if (!_indices.allocate(indexCount, range.indexOffset)) {
+		_vertices.release(range.vertexOffset, vertexCount);
+		return false;
+	}
+	range.vertexCount = vertexCount;
+	range.indexCount = indexCount;
+	_chunks.put(pos, range);
+	return true;
+}
+
+bool ChunkBufferLayout::get(const glm::ivec3 &pos, ChunkRange &range) const {
+	return _chunks.get(pos, range);
+}
+
+} // namespace voxelrender
@@ -0,0 +1,136 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/FlatHashMap.h"
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace voxelrender {
+
+/**
+ * @brief First fit allocator for element ranges inside of a fixed size gpu buffer
+ *
+ * Released ranges are merged with their neighbours. Ranges that touch the end of the used area shrink the used
+ * area again - this is the amount of elements that must be drawn.
+ */
+class RangeAllocator {
+private:
+	struct Range {
+		uint32_t offset;
+		uint32_t count;
+	};
+	// sorted by offset
+	core::DynamicArray<Range> _free;
+	uint32_t _end = 0u;
+	uint32_t _capacity = 0u;
+
+public:
+	void reset(uint32_t capacity);
+	/**
+	 * @return @c false if there is no free range with the given size left
+	 */
+	bool allocate(uint32_t count, uint32_t &offset);
+	void release(uint32_t offset, uint32_t count);
+
+	/**
+	 * @return The end of the last allocated range
+	 */
+	uint32_t end() const;
+	uint32_t capacity() const;
+	/**
+	 * @return The amount of elements in the holes below @c end()
+	 */
+	uint32_t fragmented() const;
+};
+
+inline uint32_t RangeAllocator::end() const {
+	return _end;
+}
+
+inline uint32_t RangeAllocator::capacity() const {
+	return _capacity;
+}
+
+/**
+ * @brief The location of the vertices and indices of a single chunk mesh in the volume buffers
+ */
+struct ChunkRange {
+	uint32_t vertexOffset = 0u;
+	uint32_t vertexCount = 0u;
+	uint32_t indexOffset = 0u;
+	uint32_t indexCount = 0u;
+};
+
+/**
+ * @brief Keeps track of where each chunk mesh of a volume lives in the vertex and index buffers
+ *
+ * This allows to only upload the chunks that were re-extracted instead of concatenating and uploading all
+ * chunks of a volume again.
+ * @sa RawVolumeRenderer
+ */
+class ChunkBufferLayout {
+private:
+	core::FlatHashMap<glm::ivec3, ChunkRange, glm::hash<glm::ivec3>> _chunks;
+	RangeAllocator _vertices;
+	RangeAllocator _indices;
+
+public:
+	/**
+	 * @brief Forget about all chunks and set the new buffer sizes (in elements)
+	 */
+	void reset(uint32_t vertexCapacity, uint32_t indexCapacity);
+	/**
+	 * @brief Releases the previous ranges of the chunk and allocates new ones
+	 * @param[out] old The previous ranges of the chunk - counts are @c 0 if the chunk wasn't known yet
+	 * @return @c false if the buffers are too small - the chunk is no longer part of the layout in this case
+	 */
+	bool allocate(const glm::ivec3 &pos, uint32_t vertexCount, uint32_t indexCount, ChunkRange &range,
+				  ChunkRange &old);
+	/**
+	 * @param[out] old The released ranges of the chunk
+	 * @return @c false if the chunk isn't part of the layout
+	 */
+	bool release(const glm::ivec3 &pos, ChunkRange &old);
+	bool get(const glm::ivec3 &pos, ChunkRange &range) const;
+
+	bool empty() const;
+	size_t chunks() const;
+	uint32_t vertexCapacity() const;
+	uint32_t indexCapacity() const;
+	/**
+	 * @return The amount of indices that must be drawn to cover all chunks
+	 */
+	uint32_t indexEnd() const;
+	uint32_t vertexEnd() const;
+};
+
+inline bool ChunkBufferLayout::empty() const {
+	return _chunks.empty();
+}
+
+inline size_t ChunkBufferLayout::chunks() const {
+	return _chunks.size();
+}
+
+inline uint32_t ChunkBufferLayout::vertexCapacity() const {
+	return _vertices.capacity();
+}
+
+inline uint32_t ChunkBufferLayout::indexCapacity() const {
+	return _indices.capacity();
+}
+
+inline uint32_t ChunkBufferLayout::indexEnd() const {
+	return _indices.end();
+}
+
+inline uint32_t ChunkBufferLayout::vertexEnd() const {
+	return _vertices.end();
+}
+
+} // namespace voxelrender
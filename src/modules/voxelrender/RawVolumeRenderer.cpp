@@ -105,7 +105,7 @@ void RawVolumeRenderer::construct() {
 
 bool RawVolumeRenderer::initStateBuffers() {
 	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
-	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
+	const bool normals = !voxel::isCubicMesh(meshMode);
 	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
 		State &state = _state[idx];
 		_meshState->setModel(idx, glm::mat4(1.0f));
@@ -115,6 +115,8 @@ bool RawVolumeRenderer::initStateBuffers() {
 				Log::error("Could not create the vertex buffer object");
 				return false;
 			}
+			// the chunks are updated in place
+			state._vertexBuffer[i].setMode(state._vertexBufferIndex[i], video::BufferMode::Dynamic);
 
 			if (normals) {
 				state._normalBufferIndex[i] = state._vertexBuffer[i].create();
@@ -122,6 +124,7 @@ bool RawVolumeRenderer::initStateBuffers() {
 					Log::error("Could not create the normal buffer object");
 					return false;
 				}
+				state._vertexBuffer[i].setMode(state._normalBufferIndex[i], video::BufferMode::Dynamic);
 			}
 
 			state._indexBufferIndex[i] = state._vertexBuffer[i].create(nullptr, 0, video::BufferType::IndexBuffer);
@@ -129,6 +132,7 @@ bool RawVolumeRenderer::initStateBuffers() {
 				Log::error("Could not create the vertex buffer object for the indices");
 				return false;
 			}
+			state._vertexBuffer[i].setMode(state._indexBufferIndex[i], video::BufferMode::Dynamic);
 		}
 	}
 
@@ -249,23 +253,140 @@ void RawVolumeRenderer::update() {
 		resetStateBuffers();
 	}
 
-	int cnt = 0;
+	_uploadedBytes = 0u;
+	// collect all volumes first - a volume might get several chunk meshes in one frame
+	core::DynamicArray<int> updated;
 	for (;;) {
 		const int idx = _meshState->pop();
 		if (idx == -1) {
 			break;
 		}
-		if (!updateBufferForVolume(idx, voxel::MeshType_Opaque)) {
+		if (core::find(updated.begin(), updated.end(), idx) == updated.end()) {
+			updated.push_back(idx);
+		}
+	}
+	for (int idx : updated) {
+		_meshState->popDirtyChunks(idx, _dirtyChunks);
+		if (!updateBufferForVolume(idx, voxel::MeshType_Opaque, _dirtyChunks)) {
 			Log::error("Failed to update the mesh at index %i", idx);
 		}
-		if (!updateBufferForVolume(idx, voxel::MeshType_Transparency)) {
+		if (!updateBufferForVolume(idx, voxel::MeshType_Transparency, _dirtyChunks)) {
 			Log::error("Failed to update the mesh at index %i", idx);
 		}
-		++cnt;
 	}
-	if (cnt > 0) {
-		Log::debug("Perform %i mesh updates in this frame", cnt);
+	if (!updated.empty()) {
+		Log::debug("Perform %i mesh updates in this frame (%i bytes uploaded)", (int)updated.size(),
+				   (int)_uploadedBytes);
+	}
+}
+
+bool RawVolumeRenderer::clearIndices(State &state, voxel::MeshType type, uint32_t offset, uint32_t count) {
+	// everything beyond the end isn't rendered anyway
+	const uint32_t end = state._layout[type].indexEnd();
+	if (offset >= end || count == 0u) {
+		return true;
 	}
+	count = core_min(count, end - offset);
+	// degenerated triangles - this keeps the single draw call for all chunks
+	_indicesScratch.resize(count);
+	_indicesScratch.fill((voxel::IndexType)0);
+	const size_t size = count * sizeof(voxel::IndexType);
+	_uploadedBytes += size;
+	return state._vertexBuffer[type].updateRange(state._indexBufferIndex[type], offset * sizeof(voxel::IndexType),
+												 _indicesScratch.data(), size);
+}
+
+bool RawVolumeRenderer::uploadChunkIndices(State &state, voxel::MeshType type, const ChunkRange &range,
+										   const voxel::Mesh *mesh) {
+	const voxel::IndexArray &indexVector = mesh->getIndexVector();
+	core_assert(indexVector.size() == range.indexCount);
+	_indicesScratch.resize(range.indexCount);
+	for (uint32_t j = 0; j < range.indexCount; ++j) {
+		_indicesScratch[j] = indexVector[j] + range.vertexOffset;
+	}
+	const size_t size = range.indexCount * sizeof(voxel::IndexType);
+	_uploadedBytes += size;
+	return state._vertexBuffer[type].updateRange(state._indexBufferIndex[type],
+												 range.indexOffset * sizeof(voxel::IndexType),
+												 _indicesScratch.data(), size);
+}
+
+bool RawVolumeRenderer::updateChunk(int bufferIndex, voxel::MeshType type, const glm::ivec3 &pos) {
+	State &state = _state[bufferIndex];
+	const voxel::MeshState::MeshesMap &meshes = _meshState->meshes(type);
+	const voxel::Mesh *mesh = nullptr;
+	auto iter = meshes.find(pos);
+	if (iter != meshes.end()) {
+		mesh = iter->value[bufferIndex];
+	}
+	uint32_t vertCount = 0u;
+	uint32_t indCount = 0u;
+	if (mesh != nullptr && mesh->getNoOfIndices() > 0) {
+		vertCount = (uint32_t)mesh->getNoOfVertices();
+		indCount = (uint32_t)mesh->getNoOfIndices();
+	}
+
+	ChunkBufferLayout &layout = state._layout[type];
+	ChunkRange range;
+	ChunkRange old;
+	if (!layout.allocate(pos, vertCount, indCount, range, old)) {
+		Log::debug("Buffers of volume %i are too small for chunk %i:%i:%i", bufferIndex, pos.x, pos.y, pos.z);
+		return false;
+	}
+	if (!clearIndices(state, type, old.indexOffset, old.indexCount)) {
+		return false;
+	}
+	if (range.indexCount == 0u) {
+		return true;
+	}
+
+	video::Buffer &buffer = state._vertexBuffer[type];
+	const voxel::VertexArray &vertexVector = mesh->getVertexVector();
+	const size_t verticesSize = vertexVector.size() * sizeof(voxel::VoxelVertex);
+	if (!buffer.updateRange(state._vertexBufferIndex[type], range.vertexOffset * sizeof(voxel::VoxelVertex),
+							vertexVector.data(), verticesSize)) {
+		Log::error("Failed to update the vertex buffer range");
+		return false;
+	}
+	_uploadedBytes += verticesSize;
+
+	const voxel::NormalArray &normalVector = mesh->getNormalVector();
+	if (state._normalBufferIndex[type] != -1 && !normalVector.empty()) {
+		core_assert(vertexVector.size() == normalVector.size());
+		const size_t normalsSize = normalVector.size() * sizeof(glm::vec3);
+		if (!buffer.updateRange(state._normalBufferIndex[type], range.vertexOffset * sizeof(glm::vec3),
+								normalVector.data(), normalsSize)) {
+			Log::error("Failed to update the normal buffer range");
+			return false;
+		}
+		_uploadedBytes += normalsSize;
+	}
+
+	if (!uploadChunkIndices(state, type, range, mesh)) {
+		Log::error("Failed to update the index buffer range");
+		return false;
+	}
+	return true;
+}
+
+bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type,
+											  const core::DynamicArray<glm::ivec3> &chunks) {
+	if (idx < 0 || idx >= voxel::MAX_VOLUMES) {
+		return false;
+	}
+	const int bufferIndex = _meshState->resolveIdx(idx);
+	if (bufferIndex != idx || _state[bufferIndex]._layout[type].empty()) {
+		return updateBufferForVolume(idx, type);
+	}
+	core_trace_scoped(RawVolumeRendererUpdateChunks);
+	for (const glm::ivec3 &pos : chunks) {
+		if (!updateChunk(bufferIndex, type, pos)) {
+			// out of space - rebuild the buffers with new headroom
+			return updateBufferForVolume(idx, type);
+		}
+	}
+	_state[bufferIndex]._dirtyNormals = true;
+	return true;
 }
 
 bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
@@ -281,28 +402,36 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
 	_meshState->count(type, bufferIndex, vertCount, normalsCount, indCount);
 
 	State &state = _state[bufferIndex];
+	ChunkBufferLayout &layout = state._layout[type];
 	if (indCount == 0u || vertCount == 0u) {
 		Log::debug("clear vertexbuffer: %i", idx);
 		video::Buffer &buffer = state._vertexBuffer[type];
 		buffer.update(state._vertexBufferIndex[type], nullptr, 0);
 		buffer.update(state._normalBufferIndex[type], nullptr, 0);
 		buffer.update(state._indexBufferIndex[type], nullptr, 0);
+		layout.reset(0u, 0u);
 		state._dirtyNormals = true;
 		return true;
 	}
 
-	const size_t verticesBufSize = vertCount * sizeof(voxel::VoxelVertex);
+	// leave some room to put re-extracted chunks into the buffers without re-uploading all of them
+	const size_t vertCapacity = vertCount + vertCount / 2;
+	const size_t indCapacity = indCount + indCount / 2;
+	layout.reset((uint32_t)vertCapacity, (uint32_t)indCapacity);
+
+	const size_t verticesBufSize = vertCapacity * sizeof(voxel::VoxelVertex);
 	voxel::VoxelVertex *verticesBuf = (voxel::VoxelVertex *)core_malloc(verticesBufSize);
-	const size_t normalsBufSize = normalsCount * sizeof(glm::vec3);
+	const size_t normalsBufSize = normalsCount > 0u ? vertCapacity * sizeof(glm::vec3) : 0u;
 	glm::vec3 *normalsBuf = (glm::vec3 *)core_malloc(normalsBufSize);
-	const size_t indicesBufSize = indCount * sizeof(voxel::IndexType);
+	const size_t indicesBufSize = indCapacity * sizeof(voxel::IndexType);
 	voxel::IndexType *indicesBuf = (voxel::IndexType *)core_malloc(indicesBufSize);
+	// the unused part is never drawn - but keep it defined
+	core_memset(verticesBuf + vertCount, 0, (vertCapacity - vertCount) * sizeof(voxel::VoxelVertex));
+	if (normalsBufSize > 0u) {
+		core_memset(normalsBuf + vertCount, 0, (vertCapacity - vertCount) * sizeof(glm::vec3));
+	}
+	core_memset(indicesBuf + indCount, 0, (indCapacity - indCount) * sizeof(voxel::IndexType));
 
-	voxel::VoxelVertex *verticesPos = verticesBuf;
-	glm::vec3 *normalsPos = normalsBuf;
-	voxel::IndexType *indicesPos = indicesBuf;
-
-	voxel::IndexType offset = (voxel::IndexType)0;
 	for (const auto &i : _meshState->meshes(type)) {
 		const voxel::MeshState::Meshes &meshes = i->second;
 		const voxel::Mesh *mesh = meshes[bufferIndex];
@@ -312,20 +441,22 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
 		const voxel::VertexArray &vertexVector = mesh->getVertexVector();
 		const voxel::NormalArray &normalVector = mesh->getNormalVector();
 		const voxel::IndexArray &indexVector = mesh->getIndexVector();
-		core_memcpy(verticesPos, &vertexVector[0], vertexVector.size() * sizeof(voxel::VoxelVertex));
-		if (!normalVector.empty()) {
+		ChunkRange range;
+		ChunkRange old;
+		if (!layout.allocate(i->first, (uint32_t)vertexVector.size(), (uint32_t)indexVector.size(), range, old)) {
+			core_assert_msg(false, "Chunk doesn't fit into the volume buffers");
+			continue;
+		}
+		core_memcpy(verticesBuf + range.vertexOffset, &vertexVector[0],
+					vertexVector.size() * sizeof(voxel::VoxelVertex));
+		if (!normalVector.empty() && normalsBufSize > 0u) {
 			core_assert(vertexVector.size() == normalVector.size());
-			core_memcpy(normalsPos, &normalVector[0], normalVector.size() * sizeof(glm::vec3));
+			core_memcpy(normalsBuf + range.vertexOffset, &normalVector[0], normalVector.size() * sizeof(glm::vec3));
 		}
-		core_memcpy(indicesPos, &indexVector[0], indexVector.size() * sizeof(voxel::IndexType));
-
+		voxel::IndexType *indicesPos = indicesBuf + range.indexOffset;
 		for (size_t j = 0; j < indexVector.size(); ++j) {
-			*indicesPos++ += offset;
+			indicesPos[j] = indexVector[j] + range.vertexOffset;
 		}
-
-		verticesPos += vertexVector.size();
-		normalsPos += normalVector.size();
-		offset += vertexVector.size();
 	}
 	state._dirtyNormals = true;
 
@@ -333,18 +464,24 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
 	if (!state._vertexBuffer[type].update(state._vertexBufferIndex[type], verticesBuf, verticesBufSize)) {
 		Log::error("Failed to update the vertex buffer");
 		core_free(indicesBuf);
+		core_free(normalsBuf);
 		core_free(verticesBuf);
+		layout.reset(0u, 0u);
 		return false;
 	}
 	core_free(verticesBuf);
+	_uploadedBytes += verticesBufSize;
 
 	if (state._normalBufferIndex[type] != -1) {
 		Log::debug("update normalbuffer: %i (type: %i)", idx, type);
 		if (!state._vertexBuffer[type].update(state._normalBufferIndex[type], normalsBuf, normalsBufSize)) {
 			Log::error("Failed to update the normal buffer");
+			core_free(indicesBuf);
 			core_free(normalsBuf);
+			layout.reset(0u, 0u);
 			return false;
 		}
+		_uploadedBytes += normalsBufSize;
 	}
 	core_free(normalsBuf);
 
@@ -352,9 +489,11 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
 	if (!state._vertexBuffer[type].update(state._indexBufferIndex[type], indicesBuf, indicesBufSize)) {
 		Log::error("Failed to update the index buffer");
 		core_free(indicesBuf);
+		layout.reset(0u, 0u);
 		return false;
 	}
 	core_free(indicesBuf);
+	_uploadedBytes += indicesBufSize;
 	return true;
 }
 
@@ -627,7 +766,14 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 				continue;
 			}
 			if (mesh->sort(camera.worldPosition())) {
-				updateBufferForVolume(bufferIndex, voxel::MeshType_Transparency);
+				// the vertices are untouched - only the indices of this chunk have to be uploaded again
+				State &state = _state[bufferIndex];
+				ChunkRange range;
+				if (!state._layout[voxel::MeshType_Transparency].get(i->first, range) ||
+					range.indexCount != (uint32_t)mesh->getNoOfIndices() ||
+					!uploadChunkIndices(state, voxel::MeshType_Transparency, range, mesh)) {
+					updateBufferForVolume(bufferIndex, voxel::MeshType_Transparency);
+				}
 			}
 		}
 	}
@@ -686,7 +832,7 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 	core_assert_always(_voxelData.update(_voxelShaderFragData));
 
 	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
-	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
+	const bool normals = !voxel::isCubicMesh(meshMode);
 	video::Id oldShader = video::getProgram();
 	if (normals) {
 		_voxelNormShader.activate();
@@ -776,6 +922,7 @@ void RawVolumeRenderer::deleteMesh(int idx, voxel::MeshType meshType) {
 	}
 	vertexBuffer.update(state._indexBufferIndex[meshType], nullptr, 0);
 	core_assert(vertexBuffer.size(state._indexBufferIndex[meshType]) == 0);
+	state._layout[meshType].reset(0u, 0u);
 
 	if (state._normalPreviewBufferIndex != -1) {
 		vertexBuffer.update(state._normalPreviewBufferIndex, nullptr, 0);
@@ -792,6 +939,7 @@ void RawVolumeRenderer::shutdownStateBuffers() {
 		State &state = _state[idx];
 		for (int i = 0; i < voxel::MeshType_Max; ++i) {
 			state._vertexBuffer[i].shutdown();
+			state._layout[i].reset(0u, 0u);
 			state._vertexBufferIndex[i] = -1;
 			state._normalBufferIndex[i] = -1;
 			state._indexBufferIndex[i] = -1;
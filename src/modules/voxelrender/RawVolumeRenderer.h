@@ -19,6 +19,7 @@
 #include "video/FrameBuffer.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
+#include "voxelrender/ChunkBufferLayout.h"
 #include "voxelrender/Shadow.h"
 
 namespace video {
@@ -72,9 +73,11 @@ protected:
 		int32_t _normalPreviewBufferIndex = -1;
 		int32_t _indexBufferIndex[voxel::MeshType_Max]{-1, -1};
 		video::Buffer _vertexBuffer[voxel::MeshType_Max];
+		// where the chunk meshes are located in the buffers
+		ChunkBufferLayout _layout[voxel::MeshType_Max];
 
 		uint32_t indices(voxel::MeshType type) const {
-			return _vertexBuffer[type].elements(_indexBufferIndex[type], 1, sizeof(voxel::IndexType));
+			return _layout[type].indexEnd();
 		}
 
 		bool hasData() const {
@@ -104,8 +107,24 @@ protected:
 	core::VarPtr _shadowMap;
 	core::VarPtr _bloom;
 
+	// bytes that were uploaded into the vertex, normal and index buffers since the last update() call
+	size_t _uploadedBytes = 0u;
+	core::DynamicArray<voxel::IndexType> _indicesScratch;
+	core::DynamicArray<glm::ivec3> _dirtyChunks;
+
 	void updatePalette(int idx);
+	/**
+	 * @brief Rebuilds the whole buffers of the given volume from all of its chunk meshes
+	 */
 	bool updateBufferForVolume(int idx, voxel::MeshType type);
+	/**
+	 * @brief Only uploads the given chunks into the free ranges of the buffers - falls back to a full rebuild if
+	 * the buffers are too small
+	 */
+	bool updateBufferForVolume(int idx, voxel::MeshType type, const core::DynamicArray<glm::ivec3> &chunks);
+	bool updateChunk(int bufferIndex, voxel::MeshType type, const glm::ivec3 &pos);
+	bool uploadChunkIndices(State &state, voxel::MeshType type, const ChunkRange &range, const voxel::Mesh *mesh);
+	bool clearIndices(State &state, voxel::MeshType type, uint32_t offset, uint32_t count);
 	void deleteMesh(int idx, voxel::MeshType meshType);
 	void deleteMeshes(int idx);
 	void updateCulling(int idx, const video::Camera &camera);
@@ -162,6 +181,11 @@ s	 */
 
 	void update();
 
+	/**
+	 * @return The amount of bytes that were uploaded to the gpu buffers since the last @c update() call
+	 */
+	size_t uploadedBytes() const;
+
 	/**
 	 * @return the managed voxel::RawVolume instance pointer, or @c nullptr if there is none set.
 	 * @note You take the ownership of the returned volume pointers. Don't forget to delete them.
@@ -177,4 +201,8 @@ inline voxel::MeshStatePtr RawVolumeRenderer::meshState() const {
 	return _meshState;
 }
 
+inline size_t RawVolumeRenderer::uploadedBytes() const {
+	return _uploadedBytes;
+}
+
 } // namespace voxelrender
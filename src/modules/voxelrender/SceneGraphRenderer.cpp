@@ -186,6 +186,7 @@ void SceneGraphRenderer::prepare(const RenderContext &renderContext) {
 
 	const int activeNodeId = sceneGraph.activeNode();
 	const scenegraph::SceneGraphNode &activeNode = sceneGraph.node(activeNodeId);
+	const scenegraph::FrameTransforms &transforms = sceneGraph.transformsForFrame(frame);
 	for (auto entry : sceneGraph.nodes()) {
 		scenegraph::SceneGraphNode &node = entry->value;
 		if (renderContext.onlyModels && !node.isModelNode()) {
@@ -216,7 +217,7 @@ void SceneGraphRenderer::prepare(const RenderContext &renderContext) {
 			_volumeRenderer.scheduleRegionExtraction(id, region);
 		}
 		if (renderContext.sceneMode) {
-			const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frame);
+			const scenegraph::FrameTransform &transform = transforms[node.id()];
 			const glm::vec3 scale = transform.scale();
 			const int negative = (int)std::signbit(scale.x) + (int)std::signbit(scale.y) +
 								 (int)std::signbit(scale.z);
@@ -270,7 +271,7 @@ void SceneGraphRenderer::prepare(const RenderContext &renderContext) {
 			}
 			const int referencedId = getVolumeId(node.reference());
 			meshState->setReference(id, referencedId);
-			const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frame);
+			const scenegraph::FrameTransform &transform = transforms[node.id()];
 			const voxel::Region region = sceneGraph.resolveRegion(node);
 			const glm::mat4 worldMatrix = transform.worldMatrix();
 			const glm::vec3 maxs = worldMatrix * glm::vec4(region.getUpperCorner(), 1.0f);
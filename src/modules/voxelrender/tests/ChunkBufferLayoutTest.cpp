@@ -0,0 +1,91 @@
+/**
+ * @file
+ */
+
+#include "voxelrender/ChunkBufferLayout.h"
+#include <gtest/gtest.h>
+
+namespace voxelrender {
+
+TEST(RangeAllocatorTest, testAllocateRelease) {
+	RangeAllocator allocator;
+	allocator.reset(100u);
+	uint32_t a, b, c;
+	ASSERT_TRUE(allocator.allocate(10u, a));
+	ASSERT_TRUE(allocator.allocate(20u, b));
+	ASSERT_TRUE(allocator.allocate(30u, c));
+	EXPECT_EQ(0u, a);
+	EXPECT_EQ(10u, b);
+	EXPECT_EQ(30u, c);
+	EXPECT_EQ(60u, allocator.end());
+
+	uint32_t d;
+	EXPECT_FALSE(allocator.allocate(41u, d));
+
+	allocator.release(b, 20u);
+	EXPECT_EQ(60u, allocator.end());
+	EXPECT_EQ(20u, allocator.fragmented());
+	// first fit reuses the hole
+	ASSERT_TRUE(allocator.allocate(15u, d));
+	EXPECT_EQ(10u, d);
+	EXPECT_EQ(5u, allocator.fragmented());
+}
+
+TEST(RangeAllocatorTest, testMergeAndShrink) {
+	RangeAllocator allocator;
+	allocator.reset(100u);
+	uint32_t a, b, c;
+	ASSERT_TRUE(allocator.allocate(10u, a));
+	ASSERT_TRUE(allocator.allocate(10u, b));
+	ASSERT_TRUE(allocator.allocate(10u, c));
+	allocator.release(a, 10u);
+	allocator.release(b, 10u);
+	EXPECT_EQ(20u, allocator.fragmented());
+	uint32_t d;
+	ASSERT_TRUE(allocator.allocate(20u, d));
+	EXPECT_EQ(0u, d);
+	allocator.release(d, 20u);
+	// releasing the last range also gives back the merged holes
+	allocator.release(c, 10u);
+	EXPECT_EQ(0u, allocator.end());
+	EXPECT_EQ(0u, allocator.fragmented());
+}
+
+TEST(ChunkBufferLayoutTest, testReplaceChunk) {
+	ChunkBufferLayout layout;
+	layout.reset(100u, 150u);
+	ChunkRange range1, range2, range3, old;
+	ASSERT_TRUE(layout.allocate(glm::ivec3(0), 40u, 60u, range1, old));
+	EXPECT_EQ(0u, old.indexCount);
+	ASSERT_TRUE(layout.allocate(glm::ivec3(32, 0, 0), 40u, 60u, range2, old));
+	EXPECT_EQ(40u, range2.vertexOffset);
+	EXPECT_EQ(60u, range2.indexOffset);
+	EXPECT_EQ(120u, layout.indexEnd());
+
+	// the chunk got smaller - it fits into its old place
+	ASSERT_TRUE(layout.allocate(glm::ivec3(0), 20u, 30u, range3, old));
+	EXPECT_EQ(0u, range3.vertexOffset);
+	EXPECT_EQ(0u, range3.indexOffset);
+	EXPECT_EQ(60u, old.indexCount);
+	EXPECT_EQ(120u, layout.indexEnd());
+	EXPECT_EQ(2u, layout.chunks());
+
+	// doesn't fit anymore
+	EXPECT_FALSE(layout.allocate(glm::ivec3(32, 0, 0), 40u, 121u, range2, old));
+	EXPECT_EQ(1u, layout.chunks());
+	EXPECT_EQ(30u, layout.indexEnd());
+}
+
+TEST(ChunkBufferLayoutTest, testEmptyChunk) {
+	ChunkBufferLayout layout;
+	layout.reset(10u, 10u);
+	ChunkRange range, old;
+	ASSERT_TRUE(layout.allocate(glm::ivec3(0), 4u, 6u, range, old));
+	ASSERT_TRUE(layout.allocate(glm::ivec3(0), 0u, 0u, range, old));
+	EXPECT_EQ(6u, old.indexCount);
+	EXPECT_TRUE(layout.empty());
+	EXPECT_EQ(0u, layout.indexEnd());
+	EXPECT_FALSE(layout.get(glm::ivec3(0), range));
+}
+
+} // namespace voxelrender
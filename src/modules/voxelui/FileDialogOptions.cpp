@@ -20,6 +20,7 @@
 #include "voxelformat/private/magicavoxel/VoxFormat.h"
 #include "voxelformat/private/mesh/GLTFFormat.h"
 #include "voxelformat/private/mesh/MeshFormat.h"
+#include "voxelformat/private/minecraft/MCRFormat.h"
 #include "voxelformat/private/qubicle/QBFormat.h"
 #include "voxelformat/private/qubicle/QBTFormat.h"
 #include "voxelformat/private/vengi/VENGIFormat.h"
@@ -101,6 +102,9 @@ static void saveOptionsMesh(const io::FormatDescription *desc) {
 		ImGui::CheckboxVar("KHR_materials_pbrSpecularGlossiness",
 						   cfg::VoxFormatGLTF_KHR_materials_pbrSpecularGlossiness);
 		ImGui::CheckboxVar("KHR_materials_specular", cfg::VoxFormatGLTF_KHR_materials_specular);
+		ImGui::InputVarInt("MSFT_lod", cfg::VoxFormatGLTF_MSFT_lod);
+		ImGui::CheckboxVar("KHR_mesh_quantization", cfg::VoxFormatGLTF_KHR_mesh_quantization);
+		ImGui::CheckboxVar("EXT_meshopt_compression", cfg::VoxFormatGLTF_EXT_meshopt_compression);
 	}
 	ImGui::CheckboxVar(_("Export materials"), cfg::VoxFormatWithMaterials);
 
@@ -189,9 +193,10 @@ static void loadOptionsMesh() {
 	ImGui::CheckboxVar(_("Fill hollow"), cfg::VoxformatFillHollow);
 	ImGui::InputVarInt(_("Point cloud size"), cfg::VoxformatPointCloudSize);
 
-	const char *voxelizationModes[] = {_("high quality"), _("faster and less memory")};
+	const char *voxelizationModes[] = {_("high quality"), _("faster and less memory"), _("tiled and parallel")};
 	static_assert(voxelformat::MeshFormat::VoxelizeMode::HighQuality == 0, "HighQuality must be at index 0");
 	static_assert(voxelformat::MeshFormat::VoxelizeMode::Fast == 1, "Fast must be at index 1");
+	static_assert(voxelformat::MeshFormat::VoxelizeMode::Tiled == 2, "Tiled must be at index 2");
 	const core::VarPtr &voxelizationVar = core::Var::getSafe(cfg::VoxformatVoxelizeMode);
 	const int currentVoxelizationMode = voxelizationVar->intVal();
 
@@ -254,6 +259,11 @@ bool loadOptions(const io::FormatDescription *desc, const io::FilesystemEntry &e
 		loadOptionsPng(entry);
 	}
 
+	if (*desc == voxelformat::MCRFormat::format()) {
+		ImGui::InputVarString(_("Region"), cfg::VoxformatMCRRegion);
+		ImGui::TooltipTextUnformatted(_("'miny maxy' or 'minx miny minz maxx maxy maxz' - empty to load everything"));
+	}
+
 	loadOptionsGeneric(desc, entry, paletteCache);
 	return true;
 }
@@ -0,0 +1,266 @@
+/**
+ * @file
+ */
+
+#include "OccupancyPyramid.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include "core/concurrent/ThreadPool.h"
+#include "voxel/RawVolume.h"
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
+#include <limits>
+
+namespace voxelutil {
+
+OccupancyPyramid::OccupancyPyramid(const voxel::RawVolume *volume) : _volume(volume), _region(volume->region()) {
+	constexpr int brickSize = 1 << BrickShift;
+	glm::ivec3 size = (_region.getDimensionsInVoxels() + brickSize - 1) >> BrickShift;
+	for (;;) {
+		Level level;
+		level.size = size;
+		level.cells.resize((size_t)size.x * size.y * size.z);
+		_levels.emplace_back(core::move(level));
+		if (size.x == 1 && size.y == 1 && size.z == 1) {
+			break;
+		}
+		size = (size + 1) >> 1;
+	}
+	build();
+}
+
+bool OccupancyPyramid::occupied(int level, const glm::ivec3 &cell) const {
+	if (level < 0 || level >= levels()) {
+		return false;
+	}
+	const Level &l = _levels[level];
+	if (glm::any(glm::lessThan(cell, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(cell, l.size))) {
+		return false;
+	}
+	return l.cells[l.index(cell)] != 0u;
+}
+
+void OccupancyPyramid::buildBricks(const voxel::Region &region) {
+	constexpr int brickSize = 1 << BrickShift;
+	Level &bricks = _levels[0];
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const glm::ivec3 brickMins = (mins - lower) >> BrickShift;
+	const glm::ivec3 brickMaxs = (maxs - lower) >> BrickShift;
+	for (int z = brickMins.z; z <= brickMaxs.z; ++z) {
+		for (int y = brickMins.y; y <= brickMaxs.y; ++y) {
+			for (int x = brickMins.x; x <= brickMaxs.x; ++x) {
+				bricks.cells[bricks.index(glm::ivec3(x, y, z))] = 0u;
+			}
+		}
+	}
+
+	voxel::RawVolume::Sampler sampler(_volume);
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		const int brickZ = (z - lower.z) >> BrickShift;
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			const int brickY = (y - lower.y) >> BrickShift;
+			sampler.setPosition(mins.x, y, z);
+			for (int x = mins.x; x <= maxs.x;) {
+				const int brickX = (x - lower.x) >> BrickShift;
+				uint8_t &cell = bricks.cells[bricks.index(glm::ivec3(brickX, brickY, brickZ))];
+				if (cell == 0u && !voxel::isAir(sampler.voxel().getMaterial())) {
+					cell = 1u;
+				}
+				if (cell != 0u) {
+					// the rest of this brick row doesn't change the result
+					const int next = lower.x + (brickX + 1) * brickSize;
+					sampler.movePositiveX(next - x);
+					x = next;
+				} else {
+					sampler.movePositiveX();
+					++x;
+				}
+			}
+		}
+	}
+}
+
+void OccupancyPyramid::buildLevel(int level, const glm::ivec3 &childMins, const glm::ivec3 &childMaxs) {
+	const Level &children = _levels[level - 1];
+	Level &parents = _levels[level];
+	const glm::ivec3 mins = childMins >> 1;
+	const glm::ivec3 maxs = glm::min(childMaxs >> 1, parents.size - 1);
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				const glm::ivec3 childLower(x * 2, y * 2, z * 2);
+				const glm::ivec3 childUpper = glm::min(childLower + 1, children.size - 1);
+				uint8_t value = 0u;
+				for (int cz = childLower.z; cz <= childUpper.z && value == 0u; ++cz) {
+					for (int cy = childLower.y; cy <= childUpper.y && value == 0u; ++cy) {
+						for (int cx = childLower.x; cx <= childUpper.x; ++cx) {
+							if (children.cells[children.index(glm::ivec3(cx, cy, cz))] != 0u) {
+								value = 1u;
+								break;
+							}
+						}
+					}
+				}
+				parents.cells[parents.index(glm::ivec3(x, y, z))] = value;
+			}
+		}
+	}
+}
+
+void OccupancyPyramid::build() {
+	core_trace_scoped(OccupancyPyramidBuild);
+	buildBricks(_region);
+	for (int level = 1; level < levels(); ++level) {
+		buildLevel(level, glm::ivec3(0), _levels[level - 1].size - 1);
+	}
+}
+
+void OccupancyPyramid::update(const voxel::Region &dirtyRegion) {
+	core_trace_scoped(OccupancyPyramidUpdate);
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 mins = glm::max(dirtyRegion.getLowerCorner(), lower);
+	const glm::ivec3 maxs = glm::min(dirtyRegion.getUpperCorner(), _region.getUpperCorner());
+	if (glm::any(glm::greaterThan(mins, maxs))) {
+		return;
+	}
+	// the bricks are rebuilt completely - extend the region to the brick boundaries
+	glm::ivec3 cellMins = (mins - lower) >> BrickShift;
+	glm::ivec3 cellMaxs = (maxs - lower) >> BrickShift;
+	const glm::ivec3 alignedMins = lower + (cellMins << BrickShift);
+	const glm::ivec3 alignedMaxs =
+		glm::min(lower + ((cellMaxs + 1) << BrickShift) - 1, _region.getUpperCorner());
+	buildBricks(voxel::Region(alignedMins, alignedMaxs));
+	for (int level = 1; level < levels(); ++level) {
+		buildLevel(level, cellMins, cellMaxs);
+		cellMins >>= 1;
+		cellMaxs >>= 1;
+	}
+}
+
+PickResult OccupancyPyramid::pick(const glm::vec3 &start, const glm::vec3 &directionAndLength) const {
+	core_trace_scoped(OccupancyPyramidPick);
+	PickResult result;
+	result.direction = directionAndLength;
+
+	// clip the ray against the volume bounds - the ray parameter t is in [0, 1]
+	const glm::vec3 boundsMins(_region.getLowerCorner());
+	const glm::vec3 boundsMaxs(_region.getUpperCorner() + 1);
+	constexpr float inf = (std::numeric_limits<float>::max)();
+	glm::vec3 invDir;
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	int lastAxis = -1;
+	for (int a = 0; a < 3; ++a) {
+		if (directionAndLength[a] == 0.0f) {
+			if (start[a] < boundsMins[a] || start[a] >= boundsMaxs[a]) {
+				return result;
+			}
+			invDir[a] = inf;
+			continue;
+		}
+		invDir[a] = 1.0f / directionAndLength[a];
+		float t1 = (boundsMins[a] - start[a]) * invDir[a];
+		float t2 = (boundsMaxs[a] - start[a]) * invDir[a];
+		if (t1 > t2) {
+			core::exchange(t1, t2);
+		}
+		if (t1 > tEnter) {
+			tEnter = t1;
+			lastAxis = a;
+		}
+		tExit = glm::min(tExit, t2);
+	}
+	if (tEnter > tExit) {
+		return result;
+	}
+
+	const glm::ivec3 step(directionAndLength.x > 0.0f ? 1 : -1, directionAndLength.y > 0.0f ? 1 : -1,
+						  directionAndLength.z > 0.0f ? 1 : -1);
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	glm::ivec3 pos =
+		glm::clamp(glm::ivec3(glm::floor(start + directionAndLength * tEnter)), lower, _region.getUpperCorner());
+	if (lastAxis != -1) {
+		// the entry point is exactly on the boundary - don't rely on the float precision here
+		pos[lastAxis] = step[lastAxis] > 0 ? lower[lastAxis] : _region.getUpperCorner()[lastAxis];
+	}
+
+	float t = tEnter;
+	while (t <= tExit && _region.containsPoint(pos)) {
+		// find the largest empty cell that contains the current voxel
+		const glm::ivec3 local = pos - lower;
+		int emptyLevel = -1;
+		for (int level = 0; level < levels(); ++level) {
+			const Level &l = _levels[level];
+			if (l.cells[l.index(local >> (BrickShift + level))] != 0u) {
+				break;
+			}
+			emptyLevel = level;
+		}
+
+		glm::ivec3 boxMins;
+		glm::ivec3 boxMaxs;
+		if (emptyLevel == -1) {
+			if (!voxel::isAir(_volume->voxel(pos).getMaterial())) {
+				result.didHit = true;
+				result.hitVoxel = pos;
+				if (lastAxis != -1) {
+					result.hitFace = (voxel::FaceNames)(step[lastAxis] > 0 ? lastAxis + 3 : lastAxis);
+					glm::ivec3 previous = pos;
+					previous[lastAxis] -= step[lastAxis];
+					if (_region.containsPoint(previous)) {
+						result.validPreviousPosition = true;
+						result.previousPosition = previous;
+					}
+				}
+				return result;
+			}
+			boxMins = boxMaxs = pos;
+		} else {
+			const int shift = BrickShift + emptyLevel;
+			boxMins = lower + ((local >> shift) << shift);
+			boxMaxs = boxMins + (1 << shift) - 1;
+		}
+
+		// leave the box through the nearest face
+		glm::vec3 tNext;
+		for (int a = 0; a < 3; ++a) {
+			if (invDir[a] == inf) {
+				tNext[a] = inf;
+			} else {
+				const float boundary = (float)(step[a] > 0 ? boxMaxs[a] + 1 : boxMins[a]);
+				tNext[a] = (boundary - start[a]) * invDir[a];
+			}
+		}
+		const int axis = tNext.x <= tNext.y ? (tNext.x <= tNext.z ? 0 : 2) : (tNext.y <= tNext.z ? 1 : 2);
+		t = tNext[axis];
+		const glm::vec3 exitPos = start + directionAndLength * t;
+		for (int a = 0; a < 3; ++a) {
+			if (a == axis) {
+				pos[a] = step[a] > 0 ? boxMaxs[a] + 1 : boxMins[a] - 1;
+			} else {
+				pos[a] = glm::clamp((int)glm::floor(exitPos[a]), boxMins[a], boxMaxs[a]);
+			}
+		}
+		lastAxis = axis;
+	}
+	return result;
+}
+
+void OccupancyPyramid::pick(const PickRay *rays, PickResult *results, int n, core::ThreadPool *threadPool) const {
+	core_trace_scoped(OccupancyPyramidPickBatch);
+	if (threadPool == nullptr) {
+		for (int i = 0; i < n; ++i) {
+			results[i] = pick(rays[i].start, rays[i].directionAndLength);
+		}
+		return;
+	}
+	core::for_parallel(*threadPool, 0, n, 64, [this, rays, results](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			results[i] = pick(rays[i].start, rays[i].directionAndLength);
+		}
+	});
+}
+
+} // namespace voxelutil
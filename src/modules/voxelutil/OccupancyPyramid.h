@@ -0,0 +1,115 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include "voxelutil/Picking.h"
+#include <glm/vec3.hpp>
+
+namespace core {
+class ThreadPool;
+}
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelutil {
+
+/**
+ * @brief A ray for the batched queries of the @c OccupancyPyramid
+ * @note The length of the direction vector is the length of the ray - see @c raycastWithDirection()
+ */
+struct PickRay {
+	glm::vec3 start{0.0f};
+	glm::vec3 directionAndLength{0.0f};
+};
+
+/**
+ * @brief Occupancy mip pyramid for a @c voxel::RawVolume to accelerate raycasts through mostly empty volumes
+ *
+ * Level 0 stores one flag per brick of 4x4x4 voxels, each following level combines 2x2x2 cells of the previous level.
+ * A cell is occupied if any voxel inside of it is not air. The raycast uses a hierarchical DDA: it jumps over the
+ * largest empty cell that contains the current position and only visits single voxels inside of occupied bricks.
+ *
+ * The pyramid doesn't own the volume. After modifying the volume call @c update() with the dirty region - or
+ * @c build() if the volume was changed completely.
+ *
+ * @note Only the occupancy is cached - hit voxels are always read from the volume
+ */
+class OccupancyPyramid {
+public:
+	/**
+	 * @brief The level 0 cells are bricks of (1 << BrickShift)^3 voxels
+	 */
+	static constexpr int BrickShift = 2;
+
+	explicit OccupancyPyramid(const voxel::RawVolume *volume);
+
+	/**
+	 * @brief Rebuild all levels from the volume
+	 */
+	void build();
+	/**
+	 * @brief Rebuild the cells that overlap the given region of the volume
+	 */
+	void update(const voxel::Region &dirtyRegion);
+
+	/**
+	 * @return @c true if any voxel in the given cell of the given level is not air - cells outside of the level are
+	 * not occupied
+	 */
+	bool occupied(int level, const glm::ivec3 &cell) const;
+
+	inline int levels() const {
+		return (int)_levels.size();
+	}
+
+	/**
+	 * @brief Pick the first solid voxel along a vector
+	 *
+	 * The traversal only steps to the face neighbours of a voxel. @c pickVoxel() also visits the diagonal
+	 * neighbours where the ray passes close to an edge or a corner - so it can report a hit that is missed here, and
+	 * the results are not identical. Don't use this as a drop-in replacement for @c pickVoxel().
+	 *
+	 * @note Other than @c pickVoxel() the previous position is derived from the entry face of the hit voxel - and the
+	 * @c firstPosition of the @c PickResult isn't filled
+	 */
+	PickResult pick(const glm::vec3 &start, const glm::vec3 &directionAndLength) const;
+	/**
+	 * @brief Batched version of @c pick()
+	 * @param[out] results Must have space for @c n entries
+	 * @param threadPool If given, the rays are distributed over the threads of the pool
+	 */
+	void pick(const PickRay *rays, PickResult *results, int n, core::ThreadPool *threadPool = nullptr) const;
+
+private:
+	struct Level {
+		glm::ivec3 size{0};
+		core::Buffer<uint8_t> cells;
+
+		inline int index(const glm::ivec3 &cell) const {
+			return (cell.z * size.y + cell.y) * size.x + cell.x;
+		}
+	};
+
+	const voxel::RawVolume *_volume;
+	voxel::Region _region;
+	core::DynamicArray<Level> _levels;
+
+	/**
+	 * @brief Scan the voxels of the given volume region and update the level 0 bricks
+	 * @param region The volume region - must be aligned to the brick size (clipped to the volume)
+	 */
+	void buildBricks(const voxel::Region &region);
+	/**
+	 * @brief Update the cells of the given level that are covered by the given cell range of the level below
+	 */
+	void buildLevel(int level, const glm::ivec3 &childMins, const glm::ivec3 &childMaxs);
+};
+
+} // namespace voxelutil
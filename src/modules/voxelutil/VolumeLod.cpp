@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+
+#include "VolumeLod.h"
+#include "core/ScopedPtr.h"
+#include "core/Trace.h"
+#include "palette/Palette.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/MeshLod.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/VolumeRescaler.h"
+
+namespace voxelutil {
+
+static void extractLevel(const voxel::RawVolume &volume, const palette::Palette &palette,
+						 voxel::SurfaceExtractionType type, voxel::ChunkMesh &mesh, bool mergeQuads,
+						 bool reuseVertices, bool ambientOcclusion) {
+	voxel::Region region = volume.region();
+	// include the boundary voxels
+	region.shiftUpperCorner(1, 1, 1);
+	voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &volume, region, palette, mesh, glm::ivec3(0),
+															   mergeQuads, reuseVertices, ambientOcclusion);
+	voxel::extractSurface(ctx);
+}
+
+void createLodChain(const voxel::RawVolume &volume, const palette::Palette &palette,
+					voxel::SurfaceExtractionType type, int simplifiedLevels, int downsampledLevels,
+					voxel::MeshLodChain &chain, bool mergeQuads, bool reuseVertices, bool ambientOcclusion) {
+	core_trace_scoped(CreateLodChain);
+	chain.clear();
+	voxel::ChunkMesh mesh;
+	extractLevel(volume, palette, type, mesh, mergeQuads, reuseVertices, ambientOcclusion);
+	const glm::ivec3 offset = mesh.mesh[0].getOffset();
+	chain.addLevel(core::move(mesh), 0.0f);
+
+	for (int i = 0; i < simplifiedLevels; ++i) {
+		if (!chain.addSimplifiedLevel(0.5f)) {
+			break;
+		}
+	}
+
+	core::ScopedPtr<voxel::RawVolume> downsampled;
+	const voxel::RawVolume *source = &volume;
+	int factor = 1;
+	for (int i = 0; i < downsampledLevels; ++i) {
+		const glm::ivec3 &dimensions = source->region().getDimensionsInVoxels();
+		if (glm::any(glm::lessThan(dimensions, glm::ivec3(2)))) {
+			break;
+		}
+		voxel::RawVolume *lodVolume = new voxel::RawVolume(voxel::Region(glm::ivec3(0), (dimensions + 1) / 2 - 1));
+		scaleDown(*source, palette, source->region(), *lodVolume, lodVolume->region());
+		downsampled = lodVolume;
+		source = lodVolume;
+		factor *= 2;
+
+		voxel::ChunkMesh lodMesh;
+		extractLevel(*lodVolume, palette, type, lodMesh, mergeQuads, reuseVertices, ambientOcclusion);
+		// bring the vertices back into the space of the full detail mesh
+		for (int m = 0; m < voxel::ChunkMesh::Meshes; ++m) {
+			voxel::Mesh &lodLevelMesh = lodMesh.mesh[m];
+			for (voxel::VoxelVertex &vertex : lodLevelMesh.getVertexVector()) {
+				vertex.position *= (float)factor;
+			}
+			lodLevelMesh.setOffset(offset);
+			lodLevelMesh.calculateBounds();
+		}
+		// a voxel of this level covers factor^3 voxels of the full detail volume
+		chain.addLevel(core::move(lodMesh), (float)(factor - 1));
+	}
+}
+
+} // namespace voxelutil
@@ -0,0 +1,35 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/SurfaceExtractor.h"
+
+namespace palette {
+class Palette;
+}
+
+namespace voxel {
+class RawVolume;
+class MeshLodChain;
+} // namespace voxel
+
+namespace voxelutil {
+
+/**
+ * @brief Build the level of detail chain for the given volume
+ *
+ * Level 0 is the full detail mesh. The mid levels are created by simplifying the triangles of the previous level, the
+ * coarse levels are extracted from downsampled volumes - each of these levels halves the resolution.
+ *
+ * @param[in] simplifiedLevels The amount of levels that are created by triangle simplification
+ * @param[in] downsampledLevels The amount of levels that are created by downsampling the volume
+ * @note All levels share the offset and the coordinate space of the full detail mesh
+ */
+void createLodChain(const voxel::RawVolume &volume, const palette::Palette &palette,
+					voxel::SurfaceExtractionType type, int simplifiedLevels, int downsampledLevels,
+					voxel::MeshLodChain &chain, bool mergeQuads = true, bool reuseVertices = true,
+					bool ambientOcclusion = false);
+
+} // namespace voxelutil
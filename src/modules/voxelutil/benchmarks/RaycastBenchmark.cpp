@@ -0,0 +1,85 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/OccupancyPyramid.h"
+#include "voxelutil/Picking.h"
+#include <random>
+
+/**
+ * @brief Long rays through a large and mostly empty volume - compares the voxel by voxel raycast with the hierarchical
+ * traversal of the occupancy pyramid
+ */
+class RaycastBenchmark : public app::AbstractBenchmark {
+protected:
+	voxel::RawVolume _volume{voxel::Region{0, 255}};
+	core::DynamicArray<voxelutil::PickRay> _rays;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		if (!_rays.empty()) {
+			return;
+		}
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+		// a ground plane and a few scattered boxes
+		for (int z = 0; z < 256; ++z) {
+			for (int x = 0; x < 256; ++x) {
+				_volume.setVoxel(x, 0, z, voxel);
+			}
+		}
+		std::mt19937 rng(0);
+		std::uniform_int_distribution<int> coord(0, 240);
+		for (int i = 0; i < 32; ++i) {
+			const glm::ivec3 mins(coord(rng), coord(rng), coord(rng));
+			for (int z = 0; z < 8; ++z) {
+				for (int y = 0; y < 8; ++y) {
+					for (int x = 0; x < 8; ++x) {
+						_volume.setVoxel(mins + glm::ivec3(x, y, z), voxel);
+					}
+				}
+			}
+		}
+		std::uniform_real_distribution<float> pos(0.0f, 256.0f);
+		for (int i = 0; i < 1024; ++i) {
+			voxelutil::PickRay ray;
+			ray.start = glm::vec3(pos(rng), 255.5f, pos(rng));
+			ray.directionAndLength = glm::vec3(pos(rng), 0.0f, pos(rng)) - ray.start;
+			_rays.push_back(ray);
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(RaycastBenchmark, PickVoxel)(benchmark::State &state) {
+	for (auto _ : state) {
+		for (const voxelutil::PickRay &ray : _rays) {
+			benchmark::DoNotOptimize(voxelutil::pickVoxel(&_volume, ray.start, ray.directionAndLength, voxel::Voxel()));
+		}
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)_rays.size());
+}
+
+BENCHMARK_DEFINE_F(RaycastBenchmark, OccupancyPyramid)(benchmark::State &state) {
+	const voxelutil::OccupancyPyramid pyramid(&_volume);
+	core::DynamicArray<voxelutil::PickResult> results;
+	results.resize(_rays.size());
+	for (auto _ : state) {
+		pyramid.pick(_rays.data(), results.data(), (int)_rays.size());
+		benchmark::DoNotOptimize(results.data());
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * (int64_t)_rays.size());
+}
+
+BENCHMARK_DEFINE_F(RaycastBenchmark, OccupancyPyramidBuild)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxelutil::OccupancyPyramid pyramid(&_volume);
+		benchmark::DoNotOptimize(pyramid.levels());
+	}
+}
+
+BENCHMARK_REGISTER_F(RaycastBenchmark, PickVoxel)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(RaycastBenchmark, OccupancyPyramid)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(RaycastBenchmark, OccupancyPyramidBuild)->Unit(benchmark::kMillisecond);
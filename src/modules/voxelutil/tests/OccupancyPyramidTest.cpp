@@ -0,0 +1,151 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/OccupancyPyramid.h"
+#include "app/tests/AbstractTest.h"
+#include "core/GLM.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/Picking.h"
+#include <limits>
+#include <random>
+
+namespace voxelutil {
+
+class OccupancyPyramidTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Reference voxel traversal that only steps to face neighbours (Amanatides and Woo) - other than
+	 * @c pickVoxel() that also visits diagonal neighbours
+	 */
+	static PickResult pickFaceConnected(const voxel::RawVolume &v, const glm::vec3 &start,
+										const glm::vec3 &directionAndLength) {
+		PickResult result;
+		glm::ivec3 pos(glm::floor(start));
+		glm::ivec3 step;
+		glm::vec3 tMax;
+		glm::vec3 tDelta;
+		for (int a = 0; a < 3; ++a) {
+			step[a] = directionAndLength[a] > 0.0f ? 1 : -1;
+			if (directionAndLength[a] == 0.0f) {
+				tMax[a] = tDelta[a] = (std::numeric_limits<float>::max)();
+				continue;
+			}
+			const float invDir = 1.0f / directionAndLength[a];
+			const float boundary = (float)(step[a] > 0 ? pos[a] + 1 : pos[a]);
+			tMax[a] = (boundary - start[a]) * invDir;
+			tDelta[a] = glm::abs(invDir);
+		}
+		float t = 0.0f;
+		while (t <= 1.0f && v.region().containsPoint(pos)) {
+			if (!voxel::isAir(v.voxel(pos).getMaterial())) {
+				result.didHit = true;
+				result.hitVoxel = pos;
+				return result;
+			}
+			const int axis = tMax.x <= tMax.y ? (tMax.x <= tMax.z ? 0 : 2) : (tMax.y <= tMax.z ? 1 : 2);
+			t = tMax[axis];
+			tMax[axis] += tDelta[axis];
+			pos[axis] += step[axis];
+		}
+		return result;
+	}
+};
+
+TEST_F(OccupancyPyramidTest, testLevels) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	v.setVoxel(glm::ivec3(5, 9, 30), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	OccupancyPyramid pyramid(&v);
+	// 8^3 bricks, 4^3, 2^3 and the root cell
+	ASSERT_EQ(4, pyramid.levels());
+	EXPECT_TRUE(pyramid.occupied(0, glm::ivec3(1, 2, 7)));
+	EXPECT_FALSE(pyramid.occupied(0, glm::ivec3(1, 2, 6)));
+	EXPECT_TRUE(pyramid.occupied(1, glm::ivec3(0, 1, 3)));
+	EXPECT_TRUE(pyramid.occupied(3, glm::ivec3(0)));
+}
+
+TEST_F(OccupancyPyramidTest, testPicking) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(0), glm::ivec3(10)));
+	v.setVoxel(glm::ivec3(0), voxel::createVoxel(voxel::VoxelType::Generic, 0));
+	OccupancyPyramid pyramid(&v);
+	const PickResult &result = pyramid.pick(glm::vec3(0.0f, 3.0f, 0.0f), glm::down() * 100.0f);
+	ASSERT_TRUE(result.didHit);
+	EXPECT_EQ(glm::ivec3(0), result.hitVoxel);
+	EXPECT_TRUE(result.validPreviousPosition);
+	EXPECT_EQ(glm::ivec3(0, 1, 0), result.previousPosition);
+	EXPECT_EQ(voxel::FaceNames::PositiveY, result.hitFace);
+}
+
+TEST_F(OccupancyPyramidTest, testPickingFromOutside) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(-20), glm::ivec3(40)));
+	v.setVoxel(glm::ivec3(30, 1, 2), voxel::createVoxel(voxel::VoxelType::Generic, 0));
+	OccupancyPyramid pyramid(&v);
+	const PickResult &result = pyramid.pick(glm::vec3(-100.0f, 1.5f, 2.5f), glm::right() * 200.0f);
+	ASSERT_TRUE(result.didHit);
+	EXPECT_EQ(glm::ivec3(30, 1, 2), result.hitVoxel);
+	EXPECT_EQ(glm::ivec3(29, 1, 2), result.previousPosition);
+	EXPECT_EQ(voxel::FaceNames::NegativeX, result.hitFace);
+
+	const PickResult &miss = pyramid.pick(glm::vec3(-100.0f, 2.5f, 2.5f), glm::right() * 200.0f);
+	EXPECT_FALSE(miss.didHit);
+	const PickResult &tooShort = pyramid.pick(glm::vec3(-100.0f, 1.5f, 2.5f), glm::right() * 100.0f);
+	EXPECT_FALSE(tooShort.didHit);
+}
+
+TEST_F(OccupancyPyramidTest, testUpdate) {
+	voxel::RawVolume v(voxel::Region(0, 63));
+	OccupancyPyramid pyramid(&v);
+	const glm::vec3 start(10.5f, 70.0f, 20.5f);
+	const glm::vec3 dir = glm::down() * 100.0f;
+	EXPECT_FALSE(pyramid.pick(start, dir).didHit);
+
+	v.setVoxel(glm::ivec3(10, 5, 20), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	pyramid.update(voxel::Region(glm::ivec3(10, 5, 20), glm::ivec3(10, 5, 20)));
+	PickResult result = pyramid.pick(start, dir);
+	ASSERT_TRUE(result.didHit);
+	EXPECT_EQ(glm::ivec3(10, 5, 20), result.hitVoxel);
+
+	v.setVoxel(glm::ivec3(10, 5, 20), voxel::Voxel());
+	pyramid.update(voxel::Region(glm::ivec3(10, 5, 20), glm::ivec3(10, 5, 20)));
+	EXPECT_FALSE(pyramid.pick(start, dir).didHit);
+	EXPECT_FALSE(pyramid.occupied(pyramid.levels() - 1, glm::ivec3(0)));
+}
+
+TEST_F(OccupancyPyramidTest, testMatchesPickVoxel) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(-8), glm::ivec3(55)));
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> coord(-8, 55);
+	for (int i = 0; i < 200; ++i) {
+		v.setVoxel(coord(rng), coord(rng), coord(rng), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	}
+	OccupancyPyramid pyramid(&v);
+	std::uniform_real_distribution<float> pos(-7.5f, 54.5f);
+	core::DynamicArray<PickRay> rays;
+	for (int i = 0; i < 256; ++i) {
+		PickRay ray;
+		ray.start = glm::vec3(pos(rng), pos(rng), pos(rng));
+		ray.directionAndLength = glm::vec3(pos(rng), pos(rng), pos(rng)) - ray.start;
+		rays.push_back(ray);
+	}
+	core::DynamicArray<PickResult> results;
+	results.resize(rays.size());
+	pyramid.pick(rays.data(), results.data(), (int)rays.size(), &_testApp->threadPool());
+	int hits = 0;
+	for (size_t i = 0; i < rays.size(); ++i) {
+		const PickResult &expected = pickFaceConnected(v, rays[i].start, rays[i].directionAndLength);
+		const PickResult &result = results[i];
+		ASSERT_EQ(expected.didHit, result.didHit) << "ray " << i;
+		if (expected.didHit) {
+			EXPECT_EQ(expected.hitVoxel, result.hitVoxel) << "ray " << i;
+			++hits;
+		}
+		// pickVoxel() visits diagonal neighbours, too - so it can only hit more and earlier
+		const PickResult &voxelPick = pickVoxel(&v, rays[i].start, rays[i].directionAndLength, voxel::Voxel());
+		if (result.didHit) {
+			EXPECT_TRUE(voxelPick.didHit) << "ray " << i;
+		}
+	}
+	EXPECT_GT(hits, 0);
+}
+
+} // namespace voxelutil
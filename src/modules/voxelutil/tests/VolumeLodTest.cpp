@@ -0,0 +1,81 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/VolumeLod.h"
+#include "app/tests/AbstractTest.h"
+#include "palette/Palette.h"
+#include "voxel/MeshLod.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include <glm/geometric.hpp>
+
+namespace voxelutil {
+
+class VolumeLodTest : public app::AbstractTest {
+protected:
+	static size_t indices(const voxel::ChunkMesh &mesh) {
+		return mesh.mesh[0].getNoOfIndices() + mesh.mesh[1].getNoOfIndices();
+	}
+
+	// a sphere that is not located at the origin
+	static void fillSphere(voxel::RawVolume &volume) {
+		const voxel::Region &region = volume.region();
+		const glm::vec3 center = glm::vec3(region.getLowerCorner()) + glm::vec3(region.getDimensionsInVoxels()) / 2.0f;
+		const float radius = (float)region.getWidthInVoxels() / 2.0f - 1.0f;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if (glm::distance(glm::vec3(x, y, z) + 0.5f, center) <= radius) {
+						volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1 + (x + y) % 3));
+					}
+				}
+			}
+		}
+	}
+};
+
+TEST_F(VolumeLodTest, testCreateLodChain) {
+	voxel::RawVolume volume(voxel::Region(10, 41));
+	fillSphere(volume);
+	palette::Palette palette;
+	palette.nippon();
+	voxel::MeshLodChain chain;
+	createLodChain(volume, palette, voxel::SurfaceExtractionType::Cubic, 2, 2, chain, false, true);
+	ASSERT_GE(chain.size(), 4);
+	voxel::Mesh fullDetail = chain.level(0).mesh[0];
+	ASSERT_FALSE(fullDetail.isEmpty());
+	fullDetail.calculateBounds();
+	for (int i = 1; i < chain.size(); ++i) {
+		EXPECT_LE(chain.error(i - 1), chain.error(i)) << "The error must not decrease for level " << i;
+		EXPECT_LT(indices(chain.level(i)), indices(chain.level(0))) << "Level " << i << " has too many indices";
+		voxel::Mesh mesh = chain.level(i).mesh[0];
+		mesh.calculateBounds();
+		ASSERT_FALSE(mesh.isEmpty()) << "Level " << i << " is empty";
+		EXPECT_EQ(fullDetail.getOffset(), mesh.getOffset());
+		// all levels must cover the same space
+		EXPECT_NEAR(fullDetail.mins().x, mesh.mins().x, 4.0f) << "Level " << i;
+		EXPECT_NEAR(fullDetail.maxs().x, mesh.maxs().x, 4.0f) << "Level " << i;
+	}
+}
+
+TEST_F(VolumeLodTest, testSelectLod) {
+	voxel::RawVolume volume(voxel::Region(0, 31));
+	fillSphere(volume);
+	palette::Palette palette;
+	palette.nippon();
+	voxel::MeshLodChain chain;
+	EXPECT_EQ(-1, chain.select(10.0f, 0.001f));
+	createLodChain(volume, palette, voxel::SurfaceExtractionType::Cubic, 1, 2, chain, false, true);
+	ASSERT_GE(chain.size(), 2);
+	EXPECT_EQ(0, chain.select(0.0f, 0.001f));
+	EXPECT_EQ(chain.size() - 1, chain.select(1000000.0f, 0.001f));
+	int last = 0;
+	for (float distance = 1.0f; distance < 100000.0f; distance *= 2.0f) {
+		const int lod = chain.select(distance, 0.001f);
+		EXPECT_GE(lod, last) << "The level of detail must not increase with the distance";
+		last = lod;
+	}
+}
+
+} // namespace voxelutil
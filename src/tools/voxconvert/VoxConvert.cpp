@@ -14,6 +14,7 @@
 #include "core/collection/Set.h"
 #include "core/collection/StringSet.h"
 #include "core/concurrent/Concurrency.h"
+#include "core/concurrent/ThreadPool.h"
 #include "engine-git.h"
 #include "image/Image.h"
 #include "io/Archive.h"
@@ -49,6 +50,8 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/trigonometric.hpp>
 
+thread_local VoxConvert::BatchResult *VoxConvert::_batchJob = nullptr;
+
 VoxConvert::VoxConvert(const io::FilesystemPtr &filesystem, const core::TimeProviderPtr &timeProvider)
 	: Super(filesystem, timeProvider, core::cpus()) {
 	init(ORGANISATION, "voxconvert");
@@ -65,6 +68,9 @@ app::AppState VoxConvert::onConstruct() {
 	registerArg("--filter").setDescription("Model filter. For example '1-4,6'");
 	registerArg("--filter-property").setDescription("Model filter by property. For example 'name:foo'");
 	registerArg("--force").setShort("-f").setDescription("Overwrite existing files");
+	registerArg("--jobs")
+		.setDescription("Convert every input file on its own with the given amount of threads. The --output value "
+						"needs a * as placeholder for the input file name. Use 0 for the amount of cores");
 	registerArg("--input").setShort("-i").setDescription("Allow to specify input files").addFlag(ARGUMENT_FLAG_FILE);
 	registerArg("--wildcard")
 		.setShort("-w")
@@ -381,6 +387,25 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
+	if (hasArg("--jobs")) {
+		if (infiles.empty()) {
+			Log::error("Batch mode needs input files");
+			return app::AppState::InitFailure;
+		}
+		if (_exportModels || _printSceneGraph) {
+			Log::error("--export-models and --json are not supported in batch mode");
+			return app::AppState::InitFailure;
+		}
+		if (outfiles.size() != 1u || !outfiles[0].contains("*")) {
+			Log::error("Batch mode needs exactly one output file with a * as placeholder for the input file name");
+			return app::AppState::InitFailure;
+		}
+		if (!batchConvert(infiles, outfiles[0], scriptParameters)) {
+			return app::AppState::InitFailure;
+		}
+		return state;
+	}
+
 	const io::ArchivePtr &fsArchive = io::openFilesystemArchive(filesystem());
 	scenegraph::SceneGraph sceneGraph;
 	for (const core::String &infile : infiles) {
@@ -460,30 +485,10 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
-	const bool applyFilter = hasArg("--filter");
-	if (applyFilter) {
-		if (infiles.size() == 1u) {
-			filterModels(sceneGraph);
-		} else {
-			Log::warn("Don't apply model filters for multiple input files");
-		}
-	}
-
-	const bool applyFilterProperty = hasArg("--filter-property");
-	if (applyFilterProperty) {
-		if (infiles.size() == 1u) {
-			const core::String &property = getArgVal("--filter-property");
-			core::String key = property;
-			core::String value;
-			const size_t colonPos = property.find(":");
-			if (colonPos != core::String::npos) {
-				key = property.substr(0, colonPos);
-				value = property.substr(colonPos + 1);
-			}
-			filterModelsByProperty(sceneGraph, key, value);
-		} else {
-			Log::warn("Don't apply model property filters for multiple input files");
-		}
+	if (infiles.size() == 1u) {
+		filterSceneGraph(sceneGraph);
+	} else if (hasArg("--filter") || hasArg("--filter-property")) {
+		Log::warn("Don't apply model filters for multiple input files");
 	}
 
 	if (_exportModels) {
@@ -501,19 +506,50 @@ app::AppState VoxConvert::onInit() {
 		return state;
 	}
 
+	if (!transformSceneGraph(sceneGraph, infilesstr, scriptParameters)) {
+		return app::AppState::InitFailure;
+	}
+
+	for (const core::String &outfile : outfiles) {
+		if (!saveSceneGraph(sceneGraph, outfile)) {
+			return app::AppState::InitFailure;
+		}
+	}
+	return state;
+}
+
+void VoxConvert::filterSceneGraph(scenegraph::SceneGraph &sceneGraph) {
+	if (hasArg("--filter")) {
+		filterModels(sceneGraph);
+	}
+	if (hasArg("--filter-property")) {
+		const core::String &property = getArgVal("--filter-property");
+		core::String key = property;
+		core::String value;
+		const size_t colonPos = property.find(":");
+		if (colonPos != core::String::npos) {
+			key = property.substr(0, colonPos);
+			value = property.substr(colonPos + 1);
+		}
+		filterModelsByProperty(sceneGraph, key, value);
+	}
+}
+
+bool VoxConvert::transformSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &name,
+									 const core::String &scriptParameters) {
 	if (_mergeModels) {
 		Log::info("Merge models");
 		const scenegraph::SceneGraph::MergeResult &merged = sceneGraph.merge();
 		if (!merged.hasVolume()) {
 			Log::error("Failed to merge models");
-			return app::AppState::InitFailure;
+			return false;
 		}
 		sceneGraph.clear();
 		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 		node.setVolume(merged.volume(), true);
 		node.setPalette(merged.palette);
 		node.setNormalPalette(merged.normalPalette);
-		node.setName(infilesstr);
+		node.setName(name);
 		sceneGraph.emplace(core::move(node));
 	}
 
@@ -553,29 +589,166 @@ app::AppState VoxConvert::onInit() {
 	if (_splitModels) {
 		split(getArgIvec3("--split"), sceneGraph);
 	}
+	return true;
+}
 
-	for (const core::String &outfile : outfiles) {
-		if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, palette::palettes()))) {
-			// if the given format is a palette only format (some voxel formats might have the same
-			// extension - so we check that here)
-			const palette::Palette &palette = sceneGraph.mergePalettes(false);
-			if (!palette.save(outfile.c_str())) {
-				Log::error("Failed to save palette to %s", outfile.c_str());
-				return app::AppState::InitFailure;
+bool VoxConvert::saveSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &outfile) {
+	if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, palette::palettes()))) {
+		// if the given format is a palette only format (some voxel formats might have the same
+		// extension - so we check that here)
+		const palette::Palette &palette = sceneGraph.mergePalettes(false);
+		if (!palette.save(outfile.c_str())) {
+			Log::error("Failed to save palette to %s", outfile.c_str());
+			return false;
+		}
+		Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
+	} else {
+		Log::debug("Save %i models", (int)sceneGraph.size());
+		voxelformat::SaveContext saveCtx;
+		const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
+		if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
+			Log::error("Failed to write to output file '%s'", outfile.c_str());
+			return false;
+		}
+		Log::info("Wrote output file %s", outfile.c_str());
+	}
+	return true;
+}
+
+void VoxConvert::batchLogOutputFunction(void *userdata, int category, SDL_LogPriority priority,
+										const char *message) {
+	if (_batchJob != nullptr) {
+		_batchJob->log.emplace_back(BatchLogMessage{category, priority, message});
+		return;
+	}
+	const BatchLogOutput *output = (const BatchLogOutput *)userdata;
+	output->callback(output->userdata, category, priority, message);
+}
+
+VoxConvert::BatchResult VoxConvert::convertFile(const core::String &infile, const core::String &outfile,
+												const core::String &scriptParameters) {
+	const uint64_t start = core::TimeProvider::systemMillis();
+	BatchResult result;
+	if (shouldQuit()) {
+		return result;
+	}
+	// the messages of the jobs that run in parallel would interleave
+	_batchJob = &result;
+	// every input file gets its own scene graph - the memory is released once the file is converted
+	scenegraph::SceneGraph sceneGraph;
+	voxelformat::LoadContext loadCtx;
+	io::FileDescription fileDesc;
+	fileDesc.set(infile);
+	const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
+	if (voxelformat::loadFormat(fileDesc, archive, sceneGraph, loadCtx) && !sceneGraph.empty()) {
+		filterSceneGraph(sceneGraph);
+		if (transformSceneGraph(sceneGraph, core::string::extractFilenameWithExtension(infile), scriptParameters)) {
+			result.success = saveSceneGraph(sceneGraph, outfile);
+		}
+	}
+	_batchJob = nullptr;
+	result.millis = core::TimeProvider::systemMillis() - start;
+	return result;
+}
+
+bool VoxConvert::batchConvert(const core::DynamicArray<core::String> &infiles, const core::String &outfilePattern,
+							  const core::String &scriptParameters) {
+	const core::String &filter = getArgVal("--wildcard", "");
+	core::DynamicArray<core::String> batchInfiles;
+	for (const core::String &infile : infiles) {
+		if (filesystem()->sysIsReadableDir(infile)) {
+			core::DynamicArray<io::FilesystemEntry> entities;
+			filesystem()->list(infile, entities, filter);
+			for (const io::FilesystemEntry &entry : entities) {
+				if (entry.type == io::FilesystemEntry::Type::file) {
+					batchInfiles.push_back(core::string::path(infile, entry.name));
+				}
 			}
-			Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
+		} else if (io::isZipArchive(infile)) {
+			Log::error("Archives are not supported in batch mode: %s", infile.c_str());
+			return false;
 		} else {
-			Log::debug("Save %i models", (int)sceneGraph.size());
-			voxelformat::SaveContext saveCtx;
-			const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
-			if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
-				Log::error("Failed to write to output file '%s'", outfile.c_str());
-				return app::AppState::InitFailure;
-			}
-			Log::info("Wrote output file %s", outfile.c_str());
+			batchInfiles.push_back(infile);
 		}
 	}
-	return state;
+	if (batchInfiles.empty()) {
+		Log::error("Could not find any input file");
+		return false;
+	}
+
+	const core::String &outdir = core::string::extractDir(outfilePattern);
+	if (!outdir.empty() && !filesystem()->sysCreateDir(outdir)) {
+		Log::error("Failed to create output directory %s", outdir.c_str());
+		return false;
+	}
+
+	const bool force = hasArg("--force");
+	core::StringSet uniqueOutfiles;
+	core::DynamicArray<core::String> batchOutfiles;
+	batchOutfiles.reserve(batchInfiles.size());
+	for (const core::String &infile : batchInfiles) {
+		const core::String &outfile =
+			core::string::replaceAll(outfilePattern, "*", core::string::extractFilename(infile));
+		if (!uniqueOutfiles.insert(outfile)) {
+			Log::error("Output file '%s' would be written by more than one input file", outfile.c_str());
+			return false;
+		}
+		if (!force && filesystem()->open(outfile)->exists()) {
+			Log::error("Given output file '%s' already exists", outfile.c_str());
+			return false;
+		}
+		batchOutfiles.push_back(outfile);
+	}
+
+	int jobs = getArgVal("--jobs", "0").toInt();
+	if (jobs <= 0) {
+		jobs = (int)core::cpus();
+	}
+	const int n = (int)batchInfiles.size();
+	Log::info("Convert %i files with %i jobs", n, jobs);
+
+	const uint64_t start = core::TimeProvider::systemMillis();
+	BatchLogOutput logOutput;
+	SDL_LogGetOutputFunction(&logOutput.callback, &logOutput.userdata);
+	SDL_LogSetOutputFunction(batchLogOutputFunction, &logOutput);
+	// the amount of threads limits the amount of scene graphs that are loaded at the same time
+	core::ThreadPool threadPool(jobs, "voxconvert");
+	threadPool.init();
+	core::DynamicArray<std::future<BatchResult>> futures;
+	futures.reserve(n);
+	for (int i = 0; i < n; ++i) {
+		futures.emplace_back(threadPool.enqueue([this, i, &batchInfiles, &batchOutfiles, &scriptParameters]() {
+			return convertFile(batchInfiles[i], batchOutfiles[i], scriptParameters);
+		}));
+	}
+
+	// report in the order of the input files - independent of the order the jobs finish in
+	core::DynamicArray<core::String> failed;
+	for (int i = 0; i < n; ++i) {
+		BatchResult result;
+		if (futures[i].valid()) {
+			result = futures[i].get();
+		}
+		for (const BatchLogMessage &msg : result.log) {
+			logOutput.callback(logOutput.userdata, msg.category, msg.priority, msg.message.c_str());
+		}
+		if (result.success) {
+			Log::info("[%i/%i] %s -> %s (%i ms)", i + 1, n, batchInfiles[i].c_str(), batchOutfiles[i].c_str(),
+					  (int)result.millis);
+		} else {
+			Log::error("[%i/%i] Failed to convert %s (%i ms)", i + 1, n, batchInfiles[i].c_str(), (int)result.millis);
+			failed.push_back(batchInfiles[i]);
+		}
+	}
+	threadPool.shutdown(true);
+	SDL_LogSetOutputFunction(logOutput.callback, logOutput.userdata);
+
+	Log::info("Converted %i of %i files in %i ms", n - (int)failed.size(), n,
+			  (int)(core::TimeProvider::systemMillis() - start));
+	for (const core::String &infile : failed) {
+		Log::error(" * %s", infile.c_str());
+	}
+	return failed.empty();
 }
 
 core::String VoxConvert::getFilenameForModelName(const core::String &inputfile, const core::String &modelName,
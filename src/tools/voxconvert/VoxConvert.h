@@ -5,6 +5,8 @@
 #pragma once
 
 #include "app/CommandlineApp.h"
+#include "core/Log.h"
+#include "core/collection/DynamicArray.h"
 #include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 
@@ -60,12 +62,54 @@ private:
 			return *this;
 		}
 	};
+
+	struct BatchLogMessage {
+		int category = 0;
+		SDL_LogPriority priority = SDL_LOG_PRIORITY_INFO;
+		core::String message;
+	};
+
+	struct BatchResult {
+		bool success = false;
+		uint64_t millis = 0u;
+		/**
+		 * @brief The log messages of the job - they are printed in the order of the input files
+		 */
+		core::DynamicArray<BatchLogMessage> log;
+	};
+
+	/**
+	 * @brief The result of the batch job that is executed on the current thread - its log messages are buffered
+	 */
+	static thread_local BatchResult *_batchJob;
+
+	struct BatchLogOutput {
+		SDL_LogOutputFunction callback = nullptr;
+		void *userdata = nullptr;
+	};
+	static void batchLogOutputFunction(void *userdata, int category, SDL_LogPriority priority, const char *message);
 protected:
 	glm::ivec3 getArgIvec3(const core::String &name);
 	core::String getFilenameForModelName(const core::String &inputfile, const core::String &modelName,
 										 const core::String &outExt, int id, bool uniqueNames);
 	bool handleInputFile(const core::String &infile, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 						 bool multipleInputs);
+	void filterSceneGraph(scenegraph::SceneGraph &sceneGraph);
+	bool transformSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &name,
+							 const core::String &scriptParameters);
+	bool saveSceneGraph(scenegraph::SceneGraph &sceneGraph, const core::String &outfile);
+	/**
+	 * @brief Loads, transforms and saves a single input file in its own scene graph. This is executed on
+	 * the worker threads of the batch mode.
+	 */
+	BatchResult convertFile(const core::String &infile, const core::String &outfile,
+							const core::String &scriptParameters);
+	/**
+	 * @brief Converts every input file on its own (the @c --jobs mode). The @c * in the output file pattern is
+	 * replaced by the input file name.
+	 */
+	bool batchConvert(const core::DynamicArray<core::String> &infiles, const core::String &outfilePattern,
+					  const core::String &scriptParameters);
 
 	void usage() const override;
 	void printUsageHeader() const override;
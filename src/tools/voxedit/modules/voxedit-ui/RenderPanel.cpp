@@ -102,6 +102,9 @@ void RenderPanel::updateSettings(const char *id, const scenegraph::SceneGraph &s
 		changed += ImGui::Checkbox(_("High Quality BVH"), &params.highqualitybvh);
 		ImGui::TooltipTextUnformatted(_("High quality bounding volume hierarchy"));
 		changed += ImGui::Checkbox(_("Denoise"), &params.denoise);
+		changed += ImGui::Checkbox(_("Trace voxels"), &state.voxels);
+		ImGui::TooltipTextUnformatted(_("Intersect the voxels directly instead of extracting meshes. Starts faster "
+										"and needs less memory for large scenes - the tracer setting is ignored."));
 
 		if (ImGui::Button(_("Reset all"))) {
 			params = yocto::trace_params();
@@ -817,8 +817,8 @@ bool SceneManager::mementoModification(const memento::MementoState& s) {
 			if (node->type() == scenegraph::SceneGraphNodeType::ModelReference && s.nodeType == scenegraph::SceneGraphNodeType::Model) {
 				node->unreferenceModelNode(_sceneGraph.node(node->reference()));
 			}
-			if (node->region() != s.dataRegion()) {
-				voxel::RawVolume *v = new voxel::RawVolume(s.dataRegion());
+			if (node->region() != s.volumeRegion()) {
+				voxel::RawVolume *v = new voxel::RawVolume(s.volumeRegion());
 				if (!setSceneGraphNodeVolume(*node, v)) {
 					delete v;
 				}
@@ -840,7 +840,7 @@ bool SceneManager::mementoStateToNode(const memento::MementoState &s) {
 	core_assert(s.nodeType != scenegraph::SceneGraphNodeType::Max);
 	scenegraph::SceneGraphNode newNode(s.nodeType, s.nodeUUID);
 	if (newNode.isModelNode()) {
-		newNode.setVolume(new voxel::RawVolume(s.dataRegion()), true);
+		newNode.setVolume(new voxel::RawVolume(s.volumeRegion()), true);
 		if (s.hasVolumeData()) {
 			memento::MementoData::toVolume(newNode.volume(), s.data);
 		}
@@ -1576,6 +1576,7 @@ void SceneManager::construct() {
 	_movementSpeed = core::Var::get(cfg::VoxEditMovementSpeed, "180.0f");
 	_transformUpdateChildren = core::Var::get(cfg::VoxEditTransformUpdateChildren, "true", -1, _("Update the children of a node when the transform of the node changes"));
 	_maxSuggestedVolumeSize = core::Var::getSafe(cfg::VoxEditMaxSuggestedVolumeSize);
+	_undoMaxMemory = core::Var::get(cfg::VoxEditUndoMaxMemory, "256", -1, _("The memory budget in MB for the undo states"));
 
 	command::Command::registerCommand("resizetoselection", [&](const command::CmdArgs &args) {
 		const voxel::Region &region = modifier().selectionMgr().region();
@@ -2400,6 +2401,7 @@ bool SceneManager::init() {
 
 	voxel::Region maxUndoRegion(0, _maxSuggestedVolumeSize->intVal() - 1);
 	_mementoHandler.setMaxUndoRegion(maxUndoRegion);
+	_mementoHandler.setMaxMemory((size_t)_undoMaxMemory->intVal() * 1024u * 1024u);
 
 	_modifierFacade.setLockedAxis(math::Axis::None, true);
 	return true;
@@ -2504,6 +2506,10 @@ bool SceneManager::update(double nowSeconds) {
 		_mementoHandler.setMaxUndoRegion(maxUndoRegion);
 		_maxSuggestedVolumeSize->markClean();
 	}
+	if (_undoMaxMemory->isDirty()) {
+		_mementoHandler.setMaxMemory((size_t)_undoMaxMemory->intVal() * 1024u * 1024u);
+		_undoMaxMemory->markClean();
+	}
 
 	_movement.update(nowSeconds);
 	voxelgenerator::ScriptState state = _luaApi.update(nowSeconds);
@@ -2717,6 +2723,7 @@ int SceneManager::traceScene() {
 	core_trace_scoped(EditorSceneOnProcessUpdateRay);
 	float intersectDist = _camera->farPlane();
 	const math::Ray& ray = _camera->mouseRay(_mouseCursor);
+	const scenegraph::FrameTransforms &transforms = _sceneGraph.transformsForFrame(_currentFrameIdx);
 	for (auto entry : _sceneGraph.nodes()) {
 		const scenegraph::SceneGraphNode& node = entry->second;
 		if (previousNodeId == node.id()) {
@@ -2734,7 +2741,7 @@ int SceneManager::traceScene() {
 		float distance = 0.0f;
 		const voxel::Region& region = _sceneGraph.resolveRegion(node);
 		const glm::vec3 pivot = node.pivot();
-		const scenegraph::FrameTransform &transform = _sceneGraph.transformForFrame(node, _currentFrameIdx);
+		const scenegraph::FrameTransform &transform = transforms[node.id()];
 		const math::OBB<float>& obb = scenegraph::toOBB(true, region, pivot, transform);
 		if (obb.intersect(ray.origin, ray.direction, distance)) {
 			if (distance < intersectDist) {
@@ -82,6 +82,7 @@ protected:
 	core::VarPtr _movementSpeed;
 	core::VarPtr _transformUpdateChildren;
 	core::VarPtr _maxSuggestedVolumeSize;
+	core::VarPtr _undoMaxMemory;
 
 	bool _dirty = false;
 	// this is basically the same as the dirty state, but we stop
@@ -177,6 +177,7 @@ void SceneRenderer::updateAABBMesh(bool sceneMode, const scenegraph::SceneGraph
 	}
 	core_trace_scoped(UpdateAABBMesh);
 	_shapeBuilder.clear();
+	const scenegraph::FrameTransforms &transforms = sceneGraph.transformsForFrame(frameIdx);
 	for (auto entry : sceneGraph.nodes()) {
 		const scenegraph::SceneGraphNode &node = entry->second;
 		if (!node.isAnyModelNode()) {
@@ -195,7 +196,7 @@ void SceneRenderer::updateAABBMesh(bool sceneMode, const scenegraph::SceneGraph
 		const voxel::Region &region = sceneGraph.resolveRegion(node);
 		core_assert_msg(region.isValid(), "Region for node %s of type %i is invalid", node.name().c_str(), (int)node.type());
 		const glm::vec3 pivot = node.pivot();
-		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+		const scenegraph::FrameTransform &transform = transforms[node.id()];
 		const math::OBB<float>& obb = scenegraph::toOBB(true, region, pivot, transform);
 		// TODO: make this an aabb and use the transform matrix from the rawvolumerenderer
 		_shapeBuilder.obb(obb);
@@ -207,7 +208,7 @@ void SceneRenderer::updateAABBMesh(bool sceneMode, const scenegraph::SceneGraph
 		const voxel::RawVolume *v = sceneGraph.resolveVolume(activeNode);
 		core_assert(v != nullptr);
 		const voxel::Region &region = v->region();
-		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(activeNode, frameIdx);
+		const scenegraph::FrameTransform &transform = transforms[activeNode.id()];
 		// TODO: make this an aabb and use the transform matrix from the rawvolumerenderer
 		_shapeBuilder.obb(scenegraph::toOBB(sceneMode, region, activeNode.pivot(), transform));
 	}
@@ -229,6 +230,7 @@ void SceneRenderer::updateBoneMesh(bool sceneMode, const scenegraph::SceneGraph
 
 	const bool hideInactive = _hideInactive->boolVal();
 	const int activeNodeId = sceneGraph.activeNode();
+	const scenegraph::FrameTransforms &transforms = sceneGraph.transformsForFrame(frameIdx);
 	for (auto entry : sceneGraph.nodes()) {
 		const scenegraph::SceneGraphNode &node = entry->second;
 		if (!node.isAnyModelNode()) {
@@ -253,8 +255,8 @@ void SceneRenderer::updateBoneMesh(bool sceneMode, const scenegraph::SceneGraph
 			continue;
 		}
 
-		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
-		const scenegraph::FrameTransform &ptransform = sceneGraph.transformForFrame(pnode, frameIdx);
+		const scenegraph::FrameTransform &transform = transforms[node.id()];
+		const scenegraph::FrameTransform &ptransform = transforms[pnode.id()];
 		const glm::vec3 &ptranslation = ptransform.translation();
 		const glm::vec3 &translation = transform.translation();
 
@@ -5,8 +5,8 @@
 #pragma once
 
 #include "ModifierType.h"
-#include "Selection.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxel/BitVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 
 namespace voxedit {
@@ -15,13 +15,16 @@ namespace voxedit {
  * @brief A wrapper for a @c voxel::RawVolume that performs a sanity check for
  * the @c setVoxel() call and uses the @c ModifierType value to perform the
  * desired action for the @c setVoxel() call.
- * The sanity check also includes the @c Selections that are used to limit the
+ * The sanity check also includes the selection volume that is used to limit the
  * area of the @c voxel::RawVolume that is affected by the @c setVoxel() call.
  */
 class ModifierVolumeWrapper : public voxel::RawVolumeWrapper {
 private:
 	using Super = voxel::RawVolumeWrapper;
-	const Selections _selections;
+	/**
+	 * @brief The selected voxels - @c nullptr if every voxel may be modified
+	 */
+	const voxel::BitVolume *_selection;
 	const ModifierType _modifierType;
 	scenegraph::SceneGraphNode &_node;
 
@@ -30,28 +33,23 @@ private:
 	bool _paint;
 	bool _force;
 
-	static bool contains(const Selections &selections, int x, int y, int z) {
-		for (const Selection &sel : selections) {
-			if (sel.containsPoint(x, y, z)) {
-				return true;
-			}
-		}
-		return false;
-	}
-
 	bool skip(int x, int y, int z) const {
 		if (!_region.containsPoint(x, y, z)) {
 			return true;
 		}
-		if (_selections.empty()) {
+		if (_selection == nullptr) {
 			return false;
 		}
-		return !contains(_selections, x, y, z);
+		return !_selection->hasValue(x, y, z);
 	}
 
 public:
-	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType, const Selections &selections = {})
-		: Super(node.volume()), _selections(selections), _modifierType(modifierType), _node(node) {
+	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType,
+						  const voxel::BitVolume *selection = nullptr)
+		: Super(node.volume()), _selection(selection), _modifierType(modifierType), _node(node) {
+		if (_selection != nullptr && _selection->empty()) {
+			_selection = nullptr;
+		}
 		_erase = _modifierType == ModifierType::Erase;
 		_override = _modifierType == ModifierType::Override;
 		_paint = _modifierType == ModifierType::Paint;
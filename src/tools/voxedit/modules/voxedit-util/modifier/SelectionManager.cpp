@@ -4,7 +4,6 @@
 
 #include "SelectionManager.h"
 #include "voxel/RawVolume.h"
-#include "voxel/SparseVolume.h"
 
 namespace voxedit {
 
@@ -12,11 +11,19 @@ const Selections &SelectionManager::selections() const {
 	return _selections;
 }
 
+void SelectionManager::updateSelections() {
+	_selections.clear();
+	_selections.reserve(_selectionVolume.bricks());
+	_selectionVolume.visitBoxes([this](const voxel::Region &region) { _selections.push_back(region); });
+}
+
 void SelectionManager::invert(voxel::RawVolume &volume) {
 	if (!hasSelection()) {
 		select(volume, volume.region().getLowerCorner(), volume.region().getUpperCorner());
 	} else {
-		// TODO: SELECTION
+		_selectionVolume.invert(volume.region());
+		// the inverted selection is no union of the previous boxes - rebuild them from the selected voxels
+		updateSelections();
 	}
 }
 
@@ -26,17 +33,11 @@ void SelectionManager::unselect(voxel::RawVolume &volume) {
 
 void SelectionManager::reset() {
 	_selections.clear();
+	_selectionVolume.clear();
 }
 
 voxel::Region SelectionManager::region() const {
-	if (_selections.empty()) {
-		return voxel::Region::InvalidRegion;
-	}
-	voxel::Region r = _selections[0];
-	for (const Selection &selection : _selections) {
-		r.accumulate(selection);
-	}
-	return r;
+	return _selectionVolume.region();
 }
 
 bool SelectionManager::select(voxel::RawVolume &volume, const glm::ivec3 &mins, const glm::ivec3 &maxs) {
@@ -63,6 +64,7 @@ bool SelectionManager::select(voxel::RawVolume &volume, const glm::ivec3 &mins,
 		}
 	}
 	_selections.push_back(sel);
+	_selectionVolume.setRegion(sel, true);
 	return true;
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Selection.h"
+#include "voxel/BitVolume.h"
 
 namespace voxel {
 class RawVolume;
@@ -14,12 +15,22 @@ namespace voxedit {
 
 class SelectionManager {
 private:
+	/**
+	 * @brief The selected boxes - used for rendering and for copying the selected areas
+	 */
 	Selections _selections;
-	// voxel::SparseVolume _selectionVolume;
+	/**
+	 * @brief One bit per selected voxel - used for the membership tests of the modifiers
+	 */
+	voxel::BitVolume _selectionVolume;
+
+	void updateSelections();
 
 public:
 	// TODO: SELECTION: reduce access to this as much as possible
 	const Selections &selections() const;
+	const voxel::BitVolume &selectionVolume() const;
+	bool isSelected(const glm::ivec3 &pos) const;
 
 	template <typename F>
 	void visitSelections(F &&f) const {
@@ -40,7 +51,15 @@ public:
 };
 
 inline bool SelectionManager::hasSelection() const {
-	return !_selections.empty();
+	return !_selectionVolume.empty();
+}
+
+inline const voxel::BitVolume &SelectionManager::selectionVolume() const {
+	return _selectionVolume;
+}
+
+inline bool SelectionManager::isSelected(const glm::ivec3 &pos) const {
+	return _selectionVolume.hasValue(pos);
 }
 
 } // namespace voxedit
@@ -209,10 +209,10 @@ TEST_F(SceneManagerTest, testNodeAddUndoRedo) {
 	for (int i = 0; i < 3; ++i) {
 		SCOPED_TRACE(i);
 		{
-			EXPECT_EQ(2u, mementoHandler.statePosition());
+			EXPECT_EQ(2, mementoHandler.statePosition());
 			ASSERT_TRUE(mementoHandler.canUndo());
 			EXPECT_TRUE(_sceneMgr->undo());
-			EXPECT_EQ(1u, mementoHandler.statePosition());
+			EXPECT_EQ(1, mementoHandler.statePosition());
 			ASSERT_TRUE(mementoHandler.canUndo());
 			ASSERT_TRUE(mementoHandler.canRedo());
 			EXPECT_EQ(2u, _sceneMgr->sceneGraph().size()) << _sceneMgr->sceneGraph();
@@ -258,7 +258,7 @@ TEST_F(SceneManagerTest, testUndoRedoModificationMultipleNodes) {
 	EXPECT_EQ(5u, mementoHandler.stateSize());
 
 	// last state is the active state
-	EXPECT_EQ(4u, mementoHandler.statePosition());
+	EXPECT_EQ(4, mementoHandler.statePosition());
 
 	for (int i = 0; i < 3; ++i) {
 		const int nodeId = _sceneMgr->sceneGraph().activeNode();
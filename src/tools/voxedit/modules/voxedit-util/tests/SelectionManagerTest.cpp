@@ -3,7 +3,10 @@
  */
 
 #include "../modifier/SelectionManager.h"
+#include "../Clipboard.h"
 #include "app/tests/AbstractTest.h"
+#include "palette/Palette.h"
+#include "voxel/RawVolume.h"
 
 namespace voxedit {
 
@@ -12,10 +15,73 @@ private:
 	using Super = app::AbstractTest;
 };
 
-TEST_F(SelectionManagerTest, test) {
+TEST_F(SelectionManagerTest, testSelect) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
 	SelectionManager mgr;
 	EXPECT_FALSE(mgr.hasSelection());
-	// TODO: SELECTION: implement test
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(1), glm::ivec3(3)));
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(10), glm::ivec3(12)));
+	EXPECT_TRUE(mgr.hasSelection());
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(2)));
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(11)));
+	EXPECT_FALSE(mgr.isSelected(glm::ivec3(5)));
+	EXPECT_EQ(voxel::Region(1, 12), mgr.region());
+	EXPECT_EQ(2u, mgr.selections().size());
+	mgr.unselect(volume);
+	EXPECT_FALSE(mgr.hasSelection());
+	EXPECT_FALSE(mgr.region().isValid());
+}
+
+TEST_F(SelectionManagerTest, testInvert) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	SelectionManager mgr;
+	mgr.invert(volume);
+	EXPECT_EQ(volume.region(), mgr.region());
+	mgr.reset();
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(0), glm::ivec3(7)));
+	mgr.invert(volume);
+	EXPECT_FALSE(mgr.isSelected(glm::ivec3(0)));
+	EXPECT_FALSE(mgr.isSelected(glm::ivec3(7)));
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(8)));
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(15, 0, 0)));
+	EXPECT_EQ((size_t)(16 * 16 * 16 - 8 * 8 * 8), mgr.selectionVolume().count());
+	EXPECT_EQ(volume.region(), mgr.region());
+	EXPECT_FALSE(mgr.selections().empty());
+}
+
+TEST_F(SelectionManagerTest, testInvertNotBrickAligned) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	volume.fill(voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	SelectionManager mgr;
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(2), glm::ivec3(5)));
+	mgr.invert(volume);
+	ASSERT_FALSE(mgr.isSelected(glm::ivec3(3)));
+
+	// the boxes must exactly cover the inverted selection
+	size_t boxVoxels = 0u;
+	for (const Selection &selection : mgr.selections()) {
+		EXPECT_FALSE(voxel::intersects(selection, voxel::Region(2, 5))) << selection.toString();
+		boxVoxels += (size_t)selection.voxels();
+	}
+	EXPECT_EQ(mgr.selectionVolume().count(), boxVoxels);
+
+	palette::Palette palette;
+	palette.nippon();
+	const voxel::VoxelData voxelData(&volume, &palette, false);
+	const voxel::VoxelData copy = tool::copy(voxelData, mgr.selections());
+	ASSERT_TRUE(copy);
+	EXPECT_EQ(volume.region(), copy.volume->region());
+	EXPECT_TRUE(voxel::isAir(copy.volume->voxel(3, 3, 3).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(copy.volume->voxel(2, 5, 2).getMaterial()));
+	EXPECT_FALSE(voxel::isAir(copy.volume->voxel(1, 3, 3).getMaterial()));
+	EXPECT_FALSE(voxel::isAir(copy.volume->voxel(15, 15, 15).getMaterial()));
+
+	// select a part of the hole again
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(3), glm::ivec3(4)));
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(3)));
+	EXPECT_TRUE(mgr.isSelected(glm::ivec3(4)));
+	EXPECT_FALSE(mgr.isSelected(glm::ivec3(2)));
+	EXPECT_EQ((size_t)(16 * 16 * 16 - 4 * 4 * 4 + 2 * 2 * 2), mgr.selectionVolume().count());
 }
 
 } // namespace voxedit